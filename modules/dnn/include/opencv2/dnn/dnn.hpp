@@ -340,6 +340,16 @@ CV__DNN_EXPERIMENTAL_NS_BEGIN
          */
         virtual void unsetAttached();
 
+        /**
+         * @brief Tries to switch the layer to 8-bit integer computations.
+         * @param[in] inputScale quantization step of the layer input: the input is approximated
+         *                       as @p inputScale * q with integer q in [-127, 127]. A non-positive
+         *                       value switches the layer back to floating point computations.
+         * @returns True if the layer runs in 8-bit integers now.
+         * @see Net::quantize
+         */
+        virtual bool tryQuantize(float inputScale);
+
         virtual bool getMemoryShapes(const std::vector<MatShape> &inputs,
                                      const int requiredOutputs,
                                      std::vector<MatShape> &outputs,
@@ -459,6 +469,10 @@ CV__DNN_EXPERIMENTAL_NS_BEGIN
          *  @param outputName name for layer which output is needed to get
          *  @return blob for first output of specified layer.
          *  @details By default runs forward pass for the whole network.
+         *
+         *  The returned blob refers to the memory of the network: it is overwritten by the next forward pass
+         *  and may be released by a change of the inputs shapes or of the network. Clone it or use
+         *  forwardInto() to keep the output.
          */
         CV_WRAP Mat forward(const String& outputName = String());
 
@@ -467,10 +481,28 @@ CV__DNN_EXPERIMENTAL_NS_BEGIN
          *  @details By default runs forward pass for the whole network.
          *
          *  This is an asynchronous version of forward(const String&).
-         *  dnn::DNN_BACKEND_INFERENCE_ENGINE backend is required.
+         *  dnn::DNN_BACKEND_INFERENCE_ENGINE or dnn::DNN_BACKEND_OPENCV backend (with dnn::DNN_TARGET_CPU) is required.
+         *
+         *  With dnn::DNN_BACKEND_OPENCV the request keeps a copy of the current inputs, so setInput() may be
+         *  called for the next request right away; the returned AsyncArray holds its own copy of the output.
+         *  The requests are computed by background threads, see setMaxAsyncRequests(), in the order of the calls.
+         *  Every thread has its own blobs and shares the layers with the network (see cloneSharingWeights()),
+         *  so the requests are computed at the same time with each other and with forward().
+         *  The first request after the network is set up for other input shapes or outputs is computed
+         *  by the calling thread, because the layers prepare some data on the first call. The pending requests
+         *  are completed before the network is set up again or quantized.
          */
         CV_WRAP AsyncArray forwardAsync(const String& outputName = String());
 
+        /** @brief Sets the maximal number of requests of forwardAsync() computed at the same time.
+         *  @param count the number of the background threads, 2 by default.
+         *
+         *  Every thread keeps its own copy of the network blobs, and the layers of every request are
+         *  computed in parallel as in forward(), so more threads mostly help the networks whose layers
+         *  don't load all the CPUs. Only dnn::DNN_BACKEND_OPENCV uses this value.
+         */
+        CV_WRAP void setMaxAsyncRequests(int count);
+
         /** @brief Runs forward pass to compute output of layer with name @p outputName.
          *  @param outputBlobs contains all output blobs for specified layer.
          *  @param outputName name for layer which output is needed to get
@@ -492,6 +524,16 @@ CV__DNN_EXPERIMENTAL_NS_BEGIN
         CV_WRAP_AS(forwardAndRetrieve) void forward(CV_OUT std::vector<std::vector<Mat> >& outputBlobs,
                                                     const std::vector<String>& outBlobNames);
 
+        /** @brief Runs forward pass and writes outputs of layers listed in @p outBlobNames to @p outputBlobs.
+         *  @param outputBlobs blobs for first outputs of specified layers. The blobs which already have the shape
+         *  and the type of the outputs are filled in place, so their data pointers are not changed; the others
+         *  are (re)allocated.
+         *  @param outBlobNames names for layers which outputs are needed to get
+         *  @details Unlike the blobs returned by forward(), @p outputBlobs are the caller's memory: they keep
+         *  their values after the next forward pass and may be preallocated once for all the passes.
+         */
+        void forwardInto(std::vector<Mat>& outputBlobs, const std::vector<String>& outBlobNames);
+
         /**
          * @brief Compile Halide layers.
          * @param[in] scheduler Path to YAML file with scheduling directives.
@@ -543,6 +585,38 @@ CV__DNN_EXPERIMENTAL_NS_BEGIN
         CV_WRAP void setInput(InputArray blob, const String& name = "",
                               double scalefactor = 1.0, const Scalar& mean = Scalar());
 
+        /** @brief Sets the user's blob as the input of the network without copying it.
+         *  @param blob        A blob with CV_32F or CV_8U depth.
+         *  @param name        A name of input layer.
+         *  @param scalefactor An optional normalization scale.
+         *  @param mean        An optional mean subtraction values.
+         *  @details Unlike setInput(), the network keeps a header of @p blob and reads its data at every forward
+         *  pass, so the blob can be refilled in place for the next pass. A continuous CV_32F blob without
+         *  normalization is read by the layers directly with dnn::DNN_BACKEND_OPENCV and dnn::DNN_TARGET_CPU,
+         *  the other blobs are converted at every forward pass as the ones set by setInput().
+         *
+         *  The network never writes to @p blob. Its data must not be changed during a forward pass and, if
+         *  @p blob doesn't own its memory (e.g. it was created from the user's pointer), the memory has to
+         *  stay valid until the input is replaced by setInput() or bindInput(). forwardAsync() copies
+         *  the inputs when it is called.
+         */
+        void bindInput(const Mat& blob, const String& name = "",
+                       double scalefactor = 1.0, const Scalar& mean = Scalar());
+
+        /** @brief Creates a network which shares the layers and their weights with this one.
+         *  @details The new network has its own input, output and intermediate blobs, so both networks
+         *  (and any other copies) can be computed at the same time from different threads while the
+         *  fused and packed weights are stored once.
+         *
+         *  The current inputs must be set. The network is set up for them and for the outputs of the last
+         *  forward() call (or for the last layer), computed once and copied together with the inputs.
+         *  dnn::DNN_BACKEND_OPENCV with dnn::DNN_TARGET_CPU is required.
+         *  @note The networks which share the layers can't change the shapes of the inputs, the computed
+         *  outputs, the backend or the target anymore, and can't be quantized. Use a separate network
+         *  for every set of input shapes. Changing the layer parameters by setParam() affects all of them.
+         */
+        CV_WRAP Net cloneSharingWeights();
+
         /** @brief Sets the new value for the learned param of the layer.
          *  @param layer name or id of the layer.
          *  @param numParam index of the layer parameter in the Layer::blobs array.
@@ -670,16 +744,73 @@ CV__DNN_EXPERIMENTAL_NS_BEGIN
                                           CV_OUT std::vector<size_t>& weights,
                                           CV_OUT std::vector<size_t>& blobs) const; // FIXIT: CV_WRAP
 
+        /** @brief Returns bytes number of the intermediate blobs of the network allocated by the last forward() call.
+         * @param planned output parameter to store bytes which are allocated for the outputs and internal
+         *                blobs of the layers (the network inputs are not counted).
+         * @param naive output parameter to store bytes which the same blobs take if each of them has its own memory.
+         *
+         * With DNN_BACKEND_OPENCV and DNN_TARGET_CPU the blobs are placed into a single block of memory
+         * by their lifetimes after the layers fusion, so the blobs which are not used at the same time share memory.
+         * The layers which support it are computed in-place. Set OPENCV_DNN_DISABLE_MEMORY_PLANNER=1 to use
+         * the memory reuse of the other targets instead.
+         */
+        CV_WRAP void getBlobsMemory(CV_OUT size_t& planned, CV_OUT size_t& naive);
+
         /** @brief Enables or disables layer fusion in the network.
          * @param fusion true to enable the fusion, false to disable. The fusion is enabled by default.
          */
         CV_WRAP void enableFusion(bool fusion);
 
+        /** @brief Enables or disables concurrent computation of independent layers.
+         * @param enable true to compute the layers of parallel branches of the graph at the same time.
+         * Disabled by default.
+         *
+         * A layer is started when all the layers it depends on are finished. The layers which are ready
+         * together and are too small to use all the threads (see setNumThreads()) are computed
+         * at the same time, each one by a single thread; the larger ones use all the threads.
+         * The blobs of the layers at the same depth of the graph don't share memory, so the network
+         * may take more memory. Only DNN_BACKEND_OPENCV with DNN_TARGET_CPU is supported,
+         * the layers are computed one by one otherwise.
+         */
+        CV_WRAP void enableConcurrentBranches(bool enable);
+
+        /** @brief Sets the number of input shapes the network is kept set up for.
+         * @param size maximal number of kept set ups, including the current one. 1 by default.
+         *
+         * The network is set up (shapes inference, layers fusion, memory allocation and weights preparation)
+         * for the shapes of its inputs and the requested outputs. By default it's set up again every time
+         * they change. If @p size is greater than 1, the set ups for the @p size most recently used
+         * combinations of input shapes and outputs are kept, so the network isn't set up again
+         * when it switches back to one of them. Every kept set up has its own blobs and layer instances with
+         * their prepared weights, the original weights are shared. getLayer() returns the layers
+         * of the current set up.
+         *
+         * Only DNN_BACKEND_OPENCV with DNN_TARGET_CPU is supported. The kept set ups are dropped
+         * when the backend, target, fusion or parameters of the network are changed.
+         */
+        CV_WRAP void setPlanCacheSize(int size);
+
+        /** @brief Calibrates the network and switches it to 8-bit integer inference where possible.
+         * @param calibData representative input blobs, each one is passed to setInput() with
+         *                  the scale factor and the mean of the current network input.
+         *
+         * The network is run on every blob to find the dynamic range of the layer inputs.
+         * Then the convolution and fully connected layers quantize their weights per output
+         * channel and their inputs per tensor, and compute the dot products in 8-bit integers
+         * with 32-bit accumulation. Other layers keep floating point computations.
+         * Only DNN_BACKEND_OPENCV with DNN_TARGET_CPU is supported. An empty @p calibData
+         * switches the network back to floating point computations.
+         * @note The network input is left set to the last calibration blob.
+         */
+        CV_WRAP void quantize(InputArrayOfArrays calibData);
+
         /** @brief Returns overall time for inference and timings (in ticks) for layers.
          * Indexes in returned vector correspond to layers ids. Some layers can be fused with others,
          * in this case zero ticks count will be return for that skipped layers.
          * @param timings vector for tick timings for all layers.
-         * @return overall ticks for model inference.
+         * @return overall ticks for model inference. If some layers were computed concurrently
+         * (see enableConcurrentBranches()) this is the elapsed time of the inference, which is less
+         * than the sum of @p timings: their ratio is the achieved speedup.
          */
         CV_WRAP int64 getPerfProfile(CV_OUT std::vector<double>& timings);
 
@@ -937,6 +1068,79 @@ CV__DNN_EXPERIMENTAL_NS_BEGIN
                                    const Scalar& mean = Scalar(), bool swapRB=false, bool crop=false,
                                    int ddepth=CV_32F);
 
+    /**
+     * @brief Enum of dimensions order of the blobs produced by blobFromImageWithParams.
+     * @see Image2BlobParams
+     */
+    enum DataLayout
+    {
+        DNN_LAYOUT_NCHW = 0, //!< Planar layout: images, channels, rows, columns.
+        DNN_LAYOUT_NHWC = 1  //!< Interleaved layout: images, rows, columns, channels.
+    };
+
+    /**
+     * @brief Enum of the ways to fit an image into the spatial size of a blob.
+     * @see Image2BlobParams
+     */
+    enum ImagePaddingMode
+    {
+        DNN_PMODE_NULL = 0,        //!< Direct resize without preserving aspect ratio.
+        DNN_PMODE_CROP_CENTER = 1, //!< Resize preserving aspect ratio so the image covers the blob, then crop from the center.
+        DNN_PMODE_LETTERBOX = 2    //!< Resize preserving aspect ratio so the image fits the blob, then pad with @ref Image2BlobParams::borderValue.
+    };
+
+    /** @brief Parameters of image to blob conversion for blobFromImageWithParams and blobFromImagesWithParams.
+     *
+     *  A pixel value @p v of channel @p c is written to the blob as `(v - mean[c]) * scalefactor[c]`,
+     *  so per-channel standard deviation normalization is done by passing `1/std` values as @p scalefactor.
+     *  If @p swapRB is true, @p mean, @p scalefactor and @p borderValue are given in the order of the output channels.
+     */
+    struct CV_EXPORTS_W_SIMPLE Image2BlobParams
+    {
+        CV_WRAP Image2BlobParams();
+        CV_WRAP Image2BlobParams(const Scalar& scalefactor, const Size& size = Size(), const Scalar& mean = Scalar(),
+                                 bool swapRB = false, int ddepth = CV_32F, int datalayout = DNN_LAYOUT_NCHW,
+                                 int paddingmode = DNN_PMODE_NULL, const Scalar& borderValue = Scalar());
+
+        CV_PROP_RW Scalar scalefactor; //!< per-channel multiplier for image values.
+        CV_PROP_RW Size size;          //!< spatial size of the blob; size of the first image if empty.
+        CV_PROP_RW Scalar mean;        //!< per-channel values which are subtracted from image values.
+        CV_PROP_RW bool swapRB;        //!< swap the first and the last channels of 3- and 4-channel images.
+        CV_PROP_RW int ddepth;         //!< depth of the blob: CV_32F or CV_8U.
+        CV_PROP_RW int datalayout;     //!< dimensions order of the blob, see @ref DataLayout.
+        CV_PROP_RW int paddingmode;    //!< the way to fit images into @p size, see @ref ImagePaddingMode.
+        CV_PROP_RW Scalar borderValue; //!< value of the padded pixels for @ref DNN_PMODE_LETTERBOX.
+    };
+
+    /** @brief Creates 4-dimensional blob from image with given params.
+     *
+     *  The images are resized (cropped or padded) by cv::resize() first, one temporary image per input
+     *  image, so the result is the same as the one of the separate operations. Channels swapping,
+     *  conversion, mean subtraction, scaling and layout transformation are fused into a single pass
+     *  over the resized images which writes directly into the blob.
+     *  blobFromImage(image, scalefactor, size, mean, swapRB, crop, ddepth) is equivalent to
+     *  `Image2BlobParams(Scalar::all(scalefactor), size, mean, swapRB, ddepth, DNN_LAYOUT_NCHW,
+     *  crop ? DNN_PMODE_CROP_CENTER : DNN_PMODE_NULL)`.
+     *  @param image input image (with 1-, 3- or 4-channels).
+     *  @param param struct of Image2BlobParams, contains all parameters needed by the conversion.
+     *  @returns 4-dimensional Mat with NCHW or NHWC dimensions order.
+     */
+    CV_EXPORTS_W Mat blobFromImageWithParams(InputArray image, const Image2BlobParams& param = Image2BlobParams());
+
+    /** @overload */
+    CV_EXPORTS_W void blobFromImageWithParams(InputArray image, OutputArray blob, const Image2BlobParams& param = Image2BlobParams());
+
+    /** @brief Creates 4-dimensional blob from series of images with given params.
+     *  @details Images are processed in parallel. See blobFromImageWithParams.
+     *  @param images input images (all with the same number of channels: 1, 3 or 4).
+     *  @param param struct of Image2BlobParams, contains all parameters needed by the conversion.
+     *  @returns 4-dimensional Mat with NCHW or NHWC dimensions order.
+     */
+    CV_EXPORTS_W Mat blobFromImagesWithParams(InputArrayOfArrays images, const Image2BlobParams& param = Image2BlobParams());
+
+    /** @overload */
+    CV_EXPORTS_W void blobFromImagesWithParams(InputArrayOfArrays images, OutputArray blob, const Image2BlobParams& param = Image2BlobParams());
+
     /** @brief Parse a 4D blob and output the images it contains as 2D arrays through a simpler data structure
      *  (std::vector<cv::Mat>).
      *  @param[in] blob_ 4 dimensional array (images, channels, height, width) in floating point precision (CV_32F) from
@@ -574,15 +574,8 @@ static inline void PrintTo(const ConvParamID& v, std::ostream* os)
 
 
 
-typedef tuple<ConvParamID, tuple<Backend, Target> > ConvTestParam_t;
-typedef TestBaseWithParam<ConvTestParam_t> Conv;
-
-PERF_TEST_P_(Conv, conv)
+static LayerParams getConvLayerParams(const ConvParam_t& params)
 {
-    int test_id = (int)get<0>(GetParam());
-    ASSERT_GE(test_id, 0); ASSERT_LT(test_id, ConvParamID::CONV_LAST);
-    const ConvParam_t& params = testConvolutionConfigs[test_id];
-    double declared_flops = params.declared_flops;
     Size kernel = params.kernel;
     MatShape inputShape = MatShape(params.shapeIn.dims, params.shapeIn.dims + 4);
     int outChannels = params.outCN;
@@ -593,11 +586,8 @@ PERF_TEST_P_(Conv, conv)
     Size padAdjust = params.padAdjust;
     std::string padMode(params.padMode);
     bool hasBias = params.hasBias;
-    Backend backendId = get<0>(get<1>(GetParam()));
-    Target targetId = get<1>(get<1>(GetParam()));
 
     int inChannels = inputShape[1];
-    Size inSize(inputShape[3], inputShape[2]);
 
     int sz[] = {outChannels, inChannels / groups, kernel.height, kernel.width};
     Mat weights(4, &sz[0], CV_32F);
@@ -631,7 +621,24 @@ PERF_TEST_P_(Conv, conv)
         randu(bias, -1.0f, 1.0f);
         lp.blobs.push_back(bias);
     }
-    int inpSz[] = {1, inChannels, inSize.height, inSize.width};
+    return lp;
+}
+
+typedef tuple<ConvParamID, tuple<Backend, Target> > ConvTestParam_t;
+typedef TestBaseWithParam<ConvTestParam_t> Conv;
+
+PERF_TEST_P_(Conv, conv)
+{
+    int test_id = (int)get<0>(GetParam());
+    ASSERT_GE(test_id, 0); ASSERT_LT(test_id, ConvParamID::CONV_LAST);
+    const ConvParam_t& params = testConvolutionConfigs[test_id];
+    double declared_flops = params.declared_flops;
+    MatShape inputShape = MatShape(params.shapeIn.dims, params.shapeIn.dims + 4);
+    Backend backendId = get<0>(get<1>(GetParam()));
+    Target targetId = get<1>(get<1>(GetParam()));
+
+    LayerParams lp = getConvLayerParams(params);
+    int inpSz[] = {1, inputShape[1], inputShape[2], inputShape[3]};
     Mat input(4, &inpSz[0], CV_32F);
     randu(input, -1.0f, 1.0f);
 
@@ -666,9 +673,117 @@ PERF_TEST_P_(Conv, conv)
     SANITY_CHECK_NOTHING();
 }
 
+typedef TestBaseWithParam<ConvParamID> Conv_int8;
+
+PERF_TEST_P_(Conv_int8, conv)
+{
+    int test_id = (int)GetParam();
+    ASSERT_GE(test_id, 0); ASSERT_LT(test_id, ConvParamID::CONV_LAST);
+    const ConvParam_t& params = testConvolutionConfigs[test_id];
+    MatShape inputShape = MatShape(params.shapeIn.dims, params.shapeIn.dims + 4);
+
+    LayerParams lp = getConvLayerParams(params);
+    int inpSz[] = {1, inputShape[1], inputShape[2], inputShape[3]};
+    Mat input(4, &inpSz[0], CV_32F);
+    randu(input, -1.0f, 1.0f);
+
+    Net net;
+    net.addLayerToPrev(lp.name, lp.type, lp);
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    net.setPreferableTarget(DNN_TARGET_CPU);
+
+    net.setInput(input);
+    Mat ref = net.forward().clone();
+
+    net.quantize(std::vector<Mat>(1, input));
+    Mat output = net.forward();
+
+    std::cout << "INT8 relative L2 error: "
+              << cvtest::norm(ref, output, NORM_L2) / std::max(cvtest::norm(ref, NORM_L2), 1e-12) << std::endl;
+
+    TEST_CYCLE()
+    {
+        Mat res = net.forward();
+    }
+
+    SANITY_CHECK_NOTHING();
+}
+
 INSTANTIATE_TEST_CASE_P(/**/, Conv, Combine(
     ConvParamID::all(),
     dnnBackendsAndTargets(false, false)  // defined in ../test/test_common.hpp
 ));
 
+INSTANTIATE_TEST_CASE_P(/**/, Conv_int8, ConvParamID::all());
+
+// 3x3 stride 1 layers of ResNet/VGG-like backbones (Winograd path): channels, height, width
+typedef TestBaseWithParam<Vec3i> Conv_3x3s1;
+
+PERF_TEST_P_(Conv_3x3s1, conv)
+{
+    Vec3i p = GetParam();
+    ConvParam_t params = {{3, 3}, {{1, p[0], p[1], p[2]}}, p[0], 1, {1, 1}, {1, 1}, {1, 1}, {0, 0}, "", true, 0.};
+
+    LayerParams lp = getConvLayerParams(params);
+    int inpSz[] = {1, p[0], p[1], p[2]};
+    Mat input(4, &inpSz[0], CV_32F);
+    randu(input, -1.0f, 1.0f);
+
+    Net net;
+    net.addLayerToPrev(lp.name, lp.type, lp);
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    net.setPreferableTarget(DNN_TARGET_CPU);
+    net.setInput(input);
+
+    // warmup
+    net.forward();
+
+    TEST_CYCLE()
+    {
+        Mat res = net.forward();
+    }
+
+    SANITY_CHECK_NOTHING();
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Conv_3x3s1, Values(
+    Vec3i(64, 56, 56), Vec3i(128, 28, 28), Vec3i(256, 14, 14), Vec3i(512, 7, 7),
+    Vec3i(64, 224, 224), Vec3i(256, 56, 56)
+));
+
+// 3x3 depthwise layers of MobileNet-like networks: channels, height, width, stride
+typedef TestBaseWithParam<Vec4i> Conv_depthwise;
+
+PERF_TEST_P_(Conv_depthwise, conv)
+{
+    Vec4i p = GetParam();
+    ConvParam_t params = {{3, 3}, {{1, p[0], p[1], p[2]}}, p[0], p[0], {p[3], p[3]}, {1, 1}, {1, 1}, {0, 0}, "", true, 0.};
+
+    LayerParams lp = getConvLayerParams(params);
+    int inpSz[] = {1, p[0], p[1], p[2]};
+    Mat input(4, &inpSz[0], CV_32F);
+    randu(input, -1.0f, 1.0f);
+
+    Net net;
+    net.addLayerToPrev(lp.name, lp.type, lp);
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    net.setPreferableTarget(DNN_TARGET_CPU);
+    net.setInput(input);
+
+    // warmup
+    net.forward();
+
+    TEST_CYCLE()
+    {
+        Mat res = net.forward();
+    }
+
+    SANITY_CHECK_NOTHING();
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Conv_depthwise, Values(
+    Vec4i(32, 112, 112, 1), Vec4i(64, 112, 112, 2), Vec4i(128, 56, 56, 1), Vec4i(256, 28, 28, 2),
+    Vec4i(512, 14, 14, 1), Vec4i(1024, 7, 7, 1)
+));
+
 } // namespace
@@ -237,4 +237,20 @@ PERF_TEST_P_(DNNTestNetwork, Inception_v2_Faster_RCNN)
 
 INSTANTIATE_TEST_CASE_P(/*nothing*/, DNNTestNetwork, dnnBackendsAndTargets());
 
+PERF_TEST(blobFromImages, Batch)
+{
+    std::vector<Mat> images(8);
+    for (size_t i = 0; i < images.size(); i++)
+    {
+        images[i].create(480, 640, CV_8UC3);
+        randu(images[i], 0, 256);
+    }
+    Mat blob;
+    TEST_CYCLE()
+    {
+        blobFromImages(images, blob, 1.0 / 255, Size(300, 300), Scalar(104, 117, 123), true, true);
+    }
+    SANITY_CHECK_NOTHING();
+}
+
 } // namespace
@@ -52,16 +52,27 @@
 #include <numeric>
 #include <opencv2/dnn/shape_utils.hpp>
 #include <opencv2/imgproc.hpp>
+#include <opencv2/core/hal/intrin.hpp>
 
 #include <opencv2/core/utils/configuration.private.hpp>
 #include <opencv2/core/utils/logger.hpp>
 
+#ifdef CV_CXX11
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <thread>
+#endif
+
 namespace cv {
 namespace dnn {
 CV__DNN_EXPERIMENTAL_NS_BEGIN
 
 // this option is useful to run valgrind memory errors detection
 static bool DNN_DISABLE_MEMORY_OPTIMIZATIONS = utils::getConfigurationParameterBool("OPENCV_DNN_DISABLE_MEMORY_OPTIMIZATIONS", false);
+// fall back to the greedy blobs reuse of BlobManager on CPU
+static bool DNN_DISABLE_MEMORY_PLANNER = utils::getConfigurationParameterBool("OPENCV_DNN_DISABLE_MEMORY_PLANNER", false);
 
 #ifdef HAVE_OPENCL
 static bool DNN_OPENCL_ALLOW_ALL_DEVICES = utils::getConfigurationParameterBool("OPENCV_DNN_OPENCL_ALLOW_ALL_DEVICES", false);
@@ -240,90 +251,339 @@ void blobFromImages(InputArrayOfArrays images_, OutputArray blob_, double scalef
                     Size size, const Scalar& mean_, bool swapRB, bool crop, int ddepth)
 {
     CV_TRACE_FUNCTION();
-    CV_CheckType(ddepth, ddepth == CV_32F || ddepth == CV_8U, "Blob depth should be CV_32F or CV_8U");
     if (ddepth == CV_8U)
-    {
         CV_CheckEQ(scalefactor, 1.0, "Scaling is not supported for CV_8U blob depth");
-        CV_Assert(mean_ == Scalar() && "Mean subtraction is not supported for CV_8U blob depth");
-    }
+    Image2BlobParams param(Scalar::all(scalefactor), size, mean_, swapRB, ddepth, DNN_LAYOUT_NCHW,
+                           crop ? DNN_PMODE_CROP_CENTER : DNN_PMODE_NULL);
+    blobFromImagesWithParams(images_, blob_, param);
+}
 
-    std::vector<Mat> images;
-    images_.getMatVector(images);
-    CV_Assert(!images.empty());
-    for (size_t i = 0; i < images.size(); i++)
+Image2BlobParams::Image2BlobParams()
+    : scalefactor(Scalar::all(1.0)), size(Size()), mean(Scalar()), swapRB(false), ddepth(CV_32F),
+      datalayout(DNN_LAYOUT_NCHW), paddingmode(DNN_PMODE_NULL), borderValue(Scalar())
+{}
+
+Image2BlobParams::Image2BlobParams(const Scalar& scalefactor_, const Size& size_, const Scalar& mean_,
+                                   bool swapRB_, int ddepth_, int datalayout_, int paddingmode_,
+                                   const Scalar& borderValue_)
+    : scalefactor(scalefactor_), size(size_), mean(mean_), swapRB(swapRB_), ddepth(ddepth_),
+      datalayout(datalayout_), paddingmode(paddingmode_), borderValue(borderValue_)
+{}
+
+Mat blobFromImageWithParams(InputArray image, const Image2BlobParams& param)
+{
+    CV_TRACE_FUNCTION();
+    Mat blob;
+    blobFromImageWithParams(image, blob, param);
+    return blob;
+}
+
+void blobFromImageWithParams(InputArray image, OutputArray blob, const Image2BlobParams& param)
+{
+    CV_TRACE_FUNCTION();
+    std::vector<Mat> images(1, image.getMat());
+    blobFromImagesWithParams(images, blob, param);
+}
+
+Mat blobFromImagesWithParams(InputArrayOfArrays images, const Image2BlobParams& param)
+{
+    CV_TRACE_FUNCTION();
+    Mat blob;
+    blobFromImagesWithParams(images, blob, param);
+    return blob;
+}
+
+namespace
+{
+
+// Resizes the images and finds the regions of the blob covered by them.
+// Cropping is done by taking ROI of the resized image, padding is left for BlobFromImagesInvoker.
+class ResizeImagesInvoker : public ParallelLoopBody
+{
+public:
+    ResizeImagesInvoker(const std::vector<Mat>& images_, const Size& size_, int paddingmode_,
+                        std::vector<Mat>& resized_, std::vector<Rect>& rects_)
+        : images(images_), size(size_), paddingmode(paddingmode_), resized(resized_), rects(rects_)
+    {}
+
+    void operator()(const Range& r) const CV_OVERRIDE
     {
-        Size imgSize = images[i].size();
-        if (size == Size())
-            size = imgSize;
-        if (size != imgSize)
+        for (int i = r.start; i < r.end; i++)
         {
-            if(crop)
+            const Mat& image = images[i];
+            Size imgSize = image.size();
+            rects[i] = Rect(Point(), size);
+            if (imgSize == size)
+            {
+                resized[i] = image;
+            }
+            else if (paddingmode == DNN_PMODE_CROP_CENTER)
+            {
+                float resizeFactor = std::max(size.width / (float)imgSize.width,
+                                              size.height / (float)imgSize.height);
+                Mat img;
+                resize(image, img, Size(), resizeFactor, resizeFactor, INTER_LINEAR);
+                Rect crop(Point(0.5 * (img.cols - size.width),
+                                0.5 * (img.rows - size.height)),
+                          size);
+                resized[i] = img(crop);
+            }
+            else if (paddingmode == DNN_PMODE_LETTERBOX)
             {
-              float resizeFactor = std::max(size.width / (float)imgSize.width,
-                                            size.height / (float)imgSize.height);
-              resize(images[i], images[i], Size(), resizeFactor, resizeFactor, INTER_LINEAR);
-              Rect crop(Point(0.5 * (images[i].cols - size.width),
-                              0.5 * (images[i].rows - size.height)),
-                        size);
-              images[i] = images[i](crop);
+                float resizeFactor = std::min(size.width / (float)imgSize.width,
+                                              size.height / (float)imgSize.height);
+                int rw = std::min(std::max((int)(imgSize.width * resizeFactor), 1), size.width);
+                int rh = std::min(std::max((int)(imgSize.height * resizeFactor), 1), size.height);
+                resize(image, resized[i], Size(rw, rh), 0, 0, INTER_LINEAR);
+                rects[i] = Rect((size.width - rw) / 2, (size.height - rh) / 2, rw, rh);
             }
             else
-              resize(images[i], images[i], size, 0, 0, INTER_LINEAR);
+            {
+                resize(image, resized[i], size, 0, 0, INTER_LINEAR);
+            }
         }
-        if(images[i].depth() == CV_8U && ddepth == CV_32F)
-            images[i].convertTo(images[i], CV_32F);
-        Scalar mean = mean_;
-        if (swapRB)
+    }
+
+private:
+    const std::vector<Mat>& images;
+    Size size;
+    int paddingmode;
+    std::vector<Mat>& resized;
+    std::vector<Rect>& rects;
+};
+
+#if CV_SIMD128
+template<typename ST, typename DT>
+static inline int normalizeRowSIMD(const ST*, int, const float*, const float*, DT* const*)
+{
+    return 0;
+}
+
+static inline void storeNormalized(float* dst, const v_uint8x16& v, const v_float32x4& m, const v_float32x4& s)
+{
+    v_uint16x8 w0, w1;
+    v_expand(v, w0, w1);
+    v_uint32x4 q0, q1, q2, q3;
+    v_expand(w0, q0, q1);
+    v_expand(w1, q2, q3);
+    v_store(dst, (v_cvt_f32(v_reinterpret_as_s32(q0)) - m) * s);
+    v_store(dst + 4, (v_cvt_f32(v_reinterpret_as_s32(q1)) - m) * s);
+    v_store(dst + 8, (v_cvt_f32(v_reinterpret_as_s32(q2)) - m) * s);
+    v_store(dst + 12, (v_cvt_f32(v_reinterpret_as_s32(q3)) - m) * s);
+}
+
+static inline int normalizeRowSIMD(const uchar* src, int width, const float* mean, const float* scale,
+                                     float* const* dst)
+{
+    v_float32x4 m0 = v_setall_f32(mean[0]), m1 = v_setall_f32(mean[1]), m2 = v_setall_f32(mean[2]);
+    v_float32x4 s0 = v_setall_f32(scale[0]), s1 = v_setall_f32(scale[1]), s2 = v_setall_f32(scale[2]);
+    int x = 0;
+    for (; x <= width - 16; x += 16)
+    {
+        v_uint8x16 a, b, c;
+        v_load_deinterleave(src + x * 3, a, b, c);
+        storeNormalized(dst[0] + x, a, m0, s0);
+        storeNormalized(dst[1] + x, b, m1, s1);
+        storeNormalized(dst[2] + x, c, m2, s2);
+    }
+    return x;
+}
+
+static inline int normalizeRowSIMD(const float* src, int width, const float* mean, const float* scale,
+                                     float* const* dst)
+{
+    v_float32x4 m0 = v_setall_f32(mean[0]), m1 = v_setall_f32(mean[1]), m2 = v_setall_f32(mean[2]);
+    v_float32x4 s0 = v_setall_f32(scale[0]), s1 = v_setall_f32(scale[1]), s2 = v_setall_f32(scale[2]);
+    int x = 0;
+    for (; x <= width - 4; x += 4)
+    {
+        v_float32x4 a, b, c;
+        v_load_deinterleave(src + x * 3, a, b, c);
+        v_store(dst[0] + x, (a - m0) * s0);
+        v_store(dst[1] + x, (b - m1) * s1);
+        v_store(dst[2] + x, (c - m2) * s2);
+    }
+    return x;
+}
+#endif
+
+// Writes dst[k][x*step] = (src[x*cn + k] - mean[k]) * scale[k] for every channel k.
+template<typename ST, typename DT>
+static void normalizeRow(const ST* src, int width, int cn, const float* mean, const float* scale,
+                         DT* const* dst, int step)
+{
+    int x = 0;
+#if CV_SIMD128
+    if (cn == 3 && step == 1)
+        x = normalizeRowSIMD(src, width, mean, scale, dst);
+#endif
+    for (int k = 0; k < cn; k++)
+    {
+        DT* d = dst[k];
+        float m = mean[k], s = scale[k];
+        for (int j = x; j < width; j++)
+            d[j * step] = saturate_cast<DT>((static_cast<float>(src[j * cn + k]) - m) * s);
+    }
+}
+
+// Fills the rows of the blob: copies the pixels of the resized images with channels swapping,
+// type conversion, normalization and layout transformation, and sets the padding.
+class BlobFromImagesInvoker : public ParallelLoopBody
+{
+public:
+    BlobFromImagesInvoker(const std::vector<Mat>& images_, const std::vector<Rect>& rects_,
+                          const Image2BlobParams& param, Mat& blob_)
+        : images(images_), rects(rects_), blob(blob_), nhwc(param.datalayout == DNN_LAYOUT_NHWC)
+    {
+        nch = images[0].channels();
+        height = nhwc ? blob.size[1] : blob.size[2];
+        width = nhwc ? blob.size[2] : blob.size[3];
+
+        Scalar mean = param.mean, scale = param.scalefactor, border = param.borderValue;
+        if (param.swapRB)
+        {
             std::swap(mean[0], mean[2]);
+            std::swap(scale[0], scale[2]);
+            std::swap(border[0], border[2]);
+        }
+        for (int k = 0; k < 4; k++)
+        {
+            // Output channel of input channel k.
+            channels[k] = param.swapRB && nch >= 3 && (k == 0 || k == 2) ? 2 - k : k;
+            if (param.ddepth == CV_8U)
+            {
+                means[k] = 0.f;
+                scales[k] = 1.f;
+                paddings[k] = saturate_cast<uchar>(border[k]);
+            }
+            else
+            {
+                means[k] = (float)mean[k];
+                scales[k] = (float)scale[k];
+                paddings[k] = (saturate_cast<float>(border[k]) - means[k]) * scales[k];
+            }
+        }
+    }
 
-        images[i] -= mean;
-        images[i] *= scalefactor;
+    void operator()(const Range& r) const CV_OVERRIDE
+    {
+        if (blob.depth() == CV_8U)
+            processRows<uchar>(r);
+        else
+            processRows<float>(r);
     }
 
-    size_t nimages = images.size();
-    Mat image0 = images[0];
-    int nch = image0.channels();
-    CV_Assert(image0.dims == 2);
-    if (nch == 3 || nch == 4)
+private:
+    template<typename DT>
+    void processRows(const Range& r) const
     {
-        int sz[] = { (int)nimages, nch, image0.rows, image0.cols };
-        blob_.create(4, sz, ddepth);
-        Mat blob = blob_.getMat();
-        Mat ch[4];
+        DT* dst[4];
+        DT paddingValues[4];
+        int step = nhwc ? nch : 1;
+        for (int k = 0; k < nch; k++)
+            paddingValues[k] = saturate_cast<DT>(paddings[k]);
 
-        for(size_t i = 0; i < nimages; i++ )
+        for (int row = r.start; row < r.end; row++)
         {
+            int i = row / height, y = row % height;
             const Mat& image = images[i];
-            CV_Assert(image.depth() == blob_.depth());
-            nch = image.channels();
-            CV_Assert(image.dims == 2 && (nch == 3 || nch == 4));
-            CV_Assert(image.size() == image0.size());
+            const Rect& rect = rects[i];
+            for (int k = 0; k < nch; k++)
+            {
+                int c = channels[k];
+                dst[k] = nhwc ? blob.ptr<DT>(i, y) + c : blob.ptr<DT>(i, c) + (size_t)y * width;
+            }
+
+            bool inside = rect.y <= y && y < rect.y + rect.height;
+            int x0 = inside ? rect.x : width, x1 = inside ? rect.x + rect.width : width;
+            for (int k = 0; k < nch; k++)
+            {
+                for (int x = 0; x < x0; x++)
+                    dst[k][x * step] = paddingValues[k];
+                for (int x = x1; x < width; x++)
+                    dst[k][x * step] = paddingValues[k];
+            }
+            if (!inside)
+                continue;
 
-            for( int j = 0; j < nch; j++ )
-                ch[j] = Mat(image.rows, image.cols, ddepth, blob.ptr((int)i, j));
-            if(swapRB)
-                std::swap(ch[0], ch[2]);
-            split(image, ch);
+            DT* rowDst[4];
+            for (int k = 0; k < nch; k++)
+                rowDst[k] = dst[k] + (size_t)x0 * step;
+            if (image.depth() == CV_8U)
+                normalizeRow(image.ptr<uchar>(y - rect.y), rect.width, nch, means, scales, rowDst, step);
+            else
+                normalizeRow(image.ptr<float>(y - rect.y), rect.width, nch, means, scales, rowDst, step);
         }
     }
-    else
+
+    const std::vector<Mat>& images;
+    const std::vector<Rect>& rects;
+    Mat& blob;
+    bool nhwc;
+    int nch, height, width;
+    int channels[4];
+    float means[4], scales[4], paddings[4];
+};
+
+}  // namespace
+
+void blobFromImagesWithParams(InputArrayOfArrays images_, OutputArray blob_, const Image2BlobParams& param)
+{
+    CV_TRACE_FUNCTION();
+    int ddepth = param.ddepth;
+    CV_CheckType(ddepth, ddepth == CV_32F || ddepth == CV_8U, "Blob depth should be CV_32F or CV_8U");
+    if (ddepth == CV_8U)
     {
-       CV_Assert(nch == 1);
-       int sz[] = { (int)nimages, 1, image0.rows, image0.cols };
-       blob_.create(4, sz, ddepth);
-       Mat blob = blob_.getMat();
+        CV_Assert(param.scalefactor == Scalar::all(1.0) && "Scaling is not supported for CV_8U blob depth");
+        CV_Assert(param.mean == Scalar() && "Mean subtraction is not supported for CV_8U blob depth");
+    }
+    CV_Check(param.datalayout, param.datalayout == DNN_LAYOUT_NCHW || param.datalayout == DNN_LAYOUT_NHWC,
+             "Unsupported blob layout");
+    CV_Check(param.paddingmode, param.paddingmode == DNN_PMODE_NULL || param.paddingmode == DNN_PMODE_CROP_CENTER ||
+                                param.paddingmode == DNN_PMODE_LETTERBOX, "Unsupported padding mode");
 
-       for(size_t i = 0; i < nimages; i++ )
-       {
-           const Mat& image = images[i];
-           CV_Assert(image.depth() == blob_.depth());
-           nch = image.channels();
-           CV_Assert(image.dims == 2 && (nch == 1));
-           CV_Assert(image.size() == image0.size());
+    std::vector<Mat> images;
+    images_.getMatVector(images);
+    CV_Assert(!images.empty());
+    int nimages = (int)images.size();
+    int nch = images[0].channels();
+    CV_Check(nch, nch == 1 || nch == 3 || nch == 4, "Images should have 1, 3 or 4 channels");
+    for (int i = 0; i < nimages; i++)
+    {
+        const Mat& image = images[i];
+        CV_Assert(image.dims == 2);
+        CV_CheckEQ(image.channels(), nch, "All images should have the same number of channels");
+        CV_CheckDepth(image.depth(), image.depth() == ddepth || (image.depth() == CV_8U && ddepth == CV_32F),
+                      "Unsupported depth of image");
+    }
+    Size size = param.size;
+    if (size == Size())
+        size = images[0].size();
+    CV_Assert(size.width > 0 && size.height > 0);
+
+    std::vector<Mat> resized(nimages);
+    std::vector<Rect> rects(nimages);
+    ResizeImagesInvoker resizeImages(images, size, param.paddingmode, resized, rects);
+    // cv::resize is parallel itself, so a single image is resized outside of the parallel region.
+    if (nimages == 1)
+        resizeImages(Range(0, 1));
+    else
+        parallel_for_(Range(0, nimages), resizeImages);
 
-           image.copyTo(Mat(image.rows, image.cols, ddepth, blob.ptr((int)i, 0)));
-       }
+    int sz[] = { nimages, nch, size.height, size.width };
+    if (param.datalayout == DNN_LAYOUT_NHWC)
+    {
+        sz[1] = size.height;
+        sz[2] = size.width;
+        sz[3] = nch;
     }
+    blob_.create(4, sz, ddepth);
+    Mat blob = blob_.getMat();
+    CV_Assert(blob.isContinuous());
+
+    BlobFromImagesInvoker body(resized, rects, param, blob);
+    double nstripes = (double)nimages * size.height * size.width * nch / (1 << 16);
+    parallel_for_(Range(0, nimages * size.height), body, nstripes);
 }
 
 void imagesFromBlob(const cv::Mat& blob_, OutputArrayOfArrays images_)
@@ -567,6 +827,8 @@ struct DataLayer : public Layer
             Scalar& mean = means[i];
             CV_Assert(mean == Scalar() || inputsData[i].size[1] <= 4);
             CV_CheckTypeEQ(outputs[i].type(), CV_32FC1, "");
+            if (inputsData[i].data == outputs[i].data && scale == 1.0 && mean == Scalar())
+                continue;
 
             bool singleMean = true;
             for (int j = 1; j < std::min(4, inputsData[i].size[1]) && singleMean; ++j)
@@ -746,12 +1008,16 @@ struct DataLayer : public Layer
     std::vector<double> scaleFactors;
     std::vector<Scalar> means;
     std::vector<Mat> inputsData;
+    // Inputs which are the user's blobs set by Net::bindInput() rather than copies.
+    std::vector<bool> boundInputs;
     bool skip;
 };
 
 struct BlobManager
 {
 public:
+    BlobManager() : reuseMemory(true) {}
+
     // Increase references counter to layer output.
     void addReference(const LayerPin& lp)
     {
@@ -825,7 +1091,7 @@ public:
 
     void reuseOrCreate(const MatShape& shape, const LayerPin& lp, Mat& dst, bool use_half)
     {
-        if (!DNN_DISABLE_MEMORY_OPTIMIZATIONS)
+        if (reuseMemory && !DNN_DISABLE_MEMORY_OPTIMIZATIONS)
         {
             Mat bestBlob;
             LayerPin bestBlobPin;
@@ -888,17 +1154,16 @@ public:
 
         CV_Assert(ld.requiredOutputs.size() <= outShapes.size());
 
-        // Check that layer could work in-place.
+        // Check that layer could work in-place. A layer with several inputs
+        // writes its first output over the first input.
         bool inPlace = false;
-        if (layerShapes.supportInPlace)
+        if (layerShapes.supportInPlace && !ld.inputBlobs.empty() && !outShapes.empty())
         {
-            if (ld.inputBlobs.size() == 1)
-            {
-                // Get number of references to the input memory.
-                int numRef = numReferences(ld.inputBlobsId[0]);
-                // If current layer is one and only customer of this blob.
-                inPlace = numRef == 1;
-            }
+            // Get number of references to the input memory.
+            int numRef = numReferences(ld.inputBlobsId[0]);
+            // If current layer is one and only customer of this blob.
+            inPlace = numRef == 1 &&
+                      (ld.inputBlobs.size() == 1 || ld.inputBlobs[0]->total() == total(outShapes[0]));
         }
 
         ShapesVec shapes(outShapes);
@@ -935,7 +1200,7 @@ public:
                 if (total(shapes[index]))
                 {
                     LayerPin blobPin(ld.id, index);
-                    if (index < outShapes.size() && inPlace)
+                    if (index < outShapes.size() && inPlace && (ld.inputBlobs.size() == 1 || index == 0))
                     {
                         CV_Assert(ld.inputBlobs[0]->total() == total(shapes[index]));
                         ld.outputBlobs[index] = ld.inputBlobs[0]->reshape(1, shapes[index]);
@@ -949,13 +1214,16 @@ public:
     }
 
     // Clear internal state. Calls before an every reallocation.
-    void reset()
+    // If reuseMemory_ is false, every blob gets its own memory (except the
+    // outputs of in-place layers) and the reuse is left to the memory planner.
+    void reset(bool reuseMemory_ = true)
     {
         CV_TRACE_FUNCTION();
 
         refCounter.clear();
         reuseMap.clear();
         memHosts.clear();
+        reuseMemory = reuseMemory_;
     }
 
 private:
@@ -972,6 +1240,7 @@ private:
     // For origin blobs key == value.
     std::map<LayerPin, LayerPin> reuseMap;
     std::map<LayerPin, Mat> memHosts;
+    bool reuseMemory;
 };
 
 static Ptr<BackendWrapper> wrapMat(int backendId, int targetId, cv::Mat& m)
@@ -1023,11 +1292,29 @@ struct Net::Impl
         lastLayerId = 0;
         netWasAllocated = false;
         fusion = true;
+        concurrentBranches = false;
+        forwardTicks = 0;
+        calibrating = false;
         isAsync = false;
+        layersShared = false;
+        plannedBlobsMemory = naiveBlobsMemory = 0;
+        planCacheSize = 1;
         preferableBackend = DNN_BACKEND_DEFAULT;
         preferableTarget = DNN_TARGET_CPU;
         skipInfEngineInit = false;
+#ifdef CV_CXX11
+        asyncIdleWorkers = 0;
+        maxAsyncWorkers = 2;
+        asyncStop = false;
+#endif
+    }
+
+#ifdef CV_CXX11
+    ~Impl()
+    {
+        stopAsyncWorkers();
     }
+#endif
 
     Ptr<DataLayer> netInputLayer;
     std::vector<LayerPin> blobsToKeep;
@@ -1045,9 +1332,72 @@ struct Net::Impl
 
     bool netWasAllocated;
     bool fusion;
+    // compute the independent layers at the same time (see Net::enableConcurrentBranches())
+    bool concurrentBranches;
+    // The layers computed by forwardConcurrently() in the order of their allocation,
+    // the layers which can't be started before each of them is finished
+    // (indices in scheduleLayers) and the estimated amount of work of each one.
+    std::vector<int> scheduleLayers;
+    std::vector<std::vector<int> > scheduleSuccessors;
+    std::vector<double> scheduleCosts;
+    // wall time of the last forward() if some layers were computed concurrently
+    int64 forwardTicks;
     bool isAsync;
+    // the layers are used by other networks too (see Net::cloneSharingWeights())
+    bool layersShared;
+    // Net::quantize collects the largest absolute values of the layer inputs
+    bool calibrating;
+    std::map<int, float> inputRanges;
     std::vector<int64> layersTimings;
     Mat output_blob;
+    // memory of the layers outputs and internal blobs: allocated and
+    // the one they would take if every blob had its own memory
+    size_t plannedBlobsMemory, naiveBlobsMemory;
+
+    // The network set up for other input shapes or outputs (see Net::setPlanCacheSize()).
+    struct ExecutionPlan
+    {
+        ShapesVec inputShapes;
+        std::vector<LayerPin> blobsToKeep;
+        MapIdToLayerData layers;
+        std::vector<int> scheduleLayers;
+        std::vector<std::vector<int> > scheduleSuccessors;
+        std::vector<double> scheduleCosts;
+        size_t plannedBlobsMemory, naiveBlobsMemory;
+    };
+    // the most recently used first
+    std::list<ExecutionPlan> plans;
+    int planCacheSize;
+    // input blobs of the current set up if it can be kept
+    std::vector<Mat> planInputs;
+    // input scales of the layers quantized by Net::quantize()
+    std::map<int, float> quantizationScales;
+
+    // Held while the network is set up or computed: by the public methods which do that
+    // and by the worker of asynchronous requests.
+    Mutex forwardMutex;
+#ifdef CV_CXX11
+    // Request of forwardAsync() for DNN_BACKEND_OPENCV. It keeps a copy of the inputs
+    // which were set at the time of the call.
+    struct AsyncRequest
+    {
+        std::vector<Mat> inputs;
+        std::vector<double> scaleFactors;
+        std::vector<Scalar> means;
+        LayerPin pin;
+        AsyncPromise promise;
+    };
+    std::deque<AsyncRequest> asyncRequests;
+    std::mutex asyncMutex;
+    std::condition_variable asyncCond;
+    // Every worker computes the requests by its own network which shares the layers
+    // of the current set up, so the requests and forward() are computed at the same time.
+    // The workers are stopped before the network is set up again.
+    std::vector<std::thread> asyncWorkers;
+    int asyncIdleWorkers;
+    int maxAsyncWorkers;
+    bool asyncStop;
+#endif
 
     Ptr<BackendWrapper> wrap(Mat& host)
     {
@@ -1183,6 +1533,13 @@ struct Net::Impl
                   preferableTarget == DNN_TARGET_FPGA);
         if (!netWasAllocated || this->blobsToKeep != blobsToKeep_)
         {
+#ifdef CV_CXX11
+            stopAsyncWorkers();
+#endif
+            if (layersShared)
+                CV_Error(Error::StsNotImplemented, "The network shares its layers with other networks, "
+                         "so it can't be set up for other input shapes, outputs, backend or target");
+
             if (preferableBackend == DNN_BACKEND_OPENCV && IS_DNN_OPENCL_TARGET(preferableTarget))
 #ifndef HAVE_OPENCL
             {
@@ -1210,6 +1567,9 @@ struct Net::Impl
                 }
             }
 #endif
+            if (restorePlan(blobsToKeep_))
+                return;
+
             clear();
 
             allocateLayers(blobsToKeep_);
@@ -1232,7 +1592,172 @@ struct Net::Impl
 
             netWasAllocated = true;
             this->blobsToKeep = blobsToKeep_;
+            if (planCacheEnabled())
+                planInputs = layers[0].outputBlobs;
+        }
+    }
+
+    bool planCacheEnabled() const
+    {
+        return planCacheSize > 1 && preferableBackend == DNN_BACKEND_OPENCV &&
+               preferableTarget == DNN_TARGET_CPU;
+    }
+
+    void dropPlans()
+    {
+        plans.clear();
+        planInputs.clear();
+    }
+
+    // Points the inputs of the layers to the outputs of the layers of the same map.
+    static void bindInputBlobs(MapIdToLayerData& layers_)
+    {
+        for (MapIdToLayerData::iterator it = layers_.begin(); it != layers_.end(); ++it)
+        {
+            LayerData& ld = it->second;
+            for (size_t i = 0; i < ld.inputBlobs.size(); i++)
+            {
+                const LayerPin& from = ld.inputBlobsId[i];
+                ld.inputBlobs[i] = &layers_[from.lid].outputBlobs[from.oid];
+            }
+        }
+    }
+
+    // Creates a layer with the same parameters which doesn't share the data
+    // prepared for the computations (packed weights, fused layers) with the layer of `ld`.
+    Ptr<Layer> copyLayerInstance(const LayerData& ld)
+    {
+        LayerParams params = ld.params;
+        Ptr<Layer> layer = LayerFactory::createLayerInstance(ld.type, params);
+        if (!layer)
+            CV_Error(Error::StsError, "Can't create layer \"" + ld.name + "\" of type \"" + ld.type + "\"");
+        layer->blobs = ld.layerInstance->blobs;
+        std::map<int, float>::const_iterator it = quantizationScales.find(ld.id);
+        if (it != quantizationScales.end())
+            layer->tryQuantize(it->second);
+        return layer;
+    }
+
+    // Keeps the current set up of the network and restores the one for the current input
+    // shapes and `blobsToKeep_` if it was kept. Returns false if the network should be set up.
+    bool restorePlan(const std::vector<LayerPin>& blobsToKeep_)
+    {
+        if (!planCacheEnabled())
+        {
+            dropPlans();
+            return false;
+        }
+
+        ShapesVec inputShapes;
+        for (size_t i = 0; i < layers[0].outputBlobs.size(); i++)
+            inputShapes.push_back(shape(layers[0].outputBlobs[i]));
+
+        ShapesVec planShapes;
+        for (size_t i = 0; i < planInputs.size(); i++)
+            planShapes.push_back(shape(planInputs[i]));
+        if (!planInputs.empty() && planShapes == inputShapes && blobsToKeep == blobsToKeep_)
+        {
+            // the input shapes were changed and restored
+            layers[0].outputBlobs = planInputs;
+            bindInputBlobs(layers);
+            finishRestoring();
+            return true;
+        }
+
+        std::list<ExecutionPlan>::iterator plan = plans.begin();
+        while (plan != plans.end() && (plan->inputShapes != inputShapes || plan->blobsToKeep != blobsToKeep_))
+            ++plan;
+
+        std::vector<Mat> inputs = layers[0].outputBlobs;
+        bool keepCurrent = !planInputs.empty();
+        if (keepCurrent)
+        {
+            plans.push_front(ExecutionPlan());
+            ExecutionPlan& current = plans.front();
+            current.inputShapes = planShapes;
+            current.blobsToKeep = blobsToKeep;
+            current.layers.swap(layers);
+            current.layers[0].outputBlobs = planInputs;
+            current.layers[0].outputBlobsWrappers.resize(planInputs.size());
+            bindInputBlobs(current.layers);
+            current.scheduleLayers.swap(scheduleLayers);
+            current.scheduleSuccessors.swap(scheduleSuccessors);
+            current.scheduleCosts.swap(scheduleCosts);
+            current.plannedBlobsMemory = plannedBlobsMemory;
+            current.naiveBlobsMemory = naiveBlobsMemory;
+            planInputs.clear();
+        }
+
+        bool restored = plan != plans.end();
+        if (restored)
+        {
+            layers.swap(plan->layers);
+            blobsToKeep = plan->blobsToKeep;
+            scheduleLayers.swap(plan->scheduleLayers);
+            scheduleSuccessors.swap(plan->scheduleSuccessors);
+            scheduleCosts.swap(plan->scheduleCosts);
+            plannedBlobsMemory = plan->plannedBlobsMemory;
+            naiveBlobsMemory = plan->naiveBlobsMemory;
+            plans.erase(plan);
+            finishRestoring();
+        }
+        else if (keepCurrent)
+        {
+            // The kept set up uses the layers, the network is set up with their copies.
+            layers = plans.front().layers;
+            for (MapIdToLayerData::iterator it = layers.begin(); it != layers.end(); ++it)
+            {
+                LayerData& ld = it->second;
+                if (ld.id != 0 && !ld.layerInstance.empty())
+                    ld.layerInstance = copyLayerInstance(ld);
+            }
+            layers[0].outputBlobs = inputs;
+            layers[0].outputBlobsWrappers.resize(inputs.size());
+            bindInputBlobs(layers);
         }
+
+        while ((int)plans.size() >= planCacheSize)
+            plans.pop_back();
+        return restored;
+    }
+
+    void finishRestoring()
+    {
+        updateInputLayerSkip();
+        planInputs = layers[0].outputBlobs;
+        netWasAllocated = true;
+    }
+
+    // The input layer is skipped if its outputs are the input blobs as they are.
+    void updateInputLayerSkip()
+    {
+        if (preferableBackend != DNN_BACKEND_OPENCV)
+            return;
+        LayerData& inpLd = layers[0];
+        netInputLayer->finalize(std::vector<Mat>(), inpLd.outputBlobs);
+        inpLd.skip = netInputLayer->skip;
+    }
+
+    // Returns the pin of the network input with the given name. The input layer
+    // gets the outputs and the parameters for all the inputs up to this one.
+    LayerPin getInputPin(const String& name)
+    {
+        LayerPin pin;
+        pin.lid = 0;
+        pin.oid = resolvePinOutputName(getLayerData(pin.lid), name);
+
+        if (!pin.valid())
+            CV_Error(Error::StsObjectNotFound, "Requested blob \"" + name + "\" not found");
+
+        LayerData &ld = layers[pin.lid];
+        const int numInputs = std::max(pin.oid+1, (int)ld.requiredOutputs.size());
+        ld.outputBlobs.resize(numInputs);
+        ld.outputBlobsWrappers.resize(numInputs);
+        netInputLayer->inputsData.resize(numInputs);
+        netInputLayer->boundInputs.resize(numInputs);
+        netInputLayer->scaleFactors.resize(numInputs);
+        netInputLayer->means.resize(numInputs);
+        return pin;
     }
 
     int getLayerId(const String &layerName)
@@ -2184,7 +2709,9 @@ struct Net::Impl
         LayersShapesMap layersShapes;
         getLayersShapes(inputShapes, layersShapes);
 
-        blobManager.reset();
+        bool planMemory = preferableBackend == DNN_BACKEND_OPENCV && preferableTarget == DNN_TARGET_CPU &&
+                          !DNN_DISABLE_MEMORY_OPTIMIZATIONS && !DNN_DISABLE_MEMORY_PLANNER;
+        blobManager.reset(!planMemory);
         backendWrappers.clear();
         // Fake references to input blobs.
         for (int i = 0; i < layers[0].outputBlobs.size(); ++i)
@@ -2200,14 +2727,217 @@ struct Net::Impl
             blobManager.addReference(blobsToKeep_[i]);
         }
 
+        // The layers are allocated in the order they are computed by a single thread
+        // (by ids), the memory planner counts the lifetimes of blobs in these steps.
+        // If the branches are computed concurrently, the layers are ordered by their
+        // depth in the graph instead and the lifetimes are counted in the depth levels,
+        // so the blobs of the layers of the same level never share memory.
+        bool concurrent = concurrentBranches && preferableBackend == DNN_BACKEND_OPENCV &&
+                          preferableTarget == DNN_TARGET_CPU;
+        std::vector<int> steps(lastLayerId + 1, 0);
+        std::vector<std::pair<int, int> > order;
         for (it = layers.begin(); it != layers.end(); it++)
         {
-            int lid = it->first;
+            const LayerData& ld = it->second;
+            int step = ld.id;
+            if (concurrent)
+            {
+                step = 0;
+                for (size_t i = 0; i < ld.inputBlobsId.size(); i++)
+                    step = std::max(step, steps[ld.inputBlobsId[i].lid] + 1);
+            }
+            steps[ld.id] = step;
+            order.push_back(std::make_pair(step, ld.id));
+        }
+        std::sort(order.begin(), order.end());
+
+        for (size_t i = 0; i < order.size(); i++)
+        {
+            int lid = order[i].second;
             allocateLayer(lid, layersShapes);
         }
 
         layersTimings.resize(lastLayerId + 1, 0);
         fuseLayers(blobsToKeep_);
+        if (planMemory)
+            planBlobsMemory(blobsToKeep_, steps);
+
+        scheduleLayers.clear();
+        scheduleSuccessors.clear();
+        scheduleCosts.clear();
+        if (concurrent)
+        {
+            std::vector<int> orderIds;
+            for (size_t i = 0; i < order.size(); i++)
+                orderIds.push_back(order[i].second);
+            buildSchedule(orderIds);
+        }
+
+        // Memory statistics (see Net::getBlobsMemory)
+        size_t esz = layers[0].outputBlobs[0].elemSize();
+        naiveBlobsMemory = 0;
+        for (LayersShapesMap::iterator shapesIt = layersShapes.begin(); shapesIt != layersShapes.end(); ++shapesIt)
+        {
+            if (shapesIt->first == 0)
+                continue;
+            const LayerShapes& ls = shapesIt->second;
+            for (size_t i = 0; i < ls.out.size(); i++)
+                naiveBlobsMemory += total(ls.out[i])*esz;
+            for (size_t i = 0; i < ls.internal.size(); i++)
+                naiveBlobsMemory += total(ls.internal[i])*esz;
+        }
+
+        std::set<const uchar*> inputMemory;
+        for (size_t i = 0; i < layers[0].outputBlobs.size(); i++)
+            inputMemory.insert(layers[0].outputBlobs[i].datastart);
+        std::map<const uchar*, size_t> memory;
+        for (it = layers.begin(); it != layers.end(); ++it)
+        {
+            if (it->first == 0)
+                continue;
+            const LayerData& ld = it->second;
+            for (size_t i = 0; i < ld.outputBlobs.size() + ld.internals.size(); i++)
+            {
+                const Mat& m = i < ld.outputBlobs.size() ? ld.outputBlobs[i] : ld.internals[i - ld.outputBlobs.size()];
+                if (!m.empty() && !inputMemory.count(m.datastart))
+                    memory[m.datastart] = m.datalimit - m.datastart;
+            }
+        }
+        plannedBlobsMemory = 0;
+        for (std::map<const uchar*, size_t>::iterator memIt = memory.begin(); memIt != memory.end(); ++memIt)
+            plannedBlobsMemory += memIt->second;
+    }
+
+    // Places the blobs allocated by BlobManager without reuse into a single block of memory.
+    // Every memory block (a blob with its views: in-place outputs, concatenation parts)
+    // is used from the step of the first to the step of the last layer which reads
+    // or writes it, the kept blobs are used till the end. The blocks are placed in the descending order of sizes,
+    // each one into the smallest gap between the blocks in use at the same time
+    // which fits it (or after them).
+    struct MemoryBlock
+    {
+        MemoryBlock() : size(0), first(INT_MAX), last(-1), offset(0), fixed(false) {}
+        size_t size;
+        int first, last;  // steps of the layers which use the block
+        size_t offset;
+        bool fixed;  // not owned by the planner
+        std::vector<Mat*> blobs;
+
+        // larger blocks first, the ones used earlier first among the same sized
+        static bool placementOrder(const MemoryBlock* a, const MemoryBlock* b)
+        {
+            return a->size != b->size ? a->size > b->size : a->first < b->first;
+        }
+    };
+
+    void planBlobsMemory(const std::vector<LayerPin>& blobsToKeep_, const std::vector<int>& steps)
+    {
+        CV_TRACE_FUNCTION();
+
+        std::map<const uchar*, MemoryBlock> blocks;
+
+        // the network inputs stay where they are
+        for (size_t i = 0; i < layers[0].outputBlobs.size(); i++)
+            blocks[layers[0].outputBlobs[i].datastart].fixed = true;
+        for (size_t i = 0; i < netInputLayer->inputsData.size(); i++)
+            blocks[netInputLayer->inputsData[i].datastart].fixed = true;
+
+        for (MapIdToLayerData::iterator it = layers.begin(); it != layers.end(); ++it)
+        {
+            if (it->first == 0)
+                continue;
+            LayerData& ld = it->second;
+            std::vector<Mat*> blobs;
+            for (size_t i = 0; i < ld.outputBlobs.size(); i++)
+                blobs.push_back(&ld.outputBlobs[i]);
+            for (size_t i = 0; i < ld.internals.size(); i++)
+                blobs.push_back(&ld.internals[i]);
+            size_t numOwned = blobs.size();
+            blobs.insert(blobs.end(), ld.inputBlobs.begin(), ld.inputBlobs.end());
+
+            for (size_t i = 0; i < blobs.size(); i++)
+            {
+                Mat& m = *blobs[i];
+                if (m.empty())
+                    continue;
+                MemoryBlock& block = blocks[m.datastart];
+                if (i < numOwned)
+                {
+                    block.blobs.push_back(&m);
+                    block.size = std::max(block.size, (size_t)(m.datalimit - m.datastart));
+                    block.fixed |= !m.u || m.type() != CV_32F;
+                }
+                // fused layers are not computed but they are counted as well:
+                // their outputs are the ones of the layers they are fused into
+                block.first = std::min(block.first, steps[ld.id]);
+                block.last = std::max(block.last, steps[ld.id]);
+            }
+        }
+        for (size_t i = 0; i < blobsToKeep_.size(); i++)
+        {
+            const LayerPin& pin = blobsToKeep_[i];
+            const LayerData& ld = layers[pin.lid];
+            if ((size_t)pin.oid < ld.outputBlobs.size() && !ld.outputBlobs[pin.oid].empty())
+                blocks[ld.outputBlobs[pin.oid].datastart].last = INT_MAX;
+        }
+
+        const size_t alignment = 64;
+        std::vector<MemoryBlock*> order;
+        for (std::map<const uchar*, MemoryBlock>::iterator it = blocks.begin(); it != blocks.end(); ++it)
+        {
+            if (!it->second.fixed && !it->second.blobs.empty())
+                order.push_back(&it->second);
+        }
+        std::sort(order.begin(), order.end(), MemoryBlock::placementOrder);
+
+        size_t arenaSize = 0;
+        std::vector<MemoryBlock*> placed;
+        for (size_t i = 0; i < order.size(); i++)
+        {
+            MemoryBlock& block = *order[i];
+            size_t size = alignSize(block.size, alignment);
+
+            // blocks in use at the same time, sorted by offsets
+            std::vector<std::pair<size_t, size_t> > busy;
+            for (size_t j = 0; j < placed.size(); j++)
+            {
+                const MemoryBlock& other = *placed[j];
+                if (other.first <= block.last && block.first <= other.last)
+                    busy.push_back(std::make_pair(other.offset, other.offset + alignSize(other.size, alignment)));
+            }
+            std::sort(busy.begin(), busy.end());
+
+            size_t bestOffset = 0, bestGap = 0, busyEnd = 0;
+            bool found = false;
+            for (size_t j = 0; j < busy.size(); j++)
+            {
+                size_t gap = busy[j].first > busyEnd ? busy[j].first - busyEnd : 0;
+                if (gap >= size && (!found || gap < bestGap))
+                {
+                    bestOffset = busyEnd;
+                    bestGap = gap;
+                    found = true;
+                }
+                busyEnd = std::max(busyEnd, busy[j].second);
+            }
+            block.offset = found ? bestOffset : busyEnd;
+            arenaSize = std::max(arenaSize, block.offset + size);
+            placed.push_back(&block);
+        }
+
+        if (order.empty())
+            return;
+
+        const size_t esz = sizeof(float);
+        CV_Assert(arenaSize / esz <= (size_t)INT_MAX);
+        Mat arena(1, (int)(arenaSize / esz), CV_32F);
+        for (size_t i = 0; i < order.size(); i++)
+        {
+            const MemoryBlock& block = *order[i];
+            Mat mem = arena.colRange((int)(block.offset / esz), (int)((block.offset + block.size) / esz));
+            for (size_t j = 0; j < block.blobs.size(); j++)
+                *block.blobs[j] = relocateBlob(*block.blobs[j], mem);
+        }
     }
 
     void forwardLayer(LayerData &ld)
@@ -2317,6 +3047,11 @@ struct Net::Impl
                     {
                         inps[i] = *ld.inputBlobs[i];
                     }
+                    if (calibrating && !inps.empty() && inps[0].depth() == CV_32F)
+                    {
+                        float& range = inputRanges[ld.id];
+                        range = std::max(range, (float)norm(inps[0], NORM_INF));
+                    }
                     layer->forward(inps, ld.outputBlobs, ld.internals);
 
                     if (DNN_CHECK_NAN_INF)
@@ -2412,24 +3147,282 @@ struct Net::Impl
             MapIdToLayerData::iterator it;
             for (it = layers.begin(); it != layers.end(); it++)
                 it->second.flag = 0;
+            forwardTicks = 0;
         }
 
         //already was forwarded
         if (ld.flag)
             return;
 
-        //forward parents
-        MapIdToLayerData::iterator it;
-        for (it = layers.begin(); it != layers.end() && (it->second.id < ld.id); ++it)
+        std::vector<Mat> replacedInputs = useBoundInputs();
+        try
         {
-            LayerData &ld = it->second;
-            if (ld.flag)
-                continue;
-            forwardLayer(ld);
+            if (!scheduleLayers.empty())
+            {
+                // the blobs are allocated in the order of the schedule, the id order
+                // may overwrite the ones which are still read by other layers
+                forwardConcurrently(ld);
+            }
+            else
+            {
+                //forward parents
+                MapIdToLayerData::iterator it;
+                for (it = layers.begin(); it != layers.end() && (it->second.id < ld.id); ++it)
+                {
+                    LayerData &ld = it->second;
+                    if (ld.flag)
+                        continue;
+                    forwardLayer(ld);
+                }
+
+                //forward itself
+                forwardLayer(ld);
+            }
+        }
+        catch (...)
+        {
+            restoreInputLayerOutputs(replacedInputs);
+            throw;
+        }
+        restoreInputLayerOutputs(replacedInputs);
+    }
+
+    // Lets the layers read the blobs bound by Net::bindInput() which need no conversion
+    // for the time of a forward pass: the input layer outputs them instead of its own blobs.
+    // Returns the replaced outputs, the empty ones are not replaced.
+    std::vector<Mat> useBoundInputs()
+    {
+        std::vector<Mat> replaced;
+        if (preferableBackend != DNN_BACKEND_OPENCV || preferableTarget != DNN_TARGET_CPU)
+            return replaced;
+        for (size_t i = 0; i < blobsToKeep.size(); i++)
+        {
+            // the own outputs of the input layer are requested
+            if (blobsToKeep[i].lid == 0)
+                return replaced;
+        }
+
+        LayerData& inpLd = layers[0];
+        const DataLayer& inputLayer = *netInputLayer;
+        for (size_t i = 0; i < inputLayer.boundInputs.size() && i < inpLd.outputBlobs.size(); i++)
+        {
+            const Mat& inp = inputLayer.inputsData[i];
+            Mat& out = inpLd.outputBlobs[i];
+            // an output which is a part of a bigger blob (see the fusion of Concat layers) is kept
+            bool ownBlob = out.data == out.datastart &&
+                           (size_t)(out.datalimit - out.datastart) == out.total() * out.elemSize();
+            if (!inputLayer.boundInputs[i] || inp.type() != CV_32F || !inp.isContinuous() ||
+                !ownBlob || shape(inp) != shape(out) ||
+                inputLayer.scaleFactors[i] != 1.0 || inputLayer.means[i] != Scalar())
+                continue;
+            replaced.resize(inpLd.outputBlobs.size());
+            replaced[i] = out;
+            out = inp;
+        }
+        if (!replaced.empty())
+            updateInputLayerSkip();
+        return replaced;
+    }
+
+    void restoreInputLayerOutputs(const std::vector<Mat>& replaced)
+    {
+        if (replaced.empty())
+            return;
+        LayerData& inpLd = layers[0];
+        for (size_t i = 0; i < replaced.size(); i++)
+        {
+            if (!replaced[i].empty())
+                inpLd.outputBlobs[i] = replaced[i];
+        }
+        updateInputLayerSkip();
+    }
+
+    // Layers which need less operations than this per thread are computed
+    // by a single thread together with the other ready layers.
+    static double minParallelLayerCost() { return 1 << 18; }
+
+    // Finds the order of computations of the layers which is the same as computing
+    // them one by one in the order of allocation: a layer has to wait for the previous ones
+    // which write the memory it reads or writes and which read the memory it writes.
+    void buildSchedule(const std::vector<int>& order)
+    {
+        CV_TRACE_FUNCTION();
+
+        typedef std::pair<const uchar*, const uchar*> MemoryRange;
+        std::vector<std::vector<MemoryRange> > reads, writes;
+        for (size_t i = 0; i < order.size(); i++)
+        {
+            LayerData& ld = layers[order[i]];
+            if (ld.id == 0 || ld.skip)
+                continue;
+
+            std::vector<MemoryRange> r, w;
+            std::vector<MatShape> inputShapes, outputShapes;
+            double cost = 0;
+            for (size_t j = 0; j < ld.inputBlobs.size(); j++)
+            {
+                const Mat& m = *ld.inputBlobs[j];
+                r.push_back(MemoryRange(m.data, m.dataend));
+                inputShapes.push_back(shape(m));
+            }
+            for (size_t j = 0; j < ld.outputBlobs.size() + ld.internals.size(); j++)
+            {
+                const Mat& m = j < ld.outputBlobs.size() ? ld.outputBlobs[j] : ld.internals[j - ld.outputBlobs.size()];
+                w.push_back(MemoryRange(m.data, m.dataend));
+                if (j < ld.outputBlobs.size())
+                {
+                    outputShapes.push_back(shape(m));
+                    cost += m.total();
+                }
+            }
+            cost += (double)ld.getLayerInstance()->getFLOPS(inputShapes, outputShapes);
+
+            scheduleLayers.push_back(ld.id);
+            scheduleCosts.push_back(cost);
+            reads.push_back(r);
+            writes.push_back(w);
+        }
+
+        size_t n = scheduleLayers.size();
+        scheduleSuccessors.resize(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            for (size_t j = 0; j < i; j++)
+            {
+                if (overlap(writes[j], reads[i]) || overlap(writes[j], writes[i]) || overlap(reads[j], writes[i]))
+                    scheduleSuccessors[j].push_back((int)i);
+            }
+        }
+    }
+
+    static bool overlap(const std::vector<std::pair<const uchar*, const uchar*> >& a,
+                        const std::vector<std::pair<const uchar*, const uchar*> >& b)
+    {
+        for (size_t i = 0; i < a.size(); i++)
+            for (size_t j = 0; j < b.size(); j++)
+                if (a[i].first < b[j].second && b[j].first < a[i].second)
+                    return true;
+        return false;
+    }
+
+    class ConcurrentLayersInvoker : public ParallelLoopBody
+    {
+    public:
+        ConcurrentLayersInvoker(Impl& impl_, const std::vector<LayerData*>& layers_)
+            : impl(impl_), layers(layers_), failed(false) {}
+
+        void operator()(const Range& r) const CV_OVERRIDE
+        {
+            for (int i = r.start; i < r.end; i++)
+            {
+                try
+                {
+                    impl.forwardLayer(*layers[i]);
+                }
+                catch (const cv::Exception& e)
+                {
+                    AutoLock lock(mutex);
+                    if (!failed)
+                        error = e;
+                    failed = true;
+                }
+            }
+        }
+
+        Impl& impl;
+        const std::vector<LayerData*>& layers;
+        mutable Mutex mutex;
+        mutable bool failed;
+        mutable cv::Exception error;
+    };
+
+    // Computes the layers up to the given one by the schedule of buildSchedule(). The layers
+    // which are ready at the same time and are too small to use all the threads are computed
+    // concurrently, a thread per layer, the others are computed one by one by all the threads.
+    // The calibration of Net::quantize() computes all of them one by one.
+    void forwardConcurrently(LayerData& target)
+    {
+        CV_TRACE_FUNCTION();
+
+        TickMeter tm;
+        tm.start();
+
+        // the network input and the fused layers
+        MapIdToLayerData::iterator it;
+        for (it = layers.begin(); it != layers.end() && it->first <= target.id; ++it)
+        {
+            LayerData& ld = it->second;
+            if (!ld.flag && (ld.id == 0 || ld.skip))
+                forwardLayer(ld);
+        }
+
+        // the number of unfinished layers each layer waits for, -1 for the ones which are not computed
+        size_t n = scheduleLayers.size();
+        std::vector<LayerData*> layersData(n);
+        std::vector<int> numWaits(n, -1);
+        for (size_t i = 0; i < n; i++)
+        {
+            layersData[i] = &layers[scheduleLayers[i]];
+            if (layersData[i]->id <= target.id && !layersData[i]->flag)
+                numWaits[i] = 0;
+        }
+        std::vector<int> ready, next;
+        for (size_t i = 0; i < n; i++)
+        {
+            if (numWaits[i] < 0)
+                continue;
+            for (size_t j = 0; j < scheduleSuccessors[i].size(); j++)
+            {
+                int succ = scheduleSuccessors[i][j];
+                if (numWaits[succ] >= 0)
+                    numWaits[succ]++;
+            }
+        }
+        for (size_t i = 0; i < n; i++)
+        {
+            if (numWaits[i] == 0)
+                ready.push_back((int)i);
         }
 
-        //forward itself
-        forwardLayer(ld);
+        double parallelCost = minParallelLayerCost() * getNumThreads();
+        std::vector<LayerData*> small;
+        while (!ready.empty())
+        {
+            small.clear();
+            for (size_t i = 0; i < ready.size(); i++)
+            {
+                LayerData* ld = layersData[ready[i]];
+                if (ready.size() == 1 || calibrating || scheduleCosts[ready[i]] >= parallelCost)
+                    forwardLayer(*ld);
+                else
+                    small.push_back(ld);
+            }
+            if (small.size() == 1)
+                forwardLayer(*small[0]);
+            else if (!small.empty())
+            {
+                ConcurrentLayersInvoker invoker(*this, small);
+                parallel_for_(Range(0, (int)small.size()), invoker, (double)small.size());
+                if (invoker.failed)
+                    throw invoker.error;
+            }
+
+            next.clear();
+            for (size_t i = 0; i < ready.size(); i++)
+            {
+                const std::vector<int>& succ = scheduleSuccessors[ready[i]];
+                for (size_t j = 0; j < succ.size(); j++)
+                {
+                    if (numWaits[succ[j]] > 0 && --numWaits[succ[j]] == 0)
+                        next.push_back(succ[j]);
+                }
+            }
+            ready.swap(next);
+        }
+        CV_Assert(target.flag);
+
+        tm.stop();
+        forwardTicks += tm.getTimeTicks();
     }
 
     void getLayerShapesRecursively(int id, LayersShapesMap& inOutShapes)
@@ -2494,6 +3487,104 @@ struct Net::Impl
         return *std::max_element(pins.begin(), pins.end());
     }
 
+    // Creates a network which uses the same layers but has its own blobs.
+    // The memory blocks of the blobs are copied, the blobs keep their places in them.
+    // Unless `markShared` is false this network can't be set up again after that.
+    Ptr<Impl> cloneSharingLayers(bool markShared = true)
+    {
+        CV_Assert(netWasAllocated);
+
+        Ptr<Impl> dst(new Impl());
+        Ptr<DataLayer> inputLayer = dst->netInputLayer;
+        dst->layers = layers;
+        dst->layers[0].layerInstance = inputLayer;
+        dst->layerNameToId = layerNameToId;
+        dst->blobsToKeep = blobsToKeep;
+        dst->preferableBackend = preferableBackend;
+        dst->preferableTarget = preferableTarget;
+        dst->lastLayerId = lastLayerId;
+        dst->fusion = fusion;
+        dst->concurrentBranches = concurrentBranches;
+        dst->scheduleLayers = scheduleLayers;
+        dst->scheduleSuccessors = scheduleSuccessors;
+        dst->scheduleCosts = scheduleCosts;
+        dst->layersTimings = layersTimings;
+        dst->plannedBlobsMemory = plannedBlobsMemory;
+        dst->naiveBlobsMemory = naiveBlobsMemory;
+        dst->netWasAllocated = true;
+
+        inputLayer->outNames = netInputLayer->outNames;
+        inputLayer->scaleFactors = netInputLayer->scaleFactors;
+        inputLayer->means = netInputLayer->means;
+        inputLayer->inputsData = netInputLayer->inputsData;
+        inputLayer->skip = netInputLayer->skip;
+
+        std::vector<Mat*> blobs;
+        for (MapIdToLayerData::iterator it = dst->layers.begin(); it != dst->layers.end(); ++it)
+        {
+            LayerData& ld = it->second;
+            for (size_t i = 0; i < ld.outputBlobs.size(); i++)
+                blobs.push_back(&ld.outputBlobs[i]);
+            for (size_t i = 0; i < ld.internals.size(); i++)
+                blobs.push_back(&ld.internals[i]);
+        }
+        for (size_t i = 0; i < inputLayer->inputsData.size(); i++)
+            blobs.push_back(&inputLayer->inputsData[i]);
+
+        std::map<const uchar*, Mat> memory;
+        for (size_t i = 0; i < blobs.size(); i++)
+        {
+            Mat& m = *blobs[i];
+            if (m.empty())
+                continue;
+            Mat& mem = memory[m.datastart];
+            if (mem.empty())
+            {
+                size_t size = m.datalimit - m.datastart;
+                CV_Assert(size % m.elemSize() == 0);
+                mem.create(1, (int)(size / m.elemSize()), m.type());
+                memcpy(mem.data, m.datastart, size);
+            }
+            m = relocateBlob(m, mem);
+        }
+
+        bindInputBlobs(dst->layers);
+
+        layersShared = layersShared || markShared;
+        dst->layersShared = true;
+        return dst;
+    }
+
+    // Returns the header which refers to the same place in `mem` as `m` refers to
+    // in its own memory block.
+    static Mat relocateBlob(const Mat& m, const Mat& mem)
+    {
+        size_t esz = m.elemSize(), ofs = m.data - m.datastart;
+        CV_Assert(m.type() == mem.type() && ofs % esz == 0);
+        if (m.isContinuous())
+        {
+            int start = (int)(ofs / esz);
+            return mem.colRange(start, start + (int)m.total()).reshape(0, m.dims, m.size.p);
+        }
+
+        // a part of a continuous blob with the same steps
+        int dims = m.dims;
+        std::vector<int> parentSize(dims);
+        std::vector<Range> ranges(dims);
+        CV_Assert(m.step[dims - 1] == esz);
+        for (int i = 0; i < dims; i++)
+        {
+            int idx = (int)(ofs / m.step[i]);
+            ofs %= m.step[i];
+            CV_Assert(i == 0 || m.step[i - 1] % m.step[i] == 0);
+            parentSize[i] = i == 0 ? idx + m.size[0] : (int)(m.step[i - 1] / m.step[i]);
+            ranges[i] = Range(idx, idx + m.size[i]);
+            CV_Assert(ranges[i].end <= parentSize[i]);
+        }
+        Mat parent = mem.colRange(0, (int)(parentSize[0]*m.step[0] / esz)).reshape(0, dims, &parentSize[0]);
+        return parent(&ranges[0]);
+    }
+
     Mat getBlob(const LayerPin& pin)
     {
         CV_TRACE_FUNCTION();
@@ -2563,6 +3654,129 @@ struct Net::Impl
     {
         return getBlobAsync(getPinByAlias(outputName));
     }
+
+    // Is called by forwardAsync() when the network is set up for `pin` and the current inputs.
+    AsyncArray enqueueAsyncRequest(const LayerPin& pin)
+    {
+        if (asyncWorkers.empty())
+        {
+            // The layers prepare some data on the first call, so the first request
+            // is computed here before the layers are shared with the workers.
+            // setInput() lets the input blob share memory with the output of the input layer
+            // which is overwritten by the forward pass, the input is kept for the next calls.
+            std::vector<Mat>& inputsData = netInputLayer->inputsData;
+            LayerData& inpLd = layers[0];
+            for (size_t i = 0; i < inputsData.size() && i < inpLd.outputBlobs.size(); i++)
+            {
+                if (!inputsData[i].empty() && inputsData[i].data == inpLd.outputBlobs[i].data)
+                    inputsData[i] = inputsData[i].clone();
+            }
+            updateInputLayerSkip();
+            forwardToLayer(layers[pin.lid]);
+            AsyncPromise promise;
+            promise.setValue(getBlob(pin));
+            asyncWorkers.push_back(std::thread(&Impl::asyncWorkerLoop, this, cloneSharingLayers(false)));
+            return promise.getArrayResult();
+        }
+
+        AsyncRequest req;
+        req.inputs.resize(netInputLayer->inputsData.size());
+        for (size_t i = 0; i < req.inputs.size(); i++)
+            req.inputs[i] = netInputLayer->inputsData[i].clone();
+        req.scaleFactors = netInputLayer->scaleFactors;
+        req.means = netInputLayer->means;
+        req.pin = pin;
+        AsyncArray result = req.promise.getArrayResult();
+
+        bool newWorker;
+        {
+            std::lock_guard<std::mutex> lock(asyncMutex);
+            asyncRequests.push_back(std::move(req));
+            newWorker = (size_t)asyncIdleWorkers < asyncRequests.size() &&
+                        (int)asyncWorkers.size() < maxAsyncWorkers;
+        }
+        asyncCond.notify_one();
+
+        if (newWorker)
+            asyncWorkers.push_back(std::thread(&Impl::asyncWorkerLoop, this, cloneSharingLayers(false)));
+        return result;
+    }
+
+    // Completes the pending requests and stops the workers.
+    void stopAsyncWorkers()
+    {
+        if (asyncWorkers.empty())
+            return;
+        {
+            std::lock_guard<std::mutex> lock(asyncMutex);
+            asyncStop = true;
+        }
+        asyncCond.notify_all();
+        for (size_t i = 0; i < asyncWorkers.size(); i++)
+            asyncWorkers[i].join();
+        asyncWorkers.clear();
+        asyncStop = false;
+    }
+
+    // Executes the requests in the order of submission by `net`, which shares
+    // the layers with this network and is set up in the same way.
+    void asyncWorkerLoop(Ptr<Impl> net)
+    {
+        for (;;)
+        {
+            AsyncRequest req;
+            {
+                std::unique_lock<std::mutex> lock(asyncMutex);
+                asyncIdleWorkers++;
+                while (!asyncStop && asyncRequests.empty())
+                    asyncCond.wait(lock);
+                asyncIdleWorkers--;
+                if (asyncRequests.empty())
+                    return;
+                req = std::move(asyncRequests.front());
+                asyncRequests.pop_front();
+            }
+
+            try
+            {
+                Mat out = net->forwardAsyncRequest(req);
+                req.promise.setValue(out);
+            }
+            catch (const cv::Exception& e)
+            {
+                try { req.promise.setException(e); }
+                catch (...) { /* the result is not waited for anymore */ }
+            }
+            catch (const std::exception& e)
+            {
+                try { req.promise.setException(cv::Exception(Error::StsError, e.what(), CV_Func, __FILE__, __LINE__)); }
+                catch (...) { /* the result is not waited for anymore */ }
+            }
+            catch (...)
+            {
+                try { req.promise.setException(cv::Exception(Error::StsError, "Unknown exception", CV_Func, __FILE__, __LINE__)); }
+                catch (...) { /* the result is not waited for anymore */ }
+            }
+        }
+    }
+
+    // Computes the request with its inputs, the network is set up for their shapes.
+    Mat forwardAsyncRequest(AsyncRequest& req)
+    {
+        std::vector<Mat>& inputsData = netInputLayer->inputsData;
+        CV_Assert(inputsData.size() == req.inputs.size());
+        for (size_t i = 0; i < req.inputs.size(); i++)
+        {
+            CV_Assert(shape(inputsData[i]) == shape(req.inputs[i]));
+            req.inputs[i].copyTo(inputsData[i]);
+        }
+        netInputLayer->scaleFactors = req.scaleFactors;
+        netInputLayer->means = req.means;
+        updateInputLayerSkip();
+
+        forwardToLayer(layers[req.pin.lid]);
+        return getBlob(req.pin);
+    }
 #endif  // CV_CXX11
 };
 
@@ -2631,6 +3845,7 @@ int Net::addLayer(const String &name, const String &type, LayerParams &params)
         return -1;
     }
 
+    impl->dropPlans();
     int id = ++impl->lastLayerId;
     impl->layerNameToId.insert(std::make_pair(name, id));
     impl->layers.insert(std::make_pair(id, LayerData(id, name, type, params)));
@@ -2652,6 +3867,7 @@ void Net::connect(int outLayerId, int outNum, int inpLayerId, int inpNum)
 {
     CV_TRACE_FUNCTION();
 
+    impl->dropPlans();
     impl->connect(outLayerId, outNum, inpLayerId, inpNum);
 }
 
@@ -2664,6 +3880,7 @@ void Net::connect(String _outPin, String _inPin)
 
     CV_Assert(outPin.valid() && inpPin.valid());
 
+    impl->dropPlans();
     impl->connect(outPin.lid, outPin.oid, inpPin.lid, inpPin.oid);
 }
 
@@ -2671,6 +3888,8 @@ Mat Net::forward(const String& outputName)
 {
     CV_TRACE_FUNCTION();
 
+    AutoLock lock(impl->forwardMutex);
+
     String layerName = outputName;
 
     if (layerName.empty())
@@ -2692,11 +3911,19 @@ AsyncArray Net::forwardAsync(const String& outputName)
     if (layerName.empty())
         layerName = getLayerNames().back();
 
+    AutoLock lock(impl->forwardMutex);
     std::vector<LayerPin> pins(1, impl->getPinByAlias(layerName));
     impl->setUpNet(pins);
 
+    if (impl->preferableBackend == DNN_BACKEND_OPENCV)
+    {
+        if (impl->preferableTarget != DNN_TARGET_CPU)
+            CV_Error(Error::StsNotImplemented, "Asynchronous forward of DNN_BACKEND_OPENCV requires DNN_TARGET_CPU");
+        return impl->enqueueAsyncRequest(pins[0]);
+    }
+
     if (impl->preferableBackend != DNN_BACKEND_INFERENCE_ENGINE)
-        CV_Error(Error::StsNotImplemented, "Asynchronous forward for backend which is different from DNN_BACKEND_INFERENCE_ENGINE");
+        CV_Error(Error::StsNotImplemented, "Asynchronous forward for backend which is different from DNN_BACKEND_INFERENCE_ENGINE or DNN_BACKEND_OPENCV");
 
     impl->isAsync = true;
     impl->forwardToLayer(impl->getLayerData(layerName));
@@ -2712,6 +3939,8 @@ void Net::forward(OutputArrayOfArrays outputBlobs, const String& outputName)
 {
     CV_TRACE_FUNCTION();
 
+    AutoLock lock(impl->forwardMutex);
+
     String layerName = outputName;
 
     if (layerName.empty())
@@ -2784,6 +4013,8 @@ void Net::forward(OutputArrayOfArrays outputBlobs,
 {
     CV_TRACE_FUNCTION();
 
+    AutoLock lock(impl->forwardMutex);
+
     std::vector<LayerPin> pins;
     for (int i = 0; i < outBlobNames.size(); i++)
     {
@@ -2811,6 +4042,8 @@ void Net::forward(std::vector<std::vector<Mat> >& outputBlobs,
 {
     CV_TRACE_FUNCTION();
 
+    AutoLock lock(impl->forwardMutex);
+
     std::vector<LayerPin> pins;
     for (int i = 0; i < outBlobNames.size(); i++)
     {
@@ -2835,15 +4068,51 @@ void Net::forward(std::vector<std::vector<Mat> >& outputBlobs,
     }
 }
 
+void Net::forwardInto(std::vector<Mat>& outputBlobs, const std::vector<String>& outBlobNames)
+{
+    CV_TRACE_FUNCTION();
+
+    AutoLock lock(impl->forwardMutex);
+
+    std::vector<LayerPin> pins;
+    for (size_t i = 0; i < outBlobNames.size(); i++)
+    {
+        pins.push_back(impl->getPinByAlias(outBlobNames[i]));
+    }
+
+    impl->setUpNet(pins);
+
+    LayerPin out = impl->getLatestLayerPin(pins);
+
+    impl->forwardToLayer(impl->getLayerData(out.lid));
+
+    outputBlobs.resize(pins.size());
+    for (size_t i = 0; i < pins.size(); i++)
+    {
+        // copyTo() keeps the memory of the blob which has the same shape and type
+        impl->getBlob(pins[i]).copyTo(outputBlobs[i]);
+    }
+}
+
 void Net::setPreferableBackend(int backendId)
 {
     CV_TRACE_FUNCTION();
     CV_TRACE_ARG(backendId);
 
+    AutoLock lock(impl->forwardMutex);
+
     if( impl->preferableBackend != backendId )
     {
+        if (impl->layersShared)
+            CV_Error(Error::StsNotImplemented, "The network shares its layers with other networks, "
+                     "so its backend, target or fusion can't be changed");
+#ifdef CV_CXX11
+        // the requests are computed with the layers which are changed here
+        impl->stopAsyncWorkers();
+#endif
         impl->preferableBackend = backendId;
         impl->netWasAllocated = false;
+        impl->dropPlans();
         impl->clear();
     }
 }
@@ -2853,8 +4122,17 @@ void Net::setPreferableTarget(int targetId)
     CV_TRACE_FUNCTION();
     CV_TRACE_ARG(targetId);
 
+    AutoLock lock(impl->forwardMutex);
+
     if( impl->preferableTarget != targetId )
     {
+        if (impl->layersShared)
+            CV_Error(Error::StsNotImplemented, "The network shares its layers with other networks, "
+                     "so its backend, target or fusion can't be changed");
+#ifdef CV_CXX11
+        // the requests are computed with the layers which are changed here
+        impl->stopAsyncWorkers();
+#endif
         impl->preferableTarget = targetId;
         if (IS_DNN_OPENCL_TARGET(targetId))
         {
@@ -2873,6 +4151,7 @@ void Net::setPreferableTarget(int targetId)
 #endif
         }
         impl->netWasAllocated = false;
+        impl->dropPlans();
         impl->clear();
     }
 }
@@ -2889,41 +4168,96 @@ void Net::setInput(InputArray blob, const String& name, double scalefactor, cons
     CV_TRACE_FUNCTION();
     CV_TRACE_ARG_VALUE(name, "name", name.c_str());
 
-    LayerPin pin;
-    pin.lid = 0;
-    pin.oid = impl->resolvePinOutputName(impl->getLayerData(pin.lid), name);
-
-    if (!pin.valid())
-        CV_Error(Error::StsObjectNotFound, "Requested blob \"" + name + "\" not found");
+    AutoLock lock(impl->forwardMutex);
 
+    LayerPin pin = impl->getInputPin(name);
     LayerData &ld = impl->layers[pin.lid];
-    const int numInputs = std::max(pin.oid+1, (int)ld.requiredOutputs.size());
-    ld.outputBlobs.resize(numInputs);
-    ld.outputBlobsWrappers.resize(numInputs);
-    impl->netInputLayer->inputsData.resize(numInputs);
-    impl->netInputLayer->scaleFactors.resize(numInputs);
-    impl->netInputLayer->means.resize(numInputs);
-
-    MatShape prevShape = shape(impl->netInputLayer->inputsData[pin.oid]);
+    DataLayer& inputLayer = *impl->netInputLayer;
+
+    MatShape prevShape = shape(inputLayer.inputsData[pin.oid]);
     Mat blob_ = blob.getMat();
     bool oldShape = prevShape == shape(blob_);
-    if (oldShape)
+    if (oldShape && !inputLayer.boundInputs[pin.oid])
     {
-        blob_.copyTo(impl->netInputLayer->inputsData[pin.oid]);
+        blob_.copyTo(inputLayer.inputsData[pin.oid]);
+    }
+    else if (oldShape)
+    {
+        // the blob bound by bindInput() is the user's one
+        inputLayer.inputsData[pin.oid] = blob_.clone();
     }
     else
     {
         ld.outputBlobs[pin.oid] = blob_.clone();
-        impl->netInputLayer->inputsData[pin.oid] = ld.outputBlobs[pin.oid];
+        inputLayer.inputsData[pin.oid] = ld.outputBlobs[pin.oid];
+    }
+    inputLayer.boundInputs[pin.oid] = false;
+
+    if (!ld.outputBlobsWrappers[pin.oid].empty())
+    {
+        ld.outputBlobsWrappers[pin.oid]->setHostDirty();
+    }
+    inputLayer.scaleFactors[pin.oid] = scalefactor;
+    inputLayer.means[pin.oid] = mean;
+    impl->netWasAllocated = impl->netWasAllocated && oldShape;
+    if (impl->netWasAllocated)
+        impl->updateInputLayerSkip();
+}
+
+void Net::bindInput(const Mat& blob, const String& name, double scalefactor, const Scalar& mean)
+{
+    CV_TRACE_FUNCTION();
+    CV_TRACE_ARG_VALUE(name, "name", name.c_str());
+
+    AutoLock lock(impl->forwardMutex);
+
+    CV_Assert(!blob.empty());
+    LayerPin pin = impl->getInputPin(name);
+    LayerData &ld = impl->layers[pin.lid];
+    DataLayer& inputLayer = *impl->netInputLayer;
+
+    bool oldShape = shape(inputLayer.inputsData[pin.oid]) == shape(blob);
+    if (!oldShape)
+    {
+        // the network is allocated for the shapes of the input layer outputs
+        ld.outputBlobs[pin.oid] = Mat(shape(blob), CV_32F);
     }
+    inputLayer.inputsData[pin.oid] = blob;
+    inputLayer.boundInputs[pin.oid] = true;
 
     if (!ld.outputBlobsWrappers[pin.oid].empty())
     {
         ld.outputBlobsWrappers[pin.oid]->setHostDirty();
     }
-    impl->netInputLayer->scaleFactors[pin.oid] = scalefactor;
-    impl->netInputLayer->means[pin.oid] = mean;
+    inputLayer.scaleFactors[pin.oid] = scalefactor;
+    inputLayer.means[pin.oid] = mean;
     impl->netWasAllocated = impl->netWasAllocated && oldShape;
+    if (impl->netWasAllocated)
+        impl->updateInputLayerSkip();
+}
+
+Net Net::cloneSharingWeights()
+{
+    CV_TRACE_FUNCTION();
+
+    AutoLock lock(impl->forwardMutex);
+
+    if (impl->preferableBackend == DNN_BACKEND_DEFAULT)
+        impl->preferableBackend = (Backend)PARAM_DNN_BACKEND_DEFAULT;
+    if (impl->preferableBackend != DNN_BACKEND_OPENCV || impl->preferableTarget != DNN_TARGET_CPU)
+        CV_Error(Error::StsNotImplemented, "Sharing the weights is supported by DNN_BACKEND_OPENCV on DNN_TARGET_CPU only");
+
+    // the network is set up for the outputs of forward() if it was not computed yet.
+    // It's computed once more because some layers prepare their data on the first call.
+    std::vector<LayerPin> pins = impl->blobsToKeep;
+    if (!impl->netWasAllocated || pins.empty())
+        pins.assign(1, impl->getPinByAlias(getLayerNames().back()));
+    impl->setUpNet(pins);
+    impl->forwardToLayer(impl->getLayerData(impl->getLatestLayerPin(pins).lid));
+
+    Net net;
+    net.impl = impl->cloneSharingLayers();
+    return net;
 }
 
 Mat Net::getParam(LayerId layer, int numParam)
@@ -2942,6 +4276,7 @@ void Net::setParam(LayerId layer, int numParam, const Mat &blob)
     CV_Assert(numParam < (int)layerBlobs.size());
     //we don't make strong checks, use this function carefully
     layerBlobs[numParam] = blob;
+    impl->dropPlans();
 }
 
 int Net::getLayerId(const String &layer)
@@ -3473,16 +4808,142 @@ void Net::getMemoryConsumption(const MatShape& netInputShape, std::vector<int>&
                          weights, blobs);
 }
 
+void Net::getBlobsMemory(size_t& planned, size_t& naive)
+{
+    AutoLock lock(impl->forwardMutex);
+
+    planned = impl->plannedBlobsMemory;
+    naive = impl->naiveBlobsMemory;
+}
+
 void Net::enableFusion(bool fusion)
 {
+    AutoLock lock(impl->forwardMutex);
+
     if( impl->fusion != fusion )
     {
+        if (impl->layersShared)
+            CV_Error(Error::StsNotImplemented, "The network shares its layers with other networks, "
+                     "so its backend, target or fusion can't be changed");
+#ifdef CV_CXX11
+        // the requests are computed with the layers which are changed here
+        impl->stopAsyncWorkers();
+#endif
         impl->fusion = fusion;
         impl->netWasAllocated = false;
+        impl->dropPlans();
         impl->clear();
     }
 }
 
+void Net::enableConcurrentBranches(bool enable)
+{
+    AutoLock lock(impl->forwardMutex);
+
+    if( impl->concurrentBranches != enable )
+    {
+        if (impl->layersShared)
+            CV_Error(Error::StsNotImplemented, "The network shares its layers with other networks, "
+                     "so its backend, target or fusion can't be changed");
+#ifdef CV_CXX11
+        // the requests are computed with the layers which are changed here
+        impl->stopAsyncWorkers();
+#endif
+        impl->concurrentBranches = enable;
+        impl->netWasAllocated = false;
+        impl->dropPlans();
+        impl->clear();
+    }
+}
+
+void Net::setMaxAsyncRequests(int count)
+{
+    AutoLock lock(impl->forwardMutex);
+
+#ifdef CV_CXX11
+    impl->maxAsyncWorkers = std::max(count, 1);
+    if ((int)impl->asyncWorkers.size() > impl->maxAsyncWorkers)
+        impl->stopAsyncWorkers();
+#else
+    CV_UNUSED(count);
+#endif
+}
+
+void Net::setPlanCacheSize(int size)
+{
+    AutoLock lock(impl->forwardMutex);
+
+    impl->planCacheSize = std::max(size, 1);
+    if (!impl->planCacheEnabled())
+        impl->dropPlans();
+    while ((int)impl->plans.size() >= impl->planCacheSize)
+        impl->plans.pop_back();
+}
+
+void Net::quantize(InputArrayOfArrays calibData)
+{
+    CV_TRACE_FUNCTION();
+
+    AutoLock lock(impl->forwardMutex);
+
+    if (impl->layersShared)
+        CV_Error(Error::StsNotImplemented, "The network shares its layers with other networks and can't be quantized");
+#ifdef CV_CXX11
+    impl->stopAsyncWorkers();
+#endif
+
+    impl->dropPlans();
+    impl->quantizationScales.clear();
+    for (Impl::MapIdToLayerData::iterator it = impl->layers.begin(); it != impl->layers.end(); ++it)
+    {
+        if (!it->second.layerInstance.empty())
+            it->second.layerInstance->tryQuantize(0.f);
+    }
+
+    std::vector<Mat> samples;
+    calibData.getMatVector(samples);
+    if (samples.empty())
+        return;
+
+    int backend = impl->preferableBackend == DNN_BACKEND_DEFAULT ? PARAM_DNN_BACKEND_DEFAULT : impl->preferableBackend;
+    if (backend != DNN_BACKEND_OPENCV || impl->preferableTarget != DNN_TARGET_CPU)
+        CV_Error(Error::StsNotImplemented, "8-bit quantization is supported by DNN_BACKEND_OPENCV on DNN_TARGET_CPU only");
+
+    const std::vector<double>& scaleFactors = impl->netInputLayer->scaleFactors;
+    const std::vector<Scalar>& means = impl->netInputLayer->means;
+    double scale = scaleFactors.empty() ? 1.0 : scaleFactors[0];
+    Scalar mean = means.empty() ? Scalar() : means[0];
+
+    impl->inputRanges.clear();
+    impl->calibrating = true;
+    try
+    {
+        std::vector<Mat> outs;
+        std::vector<String> outNames = getUnconnectedOutLayersNames();
+        for (size_t i = 0; i < samples.size(); i++)
+        {
+            setInput(samples[i], "", scale, mean);
+            forward(outs, outNames);
+        }
+    }
+    catch (...)
+    {
+        impl->calibrating = false;
+        throw;
+    }
+    impl->calibrating = false;
+
+    for (std::map<int, float>::const_iterator it = impl->inputRanges.begin(); it != impl->inputRanges.end(); ++it)
+    {
+        LayerData& ld = impl->layers[it->first];
+        if (it->second > 0.f && !ld.skip && ld.layerInstance->tryQuantize(it->second/127))
+            impl->quantizationScales[it->first] = it->second/127;
+    }
+    impl->inputRanges.clear();
+    // the layers of the kept set ups are not quantized
+    impl->dropPlans();
+}
+
 void Net::setHalideScheduler(const String& scheduler)
 {
     CV_TRACE_FUNCTION();
@@ -3493,7 +4954,11 @@ void Net::setHalideScheduler(const String& scheduler)
 
 int64 Net::getPerfProfile(std::vector<double>& timings)
 {
+    AutoLock lock(impl->forwardMutex);
+
     timings = std::vector<double>(impl->layersTimings.begin() + 1, impl->layersTimings.end());
+    if (impl->forwardTicks > 0)
+        return impl->forwardTicks;
     int64 total = (int64)std::accumulate(timings.begin(), timings.end(), 0.0);
     return total;
 }
@@ -3622,6 +5087,7 @@ Ptr<BackendNode> Layer::tryAttach(const Ptr<BackendNode>& node)
 
 bool Layer::setActivation(const Ptr<ActivationLayer>&) { return false; }
 bool Layer::tryFuse(Ptr<Layer>&) { return false; }
+bool Layer::tryQuantize(float) { return false; }
 void Layer::getScaleShift(Mat& scale, Mat& shift) const
 {
     scale = Mat();
@@ -46,6 +46,7 @@
 #include "../op_inf_engine.hpp"
 #include "opencv2/core/hal/hal.hpp"
 #include "opencv2/core/hal/intrin.hpp"
+#include <opencv2/core/utils/configuration.private.hpp>
 #include <iostream>
 #include <numeric>
 
@@ -59,6 +60,8 @@ namespace cv
 namespace dnn
 {
 
+static bool DNN_CONV_WINOGRAD = utils::getConfigurationParameterBool("OPENCV_DNN_CONV_WINOGRAD", true);
+
 class BaseConvolutionLayerImpl : public ConvolutionLayer
 {
 public:
@@ -222,6 +225,15 @@ public:
     std::vector<float> reluslope;
     Ptr<ActivationLayer> activ;
 
+    // 8-bit integer mode: int8InputScale > 0 is the quantization step of the input,
+    // weightsInt8 are rebuilt whenever weightsMat changes, so forward() only reads them
+    float int8InputScale;
+    Mat weightsInt8;
+    std::vector<float> int8Scales;
+
+    // 3x3 kernels transformed for Winograd F(4x4, 3x3): 36 rows of outCn x inpCn matrices
+    Mat winogradWeights;
+
 #ifdef HAVE_OPENCL
     Ptr<OCL4DNNConvSpatial<float> > convolutionOp;
     std::vector<UMat> umat_blobs;
@@ -229,7 +241,7 @@ public:
     ocl4dnnFusedActiv_t activType;
     float power;
 #endif
-    ConvolutionLayerImpl(const LayerParams &params) : BaseConvolutionLayerImpl(params)
+    ConvolutionLayerImpl(const LayerParams &params) : BaseConvolutionLayerImpl(params), int8InputScale(0.f)
     {
 #ifdef HAVE_OPENCL
         newActiv = false;
@@ -340,11 +352,69 @@ public:
             for(int i = 0; i < outCn; i++ )
                 biasvec[i] = biasMat.at<float>(i);
         }
+        initInt8();
+
+        // Winograd F(4x4, 3x3) takes 36 multiplications per 16 outputs instead of 144. The transforms
+        // cost O(inpCn + outCn) per tile, so it pays off for layers with enough channels only.
+        std::vector<Mat> inputs;
+        inputs_arr.getMatVector(inputs);
+        const int inpCn = inputs[0].size[1];
+        winogradWeights.release();
+        if (DNN_CONV_WINOGRAD && inputs[0].type() == CV_32F && kernel_size.size() == 2 &&
+            kernel_size[0] == 3 && kernel_size[1] == 3 && strides[0] == 1 && strides[1] == 1 &&
+            dilations[0] == 1 && dilations[1] == 1 && inpCn == blobs[0].size[1] &&
+            inpCn >= WINOGRAD_MIN_CN && outCn >= WINOGRAD_MIN_CN && inpCn <= WINOGRAD_MAX_CN)
+        {
+            initWinograd();
+        }
 #ifdef HAVE_OPENCL
         convolutionOp.release();
 #endif
     }
 
+    enum { WINOGRAD_MIN_CN = 16, WINOGRAD_MAX_CN = 1024 };
+
+    // U = G*g*G^T for every 3x3 kernel g, where
+    // G = [1/4 0 0; -1/6 -1/6 -1/6; -1/6 1/6 -1/6; 1/24 1/12 1/6; 1/24 -1/12 1/6; 0 0 1]
+    void initWinograd()
+    {
+        const int outCn = weightsMat.rows, inpCn = blobs[0].size[1];
+        winogradWeights.create(36, outCn*inpCn, CV_32F);
+        float* wptr = winogradWeights.ptr<float>();
+        size_t xistep = winogradWeights.step1();
+
+        for (int k = 0; k < outCn; k++)
+        {
+            const float* g = weightsMat.ptr<float>(k);
+            for (int c = 0; c < inpCn; c++, g += 9)
+            {
+                float tmp[6][3], u[36];
+                for (int j = 0; j < 3; j++)
+                {
+                    float g0 = g[j], g1 = g[3 + j], g2 = g[6 + j];
+                    tmp[0][j] = g0*(1.f/4);
+                    tmp[1][j] = -(g0 + g1 + g2)*(1.f/6);
+                    tmp[2][j] = -(g0 - g1 + g2)*(1.f/6);
+                    tmp[3][j] = g0*(1.f/24) + g1*(1.f/12) + g2*(1.f/6);
+                    tmp[4][j] = g0*(1.f/24) - g1*(1.f/12) + g2*(1.f/6);
+                    tmp[5][j] = g2;
+                }
+                for (int i = 0; i < 6; i++)
+                {
+                    float g0 = tmp[i][0], g1 = tmp[i][1], g2 = tmp[i][2];
+                    u[i*6] = g0*(1.f/4);
+                    u[i*6 + 1] = -(g0 + g1 + g2)*(1.f/6);
+                    u[i*6 + 2] = -(g0 - g1 + g2)*(1.f/6);
+                    u[i*6 + 3] = g0*(1.f/24) + g1*(1.f/12) + g2*(1.f/6);
+                    u[i*6 + 4] = g0*(1.f/24) - g1*(1.f/12) + g2*(1.f/6);
+                    u[i*6 + 5] = g2;
+                }
+                for (int xi = 0; xi < 36; xi++)
+                    wptr[xi*xistep + k*inpCn + c] = u[xi];
+            }
+        }
+    }
+
     bool setActivation(const Ptr<ActivationLayer>& layer) CV_OVERRIDE
     {
         if (!activ.empty() && !layer.empty())
@@ -415,6 +485,32 @@ public:
                 biasvec[i] += b.at<float>(i);
         }
         biasvec[outCn] = biasvec[outCn+1] = biasvec[outCn-1];
+        initInt8();
+        if (!winogradWeights.empty())
+            initWinograd();
+    }
+
+    bool tryQuantize(float inputScale) CV_OVERRIDE
+    {
+        int8InputScale = kernel_size.size() == 2 && inputScale > 0.f ? inputScale : 0.f;
+        initInt8();
+        return int8InputScale > 0.f;
+    }
+
+    // the weights are not known before finalize(), it calls this again
+    void initInt8()
+    {
+        if (int8InputScale > 0.f && !weightsMat.empty())
+        {
+            quantizeWeightsInt8(weightsMat, weightsInt8, int8Scales);
+            for (size_t i = 0; i < int8Scales.size(); i++)
+                int8Scales[i] *= int8InputScale;
+        }
+        else
+        {
+            weightsInt8.release();
+            int8Scales.clear();
+        }
     }
 
     virtual Ptr<BackendNode> initHalide(const std::vector<Ptr<BackendWrapper> > &inputs) CV_OVERRIDE
@@ -1013,6 +1109,348 @@ public:
         }
     };
 
+    // Winograd F(4x4, 3x3) convolution. Every stripe takes BLK_TILES 6x6 input tiles (4x4 output
+    // tiles) and a range of output channels. The tiles are transformed to V = B^T*d*B for all the
+    // input channels, multiplied by the transformed weights (36 independent GEMMs) and the products
+    // are transformed back to Y = A^T*M*A.
+    class ParallelWinograd : public cv::ParallelLoopBody
+    {
+    public:
+        enum { BLK_TILES = 16, BLK_K = 32 };
+
+        ParallelWinograd(const Mat& _input, Mat& _output, const Mat& _weights, const std::vector<float>& _biasvec,
+                         int _pad_t, int _pad_l, const ActivationLayer* _activ)
+            : input(_input), output(_output), weights(_weights), biasvec(_biasvec),
+              pad_t(_pad_t), pad_l(_pad_l), activ(_activ)
+        {
+            int outCn = output.size[1];
+            tilesY = (output.size[2] + 3)/4;
+            tilesX = (output.size[3] + 3)/4;
+            int ntiles = input.size[0]*tilesY*tilesX;
+            ntileBlocks = (ntiles + BLK_TILES - 1)/BLK_TILES;
+
+            // split the output channels too if there are not enough tiles to load all the threads
+            int nthreads = std::max(getNumThreads(), 1);
+            int maxKParts = (outCn + BLK_K - 1)/BLK_K;
+            nkparts = ntileBlocks >= nthreads ? 1 : std::min((nthreads + ntileBlocks - 1)/ntileBlocks, maxKParts);
+            kpartSize = (int)alignSize((outCn + nkparts - 1)/nkparts, 4);
+            nkparts = (outCn + kpartSize - 1)/kpartSize;
+        }
+
+        int numStripes() const { return ntileBlocks*nkparts; }
+
+        virtual void operator ()(const Range &r) const CV_OVERRIDE
+        {
+            int inpCn = input.size[1], outCn = output.size[1];
+            int height = input.size[2], width = input.size[3];
+            int outH = output.size[2], outW = output.size[3];
+            int tilesPerImage = tilesY*tilesX, ntiles = input.size[0]*tilesPerImage;
+            size_t inpPlaneSize = (size_t)height*width, outPlaneSize = (size_t)outH*outW;
+            size_t vxistep = (size_t)inpCn*BLK_TILES, mxistep = (size_t)BLK_K*BLK_TILES;
+            const float* wptr = weights.ptr<float>();
+            size_t wxistep = weights.step1();
+
+            AutoBuffer<float> vbuf_(36*vxistep), mbuf_(36*mxistep);
+            float* vbuf = vbuf_.data();
+            float* mbuf = mbuf_.data();
+
+            for( int stripe = r.start; stripe < r.end; stripe++ )
+            {
+                int t0 = (stripe / nkparts)*BLK_TILES, t1 = std::min(t0 + BLK_TILES, ntiles);
+                int k0 = (stripe % nkparts)*kpartSize, k1 = std::min(k0 + kpartSize, outCn);
+
+                if( t1 - t0 < BLK_TILES )
+                    memset(vbuf, 0, 36*vxistep*sizeof(vbuf[0]));
+
+                for( int t = t0; t < t1; t++ )
+                {
+                    int n = t / tilesPerImage, ty = (t % tilesPerImage) / tilesX, tx = t % tilesX;
+                    int y0 = ty*4 - pad_t, x0 = tx*4 - pad_l;
+                    bool inside = 0 <= y0 && y0 + 6 <= height && 0 <= x0 && x0 + 6 <= width;
+                    const float* inptr = input.ptr<float>(n);
+
+                    for( int c = 0; c < inpCn; c++, inptr += inpPlaneSize )
+                    {
+                        float d[36];
+                        if( inside )
+                        {
+                            const float* src = inptr + y0*width + x0;
+                            for( int i = 0; i < 6; i++, src += width )
+                                for( int j = 0; j < 6; j++ )
+                                    d[i*6 + j] = src[j];
+                        }
+                        else
+                        {
+                            for( int i = 0; i < 6; i++ )
+                            {
+                                int y = y0 + i;
+                                for( int j = 0; j < 6; j++ )
+                                {
+                                    int x = x0 + j;
+                                    d[i*6 + j] = 0 <= y && y < height && 0 <= x && x < width ? inptr[y*width + x] : 0.f;
+                                }
+                            }
+                        }
+                        inputTransform(d, vbuf + (size_t)c*BLK_TILES + (t - t0), vxistep);
+                    }
+                }
+
+                for( int kb = k0; kb < k1; kb += BLK_K )
+                {
+                    int nk = std::min((int)BLK_K, k1 - kb);
+                    winogradGemm(wptr + (size_t)kb*inpCn, inpCn, wxistep, vbuf, vxistep,
+                                 mbuf, mxistep, nk, inpCn, BLK_TILES, 36);
+
+                    for( int t = t0; t < t1; t++ )
+                    {
+                        int n = t / tilesPerImage, ty = (t % tilesPerImage) / tilesX, tx = t % tilesX;
+                        int y0 = ty*4, x0 = tx*4;
+                        int nrows = std::min(4, outH - y0), ncols = std::min(4, outW - x0);
+                        float* outptr = output.ptr<float>(n, kb) + y0*outW + x0;
+
+                        for( int k = 0; k < nk; k++, outptr += outPlaneSize )
+                        {
+                            float y[16];
+                            outputTransform(mbuf + (size_t)k*BLK_TILES + (t - t0), mxistep, y);
+                            float bias = biasvec[kb + k];
+                            for( int i = 0; i < nrows; i++ )
+                                for( int j = 0; j < ncols; j++ )
+                                    outptr[i*outW + j] = y[i*4 + j] + bias;
+                        }
+                    }
+                }
+
+                if( activ )
+                {
+                    for( int t = t0; t < t1; t++ )
+                    {
+                        int n = t / tilesPerImage, ty = (t % tilesPerImage) / tilesX, tx = t % tilesX;
+                        int y0 = ty*4, x0 = tx*4;
+                        int nrows = std::min(4, outH - y0), ncols = std::min(4, outW - x0);
+                        float* outptr = output.ptr<float>(n, k0) + y0*outW + x0;
+                        for( int i = 0; i < nrows; i++, outptr += outW )
+                            activ->forwardSlice(outptr, outptr, ncols, outPlaneSize, k0, k1);
+                    }
+                }
+            }
+        }
+
+        // V = B^T*d*B, where
+        // B^T = [4 0 -5 0 1 0; 0 -4 -4 1 1 0; 0 4 -4 -1 1 0; 0 -2 -1 2 1 0; 0 2 -1 -2 1 0; 0 4 0 -5 0 1]
+        static void inputTransform(const float* d, float* v, size_t xistep)
+        {
+            float tmp[36];
+            for( int j = 0; j < 6; j++ )
+            {
+                float d0 = d[j], d1 = d[6 + j], d2 = d[12 + j], d3 = d[18 + j], d4 = d[24 + j], d5 = d[30 + j];
+                tmp[j] = 4*d0 - 5*d2 + d4;
+                tmp[6 + j] = d3 + d4 - 4*(d1 + d2);
+                tmp[12 + j] = d4 - d3 + 4*(d1 - d2);
+                tmp[18 + j] = d4 - d2 + 2*(d3 - d1);
+                tmp[24 + j] = d4 - d2 - 2*(d3 - d1);
+                tmp[30 + j] = 4*d1 - 5*d3 + d5;
+            }
+            for( int i = 0; i < 6; i++ )
+            {
+                const float* t = tmp + i*6;
+                float* vi = v + i*6*xistep;
+                vi[0] = 4*t[0] - 5*t[2] + t[4];
+                vi[xistep] = t[3] + t[4] - 4*(t[1] + t[2]);
+                vi[xistep*2] = t[4] - t[3] + 4*(t[1] - t[2]);
+                vi[xistep*3] = t[4] - t[2] + 2*(t[3] - t[1]);
+                vi[xistep*4] = t[4] - t[2] - 2*(t[3] - t[1]);
+                vi[xistep*5] = 4*t[1] - 5*t[3] + t[5];
+            }
+        }
+
+        // Y = A^T*M*A, where A^T = [1 1 1 1 1 0; 0 1 -1 2 -2 0; 0 1 1 4 4 0; 0 1 -1 8 -8 1]
+        static void outputTransform(const float* m, size_t xistep, float* y)
+        {
+            float tmp[24];
+            for( int j = 0; j < 6; j++ )
+            {
+                float m0 = m[j*xistep], m1 = m[(6 + j)*xistep], m2 = m[(12 + j)*xistep];
+                float m3 = m[(18 + j)*xistep], m4 = m[(24 + j)*xistep], m5 = m[(30 + j)*xistep];
+                float s12 = m1 + m2, d12 = m1 - m2, s34 = m3 + m4, d34 = m3 - m4;
+                tmp[j] = m0 + s12 + s34;
+                tmp[6 + j] = d12 + 2*d34;
+                tmp[12 + j] = s12 + 4*s34;
+                tmp[18 + j] = d12 + 8*d34 + m5;
+            }
+            for( int i = 0; i < 4; i++ )
+            {
+                const float* t = tmp + i*6;
+                float s12 = t[1] + t[2], d12 = t[1] - t[2], s34 = t[3] + t[4], d34 = t[3] - t[4];
+                y[i*4] = t[0] + s12 + s34;
+                y[i*4 + 1] = d12 + 2*d34;
+                y[i*4 + 2] = s12 + 4*s34;
+                y[i*4 + 3] = d12 + 8*d34 + t[5];
+            }
+        }
+
+    private:
+        const Mat& input;
+        Mat& output;
+        const Mat& weights;
+        const std::vector<float>& biasvec;
+        int pad_t, pad_l;
+        const ActivationLayer* activ;
+        int tilesY, tilesX, ntileBlocks, nkparts, kpartSize;
+    };
+
+    // Depthwise convolution (a group per input channel, one output channel per group).
+    // Every stripe computes a range of rows of one output plane directly, without im2row.
+    class ParallelDepthwiseConv : public cv::ParallelLoopBody
+    {
+    public:
+        ParallelDepthwiseConv(const Mat& _input, Mat& _output, const Mat& _weights, const std::vector<float>& _biasvec,
+                              const ConvolutionLayerImpl& _conv, const ActivationLayer* _activ)
+            : input(_input), output(_output), weights(_weights), biasvec(_biasvec), conv(_conv), activ(_activ)
+        {
+            int nplanes = output.size[0]*output.size[1], outH = output.size[2];
+            // split the planes into row blocks only if there are too few of them
+            int nthreads = std::max(getNumThreads(), 1);
+            nrowblocks = nplanes >= nthreads*4 ? 1 : std::min((nthreads*4 + nplanes - 1)/nplanes, outH);
+        }
+
+        int numStripes() const { return output.size[0]*output.size[1]*nrowblocks; }
+
+        virtual void operator ()(const Range &r) const CV_OVERRIDE
+        {
+            int cn = output.size[1], outH = output.size[2], outW = output.size[3];
+            int height = input.size[2], width = input.size[3];
+            size_t outPlaneSize = (size_t)outH*outW;
+
+            for( int stripe = r.start; stripe < r.end; stripe++ )
+            {
+                int plane = stripe / nrowblocks, rb = stripe % nrowblocks;
+                int c = plane % cn;
+                int y0 = rb*outH/nrowblocks, y1 = (rb + 1)*outH/nrowblocks;
+                const float* inptr = input.ptr<float>() + (size_t)plane*height*width;
+                float* outptr = output.ptr<float>() + plane*outPlaneSize;
+
+                depthwiseConv(weights.ptr<float>(c), (int)conv.kernel_size[0], (int)conv.kernel_size[1],
+                              (int)conv.strides[0], (int)conv.strides[1],
+                              (int)conv.dilations[0], (int)conv.dilations[1],
+                              (int)conv.pads_begin[0], (int)conv.pads_begin[1], biasvec[c],
+                              inptr, height, width, outptr, outW, y0, y1);
+
+                if( activ && y1 > y0 )
+                    activ->forwardSlice(outptr + y0*outW, outptr + y0*outW, (y1 - y0)*outW, outPlaneSize, c, c + 1);
+            }
+        }
+
+    private:
+        const Mat& input;
+        Mat& output;
+        const Mat& weights;
+        const std::vector<float>& biasvec;
+        const ConvolutionLayerImpl& conv;
+        const ActivationLayer* activ;
+        int nrowblocks;
+    };
+
+    // 2D convolution of an int8-quantized input with int8 weights. Every stripe takes
+    // BLK_SIZE output pixels of one image and group, unrolls their receptive fields
+    // into rows of int8 values (all the input channels at once) and multiplies them
+    // by the weights with 32-bit accumulation.
+    class ParallelConvInt8 : public cv::ParallelLoopBody
+    {
+    public:
+        enum { BLK_SIZE = 32 };
+
+        ParallelConvInt8(const Mat& _input, Mat& _output, const Mat& _weights, const std::vector<float>& _scales,
+                         const std::vector<float>& _biasvec, const ConvolutionLayerImpl& _conv,
+                         const ActivationLayer* _activ, int _ngroups)
+            : input(_input), output(_output), weights(_weights), scales(_scales), biasvec(_biasvec),
+              conv(_conv), activ(_activ), ngroups(_ngroups)
+        {
+            outPlaneSize = (int)output.total(2);
+            nblocks = (outPlaneSize + BLK_SIZE - 1)/BLK_SIZE;
+        }
+
+        int numStripes() const { return input.size[0]*ngroups*nblocks; }
+
+        virtual void operator ()(const Range &r) const CV_OVERRIDE
+        {
+            int inpCn = input.size[1]/ngroups, outCn = output.size[1]/ngroups;
+            int height = input.size[2], width = input.size[3];
+            int outW = output.size[3];
+            int kernel_h = conv.kernel.height, kernel_w = conv.kernel.width;
+            int stride_h = conv.stride.height, stride_w = conv.stride.width;
+            int dilation_h = conv.dilation.height, dilation_w = conv.dilation.width;
+            int pad_t = conv.pad.height, pad_l = conv.pad.width;
+            int vsz_a = weights.cols;
+            size_t inpPlaneSize = (size_t)height*width;
+
+            AutoBuffer<schar> rowbuf_((size_t)BLK_SIZE*vsz_a);
+            schar* rowbuf = rowbuf_.data();
+            // the padding is multiplied by the zero-padded weights,
+            // but it must be initialized anyway
+            memset(rowbuf, 0, (size_t)BLK_SIZE*vsz_a);
+
+            for( int stripe = r.start; stripe < r.end; stripe++ )
+            {
+                int sampleIdx = stripe/nblocks;
+                int ofs0 = (stripe - sampleIdx*nblocks)*BLK_SIZE;
+                int ofs1 = std::min(ofs0 + BLK_SIZE, outPlaneSize);
+                int startOutCn = (sampleIdx % ngroups)*outCn;
+                const schar* inptr = input.ptr<schar>() + (size_t)sampleIdx*inpCn*inpPlaneSize;
+                float* outptr = output.ptr<float>() + (size_t)sampleIdx*outCn*outPlaneSize + ofs0;
+
+                for( int ofs = ofs0; ofs < ofs1; ofs++ )
+                {
+                    schar* row = rowbuf + (size_t)(ofs - ofs0)*vsz_a;
+                    int in_i = (ofs / outW)*stride_h - pad_t;
+                    int in_j = (ofs % outW)*stride_w - pad_l;
+                    for( int k = 0; k < inpCn; k++ )
+                    {
+                        const schar* imgptr = inptr + k*inpPlaneSize;
+                        for( int i = 0; i < kernel_h; i++ )
+                        {
+                            int y = in_i + i*dilation_h;
+                            bool yinside = 0 <= y && y < height;
+                            for( int j = 0; j < kernel_w; j++, row++ )
+                            {
+                                int x = in_j + j*dilation_w;
+                                *row = yinside && 0 <= x && x < width ? imgptr[y*width + x] : (schar)0;
+                            }
+                        }
+                    }
+                }
+
+                Mat w = weights.rowRange(startOutCn, startOutCn + outCn);
+                gemmInt8(w, &scales[startOutCn], &biasvec[startOutCn], rowbuf, vsz_a,
+                         outptr, outPlaneSize, 1, outCn, ofs1 - ofs0);
+
+                if( activ )
+                    activ->forwardSlice(outptr, outptr, ofs1 - ofs0, outPlaneSize, startOutCn, startOutCn + outCn);
+            }
+        }
+
+    private:
+        const Mat& input;
+        Mat& output;
+        const Mat& weights;
+        const std::vector<float>& scales;
+        const std::vector<float>& biasvec;
+        const ConvolutionLayerImpl& conv;
+        const ActivationLayer* activ;
+        int ngroups, outPlaneSize, nblocks;
+    };
+
+    void forwardInt8(const Mat& input, Mat& output, int ngroups)
+    {
+        CV_TRACE_FUNCTION();
+
+        CV_Assert(!weightsInt8.empty());
+        Mat qinput;
+        quantizeInt8(input, qinput, int8InputScale);
+
+        ParallelConvInt8 p(qinput, output, weightsInt8, int8Scales, biasvec, *this, activ.get(), ngroups);
+        parallel_for_(Range(0, p.numStripes()), p);
+    }
+
 #ifdef HAVE_OPENCL
     bool forward_ocl(InputArrayOfArrays inps, OutputArrayOfArrays outs, OutputArrayOfArrays internals)
     {
@@ -1178,13 +1616,38 @@ public:
         CV_Assert(outputs[0].size[1] % ngroups == 0);
         int outCn = blobs[0].size[0];
 
-        reluslope.clear();
+        if (int8InputScale > 0.f)
+        {
+            forwardInt8(inputs[0], outputs[0], ngroups);
+            return;
+        }
+
+        if (!winogradWeights.empty() && ngroups == 1 && inputs[0].type() == CV_32F)
+        {
+            CV_Assert(inputs[0].isContinuous() && outputs[0].isContinuous());
+            ParallelWinograd p(inputs[0], outputs[0], winogradWeights, biasvec,
+                               (int)pads_begin[0], (int)pads_begin[1], activ.get());
+            parallel_for_(Range(0, p.numStripes()), p);
+            return;
+        }
+
+        if (kernel_size.size() == 2 && ngroups > 1 && ngroups == inputs[0].size[1] && ngroups == outCn &&
+            inputs[0].type() == CV_32F)
+        {
+            CV_Assert(inputs[0].isContinuous() && outputs[0].isContinuous());
+            ParallelDepthwiseConv p(inputs[0], outputs[0], weightsMat, biasvec, *this, activ.get());
+            parallel_for_(Range(0, p.numStripes()), p);
+            return;
+        }
+
+        // not a member: the layer may be computed by several networks at once (Net::cloneSharingWeights)
+        std::vector<float> slopes;
         if( activ )
         {
             Ptr<ReLULayer> activ_relu = activ.dynamicCast<ReLULayer>();
             if( !activ_relu.empty() )
             {
-                reluslope.assign(outCn+2, activ_relu->negativeSlope);
+                slopes.assign(outCn+2, activ_relu->negativeSlope);
             }
 
             Ptr<ChannelsPReLULayer> activ_chprelu = activ.dynamicCast<ChannelsPReLULayer>();
@@ -1193,15 +1656,15 @@ public:
                 const Mat& m = activ_chprelu->blobs[0];
                 CV_Assert(m.isContinuous() && m.type() == CV_32F && (int)m.total() == outCn);
                 const float* mdata = m.ptr<float>();
-                reluslope.resize(outCn+2);
-                std::copy(mdata, mdata + outCn, reluslope.begin());
-                reluslope[outCn] = reluslope[outCn+1] = reluslope[outCn-1];
+                slopes.resize(outCn+2);
+                std::copy(mdata, mdata + outCn, slopes.begin());
+                slopes[outCn] = slopes[outCn+1] = slopes[outCn-1];
             }
         }
 
         int nstripes = std::max(getNumThreads(), 1);
 
-        ParallelConv::run(inputs[0], outputs[0], weightsMat, biasvec, reluslope,
+        ParallelConv::run(inputs[0], outputs[0], weightsMat, biasvec, slopes,
                           kernel_size, strides, pads_begin, pads_end, dilations, activ.get(), ngroups, nstripes);
     }
 
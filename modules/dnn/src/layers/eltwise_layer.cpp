@@ -130,7 +130,15 @@ public:
 
         outputs.assign(1, inputs[0]);
         outputs[0][1] = numChannels;
-        return false;
+
+        // every output element depends on the input elements at the same place only,
+        // so the result may be written over the first input if the shapes are the same
+        for (int i = 1; i < inputs.size(); i++)
+        {
+            if (inputs[i] != inputs[0])
+                return false;
+        }
+        return true;
     }
 
     void finalize(InputArrayOfArrays inputs_arr, OutputArrayOfArrays) CV_OVERRIDE
@@ -67,7 +67,7 @@ public:
     std::vector<UMat> half_blobs;
 #endif
 
-    FullyConnectedLayerImpl(const LayerParams& params)
+    FullyConnectedLayerImpl(const LayerParams& params) : int8InputScale(0.f)
     {
         setParamsFrom(params);
         CV_Assert(1 <= blobs.size() && blobs.size() <= 2);
@@ -138,6 +138,64 @@ public:
             return false;
     }
 
+    bool tryQuantize(float inputScale) CV_OVERRIDE
+    {
+        int8InputScale = inputScale > 0.f ? inputScale : 0.f;
+        if (int8InputScale > 0.f)
+        {
+            quantizeWeightsInt8(weightsMat, weightsInt8, int8Scales);
+            for (size_t i = 0; i < int8Scales.size(); i++)
+                int8Scales[i] *= int8InputScale;
+        }
+        else
+        {
+            weightsInt8.release();
+            int8Scales.clear();
+        }
+        return int8InputScale > 0.f;
+    }
+
+    // int8 version of FullyConnected: every stripe computes a range of outputs for all the samples
+    class FullyConnectedInt8 : public ParallelLoopBody
+    {
+    public:
+        FullyConnectedInt8(const Mat& _srcMat, const Mat& _weights, const std::vector<float>& _scales,
+                           const Mat& _biasMat, Mat& _dstMat, const ActivationLayer* _activ, int _nstripes)
+            : srcMat(_srcMat), weights(_weights), scales(_scales), biasMat(_biasMat), dstMat(_dstMat),
+              activ(_activ), nstripes(_nstripes) {}
+
+        void operator()(const Range& r) const CV_OVERRIDE
+        {
+            int nw0 = weights.rows, nsamples = srcMat.rows;
+            int stripeSize = (nw0 + nstripes - 1)/nstripes;
+            int stripeStart = std::min(r.start*stripeSize, nw0);
+            int stripeEnd = std::min(r.end*stripeSize, nw0);
+            if (stripeStart >= stripeEnd)
+                return;
+
+            float* dptr = dstMat.ptr<float>() + stripeStart;
+            gemmInt8(weights.rowRange(stripeStart, stripeEnd), &scales[stripeStart],
+                     biasMat.ptr<float>() + stripeStart, srcMat.ptr<schar>(), srcMat.step1(),
+                     dptr, 1, dstMat.step1(), stripeEnd - stripeStart, nsamples);
+
+            if (activ)
+            {
+                for (int i = 0; i < nsamples; i++)
+                    activ->forwardSlice(dptr + i*dstMat.step1(), dptr + i*dstMat.step1(), 1, 1,
+                                        stripeStart, stripeEnd);
+            }
+        }
+
+    private:
+        const Mat& srcMat;
+        const Mat& weights;
+        const std::vector<float>& scales;
+        const Mat& biasMat;
+        Mat& dstMat;
+        const ActivationLayer* activ;
+        int nstripes;
+    };
+
     class FullyConnected : public ParallelLoopBody
     {
     public:
@@ -411,7 +469,18 @@ public:
             Mat dstMat = output[i].reshape(1, outerSize);
 
             const int nstripes = getNumThreads();
-            FullyConnected::run(srcMat, weightsMat, biasMat, dstMat, activ.get(), nstripes);
+            if (int8InputScale > 0.f)
+            {
+                CV_Assert(srcMat.cols == weightsMat.cols);
+                Mat qsrc = Mat::zeros(outerSize, weightsInt8.cols, CV_8S);
+                Mat qsrcData = qsrc.colRange(0, srcMat.cols);
+                quantizeInt8(srcMat, qsrcData, int8InputScale);
+                parallel_for_(Range(0, nstripes),
+                              FullyConnectedInt8(qsrc, weightsInt8, int8Scales, biasMat, dstMat,
+                                                 activ.get(), nstripes), nstripes);
+            }
+            else
+                FullyConnected::run(srcMat, weightsMat, biasMat, dstMat, activ.get(), nstripes);
         }
     }
 
@@ -475,6 +544,10 @@ public:
     bool bias;
     Mat weightsMat, biasMat;
     Ptr<ActivationLayer> activ;
+
+    float int8InputScale;
+    Mat weightsInt8;
+    std::vector<float> int8Scales;
 };
 
 Ptr<InnerProductLayer> InnerProductLayer::create(const LayerParams& params)
@@ -41,6 +41,8 @@
 //M*/
 
 #include "../precomp.hpp"
+// the baseline version of the kernels written with universal intrinsics
+#include "layers_common.simd.hpp"
 #include "layers_common.hpp"
 
 namespace cv
@@ -239,5 +241,94 @@ void getConvPoolPaddings(const std::vector<int>& inp, const std::vector<size_t>&
     }
 }
 
+void quantizeWeightsInt8(const Mat& weights, Mat& qweights, std::vector<float>& scales)
+{
+    CV_Assert(weights.dims == 2 && weights.type() == CV_32F);
+    int rows = weights.rows, cols = weights.cols;
+    qweights.create(rows, (int)alignSize(cols, INT8_VEC_ALIGN), CV_8S);
+    qweights.colRange(cols, qweights.cols).setTo(Scalar::all(0));
+    scales.resize(rows);
+
+    for (int i = 0; i < rows; i++)
+    {
+        double maxVal = norm(weights.row(i), NORM_INF);
+        scales[i] = maxVal > 0 ? (float)(maxVal/127) : 1.f;
+        weights.row(i).convertTo(qweights.row(i).colRange(0, cols), CV_8S, 1./scales[i]);
+    }
+}
+
+void quantizeInt8(const Mat& src, Mat& dst, float scale)
+{
+    CV_Assert(scale > 0.f);
+    src.convertTo(dst, CV_8S, 1./scale);
+    // -128 has no positive counterpart, the dot product kernels rely on that
+    max(dst, Scalar::all(-127), dst);
+}
+
+void gemmInt8(const Mat& weights, const float* scales, const float* bias,
+              const schar* rows, size_t rstep, float* dst, size_t dstep, size_t djstep,
+              int nw, int nrows)
+{
+    CV_Assert(weights.type() == CV_8S && weights.cols % INT8_VEC_ALIGN == 0 && nw <= weights.rows);
+    const schar* wptr = weights.ptr<schar>();
+    size_t wstep = weights.step1();
+    int vecsize = weights.cols;
+
+#if CV_TRY_AVX512_CLX
+    if (CV_CPU_HAS_SUPPORT_AVX512_CLX)
+        opt_AVX512_CLX::fastGEMMInt8(wptr, wstep, scales, bias, rows, rstep, dst, dstep, djstep, nw, nrows, vecsize);
+    else
+#endif
+#if CV_TRY_AVX512_SKX
+    if (CV_CPU_HAS_SUPPORT_AVX512_SKX)
+        opt_AVX512_SKX::fastGEMMInt8(wptr, wstep, scales, bias, rows, rstep, dst, dstep, djstep, nw, nrows, vecsize);
+    else
+#endif
+#if CV_TRY_AVX2
+    if (checkHardwareSupport(CPU_AVX2))
+        opt_AVX2::fastGEMMInt8(wptr, wstep, scales, bias, rows, rstep, dst, dstep, djstep, nw, nrows, vecsize);
+    else
+#endif
+        cpu_baseline::fastGEMMInt8(wptr, wstep, scales, bias, rows, rstep, dst, dstep, djstep, nw, nrows, vecsize);
+}
+
+void winogradGemm(const float* U, size_t ustep, size_t uxistep,
+                  const float* V, size_t vxistep, float* M, size_t mxistep,
+                  int nk, int nc, int ntiles, int nxi)
+{
+#if CV_TRY_AVX512_SKX
+    if (CV_CPU_HAS_SUPPORT_AVX512_SKX)
+        opt_AVX512_SKX::fastWinogradGemm(U, ustep, uxistep, V, vxistep, M, mxistep, nk, nc, ntiles, nxi);
+    else
+#endif
+#if CV_TRY_AVX2
+    if (checkHardwareSupport(CPU_AVX2))
+        opt_AVX2::fastWinogradGemm(U, ustep, uxistep, V, vxistep, M, mxistep, nk, nc, ntiles, nxi);
+    else
+#endif
+        cpu_baseline::fastWinogradGemm(U, ustep, uxistep, V, vxistep, M, mxistep, nk, nc, ntiles, nxi);
+}
+
+void depthwiseConv(const float* weights, int kernel_h, int kernel_w,
+                   int stride_h, int stride_w, int dilation_h, int dilation_w,
+                   int pad_t, int pad_l, float bias, const float* inptr, int height, int width,
+                   float* outptr, int outW, int y0, int y1)
+{
+#if CV_TRY_AVX512_SKX
+    if (CV_CPU_HAS_SUPPORT_AVX512_SKX)
+        opt_AVX512_SKX::fastDepthwiseConv(weights, kernel_h, kernel_w, stride_h, stride_w, dilation_h, dilation_w,
+                                          pad_t, pad_l, bias, inptr, height, width, outptr, outW, y0, y1);
+    else
+#endif
+#if CV_TRY_AVX2
+    if (checkHardwareSupport(CPU_AVX2))
+        opt_AVX2::fastDepthwiseConv(weights, kernel_h, kernel_w, stride_h, stride_w, dilation_h, dilation_w,
+                                    pad_t, pad_l, bias, inptr, height, width, outptr, outW, y0, y1);
+    else
+#endif
+        cpu_baseline::fastDepthwiseConv(weights, kernel_h, kernel_w, stride_h, stride_w, dilation_h, dilation_w,
+                                        pad_t, pad_l, bias, inptr, height, width, outptr, outW, y0, y1);
+}
+
 }
 }
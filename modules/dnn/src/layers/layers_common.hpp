@@ -73,6 +73,33 @@ void getConvPoolOutParams(const std::vector<int>& inp, const std::vector<size_t>
  void getConvPoolPaddings(const std::vector<int>& inp, const std::vector<size_t>& kernel,
                           const std::vector<size_t>& strides, const String &padMode,
                           std::vector<size_t>& pads_begin, std::vector<size_t>& pads_end);
+
+// Rows of the int8 matrices passed to gemmInt8 are zero-padded to a multiple of INT8_VEC_ALIGN
+enum { INT8_VEC_ALIGN = 64 };
+
+// Quantizes every row of a float matrix symmetrically to [-127, 127]: row ~= scales[i]*qweights.row(i)
+void quantizeWeightsInt8(const Mat& weights, Mat& qweights, std::vector<float>& scales);
+
+// Quantizes a float tensor to [-127, 127] with the given step: src ~= scale*dst.
+// dst is reallocated unless it already has the size of src and CV_8S type
+void quantizeInt8(const Mat& src, Mat& dst, float scale);
+
+// dst[i*dstep + j*djstep] = scales[i]*(weights_i * rows_j) + bias[i], see fastGEMMInt8.
+// The rows must not contain -128, which is the case for the output of quantizeInt8
+void gemmInt8(const Mat& weights, const float* scales, const float* bias,
+              const schar* rows, size_t rstep, float* dst, size_t dstep, size_t djstep,
+              int nw, int nrows);
+
+// Runs fastWinogradGemm with the best available instruction set
+void winogradGemm(const float* U, size_t ustep, size_t uxistep,
+                  const float* V, size_t vxistep, float* M, size_t mxistep,
+                  int nk, int nc, int ntiles, int nxi);
+
+// Runs fastDepthwiseConv with the best available instruction set
+void depthwiseConv(const float* weights, int kernel_h, int kernel_w,
+                   int stride_h, int stride_w, int dilation_h, int dilation_w,
+                   int pad_t, int pad_l, float bias, const float* inptr, int height, int width,
+                   float* outptr, int outW, int y0, int y1);
 }
 }
 
@@ -56,6 +56,299 @@ void fastGEMM1T( const float* vec, const float* weights,
 void fastGEMM( const float* aptr, size_t astep, const float* bptr,
                size_t bstep, float* cptr, size_t cstep,
                int ma, int na, int nb );
+void fastGEMMInt8( const schar* weights, size_t wstep, const float* scales,
+                   const float* bias, const schar* rows, size_t rstep,
+                   float* dst, size_t dstep, size_t djstep,
+                   int nw, int nrows, int vecsize );
+void fastWinogradGemm( const float* U, size_t ustep, size_t uxistep,
+                       const float* V, size_t vxistep,
+                       float* M, size_t mxistep,
+                       int nk, int nc, int ntiles, int nxi );
+void fastDepthwiseConv( const float* weights, int kernel_h, int kernel_w,
+                        int stride_h, int stride_w, int dilation_h, int dilation_w,
+                        int pad_t, int pad_l, float bias,
+                        const float* inptr, int height, int width,
+                        float* outptr, int outW, int y0, int y1 );
+
+#if !defined(CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY)
+
+#if CV_SIMD
+// acc + sums of products of the adjacent int8 values. The generic v_dotprod_expand widens
+// the values to 16 bits first; the instruction sets with 8-bit multiply-add do it in one or
+// two steps: u8*s8 products with |w| and r with the sign of w, so r must not be -128.
+static inline v_int32 v_dotprod_int8(const v_int8& w, const v_int8& r, const v_int32& acc)
+{
+#if CV_AVX_512VNNI && CV_SIMD512
+    __m512i sr = _mm512_mask_sub_epi8(r.val, _mm512_movepi8_mask(w.val), _mm512_setzero_si512(), r.val);
+    return v_int32(_mm512_dpbusd_epi32(acc.val, _mm512_abs_epi8(w.val), sr));
+#elif CV_AVX512_SKX && CV_SIMD512
+    __m512i sr = _mm512_mask_sub_epi8(r.val, _mm512_movepi8_mask(w.val), _mm512_setzero_si512(), r.val);
+    __m512i p = _mm512_maddubs_epi16(_mm512_abs_epi8(w.val), sr);
+    return v_int32(_mm512_add_epi32(acc.val, _mm512_madd_epi16(p, _mm512_set1_epi16(1))));
+#elif CV_AVX2 && CV_SIMD256
+    __m256i p = _mm256_maddubs_epi16(_mm256_abs_epi8(w.val), _mm256_sign_epi8(r.val, w.val));
+    return v_int32(_mm256_add_epi32(acc.val, _mm256_madd_epi16(p, _mm256_set1_epi16(1))));
+#elif CV_SSSE3 && CV_SIMD128 && !CV_SIMD256
+    __m128i p = _mm_maddubs_epi16(_mm_abs_epi8(w.val), _mm_sign_epi8(r.val, w.val));
+    return v_int32(_mm_add_epi32(acc.val, _mm_madd_epi16(p, _mm_set1_epi16(1))));
+#elif CV_NEON && defined(__ARM_FEATURE_DOTPROD)
+    return v_int32(vdotq_s32(acc.val, w.val, r.val));
+#else
+    return v_dotprod_expand(w, r, acc);
+#endif
+}
+#endif
+
+// dst[i*dstep + j*djstep] = scales[i]*(weights_i * rows_j) + bias[i],
+// where both int8 matrices have rows zero-padded to vecsize, a multiple of 64,
+// and the rows have no -128 values.
+// It is written with universal intrinsics, so it is also compiled
+// for the baseline in layers_common.cpp
+void fastGEMMInt8( const schar* weights, size_t wstep, const float* scales,
+                   const float* bias, const schar* rows, size_t rstep,
+                   float* dst, size_t dstep, size_t djstep,
+                   int nw, int nrows, int vecsize )
+{
+    for( int i = 0; i < nw; i += 2 )
+    {
+        // for odd nw the last row is computed twice
+        int i1 = std::min(i + 1, nw - 1);
+        const schar* wptr0 = weights + i*wstep;
+        const schar* wptr1 = weights + i1*wstep;
+        float* dptr0 = dst + i*dstep;
+        float* dptr1 = dst + i1*dstep;
+        float scale0 = scales[i], scale1 = scales[i1];
+        float bias0 = bias[i], bias1 = bias[i1];
+
+        int j = 0, k;
+#if CV_SIMD
+        for( ; j <= nrows - 4; j += 4 )
+        {
+            const schar* rptr = rows + j*rstep;
+            v_int32 s00 = vx_setzero_s32(), s01 = vx_setzero_s32(),
+                    s02 = vx_setzero_s32(), s03 = vx_setzero_s32(),
+                    s10 = vx_setzero_s32(), s11 = vx_setzero_s32(),
+                    s12 = vx_setzero_s32(), s13 = vx_setzero_s32();
+
+            for( k = 0; k < vecsize; k += v_int8::nlanes )
+            {
+                v_int8 w0 = vx_load(wptr0 + k), w1 = vx_load(wptr1 + k);
+                v_int8 r0 = vx_load(rptr + k), r1 = vx_load(rptr + rstep + k),
+                       r2 = vx_load(rptr + rstep*2 + k), r3 = vx_load(rptr + rstep*3 + k);
+
+                s00 = v_dotprod_int8(w0, r0, s00);
+                s01 = v_dotprod_int8(w0, r1, s01);
+                s02 = v_dotprod_int8(w0, r2, s02);
+                s03 = v_dotprod_int8(w0, r3, s03);
+
+                s10 = v_dotprod_int8(w1, r0, s10);
+                s11 = v_dotprod_int8(w1, r1, s11);
+                s12 = v_dotprod_int8(w1, r2, s12);
+                s13 = v_dotprod_int8(w1, r3, s13);
+            }
+
+            float* d0 = dptr0 + j*djstep;
+            float* d1 = dptr1 + j*djstep;
+            d0[0] = v_reduce_sum(s00)*scale0 + bias0;
+            d0[djstep] = v_reduce_sum(s01)*scale0 + bias0;
+            d0[djstep*2] = v_reduce_sum(s02)*scale0 + bias0;
+            d0[djstep*3] = v_reduce_sum(s03)*scale0 + bias0;
+            d1[0] = v_reduce_sum(s10)*scale1 + bias1;
+            d1[djstep] = v_reduce_sum(s11)*scale1 + bias1;
+            d1[djstep*2] = v_reduce_sum(s12)*scale1 + bias1;
+            d1[djstep*3] = v_reduce_sum(s13)*scale1 + bias1;
+        }
+#endif
+        for( ; j < nrows; j++ )
+        {
+            const schar* rptr = rows + j*rstep;
+            k = 0;
+            int s0 = 0, s1 = 0;
+#if CV_SIMD
+            v_int32 vs0 = vx_setzero_s32(), vs1 = vx_setzero_s32();
+            for( ; k < vecsize; k += v_int8::nlanes )
+            {
+                v_int8 r = vx_load(rptr + k);
+                vs0 = v_dotprod_int8(vx_load(wptr0 + k), r, vs0);
+                vs1 = v_dotprod_int8(vx_load(wptr1 + k), r, vs1);
+            }
+            s0 = v_reduce_sum(vs0);
+            s1 = v_reduce_sum(vs1);
+#endif
+            for( ; k < vecsize; k++ )
+            {
+                int r = rptr[k];
+                s0 += wptr0[k]*r;
+                s1 += wptr1[k]*r;
+            }
+            dptr0[j*djstep] = s0*scale0 + bias0;
+            dptr1[j*djstep] = s1*scale1 + bias1;
+        }
+    }
+    vx_cleanup();
+}
+
+// The batched products of Winograd convolution, one per each of nxi transformed positions:
+// M[xi*mxistep + k*ntiles + t] = sum_c U[xi*uxistep + k*ustep + c] * V[xi*vxistep + c*ntiles + t]
+void fastWinogradGemm( const float* U, size_t ustep, size_t uxistep,
+                       const float* V, size_t vxistep,
+                       float* M, size_t mxistep,
+                       int nk, int nc, int ntiles, int nxi )
+{
+    for( int xi = 0; xi < nxi; xi++ )
+    {
+        const float* uptr = U + xi*uxistep;
+        const float* vptr = V + xi*vxistep;
+        float* mptr = M + xi*mxistep;
+
+        int k = 0;
+        for( ; k < nk; k += 4 )
+        {
+            // for nk % 4 != 0 the last rows are computed several times
+            const float* u0 = uptr + std::min(k, nk - 1)*ustep;
+            const float* u1 = uptr + std::min(k + 1, nk - 1)*ustep;
+            const float* u2 = uptr + std::min(k + 2, nk - 1)*ustep;
+            const float* u3 = uptr + std::min(k + 3, nk - 1)*ustep;
+            float* m0 = mptr + std::min(k, nk - 1)*ntiles;
+            float* m1 = mptr + std::min(k + 1, nk - 1)*ntiles;
+            float* m2 = mptr + std::min(k + 2, nk - 1)*ntiles;
+            float* m3 = mptr + std::min(k + 3, nk - 1)*ntiles;
+
+            int t = 0;
+#if CV_SIMD
+            const int nlanes = v_float32::nlanes;
+            for( ; t <= ntiles - nlanes; t += nlanes )
+            {
+                v_float32 s0 = vx_setzero_f32(), s1 = vx_setzero_f32();
+                v_float32 s2 = vx_setzero_f32(), s3 = vx_setzero_f32();
+                const float* vt = vptr + t;
+                for( int c = 0; c < nc; c++, vt += ntiles )
+                {
+                    v_float32 v = vx_load(vt);
+                    s0 = v_fma(vx_setall_f32(u0[c]), v, s0);
+                    s1 = v_fma(vx_setall_f32(u1[c]), v, s1);
+                    s2 = v_fma(vx_setall_f32(u2[c]), v, s2);
+                    s3 = v_fma(vx_setall_f32(u3[c]), v, s3);
+                }
+                v_store(m0 + t, s0);
+                v_store(m1 + t, s1);
+                v_store(m2 + t, s2);
+                v_store(m3 + t, s3);
+            }
+#endif
+            for( ; t < ntiles; t++ )
+            {
+                float s0 = 0.f, s1 = 0.f, s2 = 0.f, s3 = 0.f;
+                const float* vt = vptr + t;
+                for( int c = 0; c < nc; c++, vt += ntiles )
+                {
+                    float v = *vt;
+                    s0 += u0[c]*v; s1 += u1[c]*v;
+                    s2 += u2[c]*v; s3 += u3[c]*v;
+                }
+                m0[t] = s0; m1[t] = s1; m2[t] = s2; m3[t] = s3;
+            }
+        }
+    }
+    vx_cleanup();
+}
+
+// Computes the rows [y0, y1) of a single output plane of depthwise convolution.
+// The output pixels whose receptive field is inside the image horizontally are computed
+// with vectors along the row (stride 1 or 2), the rest are computed one by one.
+void fastDepthwiseConv( const float* weights, int kernel_h, int kernel_w,
+                        int stride_h, int stride_w, int dilation_h, int dilation_w,
+                        int pad_t, int pad_l, float bias,
+                        const float* inptr, int height, int width,
+                        float* outptr, int outW, int y0, int y1 )
+{
+    int x_start = std::min((pad_l + stride_w - 1)/stride_w, outW);
+    int last_x = width - 1 - (kernel_w - 1)*dilation_w + pad_l;
+    int x_end = last_x < 0 ? 0 : last_x/stride_w + 1;
+    x_end = std::max(std::min(x_end, outW), x_start);
+
+    for( int y = y0; y < y1; y++ )
+    {
+        float* out = outptr + y*outW;
+        int yi0 = y*stride_h - pad_t;
+
+        for( int x = 0; x < outW; )
+        {
+            if( x == x_start )
+            {
+#if CV_SIMD
+                const int nlanes = v_float32::nlanes;
+                // the deinterleaving load reads one element past the last tap
+                int x_vec_end = stride_w == 1 ? x_end - nlanes : stride_w == 2 ? x_end - nlanes - 1 : x_start - 1;
+                for( ; x <= x_vec_end; x += nlanes )
+                {
+                    v_float32 s0 = vx_setall_f32(bias);
+                    for( int ky = 0; ky < kernel_h; ky++ )
+                    {
+                        int yi = yi0 + ky*dilation_h;
+                        if( (unsigned)yi >= (unsigned)height )
+                            continue;
+                        const float* row = inptr + yi*width + x*stride_w - pad_l;
+                        const float* wrow = weights + ky*kernel_w;
+                        for( int kx = 0; kx < kernel_w; kx++ )
+                        {
+                            v_float32 v;
+                            if( stride_w == 1 )
+                                v = vx_load(row + kx*dilation_w);
+                            else
+                            {
+                                v_float32 odd;
+                                v_load_deinterleave(row + kx*dilation_w, v, odd);
+                            }
+                            s0 = v_fma(v, vx_setall_f32(wrow[kx]), s0);
+                        }
+                    }
+                    v_store(out + x, s0);
+                }
+#endif
+                for( ; x < x_end; x++ )
+                {
+                    float s0 = bias;
+                    for( int ky = 0; ky < kernel_h; ky++ )
+                    {
+                        int yi = yi0 + ky*dilation_h;
+                        if( (unsigned)yi >= (unsigned)height )
+                            continue;
+                        const float* row = inptr + yi*width + x*stride_w - pad_l;
+                        const float* wrow = weights + ky*kernel_w;
+                        for( int kx = 0; kx < kernel_w; kx++ )
+                            s0 += row[kx*dilation_w]*wrow[kx];
+                    }
+                    out[x] = s0;
+                }
+                if( x >= outW )
+                    break;
+            }
+
+            // a border pixel
+            float s0 = bias;
+            int xi0 = x*stride_w - pad_l;
+            for( int ky = 0; ky < kernel_h; ky++ )
+            {
+                int yi = yi0 + ky*dilation_h;
+                if( (unsigned)yi >= (unsigned)height )
+                    continue;
+                const float* row = inptr + yi*width;
+                const float* wrow = weights + ky*kernel_w;
+                for( int kx = 0; kx < kernel_w; kx++ )
+                {
+                    int xi = xi0 + kx*dilation_w;
+                    if( (unsigned)xi < (unsigned)width )
+                        s0 += row[xi]*wrow[kx];
+                }
+            }
+            out[x++] = s0;
+        }
+    }
+    vx_cleanup();
+}
+
+#endif
 
 #if !defined(CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY) && CV_AVX
 
@@ -114,11 +114,11 @@ public:
 
         const UMat& inp0 = inputs[0];
         UMat& buffer = internals[0];
-        startAxis = clamp(startAxis, inp0.dims);
-        endAxis = clamp(endAxis, inp0.dims);
+        int start = clamp(startAxis, inp0.dims);
+        int end = clamp(endAxis, inp0.dims);
 
-        size_t num = total(shape(inp0.size), 0, startAxis);
-        size_t numPlanes = total(shape(inp0.size), startAxis, endAxis + 1);
+        size_t num = total(shape(inp0.size), 0, start);
+        size_t numPlanes = total(shape(inp0.size), start, end + 1);
         size_t planeSize = inp0.total() / (num * numPlanes);
         MatShape s = shape(1, inputs[0].total());
         UMat inp = inputs[0].reshape(1, s.size(), &s[0]).reshape(1, num);
@@ -199,14 +199,14 @@ public:
 
         const Mat& inp0 = inputs[0];
         Mat& buffer = internals[0];
-        startAxis = clamp(startAxis, inp0.dims);
-        endAxis = clamp(endAxis, inp0.dims);
+        int start = clamp(startAxis, inp0.dims);
+        int end = clamp(endAxis, inp0.dims);
 
         const float* inpData = inp0.ptr<float>();
         float* outData = outputs[0].ptr<float>();
 
-        size_t num = total(shape(inp0.size), 0, startAxis);
-        size_t numPlanes = total(shape(inp0.size), startAxis, endAxis + 1);
+        size_t num = total(shape(inp0.size), 0, start);
+        size_t numPlanes = total(shape(inp0.size), start, end + 1);
         CV_Assert(num * numPlanes != 0);
         size_t planeSize = inp0.total() / (num * numPlanes);
         for (size_t n = 0; n < num; ++n)
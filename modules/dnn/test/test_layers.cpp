@@ -1488,6 +1488,199 @@ TEST(Layer_Test_Convolution, relu_fusion)
     normAssert(input, output);
 }
 
+// 3x3 convolutions with stride 1 and enough channels use Winograd algorithm
+TEST(Layer_Test_Convolution, winograd)
+{
+    const int inpCn = 32, outCn = 40, height = 13, width = 17;
+    int weightsShape[] = {outCn, inpCn, 3, 3};
+    Mat weights(4, &weightsShape[0], CV_32F), bias(1, outCn, CV_32F);
+    randu(weights, -1.0f, 1.0f);
+    randu(bias, -1.0f, 1.0f);
+
+    int sz[] = {2, inpCn, height, width};
+    Mat input(4, &sz[0], CV_32F);
+    randu(input, -1.0f, 1.0f);
+
+    for (int pad = 0; pad <= 1; pad++)
+    {
+        SCOPED_TRACE(cv::format("pad=%d", pad));
+        Net net;
+        LayerParams lp;
+        lp.set("kernel_size", 3);
+        lp.set("pad", pad);
+        lp.set("num_output", outCn);
+        lp.type = "Convolution";
+        lp.name = "testConv";
+        lp.blobs.push_back(weights);
+        lp.blobs.push_back(bias);
+        net.addLayerToPrev(lp.name, lp.type, lp);
+
+        LayerParams lpr;
+        lpr.type = "ReLU";
+        lpr.name = "testReLU";
+        net.addLayerToPrev(lpr.name, lpr.type, lpr);
+
+        net.setInput(input);
+        net.setPreferableBackend(DNN_BACKEND_OPENCV);
+        Mat out = net.forward();
+
+        int outH = height + 2*pad - 2, outW = width + 2*pad - 2;
+        int outSz[] = {2, outCn, outH, outW};
+        Mat ref(4, &outSz[0], CV_32F);
+        for (int n = 0; n < 2; n++)
+            for (int k = 0; k < outCn; k++)
+                for (int y = 0; y < outH; y++)
+                    for (int x = 0; x < outW; x++)
+                    {
+                        double s = bias.at<float>(k);
+                        for (int c = 0; c < inpCn; c++)
+                            for (int i = 0; i < 3; i++)
+                                for (int j = 0; j < 3; j++)
+                                {
+                                    int yi = y + i - pad, xj = x + j - pad;
+                                    if (0 <= yi && yi < height && 0 <= xj && xj < width)
+                                        s += input.at<float>(Vec4i(n, c, yi, xj))*weights.at<float>(Vec4i(k, c, i, j));
+                                }
+                        ref.at<float>(Vec4i(n, k, y, x)) = (float)std::max(s, 0.);
+                    }
+        normAssert(ref, out, "", 1e-4, 1e-3);
+    }
+}
+
+TEST(Layer_Test_Convolution, depthwise)
+{
+    const int cn = 12, height = 19, width = 23;
+    int sz[] = {2, cn, height, width};
+    Mat input(4, &sz[0], CV_32F);
+    randu(input, -1.0f, 1.0f);
+
+    Mat slopes(1, cn, CV_32F);
+    randu(slopes, 0.0f, 0.5f);
+
+    // kernel, stride, dilation, pad
+    static const int params[][4] = { {3, 1, 1, 1}, {3, 2, 1, 1}, {3, 1, 2, 2}, {5, 1, 1, 2}, {5, 2, 1, 0}, {3, 3, 1, 0} };
+    for (int t = 0; t < (int)(sizeof(params)/sizeof(params[0])); t++)
+    {
+        const int kernel = params[t][0], stride = params[t][1], dilation = params[t][2], pad = params[t][3];
+        SCOPED_TRACE(cv::format("kernel=%d stride=%d dilation=%d pad=%d", kernel, stride, dilation, pad));
+
+        int weightsShape[] = {cn, 1, kernel, kernel};
+        Mat weights(4, &weightsShape[0], CV_32F), bias(1, cn, CV_32F);
+        randu(weights, -1.0f, 1.0f);
+        randu(bias, -1.0f, 1.0f);
+
+        Net net;
+        LayerParams lp;
+        lp.set("kernel_size", kernel);
+        lp.set("stride", stride);
+        lp.set("dilation", dilation);
+        lp.set("pad", pad);
+        lp.set("group", cn);
+        lp.set("num_output", cn);
+        lp.type = "Convolution";
+        lp.name = "testConv";
+        lp.blobs.push_back(weights);
+        lp.blobs.push_back(bias);
+        net.addLayerToPrev(lp.name, lp.type, lp);
+
+        LayerParams lpr;
+        lpr.type = "PReLU";
+        lpr.name = "testPReLU";
+        lpr.blobs.push_back(slopes);
+        net.addLayerToPrev(lpr.name, lpr.type, lpr);
+
+        net.setInput(input);
+        net.setPreferableBackend(DNN_BACKEND_OPENCV);
+        Mat out = net.forward();
+
+        int extent = (kernel - 1)*dilation + 1;
+        int outH = (height + 2*pad - extent)/stride + 1, outW = (width + 2*pad - extent)/stride + 1;
+        int outSz[] = {2, cn, outH, outW};
+        Mat ref(4, &outSz[0], CV_32F);
+        for (int n = 0; n < 2; n++)
+            for (int c = 0; c < cn; c++)
+                for (int y = 0; y < outH; y++)
+                    for (int x = 0; x < outW; x++)
+                    {
+                        double s = bias.at<float>(c);
+                        for (int i = 0; i < kernel; i++)
+                            for (int j = 0; j < kernel; j++)
+                            {
+                                int yi = y*stride + i*dilation - pad, xj = x*stride + j*dilation - pad;
+                                if (0 <= yi && yi < height && 0 <= xj && xj < width)
+                                    s += input.at<float>(Vec4i(n, c, yi, xj))*weights.at<float>(Vec4i(c, 0, i, j));
+                            }
+                        ref.at<float>(Vec4i(n, c, y, x)) = (float)(s >= 0 ? s : s*slopes.at<float>(c));
+                    }
+        normAssert(ref, out, "", 1e-5, 1e-4);
+    }
+}
+
+TEST(Layer_Test_Convolution, quantize_int8)
+{
+    Net net;
+    {
+        LayerParams lp;
+        lp.set("kernel_size", 3);
+        lp.set("pad", 1);
+        lp.set("stride", 2);
+        lp.set("group", 2);
+        lp.set("num_output", 16);
+        lp.type = "Convolution";
+        lp.name = "testConv";
+
+        int weightsShape[] = {16, 4, 3, 3};
+        Mat weights(4, &weightsShape[0], CV_32F), bias(1, 16, CV_32F);
+        randu(weights, -1.0f, 1.0f);
+        randu(bias, -1.0f, 1.0f);
+        lp.blobs.push_back(weights);
+        lp.blobs.push_back(bias);
+        net.addLayerToPrev(lp.name, lp.type, lp);
+    }
+    {
+        LayerParams lp;
+        lp.type = "ReLU";
+        lp.name = "testReLU";
+        net.addLayerToPrev(lp.name, lp.type, lp);
+    }
+    {
+        LayerParams lp;
+        lp.set("num_output", 10);
+        lp.type = "InnerProduct";
+        lp.name = "testFC";
+
+        Mat weights(10, 16*5*6, CV_32F), bias(1, 10, CV_32F);
+        randu(weights, -0.1f, 0.1f);
+        randu(bias, -1.0f, 1.0f);
+        lp.blobs.push_back(weights);
+        lp.blobs.push_back(bias);
+        net.addLayerToPrev(lp.name, lp.type, lp);
+    }
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+
+    int sz[] = {3, 8, 9, 11};
+    std::vector<Mat> calibData(4);
+    for (size_t i = 0; i < calibData.size(); i++)
+    {
+        calibData[i].create(4, &sz[0], CV_32F);
+        randu(calibData[i], 0.0f, 1.0f);
+    }
+    Mat input(4, &sz[0], CV_32F);
+    randu(input, 0.0f, 1.0f);
+
+    net.setInput(input);
+    Mat ref = net.forward().clone();
+
+    net.quantize(calibData);
+    net.setInput(input);
+    Mat out = net.forward().clone();
+    EXPECT_LE(cvtest::norm(ref, out, NORM_L2), 0.02 * cvtest::norm(ref, NORM_L2));
+
+    net.quantize(std::vector<Mat>());
+    net.setInput(input);
+    normAssert(ref, net.forward());
+}
+
 typedef testing::TestWithParam<tuple<bool, tuple<Backend, Target> > > Layer_Test_Eltwise_unequal;
 TEST_P(Layer_Test_Eltwise_unequal, Accuracy)
 {
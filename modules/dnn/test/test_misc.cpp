@@ -9,6 +9,11 @@
 #include <opencv2/core/ocl.hpp>
 #include <opencv2/core/opencl/ocl_defs.hpp>
 #include <opencv2/dnn/layer.details.hpp>  // CV_DNN_REGISTER_LAYER_CLASS
+#include <opencv2/dnn/shape_utils.hpp>
+
+#ifdef CV_CXX11
+#include <thread>
+#endif
 
 namespace opencv_test { namespace {
 
@@ -39,6 +44,111 @@ TEST(blobFromImage, allocated)
     ASSERT_EQ(blobData, blob.data);
 }
 
+// Reference implementation: resize, crop, convert, normalize and split the image step by step.
+static Mat blobFromImageRef(Mat img, double scalefactor, Size size, Scalar mean, bool swapRB, bool crop, int ddepth)
+{
+    if (img.size() != size)
+    {
+        if (crop)
+        {
+            float resizeFactor = std::max(size.width / (float)img.cols, size.height / (float)img.rows);
+            resize(img, img, Size(), resizeFactor, resizeFactor, INTER_LINEAR);
+            img = img(Rect(Point(0.5 * (img.cols - size.width), 0.5 * (img.rows - size.height)), size));
+        }
+        else
+            resize(img, img, size, 0, 0, INTER_LINEAR);
+    }
+    img.convertTo(img, ddepth);
+    if (swapRB)
+        std::swap(mean[0], mean[2]);
+    img -= mean;
+    img *= scalefactor;
+
+    int nch = img.channels();
+    int sz[] = {1, nch, size.height, size.width};
+    Mat blob(4, sz, ddepth);
+    std::vector<Mat> ch(nch);
+    for (int j = 0; j < nch; j++)
+        ch[j] = Mat(size, ddepth, blob.ptr(0, j));
+    if (swapRB && nch >= 3)
+        std::swap(ch[0], ch[2]);
+    split(img, ch);
+    return blob;
+}
+
+TEST(blobFromImages, fused)
+{
+    const Size sizes[] = {Size(37, 29), Size(64, 48), Size(21, 53)};
+    const int types[][2] = {{CV_8U, CV_32F}, {CV_32F, CV_32F}, {CV_8U, CV_8U}};
+    const int channels[] = {1, 3, 4};
+    for (int t = 0; t < 3; t++)
+    for (int c = 0; c < 3; c++)
+    for (int mode = 0; mode < 4; mode++)
+    {
+        int depth = types[t][0], ddepth = types[t][1], nch = channels[c];
+        bool swapRB = (mode & 1) != 0, crop = (mode & 2) != 0;
+        SCOPED_TRACE(cv::format("depth=%d ddepth=%d nch=%d swapRB=%d crop=%d", depth, ddepth, nch, swapRB, crop));
+        double scale = ddepth == CV_8U ? 1.0 : 1.0 / 57;
+        Scalar mean = ddepth == CV_8U ? Scalar() : Scalar(104, 117, 123, 50);
+
+        std::vector<Mat> images(3);
+        for (int i = 0; i < 3; i++)
+        {
+            images[i].create(sizes[i], CV_MAKETYPE(depth, nch));
+            randu(images[i], 0, 256);
+        }
+        Size size(46, 34);
+        Mat blob = blobFromImages(images, scale, size, mean, swapRB, crop, ddepth);
+        ASSERT_EQ(shape(3, nch, size.height, size.width), shape(blob));
+        ASSERT_EQ(ddepth, blob.depth());
+        for (int i = 0; i < 3; i++)
+        {
+            Mat ref = blobFromImageRef(images[i], scale, size, mean, swapRB, crop, ddepth);
+            Mat out(4, &ref.size[0], ddepth, blob.ptr(i));
+            EXPECT_EQ(0, cvtest::norm(ref, out, NORM_INF)) << "image " << i;
+        }
+    }
+}
+
+TEST(blobFromImageWithParams, letterbox_NHWC)
+{
+    Mat img(30, 80, CV_8UC3);
+    randu(img, 0, 256);
+    Size size(64, 64);
+    Scalar mean(0.485 * 255, 0.456 * 255, 0.406 * 255);
+    Scalar scale(1 / (0.229 * 255), 1 / (0.224 * 255), 1 / (0.225 * 255));
+    Scalar border(114, 114, 114);
+
+    // Image fits the width: 80x30 -> 64x24 padded by 20 rows at the top and at the bottom.
+    Mat padded;
+    resize(img, padded, Size(64, 24), 0, 0, INTER_LINEAR);
+    cv::copyMakeBorder(padded, padded, 20, 20, 0, 0, BORDER_CONSTANT, border);
+    padded.convertTo(padded, CV_32F);
+    std::vector<Mat> ch;
+    split(padded, ch);
+
+    // With swapRB mean and scale are given in the order of the output channels.
+    Image2BlobParams param(scale, size, mean, true, CV_32F, DNN_LAYOUT_NCHW, DNN_PMODE_LETTERBOX, border);
+    Mat nchw = blobFromImageWithParams(img, param);
+    ASSERT_EQ(shape(1, 3, 64, 64), shape(nchw));
+    for (int k = 0; k < 3; k++)
+    {
+        Mat ref = (ch[2 - k] - mean[k]) * scale[k];
+        Mat plane(size, CV_32F, nchw.ptr(0, k));
+        EXPECT_LE(cvtest::norm(ref, plane, NORM_INF), 1e-5) << "channel " << k;
+    }
+
+    param.datalayout = DNN_LAYOUT_NHWC;
+    param.swapRB = false;
+    Mat nhwc = blobFromImageWithParams(img, param);
+    ASSERT_EQ(shape(1, 64, 64, 3), shape(nhwc));
+    for (int k = 0; k < 3; k++)
+        ch[k] = (ch[k] - mean[k]) * scale[k];
+    Mat interleaved;
+    merge(ch, interleaved);
+    EXPECT_LE(cvtest::norm(interleaved.reshape(1, 1), Mat(1, (int)nhwc.total(), CV_32F, nhwc.ptr()), NORM_INF), 1e-5);
+}
+
 TEST(imagesFromBlob, Regression)
 {
     int nbOfImages = 8;
@@ -362,9 +472,664 @@ TEST(Net, forwardAndRetrieve)
     normAssert(outBlobs[0][1], inp.rowRange(2, 4), "second part");
 }
 
-#ifdef HAVE_INF_ENGINE
+static int addConv1x1Layer(Net& net, const String& name, int inpId, int inpChannels)
+{
+    int weightsShape[] = {4, inpChannels, 1, 1};
+    LayerParams lp;
+    lp.set("kernel_size", 1);
+    lp.set("num_output", 4);
+    lp.set("bias_term", false);
+    lp.blobs.push_back(Mat(4, &weightsShape[0], CV_32F));
+    randu(lp.blobs[0], -1.0f, 1.0f);
+    int id = net.addLayer(name, "Convolution", lp);
+    net.connect(inpId, 0, id, 0);
+    return id;
+}
+
+// Random graph of convolutions, activations, sums and concatenations
+static Net createRandomNet(RNG& rng, std::vector<String>& names)
+{
+    Net net;
+    std::vector<int> nodes(1, 0);
+    std::vector<int> channels(1, 4);
+    names.clear();
+    for (int i = 0; i < 12; i++)
+    {
+        String name = cv::format("layer%d", i);
+        int type = rng.uniform(0, 4);
+        int a = rng.uniform(0, (int)nodes.size()), b = rng.uniform(0, (int)nodes.size());
+        int id, outChannels = 4;
+        if (type == 0 || (type >= 2 && channels[a] != channels[b]))
+            id = addConv1x1Layer(net, name, nodes[a], channels[a]);
+        else
+        {
+            LayerParams lp;
+            if (type == 1)
+                id = net.addLayer(name, "ReLU", lp);
+            else if (type == 2)
+                id = net.addLayer(name, "Eltwise", lp);
+            else
+            {
+                lp.set("axis", 1);
+                id = net.addLayer(name, "Concat", lp);
+                outChannels = channels[a] + channels[b];
+            }
+            net.connect(nodes[a], 0, id, 0);
+            if (type >= 2)
+                net.connect(nodes[b], 0, id, 1);
+        }
+        nodes.push_back(id);
+        channels.push_back(outChannels);
+        names.push_back(name);
+    }
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    return net;
+}
+
+// The memory of the blobs is shared between the layers, so every layer output
+// is compared with the one computed when all of them are kept.
+TEST(Net, memoryPlanner)
+{
+    RNG& rng = theRNG();
+    for (int iter = 0; iter < 20; iter++)
+    {
+        SCOPED_TRACE(cv::format("iteration %d", iter));
+        std::vector<String> names;
+        Net net = createRandomNet(rng, names);
+
+        int inputShape[] = {1, 4, 13, 17};
+        Mat input(4, &inputShape[0], CV_32F);
+        randu(input, -1.0f, 1.0f);
+        net.setInput(input);
+        std::vector<Mat> refs;
+        net.forward(refs, names);
+
+        for (size_t i = 0; i < names.size(); i++)
+        {
+            net.setInput(input);
+            Mat out = net.forward(names[i]);
+            normAssert(refs[i], out, names[i].c_str(), 0, 0);
+        }
+
+        size_t planned = 0, naive = 0;
+        net.getBlobsMemory(planned, naive);
+        EXPECT_GT(planned, (size_t)0);
+        EXPECT_LE(planned, naive);
+    }
+}
+
+TEST(Net, memoryPlanner_chain)
+{
+    Net net;
+    int id = 0;
+    for (int i = 0; i < 6; i++)
+    {
+        int convId = addConv1x1Layer(net, cv::format("conv%d", i), id, 4);
+        LayerParams lp;
+        id = net.addLayer(cv::format("relu%d", i), "ReLU", lp);
+        net.connect(convId, 0, id, 0);
+    }
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+
+    int inputShape[] = {1, 4, 16, 16};
+    net.setInput(Mat(4, &inputShape[0], CV_32F, Scalar(1)));
+    net.forward();
+
+    // two blobs are enough: the input and the output of a convolution
+    size_t blobSize = 4*16*16*sizeof(float);
+    size_t planned = 0, naive = 0;
+    net.getBlobsMemory(planned, naive);
+    EXPECT_EQ(2*blobSize, planned);
+    EXPECT_EQ(12*blobSize, naive);
+}
+
+// The results are compared with the ones of the same network which is set up for every shape.
+// A kept set up is recognized by the memory of the output.
+TEST(Net, planCache)
+{
+    RNG& rng = theRNG();
+    for (int iter = 0; iter < 10; iter++)
+    {
+        SCOPED_TRACE(cv::format("iteration %d", iter));
+        std::vector<String> names;
+        uint64 state = rng.state;
+        Net ref = createRandomNet(rng, names);
+        rng.state = state;
+        Net net = createRandomNet(rng, names);
+        net.setPlanCacheSize(2);
+
+        // the kernel of global pooling depends on the input shape
+        LayerParams lp;
+        lp.set("pool", "ave");
+        lp.set("global_pooling", true);
+        ref.addLayerToPrev("pool", "Pooling", lp);
+        net.addLayerToPrev("pool", "Pooling", lp);
+
+        // the set up for the previous use of the width is kept or not
+        const int widths[] = {17, 9, 17, 9, 23, 17, 23, 17};
+        const int kept[] = {-1, -1, 1, 1, -1, 0, 1, 0};
+        std::map<int, Mat> outs;
+        for (int i = 0; i < 8; i++)
+        {
+            if (i == 7)
+                net.setPlanCacheSize(1);
+            int inputShape[] = {1, 4, 13, widths[i]};
+            Mat input(4, &inputShape[0], CV_32F);
+            randu(input, -1.0f, 1.0f);
+            ref.setInput(input);
+            Mat refOut = ref.forward();
+            net.setInput(input);
+            Mat out = net.forward();
+            normAssert(refOut, out, cv::format("step %d", i).c_str(), 0, 0);
+            if (kept[i] >= 0)
+            {
+                EXPECT_EQ(kept[i] != 0, outs[widths[i]].data == out.data) << "step " << i;
+            }
+            outs[widths[i]] = out;
+        }
+    }
+}
+
+// The bound blob is refilled in place, the results are compared with the ones of setInput().
+TEST(Net, bindInput)
+{
+    RNG& rng = theRNG();
+    for (int iter = 0; iter < 10; iter++)
+    {
+        SCOPED_TRACE(cv::format("iteration %d", iter));
+        std::vector<String> names;
+        uint64 state = rng.state;
+        Net ref = createRandomNet(rng, names);
+        rng.state = state;
+        Net net = createRandomNet(rng, names);
+        net.setPlanCacheSize(2);
+
+        const int widths[] = {17, 17, 9, 17};
+        for (int i = 0; i < 4; i++)
+        {
+            SCOPED_TRACE(cv::format("width %d", widths[i]));
+            int inputShape[] = {1, 4, 13, widths[i]};
+            Mat input(4, &inputShape[0], CV_32F);
+            net.bindInput(input);
+            for (int frame = 0; frame < 2; frame++)
+            {
+                randu(input, -1.0f, 1.0f);
+                Mat inputCopy = input.clone();
+                ref.setInput(input);
+                Mat refOut = ref.forward();
+                normAssert(refOut, net.forward(), "", 0, 0);
+                normAssert(inputCopy, input, "input", 0, 0);
+            }
+        }
+
+        // the blob is converted
+        int inputShape[] = {1, 4, 13, 17};
+        Mat input(4, &inputShape[0], CV_8U);
+        net.bindInput(input, "", 0.5, Scalar(2, 3, 4, 5));
+        for (int frame = 0; frame < 2; frame++)
+        {
+            randu(input, 0, 256);
+            Mat inputCopy = input.clone();
+            ref.setInput(input, "", 0.5, Scalar(2, 3, 4, 5));
+            Mat refOut = ref.forward();
+            normAssert(refOut, net.forward(), "8U", 0, 0);
+            normAssert(inputCopy, input, "8U input", 0, 0);
+        }
+
+        // setInput() copies the blob and doesn't write to the bound one
+        Mat bound(4, &inputShape[0], CV_32F);
+        randu(bound, -1.0f, 1.0f);
+        net.bindInput(bound);
+        net.forward();
+        Mat boundCopy = bound.clone();
+        Mat input2(4, &inputShape[0], CV_32F);
+        randu(input2, -1.0f, 1.0f);
+        net.setInput(input2);
+        bound.setTo(0);
+        ref.setInput(input2);
+        Mat refOut = ref.forward();
+        normAssert(refOut, net.forward(), "setInput", 0, 0);
+        EXPECT_EQ(0, cvtest::norm(bound, NORM_INF));
+        boundCopy.copyTo(bound);
+        net.setInput(bound);
+        ref.setInput(bound);
+        refOut = ref.forward();
+        normAssert(refOut, net.forward(), "setInput after bindInput", 0, 0);
+    }
+}
+
+TEST(Net, forwardInto)
+{
+    RNG& rng = theRNG();
+    std::vector<String> names;
+    Net net = createRandomNet(rng, names);
+
+    int inputShape[] = {1, 4, 13, 17};
+    Mat input(4, &inputShape[0], CV_32F);
+    randu(input, -1.0f, 1.0f);
+    net.setInput(input);
+    std::vector<Mat> refs;
+    net.forward(refs, names);
+    for (size_t i = 0; i < refs.size(); i++)
+        refs[i] = refs[i].clone();
+
+    // the last blob is allocated
+    std::vector<Mat> outs(names.size());
+    std::vector<uchar*> outsData(names.size());
+    for (size_t i = 0; i + 1 < names.size(); i++)
+    {
+        outs[i].create(refs[i].dims, refs[i].size.p, CV_32F);
+        outsData[i] = outs[i].data;
+    }
+    net.setInput(input);
+    net.forwardInto(outs, names);
+    ASSERT_EQ(names.size(), outs.size());
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        normAssert(refs[i], outs[i], names[i].c_str(), 0, 0);
+        if (i + 1 < names.size())
+        {
+            EXPECT_EQ(outsData[i], outs[i].data) << names[i];
+        }
+    }
+
+    // the outputs are not changed by the next forward pass
+    net.setInput(Mat(4, &inputShape[0], CV_32F, Scalar(0)));
+    net.forward(names.back());
+    for (size_t i = 0; i < names.size(); i++)
+        normAssert(refs[i], outs[i], names[i].c_str(), 0, 0);
+}
+
+TEST(Net, concurrentBranches)
+{
+    // the layers are small, so the ready ones are computed at the same time
+    int numThreads = getNumThreads();
+    setNumThreads(4);
+
+    RNG& rng = theRNG();
+    for (int iter = 0; iter < 20; iter++)
+    {
+        SCOPED_TRACE(cv::format("iteration %d", iter));
+        std::vector<String> names;
+        Net net = createRandomNet(rng, names);
+
+        int inputShape[] = {1, 4, 13, 17};
+        Mat input(4, &inputShape[0], CV_32F);
+        randu(input, -1.0f, 1.0f);
+        net.setInput(input);
+        std::vector<Mat> refs;
+        net.forward(refs, names);
+        for (size_t i = 0; i < refs.size(); i++)
+            refs[i] = refs[i].clone();
+
+        net.enableConcurrentBranches(true);
+        net.setInput(input);
+        normAssert(refs.back(), net.forward(), "", 0, 0);
+
+        std::vector<Mat> outs;
+        net.forward(outs, names);
+        ASSERT_EQ(refs.size(), outs.size());
+        for (size_t i = 0; i < names.size(); i++)
+        {
+            normAssert(refs[i], outs[i], names[i].c_str(), 0, 0);
+
+            net.setInput(input);
+            normAssert(refs[i], net.forward(names[i]), names[i].c_str(), 0, 0);
+        }
+
+        std::vector<double> timings;
+        EXPECT_GT(net.getPerfProfile(timings), 0);
+    }
+
+    setNumThreads(numThreads);
+}
+
+// Branches of different depth joined by a sum
+static Net createBranchesNet()
+{
+    Net net;
+    int longId = 0, shortId = 0;
+    for (int i = 0; i < 4; i++)
+        longId = addConv1x1Layer(net, cv::format("long%d", i), longId, 4);
+    for (int i = 0; i < 2; i++)
+        shortId = addConv1x1Layer(net, cv::format("short%d", i), shortId, 4);
+    LayerParams lp;
+    int sumId = net.addLayer("sum", "Eltwise", lp);
+    net.connect(longId, 0, sumId, 0);
+    net.connect(shortId, 0, sumId, 1);
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    return net;
+}
+
+// The calibration computes the layers in the order they are allocated in: with the concurrent
+// branches the blobs share memory by the depth of the layers in the graph, not by their ids.
+TEST(Net, quantize_concurrentBranches)
+{
+    uint64 state = theRNG().state;
+    Net net = createBranchesNet();
+    theRNG().state = state;
+    Net concurrentNet = createBranchesNet();
+    concurrentNet.enableConcurrentBranches(true);
+
+    const int numInputs = 4;
+    int inputShape[] = {1, 4, 13, 17};
+    std::vector<Mat> inputs(numInputs);
+    for (int i = 0; i < numInputs; i++)
+    {
+        inputs[i].create(4, &inputShape[0], CV_32F);
+        randu(inputs[i], -1.0f, 1.0f);
+    }
+    net.setInput(inputs[0]);
+    Mat ref = net.forward().clone();
+
+    net.quantize(inputs);
+    concurrentNet.quantize(inputs);
+    net.setInput(inputs[0]);
+    Mat out = net.forward().clone();
+    concurrentNet.setInput(inputs[0]);
+    normAssert(out, concurrentNet.forward(), "", 0, 0);
+    EXPECT_LE(cv::norm(ref, out, NORM_INF), 0.1 * cv::norm(ref, NORM_INF));
+}
+
+#ifdef CV_CXX11
 static const std::chrono::milliseconds async_timeout(10000);
 
+static Net createConvReLUNet(const Mat& weights, const Mat& bias)
+{
+    Net net;
+    LayerParams lp;
+    lp.set("kernel_size", 3);
+    lp.set("pad", 1);
+    lp.set("num_output", weights.size[0]);
+    lp.type = "Convolution";
+    lp.name = "testConv";
+    lp.blobs.push_back(weights);
+    lp.blobs.push_back(bias);
+    net.addLayerToPrev(lp.name, lp.type, lp);
+
+    LayerParams lpr;
+    lpr.type = "ReLU";
+    lpr.name = "testReLU";
+    net.addLayerToPrev(lpr.name, lpr.type, lpr);
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    return net;
+}
+
+TEST(Net, forwardAsync_OpenCV)
+{
+    int weightsShape[] = {8, 3, 3, 3};
+    Mat weights(4, &weightsShape[0], CV_32F), bias(1, 8, CV_32F);
+    randu(weights, -1.0f, 1.0f);
+    randu(bias, -1.0f, 1.0f);
+
+    // inputs of two different shapes, some of them 8-bit
+    const int numInputs = 8;
+    std::vector<Mat> inputs(numInputs);
+    for (int i = 0; i < numInputs; ++i)
+    {
+        int blobSize[] = {1 + i % 2, 3, 17 + (i % 3 == 0)*6, 23};
+        inputs[i].create(4, &blobSize[0], i % 4 == 1 ? CV_8U : CV_32F);
+        randu(inputs[i], 0, 255);
+    }
+
+    Net netSync = createConvReLUNet(weights, bias);
+    std::vector<Mat> refs(numInputs);
+    for (int i = 0; i < numInputs; ++i)
+    {
+        netSync.setInput(inputs[i], "", 1.0/255, Scalar(i));
+        refs[i] = netSync.forward().clone();
+    }
+
+    // all the requests are submitted before any result is retrieved
+    Net netAsync = createConvReLUNet(weights, bias);
+    std::vector<AsyncArray> outs(numInputs);
+    for (int i = numInputs - 1; i >= 0; --i)
+    {
+        netAsync.setInput(inputs[i], "", 1.0/255, Scalar(i));
+        outs[i] = netAsync.forwardAsync();
+    }
+
+    for (int i = numInputs - 1; i >= 0; --i)
+    {
+        ASSERT_TRUE(outs[i].valid());
+        Mat result;
+        EXPECT_TRUE(outs[i].get(result, async_timeout));
+        normAssert(refs[i], result, format("Index: %d", i).c_str(), 0, 0);
+    }
+
+    // the inputs of the last setInput() call are still there
+    normAssert(refs[0], netAsync.forward(), "Synchronous forward", 0, 0);
+}
+
+TEST(Net, forwardAsync_concurrent)
+{
+    int weightsShape[] = {8, 3, 3, 3};
+    Mat weights(4, &weightsShape[0], CV_32F), bias(1, 8, CV_32F);
+    randu(weights, -1.0f, 1.0f);
+    randu(bias, -1.0f, 1.0f);
+
+    const int numInputs = 12;
+    std::vector<Mat> inputs(numInputs);
+    for (int i = 0; i < numInputs; ++i)
+    {
+        int blobSize[] = {2, 3, 41, 37};
+        inputs[i].create(4, &blobSize[0], CV_32F);
+        randu(inputs[i], -1.0f, 1.0f);
+    }
+
+    Net netSync = createConvReLUNet(weights, bias);
+    std::vector<Mat> refs(numInputs);
+    for (int i = 0; i < numInputs; ++i)
+    {
+        netSync.setInput(inputs[i]);
+        refs[i] = netSync.forward().clone();
+    }
+
+    // the requests of the same shapes are computed with each other and with forward()
+    Net netAsync = createConvReLUNet(weights, bias);
+    netAsync.setMaxAsyncRequests(3);
+    std::vector<AsyncArray> outs(numInputs);
+    for (int i = 0; i < numInputs; ++i)
+    {
+        netAsync.setInput(inputs[i]);
+        outs[i] = netAsync.forwardAsync();
+        if (i % 4 == 3)
+            normAssert(refs[i], netAsync.forward(), format("Synchronous, index: %d", i).c_str(), 0, 0);
+    }
+
+    for (int i = 0; i < numInputs; ++i)
+    {
+        ASSERT_TRUE(outs[i].valid());
+        Mat result;
+        EXPECT_TRUE(outs[i].get(result, async_timeout));
+        normAssert(refs[i], result, format("Index: %d", i).c_str(), 0, 0);
+    }
+
+    // the pending requests are computed before the fused activation is detached
+    for (int i = 0; i < numInputs; ++i)
+    {
+        netAsync.setInput(inputs[i]);
+        outs[i] = netAsync.forwardAsync();
+    }
+    netAsync.enableFusion(false);
+    for (int i = 0; i < numInputs; ++i)
+    {
+        Mat result;
+        EXPECT_TRUE(outs[i].get(result, async_timeout));
+        normAssert(refs[i], result, format("Unfused, index: %d", i).c_str(), 0, 0);
+    }
+}
+
+TEST(Net, cloneSharingWeights)
+{
+    // two branches joined by Concat, which is computed in-place by its inputs
+    Net net;
+    LayerParams lp;
+    lp.type = "Convolution";
+    int weightsShape[] = {4, 3, 3, 3};
+    Mat weights(4, &weightsShape[0], CV_32F);
+    randu(weights, -1.0f, 1.0f);
+    lp.set("kernel_size", 3);
+    lp.set("pad", 1);
+    lp.set("num_output", 4);
+    lp.set("bias_term", false);
+    lp.blobs.push_back(weights);
+    int conv1 = net.addLayer("conv1", lp.type, lp);
+    net.connect(0, 0, conv1, 0);
+
+    weightsShape[0] = 5;
+    weightsShape[2] = weightsShape[3] = 1;
+    lp.blobs[0] = Mat(4, &weightsShape[0], CV_32F);
+    randu(lp.blobs[0], -1.0f, 1.0f);
+    lp.set("kernel_size", 1);
+    lp.set("pad", 0);
+    lp.set("num_output", 5);
+    int conv2 = net.addLayer("conv2", lp.type, lp);
+    net.connect(0, 0, conv2, 0);
+
+    LayerParams lpc;
+    int concat = net.addLayer("concat", "Concat", lpc);
+    net.connect(conv1, 0, concat, 0);
+    net.connect(conv2, 0, concat, 1);
+    LayerParams lpr;
+    net.addLayerToPrev("relu", "ReLU", lpr);
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+
+    const int numNets = 3, numInputs = 4;
+    int inputShape[] = {2, 3, 19, 23};
+    std::vector<Mat> inputs(numInputs), refs(numInputs);
+    for (int i = 0; i < numInputs; i++)
+    {
+        inputs[i].create(4, &inputShape[0], CV_32F);
+        randu(inputs[i], -1.0f, 1.0f);
+        net.setInput(inputs[i]);
+        refs[i] = net.forward().clone();
+    }
+
+    std::vector<Net> nets(1, net);
+    for (int i = 1; i < numNets; i++)
+    {
+        nets.push_back(net.cloneSharingWeights());
+        EXPECT_EQ(net.getLayer(conv1), nets.back().getLayer(conv1));
+        // the copy gets the current inputs
+        normAssert(refs[numInputs - 1], nets.back().forward(), "Copy", 0, 0);
+    }
+
+    std::vector<std::vector<Mat> > outs(numNets, std::vector<Mat>(numInputs));
+    std::vector<std::thread> threads;
+    for (int k = 0; k < numNets; k++)
+    {
+        threads.push_back(std::thread([&, k]()
+        {
+            for (int i = 0; i < numInputs; i++)
+            {
+                int idx = (i + k) % numInputs;
+                nets[k].setInput(inputs[idx]);
+                outs[k][idx] = nets[k].forward().clone();
+            }
+        }));
+    }
+    for (int k = 0; k < numNets; k++)
+        threads[k].join();
+
+    for (int k = 0; k < numNets; k++)
+        for (int i = 0; i < numInputs; i++)
+            normAssert(refs[i], outs[k][i], format("Net: %d, input: %d", k, i).c_str(), 0, 0);
+
+    // the shared layers are set up for the current shapes only
+    inputShape[2] = 21;
+    nets[1].setInput(Mat(4, &inputShape[0], CV_32F, Scalar(0)));
+    EXPECT_THROW(nets[1].forward(), cv::Exception);
+}
+
+TEST(Net, cloneSharingWeights_setUp)
+{
+    int weightsShape[] = {8, 3, 3, 3};
+    Mat weights(4, &weightsShape[0], CV_32F), bias(1, 8, CV_32F);
+    randu(weights, -1.0f, 1.0f);
+    randu(bias, -1.0f, 1.0f);
+    int inputShape[] = {1, 3, 19, 23};
+    Mat input(4, &inputShape[0], CV_32F);
+    randu(input, -1.0f, 1.0f);
+
+    Net net = createConvReLUNet(weights, bias);
+    net.setInput(input);
+    Mat ref = net.forward().clone();
+    Net copy = net.cloneSharingWeights();
+
+    // the attempts to change the set up don't change the shared layers,
+    // e.g. the activation fused into the convolution
+    EXPECT_THROW(net.enableFusion(false), cv::Exception);
+    EXPECT_THROW(net.enableConcurrentBranches(true), cv::Exception);
+    EXPECT_THROW(copy.setPreferableBackend(DNN_BACKEND_HALIDE), cv::Exception);
+    EXPECT_THROW(copy.setPreferableTarget(DNN_TARGET_OPENCL), cv::Exception);
+    normAssert(ref, copy.forward(), "Copy", 0, 0);
+    normAssert(ref, net.forward(), "Source", 0, 0);
+}
+
+TEST(Net, cloneSharingWeights_int8)
+{
+    Net net;
+    LayerParams lp;
+    lp.type = "Convolution";
+    int weightsShape[] = {8, 3, 3, 3};
+    Mat weights(4, &weightsShape[0], CV_32F);
+    randu(weights, -1.0f, 1.0f);
+    lp.set("kernel_size", 3);
+    lp.set("pad", 1);
+    lp.set("num_output", 8);
+    lp.set("bias_term", false);
+    lp.blobs.push_back(weights);
+    net.addLayerToPrev("conv", lp.type, lp);
+    LayerParams lpr;
+    net.addLayerToPrev("relu", "ReLU", lpr);
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+
+    const int numNets = 3, numInputs = 4;
+    int inputShape[] = {2, 3, 19, 23};
+    std::vector<Mat> inputs(numInputs), refs(numInputs);
+    for (int i = 0; i < numInputs; i++)
+    {
+        inputs[i].create(4, &inputShape[0], CV_32F);
+        randu(inputs[i], -1.0f, 1.0f);
+    }
+    net.quantize(inputs);
+    for (int i = 0; i < numInputs; i++)
+    {
+        net.setInput(inputs[i]);
+        refs[i] = net.forward().clone();
+    }
+
+    // the quantized weights are shared by the copies and only read by forward()
+    std::vector<Net> nets(1, net);
+    for (int i = 1; i < numNets; i++)
+        nets.push_back(net.cloneSharingWeights());
+
+    std::vector<std::vector<Mat> > outs(numNets, std::vector<Mat>(numInputs));
+    std::vector<std::thread> threads;
+    for (int k = 0; k < numNets; k++)
+    {
+        threads.push_back(std::thread([&, k]()
+        {
+            for (int i = 0; i < numInputs; i++)
+            {
+                int idx = (i + k) % numInputs;
+                nets[k].setInput(inputs[idx]);
+                outs[k][idx] = nets[k].forward().clone();
+            }
+        }));
+    }
+    for (int k = 0; k < numNets; k++)
+        threads[k].join();
+
+    for (int k = 0; k < numNets; k++)
+        for (int i = 0; i < numInputs; i++)
+            normAssert(refs[i], outs[k][i], format("Net: %d, input: %d", k, i).c_str(), 0, 0);
+}
+#endif  // CV_CXX11
+
+#ifdef HAVE_INF_ENGINE
+
 // This test runs network in synchronous mode for different inputs and then
 // runs the same model asynchronously for the same inputs.
 typedef testing::TestWithParam<tuple<int, Target> > Async;
@@ -1449,6 +1449,30 @@ CV_EXPORTS_W void bilateralFilter( InputArray src, OutputArray dst, int d,
                                    double sigmaColor, double sigmaSpace,
                                    int borderType = BORDER_DEFAULT );
 
+/** @brief Applies a fast approximation of the bilateral filter.
+
+The function implements the bilateral grid of @cite Paris2006 . The pixels are accumulated into a
+coarse 3D grid (x, y, intensity) with one cell per sigmaSpace pixels and per sigmaColor intensity
+levels, the grid is smoothed with a small Gaussian kernel and the result is read back with trilinear
+interpolation. Unlike bilateralFilter, the processing time does not grow with the filter size, so
+the function is much faster for large sigmaSpace values (roughly sigmaSpace \> 4). For small sigma
+values the grid becomes large: if it would take more than 256 MB, the function calls
+bilateralFilter with the same sigmas instead.
+
+Color images are filtered channel by channel, each channel uses its own values as the range
+component. Unlike bilateralFilter, an edge which is seen in some of the channels only doesn't stop
+the smoothing of the other ones, where it doesn't change the values.
+
+@param src Source 8-bit or floating-point, 1-channel or 3-channel image.
+@param dst Destination image of the same size and type as src .
+@param sigmaColor Filter sigma in the color space, see bilateralFilter.
+@param sigmaSpace Filter sigma in the coordinate space, see bilateralFilter. Values less than 1 are
+treated as 1.
+@sa bilateralFilter
+ */
+CV_EXPORTS_W void approxBilateralFilter( InputArray src, OutputArray dst,
+                                         double sigmaColor, double sigmaSpace );
+
 /** @brief Blurs an image using the box filter.
 
 The function smooths an image using the kernel:
@@ -1557,6 +1581,25 @@ CV_EXPORTS_W void filter2D( InputArray src, OutputArray dst, int ddepth,
                             InputArray kernel, Point anchor = Point(-1,-1),
                             double delta = 0, int borderType = BORDER_DEFAULT );
 
+/** @brief Convolves an image with a bank of kernels.
+
+The function computes the response of the image to every kernel of the bank, as #filter2D with the
+kernel anchor at the kernel center would do. Small kernels are applied in the spatial domain. The
+large ones are applied in the frequency domain, where the spectrum of the extrapolated image is
+computed once and multiplied by the spectrum of every kernel (see #dft and #mulSpectrums ). The
+responses are computed in parallel. The bank can be built, for example, with #getGaborKernel .
+
+@param src Input single-channel image.
+@param kernels Vector of single-channel floating-point kernels.
+@param dst Output vector of the responses, one per kernel, of the same size as src and the depth
+ddepth.
+@param ddepth Depth of the responses, CV_32F or CV_64F .
+@param borderType Pixel extrapolation method, see #BorderTypes. #BORDER_WRAP is not supported.
+@sa filter2D, getGaborKernel
+ */
+CV_EXPORTS_W void filterBank( InputArray src, InputArrayOfArrays kernels, OutputArrayOfArrays dst,
+                              int ddepth = CV_32F, int borderType = BORDER_DEFAULT );
+
 /** @brief Applies a separable linear filter to an image.
 
 The function applies a separable linear filter to the image. That is, first, every row of src is
@@ -1956,6 +1999,39 @@ CV_EXPORTS_W void goodFeaturesToTrack( InputArray image, OutputArray corners,
                                      InputArray mask, int blockSize,
                                      int gradientSize, bool useHarrisDetector = false,
                                      double k = 0.04 );
+
+/** @brief Determines strong corners evenly distributed over the image.
+
+The function works like #goodFeaturesToTrack , but the image is divided into
+gridSize.width x gridSize.height equal cells and at most maxCornersPerCell corners are retained in
+each cell, so the features are not concentrated in the most textured regions of the image. The
+corners are still selected in the descending order of the quality measure, and qualityLevel and
+minDistance are applied to the whole image.
+
+@param image Input 8-bit or floating-point 32-bit, single-channel image.
+@param corners Output vector of detected corners, sorted by the quality measure in the descending
+order.
+@param gridSize Number of cells along the x and y axes.
+@param maxCornersPerCell Maximum number of corners to return from one cell.
+@param qualityLevel Minimal accepted quality of image corners, see #goodFeaturesToTrack .
+@param minDistance Minimum possible Euclidean distance between the returned corners.
+@param mask Optional region of interest, see #goodFeaturesToTrack .
+@param blockSize Size of an average block for computing a derivative covariation matrix over each
+pixel neighborhood. See cornerEigenValsAndVecs .
+@param gradientSize Aperture parameter for the Sobel operator.
+@param useHarrisDetector Parameter indicating whether to use a Harris detector (see #cornerHarris)
+or #cornerMinEigenVal.
+@param k Free parameter of the Harris detector.
+
+@sa goodFeaturesToTrack
+ */
+CV_EXPORTS_W void goodFeaturesToTrackGrid( InputArray image, OutputArray corners,
+                                           Size gridSize, int maxCornersPerCell,
+                                           double qualityLevel, double minDistance,
+                                           InputArray mask = noArray(), int blockSize = 3,
+                                           int gradientSize = 3, bool useHarrisDetector = false,
+                                           double k = 0.04 );
+
 /** @example samples/cpp/tutorial_code/ImgTrans/houghlines.cpp
 An example using the Hough line detector
 ![Sample input image](Hough_Lines_Tutorial_Original_Image.jpg) ![Output image](Hough_Lines_Tutorial_Result.jpg)
@@ -2364,6 +2440,83 @@ CV_EXPORTS_W void convertMaps( InputArray map1, InputArray map2,
                                OutputArray dstmap1, OutputArray dstmap2,
                                int dstmap1type, bool nninterpolation = false );
 
+/** @brief Precomputed affine or perspective warp for a fixed transformation.
+
+warpAffine and warpPerspective compute the source coordinates of every destination pixel on each
+call. When the same transformation is applied to many frames (video stabilization, rectification),
+the coordinates can be computed once and stored as fixed-point maps (see convertMaps), so that each
+subsequent call reduces to the fastest remap kernel.
+
+The result of apply() is bit-exact with warpAffine / warpPerspective called with the same
+parameters, except for the builds where those functions are dispatched to IPP or to a custom HAL.
+
+The maps take 4 (#INTER_NEAREST) or 6 (other modes) bytes per destination pixel. When they would
+exceed the memory budget given to the plan, only the inverse transformation is stored and the
+coordinates are computed on the fly, which costs the same as warpAffine / warpPerspective.
+
+@code{.cpp}
+WarpPlan plan;
+plan.initAffine(M, frameSize, INTER_LINEAR);
+for (;;)
+{
+    cap >> frame;
+    plan.apply(frame, stabilized);
+}
+@endcode
+
+@sa warpAffine, warpPerspective, remap
+ */
+class CV_EXPORTS WarpPlan
+{
+public:
+    WarpPlan();
+
+    /** @brief Prepares the plan for warpAffine.
+
+    @param M \f$2\times 3\f$ transformation matrix.
+    @param dsize Size of the output image.
+    @param flags Combination of interpolation methods (see #InterpolationFlags) and the optional
+    flag #WARP_INVERSE_MAP, the same as in warpAffine.
+    @param maxMapBytes Memory budget for the precomputed maps. 0 means no maps are stored.
+     */
+    void initAffine(InputArray M, Size dsize, int flags = INTER_LINEAR,
+                    size_t maxMapBytes = (size_t)-1);
+
+    /** @brief Prepares the plan for warpPerspective.
+
+    @param M \f$3\times 3\f$ transformation matrix.
+    @param dsize Size of the output image.
+    @param flags Combination of interpolation methods (see #InterpolationFlags) and the optional
+    flag #WARP_INVERSE_MAP, the same as in warpPerspective.
+    @param maxMapBytes Memory budget for the precomputed maps. 0 means no maps are stored.
+     */
+    void initPerspective(InputArray M, Size dsize, int flags = INTER_LINEAR,
+                         size_t maxMapBytes = (size_t)-1);
+
+    /** @brief Warps the image using the planned transformation.
+
+    @param src Input image. Its size may differ between the calls.
+    @param dst Output image of the planned size and the same type as src.
+    @param borderMode Pixel extrapolation method (#BORDER_CONSTANT or #BORDER_REPLICATE etc.).
+    @param borderValue Value used in case of a constant border; by default, it equals 0.
+     */
+    void apply(InputArray src, OutputArray dst, int borderMode = BORDER_CONSTANT,
+               const Scalar& borderValue = Scalar()) const;
+
+    /** @brief Returns true if the coordinates are precomputed. */
+    bool hasMaps() const;
+
+    /** @brief Returns the memory occupied by the precomputed maps, in bytes. */
+    size_t mapBytes() const;
+
+    /** @brief Returns true if the plan is not initialized. */
+    bool empty() const;
+
+    struct Impl;
+protected:
+    Ptr<Impl> p;
+};
+
 /** @brief Calculates an affine matrix of 2D rotation.
 
 The function calculates the following matrix:
@@ -2955,6 +3108,26 @@ same as src. dst[1] is the next pyramid layer, a smoothed and down-sized src, an
 CV_EXPORTS void buildPyramid( InputArray src, OutputArrayOfArrays dst,
                               int maxlevel, int borderType = BORDER_DEFAULT );
 
+/** @brief Constructs the Gaussian pyramid and, optionally, the Laplacian pyramid of an image.
+
+The function is an optimized version of buildPyramid followed by
+\f[\texttt{laplacian[i]} = \texttt{gaussian[i]} - \texttt{pyrUp(gaussian[i+1])}, \quad i < \texttt{maxlevel}\f]
+It produces the same results, but all the levels of each pyramid are allocated in one buffer and
+every pass over a Gaussian level computes both the next Gaussian level and the Laplacian level
+above it, in horizontal stripes processed in parallel. The top of the Laplacian pyramid,
+`laplacian[maxlevel]`, is the smallest Gaussian level.
+
+@param src Source image. Check pyrDown for the list of supported types.
+@param gaussian Destination vector of maxlevel+1 images of the same type as src, see buildPyramid.
+@param laplacian Destination vector of maxlevel+1 images with the same number of channels as src.
+Their depth is CV_16S for CV_8U images, CV_32F for CV_16U and CV_16S images and the depth of src
+otherwise. Pass noArray() to build the Gaussian pyramid only.
+@param maxlevel 0-based index of the last (the smallest) pyramid layer. It must be non-negative.
+@param borderType Pixel extrapolation method used by pyrDown, see #BorderTypes (#BORDER_CONSTANT isn't supported)
+ */
+CV_EXPORTS void buildPyramid( InputArray src, OutputArrayOfArrays gaussian, OutputArrayOfArrays laplacian,
+                              int maxlevel, int borderType = BORDER_DEFAULT );
+
 //! @} imgproc_filter
 
 //! @addtogroup imgproc_transform
@@ -3632,6 +3805,103 @@ CV_EXPORTS_W int floodFill( InputOutputArray image, InputOutputArray mask,
 //! @param dst It is created if it does not have the same size and type with src1.
 CV_EXPORTS void blendLinear(InputArray src1, InputArray src2, InputArray weights1, InputArray weights2, OutputArray dst);
 
+/** @brief Provider of image tiles for TiledPipeline.
+
+Implementations read the requested rectangle of a large image, for example from a tiled TIFF file
+or a slide scanner format. TiledPipeline never calls read() concurrently.
+ */
+class CV_EXPORTS TileSource
+{
+public:
+    virtual ~TileSource();
+    //! size of the whole image
+    virtual Size size() const = 0;
+    //! type of the image, e.g. CV_8UC3
+    virtual int type() const = 0;
+    /** @brief Reads the rectangle roi (lying inside the image) into dst. */
+    virtual void read(const Rect& roi, OutputArray dst) = 0;
+};
+
+/** @brief Consumer of the image tiles produced by TiledPipeline.
+
+TiledPipeline never calls write() concurrently. The tiles may be written in any order.
+ */
+class CV_EXPORTS TileSink
+{
+public:
+    virtual ~TileSink();
+    /** @brief Stores the tile covering the rectangle roi of the output image. */
+    virtual void write(const Rect& roi, InputArray tile) = 0;
+};
+
+/** @brief Tile-based executor of image processing chains for images that do not fit into memory.
+
+The pipeline is a chain of operations (filters, morphology, threshold, resize, color conversion)
+applied to an image provided by a TileSource. The output image is split into tiles; for every tile
+the pipeline computes the region of the source image that influences it by propagating the halo
+(the neighborhood size) of each operation backwards through the chain, reads that region, runs the
+chain on it and passes the tile to a TileSink. Tiles are processed in parallel, so the peak memory
+consumption is bounded by the number of threads times the size of a tile with its halos.
+
+For filters, morphology, threshold and color conversions the result is identical to running the
+same functions on the whole image. Resize with #INTER_NEAREST matches cv::resize exactly, #INTER_AREA
+is supported for integer downscaling factors and matches cv::resize exactly as well; the other
+interpolation methods use the same pixel mapping as cv::resize and the fixed-point precision of
+remap.
+
+@code{.cpp}
+TiledPipeline pipeline;
+pipeline.GaussianBlur(Size(5, 5), 1.5)
+        .resize(0.25, 0.25, INTER_AREA)
+        .cvtColor(COLOR_BGR2GRAY)
+        .threshold(128, 255, THRESH_BINARY);
+pipeline.run(*slideReader, *tiffWriter);
+@endcode
+ */
+class CV_EXPORTS TiledPipeline
+{
+public:
+    TiledPipeline();
+
+    //! appends cv::filter2D with the default anchor
+    TiledPipeline& filter2D(int ddepth, InputArray kernel, double delta = 0,
+                            int borderType = BORDER_DEFAULT);
+    //! appends cv::GaussianBlur
+    TiledPipeline& GaussianBlur(Size ksize, double sigmaX, double sigmaY = 0,
+                                int borderType = BORDER_DEFAULT);
+    //! appends cv::boxFilter with the default anchor
+    TiledPipeline& boxFilter(int ddepth, Size ksize, bool normalize = true,
+                             int borderType = BORDER_DEFAULT);
+    //! appends cv::morphologyEx with the default anchor
+    TiledPipeline& morphologyEx(int op, InputArray kernel, int iterations = 1,
+                                int borderType = BORDER_CONSTANT,
+                                const Scalar& borderValue = morphologyDefaultBorderValue());
+    //! appends cv::threshold; #THRESH_OTSU and #THRESH_TRIANGLE need the whole image and are not supported
+    TiledPipeline& threshold(double thresh, double maxval, int type);
+    //! appends cv::resize with the given scale factors
+    TiledPipeline& resize(double fx, double fy, int interpolation = INTER_LINEAR);
+    //! appends cv::cvtColor; only the pixel-wise conversions that keep the image size are supported
+    TiledPipeline& cvtColor(int code, int dstCn = 0);
+
+    /** @brief Sets the size of the output tiles. The default is 512x512. */
+    void setTileSize(Size tileSize);
+    Size getTileSize() const;
+
+    /** @brief Returns the size of the output image for the given input size. */
+    Size outputSize(Size inputSize) const;
+    /** @brief Returns the type of the output image for the given input type. */
+    int outputType(int inputType) const;
+
+    /** @brief Runs the pipeline reading the input from src and writing the output tiles to dst. */
+    void run(TileSource& src, TileSink& dst) const;
+    /** @overload Processes an in-memory image tile by tile. */
+    void run(InputArray src, OutputArray dst) const;
+
+    struct Impl;
+protected:
+    Ptr<Impl> p;
+};
+
 //! @} imgproc_misc
 
 //! @addtogroup imgproc_color_conversions
@@ -4149,6 +4419,53 @@ without self-intersections. Otherwise, the function output is undefined.
  */
 CV_EXPORTS_W bool isContourConvex( InputArray contour );
 
+/** @brief Computes shape descriptors of many contours at once.
+
+The function computes the requested descriptors of all contours in parallel and stores them in
+packed arrays with one row per contour, in the order of the input contours. The values are the same
+as the ones returned by #contourArea , #boundingRect , #minAreaRect and #moments called for each
+contour. The descriptors of empty contours are zeros. Pass noArray() for the descriptors that are not
+needed.
+
+@param contours Input contours, e.g. the output of #findContours . Each contour is a vector of 2D
+points of type Point or Point2f.
+@param areas Output N x 1 CV_64FC1 array of the contour areas.
+@param boundingRects Output N x 1 CV_32SC4 array of the up-right bounding rectangles
+(x, y, width, height).
+@param minAreaRects Output N x 1 CV_32FC(5) array of the minimum-area rotated rectangles
+(center.x, center.y, width, height, angle).
+@param moments Output N x 10 CV_64FC1 array of the spatial moments m00, m10, m01, m20, m11, m02,
+m30, m21, m12, m03 of the contours.
+@param oriented Oriented area flag, see #contourArea .
+ */
+CV_EXPORTS_W void contourDescriptors( InputArrayOfArrays contours, OutputArray areas,
+                                      OutputArray boundingRects = noArray(),
+                                      OutputArray minAreaRects = noArray(),
+                                      OutputArray moments = noArray(), bool oriented = false );
+
+/** @brief Approximates many polygonal curves in parallel.
+
+The function is equivalent to calling #approxPolyDP for every curve.
+
+@param curves Input curves, e.g. the output of #findContours .
+@param approxCurves Output vector of the approximated curves, of the same type as the input ones.
+@param epsilon Maximum distance between the original curves and their approximations.
+@param closed If true, the approximated curves are closed.
+ */
+CV_EXPORTS_W void approxPolyDPBatch( InputArrayOfArrays curves, OutputArrayOfArrays approxCurves,
+                                     double epsilon, bool closed );
+
+/** @brief Finds the convex hulls of many point sets in parallel.
+
+The function is equivalent to calling #convexHull with returnPoints=true for every point set.
+
+@param contours Input point sets, e.g. the output of #findContours .
+@param hulls Output vector of the convex hulls.
+@param clockwise Orientation flag of the hulls, see #convexHull .
+ */
+CV_EXPORTS_W void convexHullBatch( InputArrayOfArrays contours, OutputArrayOfArrays hulls,
+                                   bool clockwise = false );
+
 /** @example samples/cpp/intersectExample.cpp
 Examples of how intersectConvexConvex works
 */
@@ -4823,6 +5140,101 @@ CV_EXPORTS_W double getFontScaleFromHeight(const int fontFace,
                                            const int pixelHeight,
                                            const int thickness = 1);
 
+/** @brief Batch of drawing primitives rendered with a single call.
+
+The class records lines, rectangles, circles, ellipses, polygons and text labels and renders them
+with draw(). The output is identical to calling the corresponding functions (cv::line,
+cv::rectangle, cv::circle, ...) one by one in the order the primitives were added.
+
+The image is split into horizontal bands. Consecutive primitives whose vertical extent fits into a
+single band are rasterized concurrently with the primitives of the other bands, while primitives
+spanning several bands are rendered on their own, so the original drawing order is preserved for
+every pixel. This makes the class well suited for overlays consisting of many small objects, such
+as detection boxes, markers and labels.
+
+Primitives can optionally be made translucent with setOpacity(). Such a primitive is rasterized
+into a coverage mask and blended into the image, so overlapping parts of the same primitive are
+blended once. Opaque primitives, the default, are drawn by the drawing functions themselves.
+
+The recorded primitives do not depend on the target image, so the same list can be drawn on many
+images. Copies of a DrawList share the recorded primitives.
+ */
+class CV_EXPORTS DrawList
+{
+public:
+    DrawList();
+
+    /** @brief Adds a line segment. See cv::line. */
+    void line(Point pt1, Point pt2, const Scalar& color,
+              int thickness = 1, int lineType = LINE_8, int shift = 0);
+
+    /** @brief Adds an upright rectangle given by two opposite corners. See cv::rectangle. */
+    void rectangle(Point pt1, Point pt2, const Scalar& color,
+                   int thickness = 1, int lineType = LINE_8, int shift = 0);
+
+    /** @overload */
+    void rectangle(Rect rec, const Scalar& color,
+                   int thickness = 1, int lineType = LINE_8, int shift = 0);
+
+    /** @brief Adds a circle. See cv::circle. */
+    void circle(Point center, int radius, const Scalar& color,
+                int thickness = 1, int lineType = LINE_8, int shift = 0);
+
+    /** @brief Adds an elliptic arc or a filled ellipse sector. See cv::ellipse. */
+    void ellipse(Point center, Size axes, double angle, double startAngle, double endAngle,
+                 const Scalar& color, int thickness = 1, int lineType = LINE_8, int shift = 0);
+
+    /** @brief Adds one or more polygonal curves. See cv::polylines. */
+    void polylines(InputArrayOfArrays pts, bool isClosed, const Scalar& color,
+                   int thickness = 1, int lineType = LINE_8, int shift = 0);
+
+    /** @brief Adds an area bounded by one or more polygons. See cv::fillPoly. */
+    void fillPoly(InputArrayOfArrays pts, const Scalar& color,
+                  int lineType = LINE_8, int shift = 0, Point offset = Point());
+
+    /** @brief Adds a filled convex polygon. See cv::fillConvexPoly. */
+    void fillConvexPoly(InputArray points, const Scalar& color,
+                        int lineType = LINE_8, int shift = 0);
+
+    /** @brief Adds a text string. See cv::putText. */
+    void putText(const String& text, Point org, int fontFace, double fontScale, Scalar color,
+                 int thickness = 1, int lineType = LINE_8, bool bottomLeftOrigin = false);
+
+    /** @brief Sets the opacity of the primitives added after the call.
+
+    The pixels covered by a primitive with opacity alpha < 1 are computed as
+    \f[\texttt{img} (x,y)  \leftarrow (1 - \alpha \cdot c(x,y)) \cdot \texttt{img} (x,y) + \alpha \cdot c(x,y) \cdot \texttt{color}\f]
+    where \f$c(x,y)\f$ is the coverage of the pixel, 1 inside the primitive and a fraction of 1 on the
+    edges of the antialiased ones. For 8-bit images the weights are rounded to multiples of 1/256.
+
+    @param alpha Opacity from 0 (the primitives are not drawn) to 1 (the default, opaque primitives).
+     */
+    void setOpacity(double alpha);
+
+    /** @brief Returns the opacity of the primitives being added. */
+    double getOpacity() const;
+
+    /** @brief Renders all the recorded primitives into the image.
+
+    @param img Image to draw on. The list can be drawn on images of any size and type supported by
+    the individual drawing functions.
+     */
+    void draw(InputOutputArray img) const;
+
+    /** @brief Removes all the recorded primitives. */
+    void clear();
+
+    /** @brief Returns the number of recorded primitives. */
+    size_t size() const;
+
+    /** @brief Returns true if the list has no primitives. */
+    bool empty() const;
+
+    struct Impl;
+protected:
+    Ptr<Impl> p;
+};
+
 /** @brief Line iterator
 
 The class is used to iterate over all the pixels on the raster line
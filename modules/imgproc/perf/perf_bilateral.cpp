@@ -35,4 +35,58 @@ PERF_TEST_P( TestBilateralFilter, BilateralFilter,
     SANITY_CHECK(dst, .01, ERROR_RELATIVE);
 }
 
+typedef TestBaseWithParam< tuple<Size, double, Mat_Type> > TestBilateralFilterLarge;
+
+// the exact filter with the window covering +-3 sigma against the bilateral grid approximation
+PERF_TEST_P( TestBilateralFilterLarge, BilateralFilter_large,
+             Combine(
+                Values( szVGA, sz1080p ), // image size
+                Values( 4., 12. ), // sigmaSpace
+                Values( CV_8UC1, CV_8UC3 ) // image type
+             )
+)
+{
+    Size sz = get<0>(GetParam());
+    double sigmaSpace = get<1>(GetParam());
+    int type = get<2>(GetParam());
+    const double sigmaColor = 30.;
+
+    Mat src(sz, type);
+    Mat dst(sz, type);
+
+    declare.in(src, WARMUP_RNG).out(dst).time(60);
+
+    TEST_CYCLE() bilateralFilter(src, dst, cvRound(sigmaSpace*3)*2 + 1, sigmaColor, sigmaSpace, BORDER_DEFAULT);
+
+    SANITY_CHECK_NOTHING();
+}
+
+PERF_TEST_P( TestBilateralFilterLarge, ApproxBilateralFilter,
+             Combine(
+                Values( szVGA, sz1080p ), // image size
+                Values( 4., 12. ), // sigmaSpace
+                Values( CV_8UC1, CV_8UC3 ) // image type
+             )
+)
+{
+    Size sz = get<0>(GetParam());
+    double sigmaSpace = get<1>(GetParam());
+    int type = get<2>(GetParam());
+    const double sigmaColor = 30.;
+
+    Mat src(sz, type);
+    Mat dst(sz, type);
+
+    declare.in(src, WARMUP_RNG).out(dst);
+
+    TEST_CYCLE() approxBilateralFilter(src, dst, sigmaColor, sigmaSpace);
+
+    // quality against the exact filter, see BilateralFilter_large for its timing
+    Mat ref;
+    bilateralFilter(src, ref, cvRound(sigmaSpace*3)*2 + 1, sigmaColor, sigmaSpace, BORDER_DEFAULT);
+    RecordProperty("PSNR", cv::format("%.2f", cvtest::PSNR(ref, dst)));
+
+    SANITY_CHECK_NOTHING();
+}
+
 } // namespace
@@ -106,4 +106,52 @@ PERF_TEST_P(TestBoundingRect, BoundingRect,
     SANITY_CHECK_NOTHING();
 }
 
+typedef TestBaseWithParam<bool> TestContourDescriptors;
+
+PERF_TEST_P(TestContourDescriptors, ContourDescriptors, testing::Bool()) // batch or one call per contour
+{
+    bool batch = GetParam();
+
+    Mat img(sz1080p, CV_8UC1);
+    RNG rng(12345);
+    rng.fill(img, RNG::UNIFORM, 0, 256);
+    GaussianBlur(img, img, Size(0, 0), 3);
+    cv::threshold(img, img, 128, 255, THRESH_BINARY);
+
+    vector< vector<Point> > contours;
+    findContours(img, contours, RETR_LIST, CHAIN_APPROX_SIMPLE);
+    int n = (int)contours.size();
+
+    Mat areas, rects, boxes, mom;
+    vector< vector<Point> > hulls;
+
+    TEST_CYCLE()
+    {
+        if (batch)
+        {
+            contourDescriptors(contours, areas, rects, boxes, mom);
+            convexHullBatch(contours, hulls);
+        }
+        else
+        {
+            areas.create(n, 1, CV_64F);
+            rects.create(n, 1, CV_32SC4);
+            boxes.create(n, 1, CV_32FC(5));
+            hulls.resize(n);
+            for (int i = 0; i < n; i++)
+            {
+                areas.at<double>(i) = contourArea(contours[i]);
+                Rect r = boundingRect(contours[i]);
+                rects.at<Vec4i>(i) = Vec4i(r.x, r.y, r.width, r.height);
+                RotatedRect box = minAreaRect(contours[i]);
+                boxes.at<Vec<float, 5> >(i) = Vec<float, 5>(box.center.x, box.center.y, box.size.width, box.size.height, box.angle);
+                moments(contours[i]);
+                convexHull(contours[i], hulls[i]);
+            }
+        }
+    }
+
+    SANITY_CHECK_NOTHING();
+}
+
 } } // namespace
@@ -394,6 +394,37 @@ PERF_TEST_P(Size_CvtMode32F, DISABLED_cvtColor_32f,
     SANITY_CHECK_NOTHING();
 }
 
+CV_ENUM(CvtModeLabHSV,
+    COLOR_BGR2Lab, COLOR_Lab2BGR, COLOR_LBGR2Lab, COLOR_Lab2LBGR,
+    COLOR_BGR2Luv, COLOR_Luv2BGR, COLOR_LBGR2Luv, COLOR_Luv2LBGR,
+    COLOR_BGR2HSV, COLOR_HSV2BGR, COLOR_BGR2HSV_FULL, COLOR_HSV2BGR_FULL,
+    COLOR_BGR2HLS, COLOR_HLS2BGR, COLOR_BGR2HLS_FULL, COLOR_HLS2BGR_FULL
+    )
+
+typedef tuple<Size, CvtModeLabHSV, MatDepth> Size_CvtModeLabHSV_Depth_t;
+typedef perf::TestBaseWithParam<Size_CvtModeLabHSV_Depth_t> Size_CvtModeLabHSV_Depth;
+
+PERF_TEST_P(Size_CvtModeLabHSV_Depth, cvtColorLabHSV,
+            testing::Combine(
+                testing::Values(::perf::szVGA, ::perf::sz1080p),
+                CvtModeLabHSV::all(),
+                testing::Values(CV_8U, CV_32F)
+                )
+            )
+{
+    Size sz = get<0>(GetParam());
+    int mode = get<1>(GetParam());
+    int depth = get<2>(GetParam());
+    Mat src(sz, CV_MAKETYPE(depth, 3));
+    Mat dst(sz, CV_MAKETYPE(depth, 3));
+
+    declare.in(src, WARMUP_RNG).out(dst);
+
+    TEST_CYCLE() cvtColor(src, dst, mode);
+
+    SANITY_CHECK_NOTHING();
+}
+
 typedef tuple<Size, CvtModeBayer> Size_CvtMode_Bayer_t;
 typedef perf::TestBaseWithParam<Size_CvtMode_Bayer_t> Size_CvtMode_Bayer;
 
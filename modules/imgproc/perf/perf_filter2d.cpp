@@ -97,4 +97,39 @@ PERF_TEST_P( Image_KernelSize, GaborFilter2d,
     SANITY_CHECK(filteredImage, 1e-6, ERROR_RELATIVE);
 }
 
+typedef tuple<Size, int, bool> Size_KernelSize_Bank_t;
+typedef TestBaseWithParam<Size_KernelSize_Bank_t> Size_KernelSize_Bank;
+
+PERF_TEST_P(Size_KernelSize_Bank, GaborFilterBank,
+            Combine(
+                Values(szVGA, sz1080p),
+                Values(11, 31),
+                testing::Bool() // filterBank or filter2D per kernel
+            )
+)
+{
+    Size sz = get<0>(GetParam());
+    int kernelSize = get<1>(GetParam());
+    bool bank = get<2>(GetParam());
+
+    std::vector<Mat> kernels;
+    for (int i = 0; i < 16; i++)
+        kernels.push_back(getGaborKernel(Size(kernelSize, kernelSize), kernelSize/6., CV_PI*i/16, kernelSize/3., 0.5, 0, CV_32F));
+
+    Mat src(sz, CV_8UC1);
+    declare.in(src, WARMUP_RNG).time(60);
+    std::vector<Mat> dst(kernels.size());
+
+    TEST_CYCLE()
+    {
+        if (bank)
+            filterBank(src, kernels, dst);
+        else
+            for (size_t i = 0; i < kernels.size(); i++)
+                cv::filter2D(src, dst[i], CV_32F, kernels[i]);
+    }
+
+    SANITY_CHECK_NOTHING();
+}
+
 } // namespace
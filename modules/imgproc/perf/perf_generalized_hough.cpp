@@ -0,0 +1,75 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+#include "perf_precomp.hpp"
+
+namespace opencv_test {
+
+static void makeGeneralizedHoughData(Size imageSize, Mat& templ, Mat& image)
+{
+    templ.create(64, 64, CV_8UC1);
+    templ.setTo(Scalar::all(0));
+    std::vector<Point> poly;
+    poly.push_back(Point(8, 10));
+    poly.push_back(Point(50, 6));
+    poly.push_back(Point(56, 40));
+    poly.push_back(Point(30, 56));
+    poly.push_back(Point(12, 44));
+    fillConvexPoly(templ, poly, Scalar::all(255));
+    rectangle(templ, Rect(22, 20, 14, 12), Scalar::all(0), -1);
+
+    image.create(imageSize, CV_8UC1);
+    image.setTo(Scalar::all(0));
+    RNG rng(12345);
+    for (int i = 0; i < 4; i++)
+    {
+        Point pos(rng.uniform(0, imageSize.width - templ.cols), rng.uniform(0, imageSize.height - templ.rows));
+        templ.copyTo(image(Rect(pos, templ.size())));
+    }
+}
+
+typedef TestBaseWithParam<Size> GeneralizedHoughFixture;
+
+PERF_TEST_P(GeneralizedHoughFixture, Ballard, Values(szVGA, sz720p))
+{
+    Mat templ, image;
+    makeGeneralizedHoughData(GetParam(), templ, image);
+
+    Ptr<GeneralizedHoughBallard> alg = createGeneralizedHoughBallard();
+    alg->setVotesThreshold(20);
+    alg->setTemplate(templ);
+
+    Mat positions;
+    declare.time(60);
+
+    TEST_CYCLE() alg->detect(image, positions);
+
+    SANITY_CHECK_NOTHING();
+}
+
+PERF_TEST_P(GeneralizedHoughFixture, Guil, Values(szQVGA, szVGA))
+{
+    Mat templ, image;
+    makeGeneralizedHoughData(GetParam(), templ, image);
+
+    Ptr<GeneralizedHoughGuil> alg = createGeneralizedHoughGuil();
+    alg->setMinAngle(0);
+    alg->setMaxAngle(30);
+    alg->setAngleStep(1);
+    alg->setMinScale(0.9);
+    alg->setMaxScale(1.1);
+    alg->setScaleStep(0.05);
+    alg->setAngleThresh(100);
+    alg->setScaleThresh(100);
+    alg->setPosThresh(20);
+    alg->setTemplate(templ);
+
+    Mat positions;
+    declare.time(120);
+
+    TEST_CYCLE() alg->detect(image, positions);
+
+    SANITY_CHECK_NOTHING();
+}
+
+} // namespace
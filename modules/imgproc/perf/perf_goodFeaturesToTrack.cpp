@@ -41,4 +41,77 @@ PERF_TEST_P(Image_MaxCorners_QualityLevel_MinDistance_BlockSize_gradientSize_Use
     SANITY_CHECK(corners);
 }
 
+typedef tuple<Size, int> Size_MaxCorners_t;
+typedef perf::TestBaseWithParam<Size_MaxCorners_t> Size_MaxCorners;
+
+PERF_TEST_P(Size_MaxCorners, goodFeaturesToTrack_large,
+            testing::Combine(
+                testing::Values( sz1080p, sz2160p ),
+                testing::Values( 1000, 5000 )
+                )
+          )
+{
+    Size sz = get<0>(GetParam());
+    int maxCorners = get<1>(GetParam());
+
+    Mat image(sz, CV_8UC1);
+    declare.in(image, WARMUP_RNG);
+    GaussianBlur(image, image, Size(0, 0), 2);
+
+    std::vector<Point2f> corners;
+
+    TEST_CYCLE() goodFeaturesToTrack(image, corners, maxCorners, 0.01, 5);
+
+    SANITY_CHECK_NOTHING();
+}
+
+PERF_TEST_P(Size_MaxCorners, goodFeaturesToTrackGrid,
+            testing::Combine(
+                testing::Values( sz1080p, sz2160p ),
+                testing::Values( 1000, 5000 )
+                )
+          )
+{
+    Size sz = get<0>(GetParam());
+    int maxCorners = get<1>(GetParam());
+    const Size gridSize(16, 9);
+
+    Mat image(sz, CV_8UC1);
+    declare.in(image, WARMUP_RNG);
+    GaussianBlur(image, image, Size(0, 0), 2);
+
+    std::vector<Point2f> corners;
+
+    TEST_CYCLE() goodFeaturesToTrackGrid(image, corners, gridSize, maxCorners / gridSize.area(), 0.01, 5);
+
+    SANITY_CHECK_NOTHING();
+}
+
+PERF_TEST_P(Size_MaxCorners, cornerSubPix,
+            testing::Combine(
+                testing::Values( sz1080p ),
+                testing::Values( 1000, 5000 )
+                )
+          )
+{
+    Size sz = get<0>(GetParam());
+    int maxCorners = get<1>(GetParam());
+
+    Mat image(sz, CV_8UC1);
+    declare.in(image, WARMUP_RNG);
+    GaussianBlur(image, image, Size(0, 0), 2);
+
+    std::vector<Point2f> corners, refined;
+    goodFeaturesToTrack(image, corners, maxCorners, 0.01, 5);
+    TermCriteria criteria(TermCriteria::COUNT + TermCriteria::EPS, 40, 0.001);
+
+    TEST_CYCLE()
+    {
+        refined = corners;
+        cornerSubPix(image, refined, Size(5, 5), Size(-1, -1), criteria);
+    }
+
+    SANITY_CHECK_NOTHING();
+}
+
 } // namespace
@@ -83,8 +83,8 @@ PERF_TEST_P(Size_Source, calcHist3d,
     int numberOfImages = 1;
     Mat source(size.height, size.width, type);
 
-    const float r[] = {rangeLow, rangeHight};
-    const float* ranges[] = {r, r, r};
+    const float range[] = {rangeLow, rangeHight};
+    const float* ranges[] = {range, range, range};
 
     randu(source, rangeLow, rangeHight);
 
@@ -97,6 +97,36 @@ PERF_TEST_P(Size_Source, calcHist3d,
     SANITY_CHECK(hist);
 }
 
+PERF_TEST_P(Size_Source, calcBackProject3d,
+            testing::Combine(testing::Values(sz3MP, sz5MP),
+                             testing::Values(CV_8U, CV_16U, CV_32F) )
+            )
+{
+    Size size = get<0>(GetParam());
+    MatType type = get<1>(GetParam());
+    Mat source(size.height, size.width, CV_MAKETYPE(type, 3));
+    Mat hist, backProject;
+    int channels [] = {0, 1, 2};
+    int histSize [] = {16, 16, 16};
+    int dims = 3;
+    int numberOfImages = 1;
+
+    const float range[] = {rangeLow, rangeHight};
+    const float* ranges[] = {range, range, range};
+
+    randu(source, rangeLow, rangeHight);
+    calcHist(&source, numberOfImages, channels, Mat(), hist, dims, histSize, ranges);
+
+    declare.in(source);
+
+    TEST_CYCLE_MULTIRUN(3)
+    {
+        calcBackProject(&source, numberOfImages, channels, hist, backProject, ranges);
+    }
+
+    SANITY_CHECK_NOTHING();
+}
+
 #define MatSize TestMatSize
 PERF_TEST_P(MatSize, equalizeHist,
             testing::Values(TYPICAL_MAT_SIZES)
@@ -95,4 +95,52 @@ PERF_TEST_P(Size_MatType, buildPyramid, testing::Combine(
     SANITY_CHECK(dst4, eps, error_type);
 }
 
+PERF_TEST_P(Size_MatType, buildPyramid_laplacian, testing::Combine(
+                testing::Values(sz1080p, sz720p, szVGA),
+                testing::Values(CV_8UC1, CV_8UC3, CV_32FC1, CV_32FC3)
+                )
+            )
+{
+    Size sz = get<0>(GetParam());
+    int matType = get<1>(GetParam());
+    int maxLevel = 5;
+    Mat src(sz, matType);
+    std::vector<Mat> gaussian, laplacian;
+
+    declare.in(src, WARMUP_RNG);
+
+    TEST_CYCLE() buildPyramid(src, gaussian, laplacian, maxLevel);
+
+    SANITY_CHECK_NOTHING();
+}
+
+PERF_TEST_P(Size_MatType, buildPyramid_laplacian_separate, testing::Combine(
+                testing::Values(sz1080p, sz720p, szVGA),
+                testing::Values(CV_8UC1, CV_8UC3, CV_32FC1, CV_32FC3)
+                )
+            )
+{
+    Size sz = get<0>(GetParam());
+    int matType = get<1>(GetParam());
+    int maxLevel = 5;
+    int ldepth = CV_MAT_DEPTH(matType) == CV_8U ? CV_16S : CV_32F;
+    Mat src(sz, matType);
+    std::vector<Mat> gaussian, laplacian(maxLevel + 1);
+
+    declare.in(src, WARMUP_RNG);
+
+    TEST_CYCLE()
+    {
+        buildPyramid(src, gaussian, maxLevel);
+        for (int i = 0; i < maxLevel; i++)
+        {
+            Mat up;
+            pyrUp(gaussian[i + 1], up, gaussian[i].size());
+            subtract(gaussian[i], up, laplacian[i], noArray(), ldepth);
+        }
+    }
+
+    SANITY_CHECK_NOTHING();
+}
+
 } // namespace
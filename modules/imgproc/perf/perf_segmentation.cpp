@@ -0,0 +1,33 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+#include "perf_precomp.hpp"
+
+namespace opencv_test {
+
+typedef TestBaseWithParam< tuple<Size, double, int> > TestPyrMeanShiftFiltering;
+
+PERF_TEST_P( TestPyrMeanShiftFiltering, pyrMeanShiftFiltering,
+             Combine(
+                Values( szVGA, sz1080p ), // image size
+                Values( 10., 20. ), // spatial window radius
+                Values( 0, 2 ) // max pyramid level
+             )
+)
+{
+    Size sz = get<0>(GetParam());
+    double sp = get<1>(GetParam());
+    int maxLevel = get<2>(GetParam());
+    const double sr = 20.;
+
+    Mat src(sz, CV_8UC3);
+    Mat dst(sz, CV_8UC3);
+    declare.in(src, WARMUP_RNG).out(dst).time(60);
+    GaussianBlur(src, src, Size(0, 0), 3);
+
+    TEST_CYCLE() pyrMeanShiftFiltering(src, dst, sp, sr, maxLevel);
+
+    SANITY_CHECK_NOTHING();
+}
+
+} // namespace
@@ -0,0 +1,34 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+#include "perf_precomp.hpp"
+
+namespace opencv_test {
+
+typedef TestBaseWithParam<int> Subdiv2D_Points;
+
+PERF_TEST_P(Subdiv2D_Points, insert, Values(10000, 100000))
+{
+    const int count = GetParam();
+    const Rect rect(0, 0, 4000, 3000);
+
+    RNG rng(12345);
+    std::vector<Point2f> pts(count);
+    for (int i = 0; i < count; i++)
+        pts[i] = Point2f(rng.uniform(0.f, (float)rect.width), rng.uniform(0.f, (float)rect.height));
+
+    Subdiv2D subdiv;
+    std::vector<Vec6f> triangles;
+    declare.time(60);
+
+    TEST_CYCLE()
+    {
+        subdiv.initDelaunay(rect);
+        subdiv.insert(pts);
+        subdiv.getTriangleList(triangles);
+    }
+
+    SANITY_CHECK_NOTHING();
+}
+
+} // namespace
@@ -271,6 +271,70 @@ void update_map(const Mat& src, Mat& map_x, Mat& map_y, const int remapMode )
     }
 }
 
+PERF_TEST_P( TestWarpAffine, WarpPlan_affine,
+             Combine(
+                Values( szVGA, sz720p, sz1080p ),
+                InterType::all(),
+                BorderMode::all()
+             )
+)
+{
+    Size sz, szSrc(512, 512);
+    int borderMode, interType;
+    sz         = get<0>(GetParam());
+    interType  = get<1>(GetParam());
+    borderMode = get<2>(GetParam());
+    Scalar borderColor = Scalar::all(150);
+
+    Mat src(szSrc,CV_8UC4), dst(sz, CV_8UC4);
+    cvtest::fillGradient(src);
+    if(borderMode == BORDER_CONSTANT) cvtest::smoothBorder(src, borderColor, 1);
+    Mat warpMat = getRotationMatrix2D(Point2f(src.cols/2.f, src.rows/2.f), 30., 2.2);
+    WarpPlan plan;
+    plan.initAffine(warpMat, sz, interType);
+    declare.in(src).out(dst);
+
+    TEST_CYCLE() plan.apply( src, dst, borderMode, borderColor );
+
+    SANITY_CHECK_NOTHING();
+}
+
+PERF_TEST_P( TestWarpPerspective, WarpPlan_perspective,
+             Combine(
+                Values( szVGA, sz720p, sz1080p ),
+                InterType::all(),
+                BorderMode::all()
+             )
+)
+{
+    Size sz, szSrc(512, 512);
+    int borderMode, interType;
+    sz         = get<0>(GetParam());
+    interType  = get<1>(GetParam());
+    borderMode = get<2>(GetParam());
+    Scalar borderColor = Scalar::all(150);
+
+    Mat src(szSrc,CV_8UC4), dst(sz, CV_8UC4);
+    cvtest::fillGradient(src);
+    if(borderMode == BORDER_CONSTANT) cvtest::smoothBorder(src, borderColor, 1);
+    Mat rotMat = getRotationMatrix2D(Point2f(src.cols/2.f, src.rows/2.f), 30., 2.2);
+    Mat warpMat(3, 3, CV_64FC1);
+    for(int r=0; r<2; r++)
+        for(int c=0; c<3; c++)
+            warpMat.at<double>(r, c) = rotMat.at<double>(r, c);
+    warpMat.at<double>(2, 0) = .3/sz.width;
+    warpMat.at<double>(2, 1) = .3/sz.height;
+    warpMat.at<double>(2, 2) = 1;
+    WarpPlan plan;
+    plan.initPerspective(warpMat, sz, interType);
+
+    declare.in(src).out(dst);
+
+    TEST_CYCLE() plan.apply( src, dst, borderMode, borderColor );
+
+    SANITY_CHECK_NOTHING();
+}
+
 PERF_TEST(Transform, getPerspectiveTransform_1000)
 {
     unsigned int size = 8;
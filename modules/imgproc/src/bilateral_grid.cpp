@@ -0,0 +1,273 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+
+/****************************************************************************************\
+                        Bilateral grid approximation of bilateralFilter
+\****************************************************************************************/
+
+namespace cv
+{
+
+// the grid is blurred with a 5-tap binomial kernel (sigma = 1 cell), so two empty cells are kept
+// around the occupied ones
+static const int BILATERAL_GRID_PAD = 2;
+
+// the largest grid (in floats) to allocate, bilateralFilter is used for the bigger ones
+static const double BILATERAL_GRID_MAX_SIZE = (double)(1 << 26);
+
+// the grid is a gh x gw x gd Mat of 2-channel cells: the sum of the pixel values and their count.
+// Color images are filtered channel by channel, the value of the channel is the range coordinate.
+struct BilateralGridParams
+{
+    double invSpace;
+    float minVal, invColor;
+    int depth, channel;
+};
+
+// accumulates the pixels into their nearest cells. A grid row only receives the pixels of its own
+// image rows, so the grid rows are processed in parallel without synchronization.
+template<typename T>
+class BilateralGridSplatInvoker : public ParallelLoopBody
+{
+public:
+    BilateralGridSplatInvoker(const Mat& _src, Mat& _grid, const BilateralGridParams& _p,
+                              const std::vector<int>& _rowOfs, const std::vector<int>& _xofs) :
+        src(_src), grid(_grid), p(_p), rowOfs(_rowOfs), xofs(_xofs) {}
+
+    virtual void operator() (const Range& range) const CV_OVERRIDE
+    {
+        const int PAD = BILATERAL_GRID_PAD;
+        int cn = src.channels(), width = src.cols;
+
+        for( int gy = range.start; gy < range.end; gy++ )
+        {
+            for( int y = rowOfs[gy]; y < rowOfs[gy + 1]; y++ )
+            {
+                const T* s = src.ptr<T>(y) + p.channel;
+                for( int x = 0; x < width; x++, s += cn )
+                {
+                    float v = (float)s[0];
+                    int gz = cvRound((v - p.minVal)*p.invColor);
+                    gz = std::min(std::max(gz, 0), p.depth - PAD*2 - 1) + PAD;
+                    float* c = grid.ptr<float>(gy + PAD, xofs[x]) + gz*2;
+                    c[0] += v;
+                    c[1] += 1.f;
+                }
+            }
+        }
+    }
+
+private:
+    const Mat& src;
+    Mat& grid;
+    BilateralGridParams p;
+    const std::vector<int>& rowOfs;
+    const std::vector<int>& xofs;
+};
+
+// convolves the grid with [1 4 6 4 1]/16 along one axis; the range is split along another one
+class BilateralGridBlurInvoker : public ParallelLoopBody
+{
+public:
+    BilateralGridBlurInvoker(Mat& _grid, int _axis) : grid(_grid), axis(_axis) {}
+
+    virtual void operator() (const Range& range) const CV_OVERRIDE
+    {
+        const int PAD = BILATERAL_GRID_PAD;
+        int gcn = grid.channels();
+        int n[] = { grid.size[0], grid.size[1], grid.size[2] };
+        size_t step[] = { grid.step[0]/sizeof(float), grid.step[1]/sizeof(float), (size_t)gcn };
+        int outer = axis == 0 ? 1 : 0, inner = 3 - axis - outer;
+        int len = n[axis];
+        size_t lstep = step[axis];
+
+        AutoBuffer<float> _buf((len + PAD*2)*gcn);
+        float* buf = _buf.data();
+        std::fill(buf, buf + PAD*gcn, 0.f);
+        std::fill(buf + (len + PAD)*gcn, buf + (len + PAD*2)*gcn, 0.f);
+
+        for( int i = range.start; i < range.end; i++ )
+        {
+            for( int j = 0; j < n[inner]; j++ )
+            {
+                float* line = grid.ptr<float>() + i*step[outer] + j*step[inner];
+                for( int k = 0; k < len; k++ )
+                    for( int c = 0; c < gcn; c++ )
+                        buf[(k + PAD)*gcn + c] = line[k*lstep + c];
+
+                for( int k = 0; k < len; k++ )
+                {
+                    const float* b = buf + (k + PAD)*gcn;
+                    for( int c = 0; c < gcn; c++ )
+                        line[k*lstep + c] = (b[c - gcn*2] + b[c + gcn*2] +
+                                             (b[c - gcn] + b[c + gcn])*4.f + b[c]*6.f)*(1.f/16);
+                }
+            }
+        }
+    }
+
+private:
+    Mat& grid;
+    int axis;
+};
+
+// reads the filtered values back with trilinear interpolation of the grid
+template<typename T>
+class BilateralGridSliceInvoker : public ParallelLoopBody
+{
+public:
+    BilateralGridSliceInvoker(const Mat& _src, Mat& _dst, const Mat& _grid, const BilateralGridParams& _p,
+                              const std::vector<int>& _xofs, const std::vector<float>& _xalpha) :
+        src(_src), dst(_dst), grid(_grid), p(_p), xofs(_xofs), xalpha(_xalpha) {}
+
+    virtual void operator() (const Range& range) const CV_OVERRIDE
+    {
+        const int PAD = BILATERAL_GRID_PAD;
+        int cn = src.channels(), width = src.cols;
+        size_t xstep = grid.step[1]/sizeof(float), ystep = grid.step[0]/sizeof(float);
+        float zmax = (float)(p.depth - PAD*2 - 1);
+
+        for( int y = range.start; y < range.end; y++ )
+        {
+            float fy = (float)(y*p.invSpace);
+            int iy = cvFloor(fy);
+            float ay = fy - iy;
+            const T* s = src.ptr<T>(y) + p.channel;
+            T* d = dst.ptr<T>(y) + p.channel;
+
+            for( int x = 0; x < width; x++, s += cn, d += cn )
+            {
+                float fz = std::min(std::max(((float)s[0] - p.minVal)*p.invColor, 0.f), zmax);
+                int iz = cvFloor(fz);
+                float az = fz - iz, ax = xalpha[x];
+                const float* c = grid.ptr<float>(iy + PAD, xofs[x]) + (iz + PAD)*2;
+                float w[] = { (1.f - ay)*(1.f - ax), (1.f - ay)*ax, ay*(1.f - ax), ay*ax };
+                const float* corners[] = { c, c + xstep, c + ystep, c + ystep + xstep };
+
+                float sum = 0.f, count = 0.f;
+                for( int i = 0; i < 4; i++ )
+                {
+                    const float* c0 = corners[i];
+                    float w0 = w[i]*(1.f - az), w1 = w[i]*az;
+                    sum += c0[0]*w0 + c0[2]*w1;
+                    count += c0[1]*w0 + c0[3]*w1;
+                }
+
+                // the pixel is written after its own value is read, so dst may be src
+                d[0] = count > 0.f ? saturate_cast<T>(sum/count) : s[0];
+            }
+        }
+    }
+
+private:
+    const Mat& src;
+    Mat& dst;
+    const Mat& grid;
+    BilateralGridParams p;
+    const std::vector<int>& xofs;
+    const std::vector<float>& xalpha;
+};
+
+// returns the number of floats in the grid
+static double bilateralGridSize( Size size, double sigmaColor, double sigmaSpace, double minVal, double maxVal )
+{
+    const int PAD = BILATERAL_GRID_PAD;
+    double invSpace = 1./std::max(sigmaSpace, 1.);
+    return ((size.height - 1)*invSpace + 1 + PAD*2)*((size.width - 1)*invSpace + 1 + PAD*2)*
+           ((maxVal - minVal)/sigmaColor + 1 + PAD*2)*2;
+}
+
+template<typename T> static void
+approxBilateralFilter_( const Mat& src, Mat& dst, double sigmaColor, double sigmaSpace, float minVal, float maxVal )
+{
+    const int PAD = BILATERAL_GRID_PAD;
+    int cn = src.channels();
+    Size size = src.size();
+
+    BilateralGridParams p;
+    p.invSpace = 1./std::max(sigmaSpace, 1.);
+    p.minVal = minVal;
+    p.invColor = (float)(1./sigmaColor);
+    p.depth = cvRound((maxVal - minVal)*p.invColor) + 1 + PAD*2;
+    int gridRows = cvRound((size.height - 1)*p.invSpace) + 1;
+    int gridCols = cvRound((size.width - 1)*p.invSpace) + 1;
+
+    // [rowOfs[gy], rowOfs[gy + 1]) are the image rows splatted into the grid row gy
+    std::vector<int> rowOfs(gridRows + 1);
+    for( int y = 0, gy = 0; gy <= gridRows; gy++ )
+    {
+        while( y < size.height && cvRound(y*p.invSpace) < gy )
+            y++;
+        rowOfs[gy] = y;
+    }
+
+    std::vector<int> splatXofs(size.width), sliceXofs(size.width);
+    std::vector<float> xalpha(size.width);
+    for( int x = 0; x < size.width; x++ )
+    {
+        float fx = (float)(x*p.invSpace);
+        splatXofs[x] = cvRound(x*p.invSpace) + PAD;
+        sliceXofs[x] = cvFloor(fx) + PAD;
+        xalpha[x] = fx - cvFloor(fx);
+    }
+
+    int gsize[] = { gridRows + PAD*2, gridCols + PAD*2, p.depth };
+    Mat grid(3, gsize, CV_32FC2);
+
+    for( p.channel = 0; p.channel < cn; p.channel++ )
+    {
+        grid.setTo(Scalar::all(0));
+        parallel_for_(Range(0, gridRows), BilateralGridSplatInvoker<T>(src, grid, p, rowOfs, splatXofs));
+        for( int axis = 0; axis < 3; axis++ )
+        {
+            int outer = axis == 0 ? 1 : 0;
+            parallel_for_(Range(0, gsize[outer]), BilateralGridBlurInvoker(grid, axis));
+        }
+        parallel_for_(Range(0, size.height), BilateralGridSliceInvoker<T>(src, dst, grid, p, sliceXofs, xalpha),
+                      src.total()/(double)(1<<16));
+    }
+}
+
+void approxBilateralFilter( InputArray _src, OutputArray _dst, double sigmaColor, double sigmaSpace )
+{
+    CV_INSTRUMENT_REGION();
+
+    int type = _src.type(), depth = CV_MAT_DEPTH(type), cn = CV_MAT_CN(type);
+    CV_Assert( (depth == CV_8U || depth == CV_32F) && (cn == 1 || cn == 3) );
+    CV_Assert( sigmaColor > 0 && sigmaSpace > 0 );
+
+    Mat src = _src.getMat();
+    _dst.create( src.size(), type );
+    Mat dst = _dst.getMat();
+
+    if( src.empty() )
+        return;
+
+    double minVal = 0, maxVal = 255;
+    if( depth == CV_32F )
+    {
+        minMaxIdx(src.reshape(1), &minVal, &maxVal);
+        CV_Assert( cvIsInf(minVal) == 0 && cvIsInf(maxVal) == 0 );
+    }
+
+    // small sigmas need a grid with too many cells, bilateralFilter is fast for them anyway
+    if( bilateralGridSize(src.size(), sigmaColor, sigmaSpace, minVal, maxVal) > BILATERAL_GRID_MAX_SIZE )
+    {
+        if( src.data == dst.data )
+            src = src.clone();
+        bilateralFilter(src, dst, -1, sigmaColor, sigmaSpace);
+        return;
+    }
+
+    if( depth == CV_8U )
+        approxBilateralFilter_<uchar>(src, dst, sigmaColor, sigmaSpace, 0.f, 255.f);
+    else
+        approxBilateralFilter_<float>(src, dst, sigmaColor, sigmaSpace, (float)minVal, (float)maxVal);
+}
+
+}
+
+/* End of file. */
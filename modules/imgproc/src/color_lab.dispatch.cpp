@@ -0,0 +1,754 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html
+
+#include "precomp.hpp"
+
+#include "opencl_kernels_imgproc.hpp"
+
+#include "color.hpp"
+
+#include "color_lab.simd.hpp"
+#include "color_lab.simd_declarations.hpp" // defines CV_CPU_DISPATCH_MODES_ALL=AVX2,...,BASELINE based on CMakeLists.txt content
+
+namespace cv {
+
+//
+// IPP functions
+//
+
+#if NEED_IPP
+
+#if !IPP_DISABLE_RGB_XYZ
+static ippiGeneralFunc ippiRGB2XYZTab[] =
+{
+    (ippiGeneralFunc)ippiRGBToXYZ_8u_C3R, 0, (ippiGeneralFunc)ippiRGBToXYZ_16u_C3R, 0,
+    0, (ippiGeneralFunc)ippiRGBToXYZ_32f_C3R, 0, 0
+};
+#endif
+
+#if !IPP_DISABLE_XYZ_RGB
+static ippiGeneralFunc ippiXYZ2RGBTab[] =
+{
+    (ippiGeneralFunc)ippiXYZToRGB_8u_C3R, 0, (ippiGeneralFunc)ippiXYZToRGB_16u_C3R, 0,
+    0, (ippiGeneralFunc)ippiXYZToRGB_32f_C3R, 0, 0
+};
+#endif
+
+#if !IPP_DISABLE_RGB_LAB
+static ippiGeneralFunc ippiRGBToLUVTab[] =
+{
+    (ippiGeneralFunc)ippiRGBToLUV_8u_C3R, 0, (ippiGeneralFunc)ippiRGBToLUV_16u_C3R, 0,
+    0, (ippiGeneralFunc)ippiRGBToLUV_32f_C3R, 0, 0
+};
+#endif
+
+#if !IPP_DISABLE_LAB_RGB
+static ippiGeneralFunc ippiLUVToRGBTab[] =
+{
+    (ippiGeneralFunc)ippiLUVToRGB_8u_C3R, 0, (ippiGeneralFunc)ippiLUVToRGB_16u_C3R, 0,
+    0, (ippiGeneralFunc)ippiLUVToRGB_32f_C3R, 0, 0
+};
+#endif
+
+#endif
+
+
+//
+// HAL functions
+//
+
+namespace hal
+{
+
+void cvtBGRtoXYZ(const uchar * src_data, size_t src_step,
+                 uchar * dst_data, size_t dst_step,
+                 int width, int height,
+                 int depth, int scn, bool swapBlue)
+{
+    CV_INSTRUMENT_REGION();
+
+    CALL_HAL(cvtBGRtoXYZ, cv_hal_cvtBGRtoXYZ, src_data, src_step, dst_data, dst_step, width, height, depth, scn, swapBlue);
+
+#if defined(HAVE_IPP) && IPP_VERSION_X100 >= 700
+#if !IPP_DISABLE_RGB_XYZ
+    CV_IPP_CHECK()
+    {
+        if(scn == 3 && depth != CV_32F && !swapBlue)
+        {
+            if( CvtColorIPPLoopCopy(src_data, src_step, CV_MAKETYPE(depth, scn), dst_data, dst_step, width, height,
+                                    IPPReorderGeneralFunctor(ippiSwapChannelsC3RTab[depth], ippiRGB2XYZTab[depth], 2, 1, 0, depth)) )
+                return;
+        }
+        else if(scn == 4 && depth != CV_32F && !swapBlue)
+        {
+            if( CvtColorIPPLoop(src_data, src_step, dst_data, dst_step, width, height,
+                                IPPReorderGeneralFunctor(ippiSwapChannelsC4C3RTab[depth], ippiRGB2XYZTab[depth], 2, 1, 0, depth)) )
+                return;
+        }
+        else if(scn == 3 && depth != CV_32F && swapBlue)
+        {
+            if( CvtColorIPPLoopCopy(src_data, src_step, CV_MAKETYPE(depth, scn), dst_data, dst_step, width, height,
+                                    IPPGeneralFunctor(ippiRGB2XYZTab[depth])) )
+                return;
+        }
+        else if(scn == 4 && depth != CV_32F && swapBlue)
+        {
+            if( CvtColorIPPLoop(src_data, src_step, dst_data, dst_step, width, height,
+                                IPPReorderGeneralFunctor(ippiSwapChannelsC4C3RTab[depth], ippiRGB2XYZTab[depth], 0, 1, 2, depth)) )
+                return;
+        }
+    }
+#endif
+#endif
+
+    CV_CPU_DISPATCH(cvtBGRtoXYZ, (src_data, src_step, dst_data, dst_step, width, height, depth, scn, swapBlue),
+        CV_CPU_DISPATCH_MODES_ALL);
+}
+
+void cvtXYZtoBGR(const uchar * src_data, size_t src_step,
+                 uchar * dst_data, size_t dst_step,
+                 int width, int height,
+                 int depth, int dcn, bool swapBlue)
+{
+    CV_INSTRUMENT_REGION();
+
+    CALL_HAL(cvtXYZtoBGR, cv_hal_cvtXYZtoBGR, src_data, src_step, dst_data, dst_step, width, height, depth, dcn, swapBlue);
+
+#if defined(HAVE_IPP) && IPP_VERSION_X100 >= 700
+#if !IPP_DISABLE_XYZ_RGB
+    CV_IPP_CHECK()
+    {
+        if(dcn == 3 && depth != CV_32F && !swapBlue)
+        {
+            if( CvtColorIPPLoopCopy(src_data, src_step, CV_MAKETYPE(depth, 3), dst_data, dst_step, width, height,
+                                    IPPGeneralReorderFunctor(ippiXYZ2RGBTab[depth], ippiSwapChannelsC3RTab[depth], 2, 1, 0, depth)) )
+                return;
+        }
+        else if(dcn == 4 && depth != CV_32F && !swapBlue)
+        {
+            if( CvtColorIPPLoop(src_data, src_step, dst_data, dst_step, width, height,
+                                IPPGeneralReorderFunctor(ippiXYZ2RGBTab[depth], ippiSwapChannelsC3C4RTab[depth], 2, 1, 0, depth)) )
+                return;
+        }
+        if(dcn == 3 && depth != CV_32F && swapBlue)
+        {
+            if( CvtColorIPPLoopCopy(src_data, src_step, CV_MAKETYPE(depth, 3), dst_data, dst_step, width, height,
+                                    IPPGeneralFunctor(ippiXYZ2RGBTab[depth])) )
+                return;
+        }
+        else if(dcn == 4 && depth != CV_32F && swapBlue)
+        {
+            if( CvtColorIPPLoop(src_data, src_step, dst_data, dst_step, width, height,
+                                IPPGeneralReorderFunctor(ippiXYZ2RGBTab[depth], ippiSwapChannelsC3C4RTab[depth], 0, 1, 2, depth)) )
+                return;
+        }
+    }
+#endif
+#endif
+
+    CV_CPU_DISPATCH(cvtXYZtoBGR, (src_data, src_step, dst_data, dst_step, width, height, depth, dcn, swapBlue),
+        CV_CPU_DISPATCH_MODES_ALL);
+}
+
+// 8u, 32f
+void cvtBGRtoLab(const uchar * src_data, size_t src_step,
+                 uchar * dst_data, size_t dst_step,
+                 int width, int height,
+                 int depth, int scn, bool swapBlue, bool isLab, bool srgb)
+{
+    CV_INSTRUMENT_REGION();
+
+    CALL_HAL(cvtBGRtoLab, cv_hal_cvtBGRtoLab, src_data, src_step, dst_data, dst_step, width, height, depth, scn, swapBlue, isLab, srgb);
+
+#if defined(HAVE_IPP) && !IPP_DISABLE_RGB_LAB
+    CV_IPP_CHECK()
+    {
+        if (!srgb)
+        {
+            if (isLab)
+            {
+                if (scn == 3 && depth == CV_8U && !swapBlue)
+                {
+                    if (CvtColorIPPLoop(src_data, src_step, dst_data,dst_step, width, height,
+                                        IPPGeneralFunctor((ippiGeneralFunc)ippiBGRToLab_8u_C3R)))
+                        return;
+                }
+                else if (scn == 4 && depth == CV_8U && !swapBlue)
+                {
+                    if (CvtColorIPPLoop(src_data, src_step, dst_data,dst_step, width, height,
+                                        IPPReorderGeneralFunctor(ippiSwapChannelsC4C3RTab[depth],
+                                                                 (ippiGeneralFunc)ippiBGRToLab_8u_C3R, 0, 1, 2, depth)))
+                        return;
+                }
+                else if (scn == 3 && depth == CV_8U && swapBlue) // slower than OpenCV
+                {
+                    if (CvtColorIPPLoop(src_data, src_step, dst_data,dst_step, width, height,
+                                        IPPReorderGeneralFunctor(ippiSwapChannelsC3RTab[depth],
+                                                                 (ippiGeneralFunc)ippiBGRToLab_8u_C3R, 2, 1, 0, depth)))
+                        return;
+                }
+                else if (scn == 4 && depth == CV_8U && swapBlue) // slower than OpenCV
+                {
+                    if (CvtColorIPPLoop(src_data, src_step, dst_data,dst_step, width, height,
+                                        IPPReorderGeneralFunctor(ippiSwapChannelsC4C3RTab[depth],
+                                                                 (ippiGeneralFunc)ippiBGRToLab_8u_C3R, 2, 1, 0, depth)))
+                        return;
+                }
+            }
+            else
+            {
+                if (scn == 3 && swapBlue)
+                {
+                    if (CvtColorIPPLoop(src_data, src_step, dst_data,dst_step, width, height,
+                                        IPPGeneralFunctor(ippiRGBToLUVTab[depth])))
+                        return;
+                }
+                else if (scn == 4 && swapBlue)
+                {
+                    if (CvtColorIPPLoop(src_data, src_step, dst_data,dst_step, width, height,
+                                        IPPReorderGeneralFunctor(ippiSwapChannelsC4C3RTab[depth],
+                                                                 ippiRGBToLUVTab[depth], 0, 1, 2, depth)))
+                        return;
+                }
+                else if (scn == 3 && !swapBlue)
+                {
+                    if (CvtColorIPPLoop(src_data, src_step, dst_data,dst_step, width, height,
+                                        IPPReorderGeneralFunctor(ippiSwapChannelsC3RTab[depth],
+                                                                 ippiRGBToLUVTab[depth], 2, 1, 0, depth)))
+                        return;
+                }
+                else if (scn == 4 && !swapBlue)
+                {
+                    if (CvtColorIPPLoop(src_data, src_step, dst_data,dst_step, width, height,
+                                        IPPReorderGeneralFunctor(ippiSwapChannelsC4C3RTab[depth],
+                                                                 ippiRGBToLUVTab[depth], 2, 1, 0, depth)))
+                        return;
+                }
+            }
+        }
+    }
+#endif
+
+    CV_CPU_DISPATCH(cvtBGRtoLab, (src_data, src_step, dst_data, dst_step, width, height, depth, scn, swapBlue, isLab, srgb),
+        CV_CPU_DISPATCH_MODES_ALL);
+}
+
+// 8u, 32f
+void cvtLabtoBGR(const uchar * src_data, size_t src_step,
+                 uchar * dst_data, size_t dst_step,
+                 int width, int height,
+                 int depth, int dcn, bool swapBlue, bool isLab, bool srgb)
+{
+    CV_INSTRUMENT_REGION();
+
+    CALL_HAL(cvtLabtoBGR, cv_hal_cvtLabtoBGR, src_data, src_step, dst_data, dst_step, width, height, depth, dcn, swapBlue, isLab, srgb);
+
+#if defined(HAVE_IPP) && !IPP_DISABLE_LAB_RGB
+    CV_IPP_CHECK()
+    {
+        if (!srgb)
+        {
+            if (isLab)
+            {
+                if( dcn == 3 && depth == CV_8U && !swapBlue)
+                {
+                    if( CvtColorIPPLoop(src_data, src_step, dst_data,dst_step, width, height,
+                                        IPPGeneralFunctor((ippiGeneralFunc)ippiLabToBGR_8u_C3R)) )
+                        return;
+                }
+                else if( dcn == 4 && depth == CV_8U && !swapBlue)
+                {
+                    if( CvtColorIPPLoop(src_data, src_step, dst_data,dst_step, width, height,
+                                        IPPGeneralReorderFunctor((ippiGeneralFunc)ippiLabToBGR_8u_C3R,
+                                                                 ippiSwapChannelsC3C4RTab[depth], 0, 1, 2, depth)) )
+                        return;
+                }
+                if( dcn == 3 && depth == CV_8U && swapBlue)
+                {
+                    if( CvtColorIPPLoop(src_data, src_step, dst_data,dst_step, width, height,
+                                        IPPGeneralReorderFunctor((ippiGeneralFunc)ippiLabToBGR_8u_C3R,
+                                                                 ippiSwapChannelsC3RTab[depth], 2, 1, 0, depth)) )
+                        return;
+                }
+                else if( dcn == 4 && depth == CV_8U && swapBlue)
+                {
+                    if( CvtColorIPPLoop(src_data, src_step, dst_data,dst_step, width, height,
+                                        IPPGeneralReorderFunctor((ippiGeneralFunc)ippiLabToBGR_8u_C3R,
+                                                                 ippiSwapChannelsC3C4RTab[depth], 2, 1, 0, depth)) )
+                        return;
+                }
+            }
+            else
+            {
+                if( dcn == 3 && swapBlue)
+                {
+                    if( CvtColorIPPLoop(src_data, src_step, dst_data,dst_step, width, height,
+                                        IPPGeneralFunctor(ippiLUVToRGBTab[depth])) )
+                        return;
+                }
+                else if( dcn == 4 && swapBlue)
+                {
+                    if( CvtColorIPPLoop(src_data, src_step, dst_data,dst_step, width, height,
+                                        IPPGeneralReorderFunctor(ippiLUVToRGBTab[depth],
+                                                                 ippiSwapChannelsC3C4RTab[depth], 0, 1, 2, depth)) )
+                        return;
+                }
+                if( dcn == 3 && !swapBlue)
+                {
+                    if( CvtColorIPPLoop(src_data, src_step, dst_data,dst_step, width, height,
+                                        IPPGeneralReorderFunctor(ippiLUVToRGBTab[depth],
+                                                                 ippiSwapChannelsC3RTab[depth], 2, 1, 0, depth)) )
+                        return;
+                }
+                else if( dcn == 4 && !swapBlue)
+                {
+                    if( CvtColorIPPLoop(src_data, src_step, dst_data,dst_step, width, height,
+                                        IPPGeneralReorderFunctor(ippiLUVToRGBTab[depth],
+                                                                 ippiSwapChannelsC3C4RTab[depth], 2, 1, 0, depth)) )
+                        return;
+                }
+            }
+        }
+    }
+#endif
+
+    CV_CPU_DISPATCH(cvtLabtoBGR, (src_data, src_step, dst_data, dst_step, width, height, depth, dcn, swapBlue, isLab, srgb),
+        CV_CPU_DISPATCH_MODES_ALL);
+}
+
+} // namespace hal
+
+//
+// OCL calls
+//
+
+#ifdef HAVE_OPENCL
+
+// the OpenCL kernels share the tables of the baseline CPU implementation
+using namespace hal::cpu_baseline;
+
+bool oclCvtColorBGR2Luv( InputArray _src, OutputArray _dst, int bidx, bool srgb)
+{
+    OclHelper< Set<3, 4>, Set<3>, Set<CV_8U, CV_32F> > h(_src, _dst, 3);
+
+    if(!h.createKernel("BGR2Luv", ocl::imgproc::color_lab_oclsrc,
+                       format("-D dcn=3 -D bidx=%d%s", bidx, srgb ? " -D SRGB" : "")))
+    {
+        return false;
+    }
+
+    // Prepare additional arguments
+
+    initLabTabs();
+
+    static UMat usRGBGammaTab, ucoeffs, uLabCbrtTab;
+
+    if (srgb && usRGBGammaTab.empty())
+        Mat(1, GAMMA_TAB_SIZE * 4, CV_32FC1, const_cast<float*>(sRGBGammaTab)).copyTo(usRGBGammaTab);
+    if (uLabCbrtTab.empty())
+        Mat(1, LAB_CBRT_TAB_SIZE * 4, CV_32FC1, const_cast<float*>(LabCbrtTab)).copyTo(uLabCbrtTab);
+
+    float coeffs[9];
+    softdouble whitePt[3];
+    for(int i = 0; i < 3; i++)
+        whitePt[i] = D65[i];
+
+    for (int i = 0; i < 3; i++)
+    {
+        int j = i * 3;
+
+        softfloat c0 = sRGB2XYZ_D65[j    ];
+        softfloat c1 = sRGB2XYZ_D65[j + 1];
+        softfloat c2 = sRGB2XYZ_D65[j + 2];
+
+        coeffs[j + (bidx ^ 2)] = c0;
+        coeffs[j + 1]          = c1;
+        coeffs[j + bidx]       = c2;
+
+        CV_Assert( c0 >= 0 && c1 >= 0 && c2 >= 0 &&
+                   c0 + c1 + c2 < softfloat(3)/softfloat(2));
+    }
+
+    softfloat d = whitePt[0] +
+                  whitePt[1]*softdouble(15) +
+                  whitePt[2]*softdouble(3);
+    d = softfloat::one()/max(d, softfloat(FLT_EPSILON));
+    float un = d*softfloat(13*4)*whitePt[0];
+    float vn = d*softfloat(13*9)*whitePt[1];
+
+    Mat(1, 9, CV_32FC1, coeffs).copyTo(ucoeffs);
+
+    ocl::KernelArg ucoeffsarg = ocl::KernelArg::PtrReadOnly(ucoeffs);
+
+    ocl::KernelArg LabCbrtTabarg = ocl::KernelArg::PtrReadOnly(uLabCbrtTab);
+
+    // Setup additional arguments and run
+
+    if(srgb)
+        h.setArg(ocl::KernelArg::PtrReadOnly(usRGBGammaTab));
+
+    h.setArg(LabCbrtTabarg);
+    h.setArg(ucoeffsarg);
+    h.setArg(un); h.setArg(vn);
+
+    return h.run();
+}
+
+
+bool oclCvtColorBGR2Lab( InputArray _src, OutputArray _dst, int bidx, bool srgb )
+{
+    OclHelper< Set<3, 4>, Set<3>, Set<CV_8U, CV_32F> > h(_src, _dst, 3);
+
+    if(!h.createKernel("BGR2Lab", ocl::imgproc::color_lab_oclsrc,
+                       format("-D dcn=3 -D bidx=%d%s", bidx, srgb ? " -D SRGB" : "")))
+    {
+        return false;
+    }
+
+    // Prepare and set additional arguments
+
+    initLabTabs();
+
+    if (_src.depth() == CV_8U)
+    {
+        static UMat usRGBGammaTab, ulinearGammaTab, uLabCbrtTab, ucoeffs;
+
+        if (srgb && usRGBGammaTab.empty())
+            Mat(1, 256, CV_16UC1, sRGBGammaTab_b).copyTo(usRGBGammaTab);
+        else if (ulinearGammaTab.empty())
+            Mat(1, 256, CV_16UC1, linearGammaTab_b).copyTo(ulinearGammaTab);
+        if (uLabCbrtTab.empty())
+            Mat(1, LAB_CBRT_TAB_SIZE_B, CV_16UC1, LabCbrtTab_b).copyTo(uLabCbrtTab);
+
+        int coeffs[9];
+        static const softfloat lshift(1 << lab_shift);
+        for( int i = 0; i < 3; i++ )
+        {
+            coeffs[i*3+(bidx^2)] = cvRound(lshift*sRGB2XYZ_D65[i*3  ]/D65[i]);
+            coeffs[i*3+1]        = cvRound(lshift*sRGB2XYZ_D65[i*3+1]/D65[i]);
+            coeffs[i*3+bidx]     = cvRound(lshift*sRGB2XYZ_D65[i*3+2]/D65[i]);
+
+            CV_Assert(coeffs[i*3] >= 0 && coeffs[i*3+1] >= 0 && coeffs[i*3+2] >= 0 &&
+                      coeffs[i*3] + coeffs[i*3+1] + coeffs[i*3+2] < 2*(1 << lab_shift));
+        }
+        Mat(1, 9, CV_32SC1, coeffs).copyTo(ucoeffs);
+
+        const int Lscale = (116*255+50)/100;
+        const int Lshift = -((16*255*(1 << lab_shift2) + 50)/100);
+
+        h.setArg(ocl::KernelArg::PtrReadOnly(srgb ? usRGBGammaTab : ulinearGammaTab));
+        h.setArg(ocl::KernelArg::PtrReadOnly(uLabCbrtTab));
+        h.setArg(ocl::KernelArg::PtrReadOnly(ucoeffs));
+        h.setArg(Lscale); h.setArg(Lshift);
+    }
+    else
+    {
+        static UMat usRGBGammaTab, ucoeffs;
+
+        if (srgb && usRGBGammaTab.empty())
+            Mat(1, GAMMA_TAB_SIZE * 4, CV_32FC1, const_cast<float*>(sRGBGammaTab)).copyTo(usRGBGammaTab);
+
+        softdouble whitePt[3];
+        for(int i = 0; i < 3; i++)
+            whitePt[i] = D65[i];
+
+        softdouble scale[] = { softdouble::one() / whitePt[0],
+                               softdouble::one(),
+                               softdouble::one() / whitePt[2] };
+
+        float coeffs[9];
+        for (int i = 0; i < 3; i++)
+        {
+            int j = i * 3;
+
+            softfloat c0 = scale[i] * sRGB2XYZ_D65[j    ];
+            softfloat c1 = scale[i] * sRGB2XYZ_D65[j + 1];
+            softfloat c2 = scale[i] * sRGB2XYZ_D65[j + 2];
+
+            coeffs[j + (bidx ^ 2)] = c0;
+            coeffs[j + 1]          = c1;
+            coeffs[j + bidx]       = c2;
+
+            CV_Assert( c0 >= 0 && c1 >= 0 && c2 >= 0 &&
+                       c0 + c1 + c2 < softfloat((int)LAB_CBRT_TAB_SIZE));
+        }
+
+        Mat(1, 9, CV_32FC1, coeffs).copyTo(ucoeffs);
+
+        static const float _a = softfloat(16)/softfloat(116);
+        static const float _1_3f = softfloat::one()/softfloat(3);
+        ocl::KernelArg ucoeffsarg = ocl::KernelArg::PtrReadOnly(ucoeffs);
+
+        if (srgb)
+            h.setArg(ocl::KernelArg::PtrReadOnly(usRGBGammaTab));
+
+        h.setArg(ucoeffsarg);
+        h.setArg(_1_3f); h.setArg(_a);
+    }
+
+    return h.run();
+}
+
+
+bool oclCvtColorLab2BGR(InputArray _src, OutputArray _dst, int dcn, int bidx, bool srgb)
+{
+    OclHelper< Set<3>, Set<3, 4>, Set<CV_8U, CV_32F> > h(_src, _dst, dcn);
+
+    if(!h.createKernel("Lab2BGR", ocl::imgproc::color_lab_oclsrc,
+                       format("-D dcn=%d -D bidx=%d%s", dcn, bidx, srgb ? " -D SRGB" : "")))
+    {
+        return false;
+    }
+
+    // Prepare additional arguments
+
+    initLabTabs();
+
+    static UMat ucoeffs, usRGBInvGammaTab;
+
+    if (srgb && usRGBInvGammaTab.empty())
+        Mat(1, GAMMA_TAB_SIZE*4, CV_32FC1, const_cast<float*>(sRGBInvGammaTab)).copyTo(usRGBInvGammaTab);
+
+    float coeffs[9];
+    softdouble whitePt[3];
+    for(int i = 0; i < 3; i++)
+        whitePt[i] = D65[i];
+
+    for( int i = 0; i < 3; i++ )
+    {
+        coeffs[i+(bidx^2)*3] = (float)(XYZ2sRGB_D65[i  ]*whitePt[i]);
+        coeffs[i+3]          = (float)(XYZ2sRGB_D65[i+3]*whitePt[i]);
+        coeffs[i+bidx*3]     = (float)(XYZ2sRGB_D65[i+6]*whitePt[i]);
+    }
+
+    Mat(1, 9, CV_32FC1, coeffs).copyTo(ucoeffs);
+
+    float lThresh = softfloat(8); // 0.008856f * 903.3f  = (6/29)^3*(29/3)^3 = 8
+    float fThresh = softfloat(6)/softfloat(29); // 7.787f * 0.008856f + 16.0f / 116.0f = 6/29
+
+    ocl::KernelArg coeffsarg = ocl::KernelArg::PtrReadOnly(ucoeffs);
+
+    // Set additional arguments and run
+
+    if(srgb)
+        h.setArg(ocl::KernelArg::PtrReadOnly(usRGBInvGammaTab));
+
+    h.setArg(coeffsarg);
+    h.setArg(lThresh);
+    h.setArg(fThresh);
+
+    return h.run();
+}
+
+
+bool oclCvtColorLuv2BGR(InputArray _src, OutputArray _dst, int dcn, int bidx, bool srgb)
+{
+    OclHelper< Set<3>, Set<3, 4>, Set<CV_8U, CV_32F> > h(_src, _dst, dcn);
+
+    if(!h.createKernel("Luv2BGR", ocl::imgproc::color_lab_oclsrc,
+                       format("-D dcn=%d -D bidx=%d%s", dcn, bidx, srgb ? " -D SRGB" : "")))
+    {
+        return false;
+    }
+
+    // Prepare additional arguments
+
+    initLabTabs();
+
+    static UMat ucoeffs, usRGBInvGammaTab;
+
+    if (srgb && usRGBInvGammaTab.empty())
+        Mat(1, GAMMA_TAB_SIZE*4, CV_32FC1, const_cast<float*>(sRGBInvGammaTab)).copyTo(usRGBInvGammaTab);
+
+    float coeffs[9];
+    softdouble whitePt[3];
+    for(int i = 0; i < 3; i++)
+        whitePt[i] = D65[i];
+
+    for( int i = 0; i < 3; i++ )
+    {
+        coeffs[i+(bidx^2)*3] = (float)(XYZ2sRGB_D65[i  ]);
+        coeffs[i+3]          = (float)(XYZ2sRGB_D65[i+3]);
+        coeffs[i+bidx*3]     = (float)(XYZ2sRGB_D65[i+6]);
+    }
+
+    softfloat d = whitePt[0] +
+            whitePt[1]*softdouble(15) +
+            whitePt[2]*softdouble(3);
+    d = softfloat::one()/max(d, softfloat(FLT_EPSILON));
+    float un = softfloat(4*13)*d*whitePt[0];
+    float vn = softfloat(9*13)*d*whitePt[1];
+
+    Mat(1, 9, CV_32FC1, coeffs).copyTo(ucoeffs);
+
+    ocl::KernelArg coeffsarg = ocl::KernelArg::PtrReadOnly(ucoeffs);
+
+    // Set additional arguments and run
+
+    if(srgb)
+        h.setArg(ocl::KernelArg::PtrReadOnly(usRGBInvGammaTab));
+
+    h.setArg(coeffsarg);
+    h.setArg(un); h.setArg(vn);
+
+    return h.run();
+}
+
+
+bool oclCvtColorBGR2XYZ( InputArray _src, OutputArray _dst, int bidx )
+{
+    OclHelper< Set<3, 4>, Set<3>, Set<CV_8U, CV_16U, CV_32F> > h(_src, _dst, 3);
+
+    if(!h.createKernel("RGB2XYZ", ocl::imgproc::color_lab_oclsrc,
+                       format("-D dcn=3 -D bidx=%d", bidx)))
+    {
+        return false;
+    }
+
+    // Prepare additional arguments
+
+    UMat c;
+    if (_src.depth() == CV_32F)
+    {
+        float coeffs[9];
+        for(int i = 0; i < 9; i++)
+            coeffs[i] = (float)sRGB2XYZ_D65[i];
+        if (bidx == 0)
+        {
+            std::swap(coeffs[0], coeffs[2]);
+            std::swap(coeffs[3], coeffs[5]);
+            std::swap(coeffs[6], coeffs[8]);
+        }
+        Mat(1, 9, CV_32FC1, &coeffs[0]).copyTo(c);
+    }
+    else
+    {
+        int coeffs[9];
+        for(int i = 0; i < 9; i++)
+            coeffs[i] = sRGB2XYZ_D65_i[i];
+        if (bidx == 0)
+        {
+            std::swap(coeffs[0], coeffs[2]);
+            std::swap(coeffs[3], coeffs[5]);
+            std::swap(coeffs[6], coeffs[8]);
+        }
+        Mat(1, 9, CV_32SC1, &coeffs[0]).copyTo(c);
+    }
+
+    // Set additional arguments and run
+
+    h.setArg(ocl::KernelArg::PtrReadOnly(c));
+
+    return h.run();
+}
+
+
+bool oclCvtColorXYZ2BGR( InputArray _src, OutputArray _dst, int dcn, int bidx )
+{
+    OclHelper< Set<3>, Set<3, 4>, Set<CV_8U, CV_16U, CV_32F> > h(_src, _dst, dcn);
+
+    if(!h.createKernel("XYZ2RGB", ocl::imgproc::color_lab_oclsrc,
+                       format("-D dcn=%d -D bidx=%d", dcn, bidx)))
+    {
+        return false;
+    }
+
+    // Prepare additional arguments
+
+    UMat c;
+    if (_src.depth() == CV_32F)
+    {
+        float coeffs[9];
+        for(int i = 0; i < 9; i++)
+            coeffs[i] = (float)XYZ2sRGB_D65[i];
+        if (bidx == 0)
+        {
+            std::swap(coeffs[0], coeffs[6]);
+            std::swap(coeffs[1], coeffs[7]);
+            std::swap(coeffs[2], coeffs[8]);
+        }
+        Mat(1, 9, CV_32FC1, &coeffs[0]).copyTo(c);
+    }
+    else
+    {
+        int coeffs[9];
+        for(int i = 0; i < 9; i++)
+            coeffs[i] = XYZ2sRGB_D65_i[i];
+        if (bidx == 0)
+        {
+            std::swap(coeffs[0], coeffs[6]);
+            std::swap(coeffs[1], coeffs[7]);
+            std::swap(coeffs[2], coeffs[8]);
+        }
+        Mat(1, 9, CV_32SC1, &coeffs[0]).copyTo(c);
+    }
+
+    // Set additional arguments and run
+
+    h.setArg(ocl::KernelArg::PtrReadOnly(c));
+
+    return h.run();
+}
+
+#endif
+
+//
+// HAL calls
+//
+
+void cvtColorBGR2Lab( InputArray _src, OutputArray _dst, bool swapb, bool srgb)
+{
+    CvtHelper<Set<3, 4>, Set<3>, Set<CV_8U, CV_32F> > h(_src, _dst, 3);
+
+    hal::cvtBGRtoLab(h.src.data, h.src.step, h.dst.data, h.dst.step, h.src.cols, h.src.rows,
+                     h.depth, h.scn, swapb, true, srgb);
+}
+
+
+void cvtColorBGR2Luv( InputArray _src, OutputArray _dst, bool swapb, bool srgb)
+{
+    CvtHelper< Set<3, 4>, Set<3>, Set<CV_8U, CV_32F> > h(_src, _dst, 3);
+
+    hal::cvtBGRtoLab(h.src.data, h.src.step, h.dst.data, h.dst.step, h.src.cols, h.src.rows,
+                     h.depth, h.scn, swapb, false, srgb);
+}
+
+
+void cvtColorLab2BGR( InputArray _src, OutputArray _dst, int dcn, bool swapb, bool srgb )
+{
+    if( dcn <= 0 ) dcn = 3;
+    CvtHelper< Set<3>, Set<3, 4>, Set<CV_8U, CV_32F> > h(_src, _dst, dcn);
+
+    hal::cvtLabtoBGR(h.src.data, h.src.step, h.dst.data, h.dst.step, h.src.cols, h.src.rows,
+                     h.depth, dcn, swapb, true, srgb);
+}
+
+
+void cvtColorLuv2BGR( InputArray _src, OutputArray _dst, int dcn, bool swapb, bool srgb )
+{
+    if( dcn <= 0 ) dcn = 3;
+    CvtHelper< Set<3>, Set<3, 4>, Set<CV_8U, CV_32F> > h(_src, _dst, dcn);
+
+    hal::cvtLabtoBGR(h.src.data, h.src.step, h.dst.data, h.dst.step, h.src.cols, h.src.rows,
+                     h.depth, dcn, swapb, false, srgb);
+}
+
+
+void cvtColorBGR2XYZ( InputArray _src, OutputArray _dst, bool swapb )
+{
+    CvtHelper< Set<3, 4>, Set<3>, Set<CV_8U, CV_16U, CV_32F> > h(_src, _dst, 3);
+
+    hal::cvtBGRtoXYZ(h.src.data, h.src.step, h.dst.data, h.dst.step, h.src.cols, h.src.rows, h.depth, h.scn, swapb);
+}
+
+
+void cvtColorXYZ2BGR( InputArray _src, OutputArray _dst, int dcn, bool swapb )
+{
+    if( dcn <= 0 ) dcn = 3;
+    CvtHelper< Set<3>, Set<3, 4>, Set<CV_8U, CV_16U, CV_32F> > h(_src, _dst, dcn);
+
+    hal::cvtXYZtoBGR(h.src.data, h.src.step, h.dst.data, h.dst.step, h.src.cols, h.src.rows, h.depth, dcn, swapb);
+}
+
+} // namespace cv
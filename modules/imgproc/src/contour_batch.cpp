@@ -0,0 +1,204 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+
+/****************************************************************************************\
+                       Shape descriptors of many contours at once
+\****************************************************************************************/
+
+namespace cv
+{
+
+// number of contours processed by one parallel stripe
+static const int CONTOUR_BATCH = 256;
+
+static void getContours( InputArrayOfArrays _contours, std::vector<Mat>& contours )
+{
+    int i, n = (int)_contours.total();
+    contours.resize(n);
+    for( i = 0; i < n; i++ )
+        contours[i] = _contours.getMat(i);
+}
+
+class ContourDescriptorsInvoker : public ParallelLoopBody
+{
+public:
+    ContourDescriptorsInvoker(const std::vector<Mat>& _contours, double* _areas, Vec4i* _rects,
+                              Vec<float, 5>* _boxes, double* _moments, bool _oriented) :
+        contours(_contours), areas(_areas), rects(_rects), boxes(_boxes), mom(_moments), oriented(_oriented) {}
+
+    virtual void operator() (const Range& range) const CV_OVERRIDE
+    {
+        for( int i = range.start; i < range.end; i++ )
+        {
+            const Mat& c = contours[i];
+
+            // the descriptors of empty contours are zeros
+            if( c.empty() )
+            {
+                if( areas )
+                    areas[i] = 0;
+                if( rects )
+                    rects[i] = Vec4i();
+                if( boxes )
+                    boxes[i] = Vec<float, 5>();
+                if( mom )
+                    std::fill(mom + i*10, mom + (i + 1)*10, 0.);
+                continue;
+            }
+
+            if( areas )
+                areas[i] = contourArea(c, oriented);
+
+            if( rects )
+            {
+                Rect r = boundingRect(c);
+                rects[i] = Vec4i(r.x, r.y, r.width, r.height);
+            }
+
+            if( boxes )
+            {
+                RotatedRect box = minAreaRect(c);
+                boxes[i] = Vec<float, 5>(box.center.x, box.center.y, box.size.width, box.size.height, box.angle);
+            }
+
+            if( mom )
+            {
+                Moments m = moments(c);
+                double* d = mom + i*10;
+                d[0] = m.m00; d[1] = m.m10; d[2] = m.m01;
+                d[3] = m.m20; d[4] = m.m11; d[5] = m.m02;
+                d[6] = m.m30; d[7] = m.m21; d[8] = m.m12; d[9] = m.m03;
+            }
+        }
+    }
+
+private:
+    const std::vector<Mat>& contours;
+    double* areas;
+    Vec4i* rects;
+    Vec<float, 5>* boxes;
+    double* mom;
+    bool oriented;
+};
+
+enum { CONTOUR_APPROX_POLY = 0, CONTOUR_CONVEX_HULL = 1 };
+
+class ContourPolygonsInvoker : public ParallelLoopBody
+{
+public:
+    ContourPolygonsInvoker(const std::vector<Mat>& _contours, std::vector<Mat>& _results,
+                           int _op, double _epsilon, bool _flag) :
+        contours(_contours), results(_results), op(_op), epsilon(_epsilon), flag(_flag) {}
+
+    virtual void operator() (const Range& range) const CV_OVERRIDE
+    {
+        for( int i = range.start; i < range.end; i++ )
+        {
+            if( contours[i].empty() )
+                continue;
+            if( op == CONTOUR_APPROX_POLY )
+                approxPolyDP(contours[i], results[i], epsilon, flag);
+            else
+                convexHull(contours[i], results[i], flag, true);
+        }
+    }
+
+private:
+    const std::vector<Mat>& contours;
+    std::vector<Mat>& results;
+    int op;
+    double epsilon;
+    bool flag;
+};
+
+static void contourPolygons( InputArrayOfArrays _contours, OutputArrayOfArrays _dst,
+                             int op, double epsilon, bool flag )
+{
+    CV_Assert( _dst.kind() == _InputArray::STD_VECTOR_VECTOR || _dst.kind() == _InputArray::STD_VECTOR_MAT );
+
+    std::vector<Mat> contours;
+    getContours(_contours, contours);
+    int i, n = (int)contours.size();
+
+    std::vector<Mat> results(n);
+    parallel_for_(Range(0, n), ContourPolygonsInvoker(contours, results, op, epsilon, flag),
+                  n/(double)CONTOUR_BATCH);
+
+    // the output arrays are allocated serially, since the vectors of the output are not thread-safe
+    _dst.create(n, 1, 0, -1, true);
+    for( i = 0; i < n; i++ )
+    {
+        const Mat& r = results[i];
+        int type = !r.empty() ? r.type() : _dst.fixedType() ? _dst.type() : contours[i].type();
+        _dst.create((int)r.total(), 1, type, i, true);
+        if( r.empty() )
+            continue;
+        Mat di = _dst.getMat(i);
+        CV_Assert( di.isContinuous() && r.isContinuous() );
+        memcpy(di.ptr(), r.ptr(), r.total()*r.elemSize());
+    }
+}
+
+}
+
+void cv::contourDescriptors( InputArrayOfArrays _contours, OutputArray _areas,
+                             OutputArray _boundingRects, OutputArray _minAreaRects,
+                             OutputArray _moments, bool oriented )
+{
+    CV_INSTRUMENT_REGION();
+
+    std::vector<Mat> contours;
+    getContours(_contours, contours);
+    int n = (int)contours.size();
+
+    double *areas = 0, *mom = 0;
+    Vec4i* rects = 0;
+    Vec<float, 5>* boxes = 0;
+
+    if( _areas.needed() )
+    {
+        _areas.create(n, 1, CV_64F);
+        areas = _areas.getMat().ptr<double>();
+    }
+    if( _boundingRects.needed() )
+    {
+        _boundingRects.create(n, 1, CV_32SC4);
+        rects = _boundingRects.getMat().ptr<Vec4i>();
+    }
+    if( _minAreaRects.needed() )
+    {
+        _minAreaRects.create(n, 1, CV_32FC(5));
+        boxes = _minAreaRects.getMat().ptr<Vec<float, 5> >();
+    }
+    if( _moments.needed() )
+    {
+        _moments.create(n, 10, CV_64F);
+        mom = _moments.getMat().ptr<double>();
+    }
+
+    if( n == 0 || (!areas && !rects && !boxes && !mom) )
+        return;
+
+    parallel_for_(Range(0, n), ContourDescriptorsInvoker(contours, areas, rects, boxes, mom, oriented),
+                  n/(double)CONTOUR_BATCH);
+}
+
+void cv::approxPolyDPBatch( InputArrayOfArrays _curves, OutputArrayOfArrays _approxCurves,
+                            double epsilon, bool closed )
+{
+    CV_INSTRUMENT_REGION();
+
+    contourPolygons(_curves, _approxCurves, CONTOUR_APPROX_POLY, epsilon, closed);
+}
+
+void cv::convexHullBatch( InputArrayOfArrays _contours, OutputArrayOfArrays _hulls, bool clockwise )
+{
+    CV_INSTRUMENT_REGION();
+
+    contourPolygons(_contours, _hulls, CONTOUR_CONVEX_HULL, 0, clockwise);
+}
+
+/* End of file. */
@@ -41,6 +41,98 @@
 //M*/
 #include "precomp.hpp"
 
+namespace cv
+{
+
+// number of corners refined by one parallel stripe
+static const int CORNER_SUBPIX_BATCH = 64;
+
+class CornerSubPixInvoker : public ParallelLoopBody
+{
+public:
+    CornerSubPixInvoker(const Mat& _src, Point2f* _corners, const Mat& _mask, Size _win, int _max_iters, double _eps) :
+        src(_src), corners(_corners), maskm(_mask), win(_win), max_iters(_max_iters), eps(_eps) {}
+
+    virtual void operator() (const Range& range) const CV_OVERRIDE
+    {
+        int win_w = win.width * 2 + 1, win_h = win.height * 2 + 1;
+        int i, j, k;
+        Mat subpix_buf(win_h+2, win_w+2, CV_32F);
+        const float* mask = maskm.ptr<float>();
+
+        for( int pt_i = range.start; pt_i < range.end; pt_i++ )
+        {
+            Point2f cT = corners[pt_i], cI = cT;
+            int iter = 0;
+            double err = 0;
+
+            do
+            {
+                Point2f cI2;
+                double a = 0, b = 0, c = 0, bb1 = 0, bb2 = 0;
+
+                getRectSubPix(src, Size(win_w+2, win_h+2), cI, subpix_buf, subpix_buf.type());
+                const float* subpix = &subpix_buf.at<float>(1,1);
+
+                // process gradient
+                for( i = 0, k = 0; i < win_h; i++, subpix += win_w + 2 )
+                {
+                    double py = i - win.height;
+
+                    for( j = 0; j < win_w; j++, k++ )
+                    {
+                        double m = mask[k];
+                        double tgx = subpix[j+1] - subpix[j-1];
+                        double tgy = subpix[j+win_w+2] - subpix[j-win_w-2];
+                        double gxx = tgx * tgx * m;
+                        double gxy = tgx * tgy * m;
+                        double gyy = tgy * tgy * m;
+                        double px = j - win.width;
+
+                        a += gxx;
+                        b += gxy;
+                        c += gyy;
+
+                        bb1 += gxx * px + gxy * py;
+                        bb2 += gxy * px + gyy * py;
+                    }
+                }
+
+                double det=a*c-b*b;
+                if( fabs( det ) <= DBL_EPSILON*DBL_EPSILON )
+                    break;
+
+                // 2x2 matrix inversion
+                double scale=1.0/det;
+                cI2.x = (float)(cI.x + c*scale*bb1 - b*scale*bb2);
+                cI2.y = (float)(cI.y - b*scale*bb1 + a*scale*bb2);
+                err = (cI2.x - cI.x) * (cI2.x - cI.x) + (cI2.y - cI.y) * (cI2.y - cI.y);
+                cI = cI2;
+                if( cI.x < 0 || cI.x >= src.cols || cI.y < 0 || cI.y >= src.rows )
+                    break;
+            }
+            while( ++iter < max_iters && err > eps );
+
+            // if new point is too far from initial, it means poor convergence.
+            // leave initial point as the result
+            if( fabs( cI.x - cT.x ) > win.width || fabs( cI.y - cT.y ) > win.height )
+                cI = cT;
+
+            corners[pt_i] = cI;
+        }
+    }
+
+private:
+    const Mat& src;
+    Point2f* corners;
+    const Mat& maskm;
+    Size win;
+    int max_iters;
+    double eps;
+};
+
+}
+
 void cv::cornerSubPix( InputArray _image, InputOutputArray _corners,
                        Size win, Size zeroZone, TermCriteria criteria )
 {
@@ -48,7 +140,7 @@ void cv::cornerSubPix( InputArray _image, InputOutputArray _corners,
 
     const int MAX_ITERS = 100;
     int win_w = win.width * 2 + 1, win_h = win.height * 2 + 1;
-    int i, j, k;
+    int i, j;
     int max_iters = (criteria.type & CV_TERMCRIT_ITER) ? MIN(MAX(criteria.maxCount, 1), MAX_ITERS) : MAX_ITERS;
     double eps = (criteria.type & CV_TERMCRIT_EPS) ? MAX(criteria.epsilon, 0.) : 0;
     eps *= eps; // use square of error in comparison operations
@@ -65,7 +157,7 @@ void cv::cornerSubPix( InputArray _image, InputOutputArray _corners,
     CV_Assert( src.cols >= win.width*2 + 5 && src.rows >= win.height*2 + 5 );
     CV_Assert( src.channels() == 1 );
 
-    Mat maskm(win_h, win_w, CV_32F), subpix_buf(win_h+2, win_w+2, CV_32F);
+    Mat maskm(win_h, win_w, CV_32F);
     float* mask = maskm.ptr<float>();
 
     for( i = 0; i < win_h; i++ )
@@ -93,69 +185,10 @@ void cv::cornerSubPix( InputArray _image, InputOutputArray _corners,
     }
 
     // do optimization loop for all the points
-    for( int pt_i = 0; pt_i < count; pt_i++ )
-    {
-        Point2f cT = corners[pt_i], cI = cT;
-        int iter = 0;
-        double err = 0;
-
-        do
-        {
-            Point2f cI2;
-            double a = 0, b = 0, c = 0, bb1 = 0, bb2 = 0;
-
-            getRectSubPix(src, Size(win_w+2, win_h+2), cI, subpix_buf, subpix_buf.type());
-            const float* subpix = &subpix_buf.at<float>(1,1);
-
-            // process gradient
-            for( i = 0, k = 0; i < win_h; i++, subpix += win_w + 2 )
-            {
-                double py = i - win.height;
-
-                for( j = 0; j < win_w; j++, k++ )
-                {
-                    double m = mask[k];
-                    double tgx = subpix[j+1] - subpix[j-1];
-                    double tgy = subpix[j+win_w+2] - subpix[j-win_w-2];
-                    double gxx = tgx * tgx * m;
-                    double gxy = tgx * tgy * m;
-                    double gyy = tgy * tgy * m;
-                    double px = j - win.width;
-
-                    a += gxx;
-                    b += gxy;
-                    c += gyy;
-
-                    bb1 += gxx * px + gxy * py;
-                    bb2 += gxy * px + gyy * py;
-                }
-            }
-
-            double det=a*c-b*b;
-            if( fabs( det ) <= DBL_EPSILON*DBL_EPSILON )
-                break;
-
-            // 2x2 matrix inversion
-            double scale=1.0/det;
-            cI2.x = (float)(cI.x + c*scale*bb1 - b*scale*bb2);
-            cI2.y = (float)(cI.y - b*scale*bb1 + a*scale*bb2);
-            err = (cI2.x - cI.x) * (cI2.x - cI.x) + (cI2.y - cI.y) * (cI2.y - cI.y);
-            cI = cI2;
-            if( cI.x < 0 || cI.x >= src.cols || cI.y < 0 || cI.y >= src.rows )
-                break;
-        }
-        while( ++iter < max_iters && err > eps );
-
-        // if new point is too far from initial, it means poor convergence.
-        // leave initial point as the result
-        if( fabs( cI.x - cT.x ) > win.width || fabs( cI.y - cT.y ) > win.height )
-            cI = cT;
-
-        corners[pt_i] = cI;
-    }
+    parallel_for_(Range(0, count), CornerSubPixInvoker(src, corners, maskm, win, max_iters, eps),
+                  count/(double)CORNER_SUBPIX_BATCH);
 }
 
-
 CV_IMPL void
 cvFindCornerSubPix( const void* srcarr, CvPoint2D32f* _corners,
                    int count, CvSize win, CvSize zeroZone,
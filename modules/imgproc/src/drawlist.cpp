@@ -0,0 +1,520 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+#include "opencv2/core/hal/intrin.hpp"
+
+namespace cv
+{
+
+enum
+{
+    DRAW_LINE = 0,
+    DRAW_RECTANGLE,
+    DRAW_CIRCLE,
+    DRAW_ELLIPSE,
+    DRAW_POLYLINES,
+    DRAW_FILL_POLY,
+    DRAW_FILL_CONVEX_POLY,
+    DRAW_TEXT
+};
+
+// minimal height of a band; smaller bands make too many primitives span several bands
+static const int DRAWLIST_MIN_BAND_HEIGHT = 32;
+static const int DRAWLIST_MAX_BANDS = 64;
+
+struct DrawListPrimitive
+{
+    int kind;
+    Scalar color;
+    int thickness, lineType, shift;
+    Point pt1, pt2;
+    Size axes;
+    double angle, startAngle, endAngle;
+    bool flag;
+    int fontFace;
+    double fontScale;
+    int textIdx;
+    int firstContour, ncontours;
+    double alpha;
+    // conservative range of image columns and rows the primitive may touch, in pixels
+    int64 xmin, xmax, ymin, ymax;
+};
+
+// dst = (dst*(256 - w) + color*w + 128) >> 8 over a span of pixels fully covered by a primitive,
+// color holds the pixel value repeated at least len/cn times
+static void blendSpan8u(uchar* dst, const uchar* color, int len, int w)
+{
+    int i = 0;
+#if CV_SIMD
+    v_uint16 v_w = vx_setall_u16((ushort)w), v_iw = vx_setall_u16((ushort)(256 - w));
+    v_uint16 v_delta = vx_setall_u16(128);
+    for( ; i <= len - v_uint8::nlanes; i += v_uint8::nlanes )
+    {
+        v_uint16 d0, d1, c0, c1;
+        v_expand(vx_load(dst + i), d0, d1);
+        v_expand(vx_load(color + i), c0, c1);
+        d0 = v_shr<8>(d0*v_iw + c0*v_w + v_delta);
+        d1 = v_shr<8>(d1*v_iw + c1*v_w + v_delta);
+        v_store(dst + i, v_pack(d0, d1));
+    }
+    vx_cleanup();
+#endif
+    for( ; i < len; i++ )
+        dst[i] = (uchar)((dst[i]*(256 - w) + color[i]*w + 128) >> 8);
+}
+
+// blends the color into the pixels covered by the mask (coverage 0..255) with the given opacity
+static void blendMasked8u(Mat& img, const Mat& mask, const Scalar& color, double alpha)
+{
+    int cn = img.channels(), width = img.cols;
+    int ialpha = saturate_cast<int>(alpha*256);
+    AutoBuffer<uchar> _cbuf(width*cn);
+    uchar* cbuf = _cbuf.data();
+    for( int i = 0; i < width*cn; i++ )
+        cbuf[i] = saturate_cast<uchar>(color[i % cn]);
+
+    for( int y = 0; y < img.rows; y++ )
+    {
+        const uchar* m = mask.ptr<uchar>(y);
+        uchar* d = img.ptr<uchar>(y);
+        for( int x = 0; x < width; )
+        {
+            if( m[x] == 255 )
+            {
+                int x0 = x;
+                while( x < width && m[x] == 255 )
+                    x++;
+                blendSpan8u(d + x0*cn, cbuf, (x - x0)*cn, ialpha);
+            }
+            else
+            {
+                // partially covered pixels of the antialiased edges, 255 is mapped to 256
+                if( m[x] != 0 )
+                {
+                    int w = ((m[x] + (m[x] >> 7))*ialpha + 128) >> 8;
+                    for( int k = 0; k < cn; k++ )
+                        d[x*cn + k] = (uchar)((d[x*cn + k]*(256 - w) + cbuf[k]*w + 128) >> 8);
+                }
+                x++;
+            }
+        }
+    }
+}
+
+template<typename T> static void
+blendMasked_(Mat& img, const Mat& mask, const Scalar& color, double alpha)
+{
+    int cn = img.channels();
+    for( int y = 0; y < img.rows; y++ )
+    {
+        const uchar* m = mask.ptr<uchar>(y);
+        T* d = img.ptr<T>(y);
+        for( int x = 0; x < img.cols; x++, d += cn )
+        {
+            if( m[x] == 0 )
+                continue;
+            double a = alpha*m[x]*(1./255);
+            for( int k = 0; k < cn; k++ )
+                d[k] = saturate_cast<T>(d[k] + (color[k] - d[k])*a);
+        }
+    }
+}
+
+struct DrawList::Impl
+{
+    std::vector<DrawListPrimitive> prims;
+    std::vector<Point> points;
+    std::vector<int> contourOfs;
+    std::vector<String> texts;
+    // opacity of the primitives being added
+    double alpha;
+
+    Impl() : alpha(1.) { contourOfs.push_back(0); }
+
+    DrawListPrimitive& add(int kind, const Scalar& color, int thickness, int lineType, int shift)
+    {
+        CV_Assert( 0 <= shift && shift <= 16 );
+        DrawListPrimitive prim = DrawListPrimitive();
+        prim.kind = kind;
+        prim.color = color;
+        prim.thickness = thickness;
+        prim.lineType = lineType;
+        prim.shift = shift;
+        prim.alpha = alpha;
+        prim.xmin = std::numeric_limits<int>::max();
+        prim.xmax = std::numeric_limits<int>::min();
+        prim.ymin = std::numeric_limits<int>::max();
+        prim.ymax = std::numeric_limits<int>::min();
+        prims.push_back(prim);
+        return prims.back();
+    }
+
+    // extends the extent by the box [x0, x1] x [y0, y1] given in the fixed-point coordinates
+    static void extend(DrawListPrimitive& prim, int64 x0, int64 y0, int64 x1, int64 y1)
+    {
+        int64 one = (int64)1 << prim.shift;
+        prim.xmin = std::min(prim.xmin, x0 >> prim.shift);
+        prim.xmax = std::max(prim.xmax, (x1 + one - 1) >> prim.shift);
+        prim.ymin = std::min(prim.ymin, y0 >> prim.shift);
+        prim.ymax = std::max(prim.ymax, (y1 + one - 1) >> prim.shift);
+    }
+
+    // accounts for the line width and the antialiasing fringe
+    static void finish(DrawListPrimitive& prim)
+    {
+        int64 margin = std::max(prim.thickness, 1) + 2;
+        prim.xmin -= margin;
+        prim.xmax += margin;
+        prim.ymin -= margin;
+        prim.ymax += margin;
+    }
+
+    void addContours(DrawListPrimitive& prim, InputArrayOfArrays pts, bool manyContours, Point offset)
+    {
+        int ncontours = manyContours ? (int)pts.total() : 1;
+        prim.firstContour = (int)contourOfs.size() - 1;
+        prim.ncontours = ncontours;
+        for( int i = 0; i < ncontours; i++ )
+        {
+            Mat p = pts.getMat(manyContours ? i : -1);
+            if( p.total() > 0 )
+            {
+                CV_Assert(p.checkVector(2, CV_32S) >= 0);
+                const Point* v = p.ptr<Point>();
+                int n = p.rows*p.cols*p.channels()/2;
+                for( int j = 0; j < n; j++ )
+                {
+                    points.push_back(v[j]);
+                    extend(prim, (int64)v[j].x + offset.x, (int64)v[j].y + offset.y,
+                           (int64)v[j].x + offset.x, (int64)v[j].y + offset.y);
+                }
+            }
+            contourOfs.push_back((int)points.size());
+        }
+    }
+
+    void render(Mat& img, const DrawListPrimitive& prim) const
+    {
+        if( prim.alpha >= 1 )
+        {
+            rasterize(img, prim, Point());
+            return;
+        }
+
+        // translucent primitives are rasterized into a coverage mask over their bounding box,
+        // which is then blended into the image span by span
+        int64 x0 = std::max(prim.xmin, (int64)0), x1 = std::min(prim.xmax + 1, (int64)img.cols);
+        int64 y0 = std::max(prim.ymin, (int64)0), y1 = std::min(prim.ymax + 1, (int64)img.rows);
+        if( x0 >= x1 || y0 >= y1 || prim.alpha <= 0 )
+            return;
+
+        Rect roi((int)x0, (int)y0, (int)(x1 - x0), (int)(y1 - y0));
+
+        Mat mask(roi.size(), CV_8U, Scalar::all(0)), dst = img(roi);
+        DrawListPrimitive q = prim;
+        q.color = Scalar::all(255);
+        // the drawing functions antialias 8-bit images only, the mask shouldn't do it for others
+        if( q.lineType == LINE_AA && img.depth() != CV_8U )
+            q.lineType = LINE_8;
+        rasterize(mask, q, -roi.tl());
+
+        switch( img.depth() )
+        {
+        case CV_8U: blendMasked8u(dst, mask, prim.color, prim.alpha); break;
+        case CV_8S: blendMasked_<schar>(dst, mask, prim.color, prim.alpha); break;
+        case CV_16U: blendMasked_<ushort>(dst, mask, prim.color, prim.alpha); break;
+        case CV_16S: blendMasked_<short>(dst, mask, prim.color, prim.alpha); break;
+        case CV_32S: blendMasked_<int>(dst, mask, prim.color, prim.alpha); break;
+        case CV_32F: blendMasked_<float>(dst, mask, prim.color, prim.alpha); break;
+        case CV_64F: blendMasked_<double>(dst, mask, prim.color, prim.alpha); break;
+        default:
+            CV_Error(Error::StsUnsupportedFormat, "");
+        }
+    }
+
+    // draws the primitive moved by the offset given in pixels
+    void rasterize(Mat& img, const DrawListPrimitive& prim, Point offset) const
+    {
+        Point d = offset * (1 << prim.shift);
+        switch( prim.kind )
+        {
+        case DRAW_LINE:
+            cv::line(img, prim.pt1 + d, prim.pt2 + d, prim.color, prim.thickness, prim.lineType, prim.shift);
+            break;
+        case DRAW_RECTANGLE:
+            cv::rectangle(img, prim.pt1 + d, prim.pt2 + d, prim.color, prim.thickness, prim.lineType, prim.shift);
+            break;
+        case DRAW_CIRCLE:
+            cv::circle(img, prim.pt1 + d, prim.axes.width, prim.color, prim.thickness, prim.lineType, prim.shift);
+            break;
+        case DRAW_ELLIPSE:
+            cv::ellipse(img, prim.pt1 + d, prim.axes, prim.angle, prim.startAngle, prim.endAngle,
+                        prim.color, prim.thickness, prim.lineType, prim.shift);
+            break;
+        case DRAW_POLYLINES:
+        case DRAW_FILL_POLY:
+        case DRAW_FILL_CONVEX_POLY:
+            {
+            AutoBuffer<const Point*> _ptsptr(prim.ncontours);
+            AutoBuffer<int> _npts(prim.ncontours);
+            const Point** ptsptr = _ptsptr.data();
+            int* npts = _npts.data();
+            int first = contourOfs[prim.firstContour];
+            std::vector<Point> moved;
+            if( d != Point() )
+            {
+                moved.resize(contourOfs[prim.firstContour + prim.ncontours] - first);
+                for( size_t i = 0; i < moved.size(); i++ )
+                    moved[i] = points[first + i] + d;
+            }
+            for( int i = 0; i < prim.ncontours; i++ )
+            {
+                int ofs = contourOfs[prim.firstContour + i];
+                npts[i] = contourOfs[prim.firstContour + i + 1] - ofs;
+                ptsptr[i] = npts[i] <= 0 ? 0 : moved.empty() ? &points[ofs] : &moved[ofs - first];
+            }
+            if( prim.kind == DRAW_POLYLINES )
+                cv::polylines(img, ptsptr, npts, prim.ncontours, prim.flag,
+                              prim.color, prim.thickness, prim.lineType, prim.shift);
+            else if( prim.kind == DRAW_FILL_POLY )
+                cv::fillPoly(img, ptsptr, npts, prim.ncontours,
+                             prim.color, prim.lineType, prim.shift, prim.pt1);
+            else
+                cv::fillConvexPoly(img, ptsptr[0], npts[0], prim.color, prim.lineType, prim.shift);
+            }
+            break;
+        case DRAW_TEXT:
+            cv::putText(img, texts[prim.textIdx], prim.pt1 + d, prim.fontFace, prim.fontScale,
+                        prim.color, prim.thickness, prim.lineType, prim.flag);
+            break;
+        default:
+            CV_Error(Error::StsInternal, "");
+        }
+    }
+};
+
+class DrawListBandsInvoker : public ParallelLoopBody
+{
+public:
+    DrawListBandsInvoker(const DrawList::Impl& _impl, Mat& _img,
+                         const std::vector<std::vector<int> >& _bands)
+        : impl(_impl), img(_img), bands(_bands)
+    {
+    }
+
+    virtual void operator() (const Range& range) const CV_OVERRIDE
+    {
+        for( int b = range.start; b < range.end; b++ )
+        {
+            const std::vector<int>& idx = bands[b];
+            for( size_t i = 0; i < idx.size(); i++ )
+                impl.render(img, impl.prims[idx[i]]);
+        }
+    }
+
+private:
+    const DrawList::Impl& impl;
+    Mat& img;
+    const std::vector<std::vector<int> >& bands;
+};
+
+DrawList::DrawList() : p(makePtr<Impl>())
+{
+}
+
+void DrawList::line(Point pt1, Point pt2, const Scalar& color,
+                    int thickness, int lineType, int shift)
+{
+    CV_Assert( 0 < thickness );
+    DrawListPrimitive& prim = p->add(DRAW_LINE, color, thickness, lineType, shift);
+    prim.pt1 = pt1;
+    prim.pt2 = pt2;
+    Impl::extend(prim, std::min(pt1.x, pt2.x), std::min(pt1.y, pt2.y), std::max(pt1.x, pt2.x), std::max(pt1.y, pt2.y));
+    Impl::finish(prim);
+}
+
+void DrawList::rectangle(Point pt1, Point pt2, const Scalar& color,
+                         int thickness, int lineType, int shift)
+{
+    DrawListPrimitive& prim = p->add(DRAW_RECTANGLE, color, thickness, lineType, shift);
+    prim.pt1 = pt1;
+    prim.pt2 = pt2;
+    Impl::extend(prim, std::min(pt1.x, pt2.x), std::min(pt1.y, pt2.y), std::max(pt1.x, pt2.x), std::max(pt1.y, pt2.y));
+    Impl::finish(prim);
+}
+
+void DrawList::rectangle(Rect rec, const Scalar& color,
+                         int thickness, int lineType, int shift)
+{
+    CV_Assert( 0 <= shift && shift <= 16 );
+    if( !rec.empty() )
+        rectangle(rec.tl(), rec.br() - Point(1 << shift, 1 << shift),
+                  color, thickness, lineType, shift);
+}
+
+void DrawList::circle(Point center, int radius, const Scalar& color,
+                      int thickness, int lineType, int shift)
+{
+    CV_Assert( radius >= 0 );
+    DrawListPrimitive& prim = p->add(DRAW_CIRCLE, color, thickness, lineType, shift);
+    prim.pt1 = center;
+    prim.axes = Size(radius, radius);
+    Impl::extend(prim, (int64)center.x - radius, (int64)center.y - radius,
+                 (int64)center.x + radius, (int64)center.y + radius);
+    Impl::finish(prim);
+}
+
+void DrawList::ellipse(Point center, Size axes, double angle, double startAngle, double endAngle,
+                       const Scalar& color, int thickness, int lineType, int shift)
+{
+    CV_Assert( axes.width >= 0 && axes.height >= 0 );
+    DrawListPrimitive& prim = p->add(DRAW_ELLIPSE, color, thickness, lineType, shift);
+    prim.pt1 = center;
+    prim.axes = axes;
+    prim.angle = angle;
+    prim.startAngle = startAngle;
+    prim.endAngle = endAngle;
+    int64 r = std::max(axes.width, axes.height);
+    Impl::extend(prim, center.x - r, center.y - r, center.x + r, center.y + r);
+    Impl::finish(prim);
+}
+
+void DrawList::polylines(InputArrayOfArrays pts, bool isClosed, const Scalar& color,
+                         int thickness, int lineType, int shift)
+{
+    CV_Assert( 0 <= thickness );
+    bool manyContours = pts.kind() == _InputArray::STD_VECTOR_VECTOR ||
+                        pts.kind() == _InputArray::STD_VECTOR_MAT;
+    if( manyContours && pts.total() == 0 )
+        return;
+    DrawListPrimitive& prim = p->add(DRAW_POLYLINES, color, thickness, lineType, shift);
+    prim.flag = isClosed;
+    p->addContours(prim, pts, manyContours, Point());
+    Impl::finish(prim);
+}
+
+void DrawList::fillPoly(InputArrayOfArrays pts, const Scalar& color,
+                        int lineType, int shift, Point offset)
+{
+    if( pts.total() == 0 )
+        return;
+    DrawListPrimitive& prim = p->add(DRAW_FILL_POLY, color, -1, lineType, shift);
+    prim.pt1 = offset;
+    p->addContours(prim, pts, true, offset);
+    Impl::finish(prim);
+}
+
+void DrawList::fillConvexPoly(InputArray points, const Scalar& color,
+                              int lineType, int shift)
+{
+    if( points.total() == 0 )
+        return;
+    DrawListPrimitive& prim = p->add(DRAW_FILL_CONVEX_POLY, color, -1, lineType, shift);
+    p->addContours(prim, points, false, Point());
+    Impl::finish(prim);
+}
+
+void DrawList::putText(const String& text, Point org, int fontFace, double fontScale, Scalar color,
+                       int thickness, int lineType, bool bottomLeftOrigin)
+{
+    if( text.empty() )
+        return;
+    DrawListPrimitive& prim = p->add(DRAW_TEXT, color, thickness, lineType, 0);
+    prim.pt1 = org;
+    prim.fontFace = fontFace;
+    prim.fontScale = fontScale;
+    prim.flag = bottomLeftOrigin;
+    prim.textIdx = (int)p->texts.size();
+    p->texts.push_back(text);
+    // Hershey glyph coordinates together with the font base line stay within 65 font units
+    int64 r = cvCeil(std::abs(fontScale)*65);
+    int baseline = 0;
+    int64 w = getTextSize(text, fontFace, fontScale, thickness, &baseline).width;
+    Impl::extend(prim, (int64)org.x - r, (int64)org.y - r, (int64)org.x + w + r, (int64)org.y + r);
+    Impl::finish(prim);
+}
+
+void DrawList::draw(InputOutputArray _img) const
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat img = _img.getMat();
+    const Impl& impl = *p;
+    size_t i, n = impl.prims.size();
+    int nbands = std::min(img.rows / DRAWLIST_MIN_BAND_HEIGHT, (int)DRAWLIST_MAX_BANDS);
+
+    if( nbands <= 1 || n < 2 )
+    {
+        for( i = 0; i < n; i++ )
+            impl.render(img, impl.prims[i]);
+        return;
+    }
+
+    int bandHeight = (img.rows + nbands - 1) / nbands;
+    std::vector<std::vector<int> > bands(nbands);
+    int nonEmpty = 0, lastBand = -1;
+
+    for( i = 0; i <= n; i++ )
+    {
+        int b0 = -1, b1 = -1;
+        if( i < n )
+        {
+            const DrawListPrimitive& prim = impl.prims[i];
+            b0 = (int)(std::min(std::max(prim.ymin, (int64)0), (int64)img.rows - 1) / bandHeight);
+            b1 = (int)(std::min(std::max(prim.ymax, (int64)0), (int64)img.rows - 1) / bandHeight);
+            if( b0 == b1 )
+            {
+                if( bands[b0].empty() )
+                    nonEmpty++;
+                bands[b0].push_back((int)i);
+                lastBand = b0;
+                continue;
+            }
+        }
+
+        // the primitive spans several bands or the list is over: flush the accumulated run
+        if( nonEmpty > 1 )
+            parallel_for_(Range(0, nbands), DrawListBandsInvoker(impl, img, bands));
+        else if( nonEmpty == 1 )
+            DrawListBandsInvoker(impl, img, bands)(Range(lastBand, lastBand + 1));
+        for( int b = 0; b < nbands; b++ )
+            bands[b].clear();
+        nonEmpty = 0;
+
+        if( i < n )
+            impl.render(img, impl.prims[i]);
+    }
+}
+
+void DrawList::setOpacity(double alpha)
+{
+    CV_Assert( 0 <= alpha && alpha <= 1 );
+    p->alpha = alpha;
+}
+
+double DrawList::getOpacity() const
+{
+    return p->alpha;
+}
+
+void DrawList::clear()
+{
+    p->prims.clear();
+    p->points.clear();
+    p->contourOfs.resize(1);
+    p->texts.clear();
+}
+
+size_t DrawList::size() const
+{
+    return p->prims.size();
+}
+
+bool DrawList::empty() const
+{
+    return p->prims.empty();
+}
+
+}
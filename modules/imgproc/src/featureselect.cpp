@@ -356,6 +356,177 @@ static bool openvx_harris(Mat image, OutputArray _corners,
 
 #endif
 
+// collects the pointers to the local maxima of the thresholded corner quality measure. The rows are
+// split into stripes that are scanned in parallel and concatenated in order, so the list is the same
+// as the one of a serial scan.
+class CornerCandidatesInvoker : public ParallelLoopBody
+{
+public:
+    CornerCandidatesInvoker(const Mat& _eig, const Mat& _tmp, const Mat& _mask,
+                            std::vector< std::vector<const float*> >& _parts) :
+        eig(_eig), tmp(_tmp), mask(_mask), parts(_parts) {}
+
+    virtual void operator() (const Range& range) const CV_OVERRIDE
+    {
+        int rows = eig.rows - 2, nparts = (int)parts.size();
+
+        for( int i = range.start; i < range.end; i++ )
+        {
+            std::vector<const float*>& part = parts[i];
+            int y0 = 1 + rows*i/nparts, y1 = 1 + rows*(i + 1)/nparts;
+
+            for( int y = y0; y < y1; y++ )
+            {
+                const float* eig_data = (const float*)eig.ptr(y);
+                const float* tmp_data = (const float*)tmp.ptr(y);
+                const uchar* mask_data = mask.data ? mask.ptr(y) : 0;
+
+                for( int x = 1; x < eig.cols - 1; x++ )
+                {
+                    float val = eig_data[x];
+                    if( val != 0 && val == tmp_data[x] && (!mask_data || mask_data[x]) )
+                        part.push_back(eig_data + x);
+                }
+            }
+        }
+    }
+
+private:
+    const Mat& eig;
+    const Mat& tmp;
+    const Mat& mask;
+    std::vector< std::vector<const float*> >& parts;
+};
+
+static bool isFarFromCorners( const std::vector<std::vector<Point2f> >& grid, int grid_width, int grid_height,
+                              int cell_size, int x, int y, double minDistance2 )
+{
+    int x_cell = x / cell_size;
+    int y_cell = y / cell_size;
+
+    // boundary check
+    int x1 = std::max(0, x_cell - 1);
+    int y1 = std::max(0, y_cell - 1);
+    int x2 = std::min(grid_width - 1, x_cell + 1);
+    int y2 = std::min(grid_height - 1, y_cell + 1);
+
+    for( int yy = y1; yy <= y2; yy++ )
+    {
+        for( int xx = x1; xx <= x2; xx++ )
+        {
+            const std::vector<Point2f>& m = grid[yy*grid_width + xx];
+
+            for( size_t j = 0; j < m.size(); j++ )
+            {
+                float dx = x - m[j].x;
+                float dy = y - m[j].y;
+
+                if( dx*dx + dy*dy < minDistance2 )
+                    return false;
+            }
+        }
+    }
+    return true;
+}
+
+// picks the corners greedily in the descending order of the quality measure. Only the scanned part of
+// the candidate list has to be sorted, so it is sorted in chunks of growing size selected with
+// nth_element. The comparison is a strict total order, so the result is the same as with a full sort.
+// If cellsGrid is not empty, at most maxCornersPerCell corners are taken from each of its cells.
+static void selectCorners( const Mat& eig, std::vector<const float*>& tmpCorners, std::vector<Point2f>& corners,
+                           int maxCorners, double minDistance, Size cellsGrid, int maxCornersPerCell )
+{
+    int w = eig.cols;
+    int h = eig.rows;
+
+    // Partition the image into larger grids
+    const int cell_size = minDistance >= 1 ? cvRound(minDistance) : 1;
+    const int grid_width = minDistance >= 1 ? (w + cell_size - 1) / cell_size : 0;
+    const int grid_height = minDistance >= 1 ? (h + cell_size - 1) / cell_size : 0;
+    std::vector<std::vector<Point2f> > grid(grid_width*grid_height);
+    const double minDistance2 = minDistance*minDistance;
+
+    std::vector<int> cellCount(cellsGrid.area(), 0);
+
+    std::vector<const float*>::iterator first = tmpCorners.begin(), last = tmpCorners.end();
+    size_t total = tmpCorners.size(), sorted = 0, chunk = maxCorners > 0 ? (size_t)maxCorners*2 : total;
+
+    for( size_t i = 0; i < total; i++ )
+    {
+        if( i == sorted )
+        {
+            size_t next = std::min(total, sorted + chunk);
+            if( next < total )
+                std::nth_element(first + sorted, first + next, last, greaterThanPtr());
+            std::sort(first + sorted, first + next, greaterThanPtr());
+            sorted = next;
+            chunk *= 2;
+        }
+
+        int ofs = (int)((const uchar*)tmpCorners[i] - eig.ptr());
+        int y = (int)(ofs / eig.step);
+        int x = (int)((ofs - y*eig.step)/sizeof(float));
+
+        int cell = -1;
+        if( !cellCount.empty() )
+        {
+            cell = (y*cellsGrid.height/h)*cellsGrid.width + x*cellsGrid.width/w;
+            if( cellCount[cell] >= maxCornersPerCell )
+                continue;
+        }
+
+        if( minDistance >= 1 )
+        {
+            if( !isFarFromCorners(grid, grid_width, grid_height, cell_size, x, y, minDistance2) )
+                continue;
+            grid[(y / cell_size)*grid_width + x / cell_size].push_back(Point2f((float)x, (float)y));
+        }
+
+        if( cell >= 0 )
+            cellCount[cell]++;
+
+        corners.push_back(Point2f((float)x, (float)y));
+        if( maxCorners > 0 && (int)corners.size() == maxCorners )
+            break;
+    }
+}
+
+static void goodFeaturesToTrack_( const Mat& image, const Mat& mask, std::vector<Point2f>& corners,
+                                  int maxCorners, double qualityLevel, double minDistance,
+                                  int blockSize, int gradientSize, bool useHarrisDetector, double harrisK,
+                                  Size cellsGrid = Size(), int maxCornersPerCell = 0 )
+{
+    Mat eig, tmp;
+
+    if( useHarrisDetector )
+        cornerHarris( image, eig, blockSize, gradientSize, harrisK );
+    else
+        cornerMinEigenVal( image, eig, blockSize, gradientSize );
+
+    double maxVal = 0;
+    minMaxLoc( eig, 0, &maxVal, 0, 0, mask );
+    threshold( eig, eig, maxVal*qualityLevel, 0, THRESH_TOZERO );
+    dilate( eig, tmp, Mat());
+
+    // collect list of pointers to features - put them into temporary image
+    int nparts = std::max(std::min(getNumThreads()*4, image.rows - 2), 1);
+    std::vector< std::vector<const float*> > parts(nparts);
+    parallel_for_(Range(0, nparts), CornerCandidatesInvoker(eig, tmp, mask, parts), nparts);
+
+    std::vector<const float*> tmpCorners;
+    size_t total = 0;
+    for( int i = 0; i < nparts; i++ )
+        total += parts[i].size();
+    if( total == 0 )
+        return;
+
+    tmpCorners.reserve(total);
+    for( int i = 0; i < nparts; i++ )
+        tmpCorners.insert(tmpCorners.end(), parts[i].begin(), parts[i].end());
+
+    selectCorners(eig, tmpCorners, corners, maxCorners, minDistance, cellsGrid, maxCornersPerCell);
+}
+
 }
 
 void cv::goodFeaturesToTrack( InputArray _image, OutputArray _corners,
@@ -372,7 +543,7 @@ void cv::goodFeaturesToTrack( InputArray _image, OutputArray _corners,
                ocl_goodFeaturesToTrack(_image, _corners, maxCorners, qualityLevel, minDistance,
                                     _mask, blockSize, gradientSize, useHarrisDetector, harrisK))
 
-    Mat image = _image.getMat(), eig, tmp;
+    Mat image = _image.getMat();
     if (image.empty())
     {
         _corners.release();
@@ -384,132 +555,47 @@ void cv::goodFeaturesToTrack( InputArray _image, OutputArray _corners,
                !ovx::skipSmallImages<VX_KERNEL_HARRIS_CORNERS>(image.cols, image.rows),
                openvx_harris(image, _corners, maxCorners, qualityLevel, minDistance, blockSize, gradientSize, harrisK))
 
-    if( useHarrisDetector )
-        cornerHarris( image, eig, blockSize, gradientSize, harrisK );
-    else
-        cornerMinEigenVal( image, eig, blockSize, gradientSize );
-
-    double maxVal = 0;
-    minMaxLoc( eig, 0, &maxVal, 0, 0, _mask );
-    threshold( eig, eig, maxVal*qualityLevel, 0, THRESH_TOZERO );
-    dilate( eig, tmp, Mat());
-
-    Size imgsize = image.size();
-    std::vector<const float*> tmpCorners;
-
-    // collect list of pointers to features - put them into temporary image
-    Mat mask = _mask.getMat();
-    for( int y = 1; y < imgsize.height - 1; y++ )
-    {
-        const float* eig_data = (const float*)eig.ptr(y);
-        const float* tmp_data = (const float*)tmp.ptr(y);
-        const uchar* mask_data = mask.data ? mask.ptr(y) : 0;
-
-        for( int x = 1; x < imgsize.width - 1; x++ )
-        {
-            float val = eig_data[x];
-            if( val != 0 && val == tmp_data[x] && (!mask_data || mask_data[x]) )
-                tmpCorners.push_back(eig_data + x);
-        }
-    }
-
     std::vector<Point2f> corners;
-    size_t i, j, total = tmpCorners.size(), ncorners = 0;
+    goodFeaturesToTrack_( image, _mask.getMat(), corners, maxCorners, qualityLevel, minDistance,
+                          blockSize, gradientSize, useHarrisDetector, harrisK );
 
-    if (total == 0)
+    if (corners.empty())
     {
         _corners.release();
         return;
     }
 
-    std::sort( tmpCorners.begin(), tmpCorners.end(), greaterThanPtr() );
-
-    if (minDistance >= 1)
-    {
-         // Partition the image into larger grids
-        int w = image.cols;
-        int h = image.rows;
-
-        const int cell_size = cvRound(minDistance);
-        const int grid_width = (w + cell_size - 1) / cell_size;
-        const int grid_height = (h + cell_size - 1) / cell_size;
-
-        std::vector<std::vector<Point2f> > grid(grid_width*grid_height);
-
-        minDistance *= minDistance;
-
-        for( i = 0; i < total; i++ )
-        {
-            int ofs = (int)((const uchar*)tmpCorners[i] - eig.ptr());
-            int y = (int)(ofs / eig.step);
-            int x = (int)((ofs - y*eig.step)/sizeof(float));
-
-            bool good = true;
-
-            int x_cell = x / cell_size;
-            int y_cell = y / cell_size;
-
-            int x1 = x_cell - 1;
-            int y1 = y_cell - 1;
-            int x2 = x_cell + 1;
-            int y2 = y_cell + 1;
-
-            // boundary check
-            x1 = std::max(0, x1);
-            y1 = std::max(0, y1);
-            x2 = std::min(grid_width-1, x2);
-            y2 = std::min(grid_height-1, y2);
-
-            for( int yy = y1; yy <= y2; yy++ )
-            {
-                for( int xx = x1; xx <= x2; xx++ )
-                {
-                    std::vector <Point2f> &m = grid[yy*grid_width + xx];
-
-                    if( m.size() )
-                    {
-                        for(j = 0; j < m.size(); j++)
-                        {
-                            float dx = x - m[j].x;
-                            float dy = y - m[j].y;
+    Mat(corners).convertTo(_corners, _corners.fixedType() ? _corners.type() : CV_32F);
+}
 
-                            if( dx*dx + dy*dy < minDistance )
-                            {
-                                good = false;
-                                goto break_out;
-                            }
-                        }
-                    }
-                }
-            }
+void cv::goodFeaturesToTrackGrid( InputArray _image, OutputArray _corners,
+                                  Size gridSize, int maxCornersPerCell,
+                                  double qualityLevel, double minDistance,
+                                  InputArray _mask, int blockSize, int gradientSize,
+                                  bool useHarrisDetector, double harrisK )
+{
+    CV_INSTRUMENT_REGION();
 
-            break_out:
+    CV_Assert( gridSize.width > 0 && gridSize.height > 0 && maxCornersPerCell > 0 );
+    CV_Assert( qualityLevel > 0 && minDistance >= 0 );
+    CV_Assert( _mask.empty() || (_mask.type() == CV_8UC1 && _mask.sameSize(_image)) );
 
-            if (good)
-            {
-                grid[y_cell*grid_width + x_cell].push_back(Point2f((float)x, (float)y));
+    Mat image = _image.getMat();
+    if (image.empty())
+    {
+        _corners.release();
+        return;
+    }
 
-                corners.push_back(Point2f((float)x, (float)y));
-                ++ncorners;
+    std::vector<Point2f> corners;
+    goodFeaturesToTrack_( image, _mask.getMat(), corners, gridSize.area()*maxCornersPerCell,
+                          qualityLevel, minDistance, blockSize, gradientSize, useHarrisDetector, harrisK,
+                          gridSize, maxCornersPerCell );
 
-                if( maxCorners > 0 && (int)ncorners == maxCorners )
-                    break;
-            }
-        }
-    }
-    else
+    if (corners.empty())
     {
-        for( i = 0; i < total; i++ )
-        {
-            int ofs = (int)((const uchar*)tmpCorners[i] - eig.ptr());
-            int y = (int)(ofs / eig.step);
-            int x = (int)((ofs - y*eig.step)/sizeof(float));
-
-            corners.push_back(Point2f((float)x, (float)y));
-            ++ncorners;
-            if( maxCorners > 0 && (int)ncorners == maxCorners )
-                break;
-        }
+        _corners.release();
+        return;
     }
 
     Mat(corners).convertTo(_corners, _corners.fixedType() ? _corners.type() : CV_32F);
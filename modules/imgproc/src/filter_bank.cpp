@@ -0,0 +1,144 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+
+/****************************************************************************************\
+                                    Filter bank
+\****************************************************************************************/
+
+namespace cv
+{
+
+// kernels with at least this number of elements are applied in the frequency domain,
+// the same threshold as the one filter2D uses for float images
+static const int FILTER_BANK_DFT_MIN_AREA = 130;
+
+// the image extrapolated by the largest kernel margins and its spectrum, shared by all the kernels
+struct FilterBankSpectrum
+{
+    Mat spectrum;
+    Size dftSize;
+    int top, left;
+};
+
+class FilterBankInvoker : public ParallelLoopBody
+{
+public:
+    FilterBankInvoker(const Mat& _src, const std::vector<Mat>& _kernels, std::vector<Mat>& _dst,
+                      const FilterBankSpectrum& _sp, int _borderType) :
+        src(_src), kernels(_kernels), dst(_dst), sp(_sp), borderType(_borderType) {}
+
+    virtual void operator() (const Range& range) const CV_OVERRIDE
+    {
+        for( int i = range.start; i < range.end; i++ )
+        {
+            const Mat& kernel = kernels[i];
+            if( kernel.total() < (size_t)FILTER_BANK_DFT_MIN_AREA )
+            {
+                filter2D(src, dst[i], dst[i].depth(), kernel, Point(-1, -1), 0, borderType);
+                continue;
+            }
+
+            Mat kpad(sp.dftSize, CV_32F, Scalar::all(0)), kspec, prod, corr;
+            kernel.convertTo(kpad(Rect(0, 0, kernel.cols, kernel.rows)), CV_32F);
+            dft(kpad, kspec, 0, kernel.rows);
+
+            // conjugating the kernel spectrum gives the correlation, as filter2D computes
+            mulSpectrums(sp.spectrum, kspec, prod, 0, true);
+            dft(prod, corr, DFT_INVERSE | DFT_REAL_OUTPUT | DFT_SCALE, sp.top + src.rows);
+
+            Rect roi(sp.left - kernel.cols/2, sp.top - kernel.rows/2, src.cols, src.rows);
+            corr(roi).convertTo(dst[i], dst[i].depth());
+        }
+    }
+
+private:
+    const Mat& src;
+    const std::vector<Mat>& kernels;
+    std::vector<Mat>& dst;
+    const FilterBankSpectrum& sp;
+    int borderType;
+};
+
+}
+
+void cv::filterBank( InputArray _src, InputArrayOfArrays _kernels, OutputArrayOfArrays _dst,
+                     int ddepth, int borderType )
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat src = _src.getMat();
+    CV_Assert( src.channels() == 1 );
+    CV_Assert( ddepth == CV_32F || ddepth == CV_64F );
+    CV_Assert( (borderType & ~BORDER_ISOLATED) != BORDER_WRAP );
+    CV_Assert( _dst.kind() == _InputArray::STD_VECTOR_MAT );
+
+    int i, n = (int)_kernels.total();
+    std::vector<Mat> kernels(n), dst(n);
+
+    // the margins the image is extrapolated by before the transform
+    int top = 0, bottom = 0, left = 0, right = 0;
+    bool useDFT = false;
+    for( i = 0; i < n; i++ )
+    {
+        kernels[i] = _kernels.getMat(i);
+        const Mat& k = kernels[i];
+        CV_Assert( !k.empty() && k.channels() == 1 && (k.depth() == CV_32F || k.depth() == CV_64F) );
+        if( k.total() >= (size_t)FILTER_BANK_DFT_MIN_AREA )
+        {
+            useDFT = true;
+            top = std::max(top, k.rows/2);
+            bottom = std::max(bottom, k.rows - 1 - k.rows/2);
+            left = std::max(left, k.cols/2);
+            right = std::max(right, k.cols - 1 - k.cols/2);
+        }
+    }
+
+    _dst.create(n, 1, 0, -1, true);
+    for( i = 0; i < n; i++ )
+    {
+        _dst.create(src.size(), ddepth, i, true);
+        dst[i] = _dst.getMat(i);
+    }
+    if( n == 0 || src.empty() )
+        return;
+
+    FilterBankSpectrum sp;
+    if( useDFT )
+    {
+        // take the pixels outside of the ROI as filter2D does, unless the border is isolated
+        Mat ext = src;
+        int dtop = 0, dbottom = 0, dleft = 0, dright = 0;
+        if( !(borderType & BORDER_ISOLATED) )
+        {
+            Size wholeSize;
+            Point ofs;
+            src.locateROI(wholeSize, ofs);
+            dtop = std::min(top, ofs.y);
+            dbottom = std::min(bottom, wholeSize.height - src.rows - ofs.y);
+            dleft = std::min(left, ofs.x);
+            dright = std::min(right, wholeSize.width - src.cols - ofs.x);
+            ext.adjustROI(dtop, dbottom, dleft, dright);
+        }
+
+        Mat extf, padded;
+        ext.convertTo(extf, CV_32F);
+        sp.dftSize = Size(getOptimalDFTSize(src.cols + left + right), getOptimalDFTSize(src.rows + top + bottom));
+        padded.create(sp.dftSize, CV_32F);
+        Mat roi = padded(Rect(0, 0, src.cols + left + right, src.rows + top + bottom));
+        copyMakeBorder(extf, roi, top - dtop, bottom - dbottom, left - dleft, right - dright,
+                       borderType | BORDER_ISOLATED);
+        padded(Rect(roi.cols, 0, padded.cols - roi.cols, roi.rows)).setTo(Scalar::all(0));
+        padded(Rect(0, roi.rows, padded.cols, padded.rows - roi.rows)).setTo(Scalar::all(0));
+
+        dft(padded, sp.spectrum, 0, roi.rows);
+        sp.top = top;
+        sp.left = left;
+    }
+
+    parallel_for_(Range(0, n), FilterBankInvoker(src, kernels, dst, sp, borderType), n);
+}
+
+/* End of file. */
@@ -382,4 +382,403 @@ bool GCGraph<TWeight>::inSourceSegment( int i )
     return vtcs[i].t == 0;
 }
 
+/*
+  Graph of an 8-connected pixel grid for the Boykov-Kolmogorov max-flow algorithm.
+  The neighbours are addressed implicitly and the residual capacities of the n-links are stored
+  per vertex, so no adjacency lists are built. The grid is surrounded by a border of
+  unconnected vertices, which removes the bounds checks from the inner loops.
+
+  The terminal weights may be changed after maxFlow(): the next maxFlow() call continues from
+  the current flow and search trees instead of starting from scratch (dynamic graph cuts).
+*/
+template <class TWeight> class GCGridGraph
+{
+public:
+    // neighbour directions, the opposite of dir is (dir + 4) & 7
+    enum { RIGHT = 0, DOWN_RIGHT = 1, DOWN = 2, DOWN_LEFT = 3, LEFT = 4, UP_LEFT = 5, UP = 6, UP_RIGHT = 7 };
+
+    GCGridGraph();
+    void create( int rows, int cols );
+    // sets the capacity of the link between (x, y) and its neighbour in the direction dir, both ways
+    void setNWeight( int y, int x, int dir, TWeight w );
+    void setTermWeights( int y, int x, TWeight sourceW, TWeight sinkW );
+    void maxFlow();
+    bool inSourceSegment( int y, int x ) const;
+private:
+    enum { FREE = -1, TERMINAL = 8, ORPHAN = 9 };
+    enum { NOT_ACTIVE = -1, LAST_ACTIVE = -2 };
+    class Vtx
+    {
+    public:
+        int next;
+        int ts;
+        int dist;
+        schar parent; // direction to the parent vertex or one of FREE, TERMINAL, ORPHAN
+        uchar t;
+    };
+
+    int vtxIdx( int y, int x ) const { return (y + 1)*step + x + 1; }
+    TWeight& cap( int v, int dir ) { return caps[v*8 + dir]; }
+    // residual capacity of the link between v and its neighbour u = v + ofs[dir]
+    // in the direction of the tree flow, i.e. v -> u for the source tree and u -> v for the sink tree
+    TWeight treeCap( int v, int dir, uchar t ) { return t ? caps[(v + ofs[dir])*8 + ((dir + 4) & 7)] : caps[v*8 + dir]; }
+    void activate( int v );
+    void makeOrphan( int v );
+    void updateTerminal( int v );
+    void adoptOrphans();
+
+    int step;
+    int ofs[8];
+    std::vector<Vtx> vtcs;
+    std::vector<TWeight> caps;
+    std::vector<TWeight> tweights; // residual terminal capacity: > 0 from the source, < 0 to the sink
+    std::vector<TWeight> termNet;  // sourceW - sinkW of the last setTermWeights() call
+    std::vector<int> orphans;
+    int activeFirst, activeLast;
+    int currTs;
+    bool hasTrees;
+};
+
+template <class TWeight>
+GCGridGraph<TWeight>::GCGridGraph()
+{
+    step = 0;
+    activeFirst = activeLast = LAST_ACTIVE;
+    currTs = 0;
+    hasTrees = false;
+}
+
+template <class TWeight>
+void GCGridGraph<TWeight>::create( int rows, int cols )
+{
+    CV_Assert( rows > 0 && cols > 0 );
+    step = cols + 2;
+    static const int dx[] = { 1, 1, 0, -1, -1, -1, 0, 1 }, dy[] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+    for( int k = 0; k < 8; k++ )
+        ofs[k] = dy[k]*step + dx[k];
+
+    size_t vtxCount = (size_t)(rows + 2)*step;
+    Vtx v;
+    v.next = NOT_ACTIVE;
+    v.ts = v.dist = 0;
+    v.parent = FREE;
+    v.t = 0;
+    vtcs.assign( vtxCount, v );
+    caps.assign( vtxCount*8, TWeight(0) );
+    tweights.assign( vtxCount, TWeight(0) );
+    termNet.assign( vtxCount, TWeight(0) );
+    orphans.clear();
+    activeFirst = activeLast = LAST_ACTIVE;
+    currTs = 0;
+    hasTrees = false;
+}
+
+template <class TWeight>
+void GCGridGraph<TWeight>::setNWeight( int y, int x, int dir, TWeight w )
+{
+    CV_Assert( w >= 0 && !hasTrees );
+    int v = vtxIdx(y, x);
+    cap(v, dir) = w;
+    cap(v + ofs[dir], (dir + 4) & 7) = w;
+}
+
+template <class TWeight>
+void GCGridGraph<TWeight>::setTermWeights( int y, int x, TWeight sourceW, TWeight sinkW )
+{
+    int v = vtxIdx(y, x);
+    // only the difference of the terminal capacities affects the cut, so the residual capacity
+    // is shifted by the change of the difference while the flow is kept
+    TWeight net = sourceW - sinkW, delta = net - termNet[v];
+    termNet[v] = net;
+    if( delta == 0 )
+        return;
+    tweights[v] += delta;
+    if( hasTrees )
+        updateTerminal(v);
+}
+
+template <class TWeight>
+void GCGridGraph<TWeight>::activate( int v )
+{
+    if( vtcs[v].next != NOT_ACTIVE )
+        return;
+    vtcs[v].next = LAST_ACTIVE;
+    if( activeLast != LAST_ACTIVE )
+        vtcs[activeLast].next = v;
+    else
+        activeFirst = v;
+    activeLast = v;
+}
+
+template <class TWeight>
+void GCGridGraph<TWeight>::makeOrphan( int v )
+{
+    vtcs[v].parent = ORPHAN;
+    orphans.push_back(v);
+}
+
+// fixes the search trees after the residual terminal capacity of v has changed
+template <class TWeight>
+void GCGridGraph<TWeight>::updateTerminal( int v )
+{
+    Vtx& vx = vtcs[v];
+    TWeight w = tweights[v];
+    if( w == 0 )
+    {
+        if( vx.parent == TERMINAL )
+            makeOrphan(v);
+        return;
+    }
+
+    uchar t = w < 0;
+    if( vx.parent != FREE && vx.t != t )
+    {
+        // v moves to the other tree, so its children lose their parent and the links from the
+        // neighbours of the old tree to v may connect the trees now
+        for( int k = 0; k < 8; k++ )
+        {
+            int u = v + ofs[k];
+            if( vtcs[u].parent == FREE || vtcs[u].t != vx.t )
+                continue;
+            activate(u);
+            if( vtcs[u].parent == ((k + 4) & 7) )
+                makeOrphan(u);
+        }
+    }
+    vx.t = t;
+    vx.parent = TERMINAL;
+    vx.ts = 0;
+    vx.dist = 1;
+    activate(v);
+}
+
+template <class TWeight>
+void GCGridGraph<TWeight>::adoptOrphans()
+{
+    while( !orphans.empty() )
+    {
+        int v = orphans.back();
+        orphans.pop_back();
+        Vtx& vx = vtcs[v];
+        if( vx.parent != ORPHAN ) // has become a tree root meanwhile
+            continue;
+
+        int d, minDist = INT_MAX, parent = FREE;
+        uchar vt = vx.t;
+
+        for( int k = 0; k < 8; k++ )
+        {
+            // the parent must be able to send flow to v (source tree) or receive it from v (sink tree)
+            if( treeCap(v, k, vt^1) == 0 )
+                continue;
+            int u = v + ofs[k];
+            if( vtcs[u].t != vt || vtcs[u].parent == FREE )
+                continue;
+            // compute the distance to the tree root
+            for( d = 0;; )
+            {
+                Vtx& ux = vtcs[u];
+                if( ux.ts == currTs )
+                {
+                    d += ux.dist;
+                    break;
+                }
+                d++;
+                if( ux.parent == TERMINAL )
+                {
+                    ux.ts = currTs;
+                    ux.dist = 1;
+                    break;
+                }
+                if( ux.parent == ORPHAN || ux.parent == FREE )
+                {
+                    d = INT_MAX-1;
+                    break;
+                }
+                u += ofs[ux.parent];
+            }
+
+            // update the distance
+            if( ++d < INT_MAX )
+            {
+                if( d < minDist )
+                {
+                    minDist = d;
+                    parent = k;
+                }
+                for( u = v + ofs[k]; vtcs[u].ts != currTs; u += ofs[vtcs[u].parent] )
+                {
+                    vtcs[u].ts = currTs;
+                    vtcs[u].dist = --d;
+                }
+            }
+        }
+
+        if( parent != FREE )
+        {
+            vx.parent = (schar)parent;
+            vx.ts = currTs;
+            vx.dist = minDist;
+            continue;
+        }
+
+        /* no parent is found */
+        vx.parent = FREE;
+        vx.ts = 0;
+        for( int k = 0; k < 8; k++ )
+        {
+            int u = v + ofs[k];
+            int pu = vtcs[u].parent;
+            if( vtcs[u].t != vt || pu == FREE )
+                continue;
+            if( treeCap(v, k, vt^1) != 0 )
+                activate(u);
+            if( pu == ((k + 4) & 7) )
+                makeOrphan(u);
+        }
+    }
+}
+
+template <class TWeight>
+void GCGridGraph<TWeight>::maxFlow()
+{
+    CV_Assert( step > 0 );
+    if( !hasTrees )
+    {
+        // initialize the active queue and the search trees
+        for( int v = 0; v < (int)vtcs.size(); v++ )
+        {
+            if( tweights[v] != 0 )
+            {
+                Vtx& vx = vtcs[v];
+                vx.t = tweights[v] < 0;
+                vx.parent = TERMINAL;
+                vx.dist = 1;
+                activate(v);
+            }
+        }
+        hasTrees = true;
+    }
+
+    // the stamps of the previous call are not valid any longer
+    currTs++;
+    adoptOrphans();
+
+    Vtx* vtxPtr = &vtcs[0];
+    TWeight* capPtr = &caps[0];
+
+    // run the search-path -> augment-graph -> restore-trees loop
+    for(;;)
+    {
+        int v = 0, dir = -1;
+        uchar vt = 0;
+
+        // grow S & T search trees, find an edge connecting them
+        while( activeFirst != LAST_ACTIVE )
+        {
+            v = activeFirst;
+            Vtx& vx = vtxPtr[v];
+            if( vx.parent != FREE )
+            {
+                vt = vx.t;
+                for( int k = 0; k < 8; k++ )
+                {
+                    if( treeCap(v, k, vt) == 0 )
+                        continue;
+                    int u = v + ofs[k];
+                    Vtx& ux = vtxPtr[u];
+                    if( ux.parent == FREE )
+                    {
+                        ux.t = vt;
+                        ux.parent = (schar)((k + 4) & 7);
+                        ux.ts = vx.ts;
+                        ux.dist = vx.dist + 1;
+                        activate(u);
+                        continue;
+                    }
+
+                    if( ux.t != vt )
+                    {
+                        dir = k;
+                        break;
+                    }
+
+                    if( ux.dist > vx.dist+1 && ux.ts <= vx.ts )
+                    {
+                        // reassign the parent
+                        ux.parent = (schar)((k + 4) & 7);
+                        ux.ts = vx.ts;
+                        ux.dist = vx.dist + 1;
+                    }
+                }
+                if( dir >= 0 )
+                    break;
+            }
+            // exclude the vertex from the active list
+            activeFirst = vx.next;
+            if( activeFirst == LAST_ACTIVE )
+                activeLast = LAST_ACTIVE;
+            vx.next = NOT_ACTIVE;
+        }
+
+        if( dir < 0 )
+            break;
+
+        // the path goes from the source tree vertex a to the sink tree vertex b
+        int a = vt ? v + ofs[dir] : v, b = vt ? v : v + ofs[dir];
+        int abDir = vt ? (dir + 4) & 7 : dir;
+        int e0 = a*8 + abDir, e0rev = b*8 + ((abDir + 4) & 7);
+
+        // find the minimum edge weight along the path
+        TWeight minWeight = capPtr[e0];
+        CV_Assert( minWeight > 0 );
+        int w, p;
+        for( w = a; (p = vtxPtr[w].parent) != TERMINAL; w += ofs[p] )
+            minWeight = std::min(minWeight, capPtr[(w + ofs[p])*8 + ((p + 4) & 7)]);
+        minWeight = std::min(minWeight, tweights[w]);
+        for( w = b; (p = vtxPtr[w].parent) != TERMINAL; w += ofs[p] )
+            minWeight = std::min(minWeight, capPtr[w*8 + p]);
+        minWeight = std::min(minWeight, -tweights[w]);
+        CV_Assert( minWeight > 0 );
+
+        // modify weights of the edges along the path and collect orphans
+        capPtr[e0] -= minWeight;
+        capPtr[e0rev] += minWeight;
+
+        for( w = a; (p = vtxPtr[w].parent) != TERMINAL; )
+        {
+            int pw = w + ofs[p];
+            capPtr[w*8 + p] += minWeight;
+            if( (capPtr[pw*8 + ((p + 4) & 7)] -= minWeight) == 0 )
+                makeOrphan(w);
+            w = pw;
+        }
+        if( (tweights[w] -= minWeight) == 0 )
+            makeOrphan(w);
+
+        for( w = b; (p = vtxPtr[w].parent) != TERMINAL; )
+        {
+            int pw = w + ofs[p];
+            capPtr[pw*8 + ((p + 4) & 7)] += minWeight;
+            if( (capPtr[w*8 + p] -= minWeight) == 0 )
+                makeOrphan(w);
+            w = pw;
+        }
+        if( (tweights[w] += minWeight) == 0 )
+            makeOrphan(w);
+
+        // restore the search trees by finding new parents for the orphans
+        currTs++;
+        adoptOrphans();
+    }
+}
+
+template <class TWeight>
+bool GCGridGraph<TWeight>::inSourceSegment( int y, int x ) const
+{
+    // the vertices that are not connected to the sink form the source segment
+    const Vtx& v = vtcs[vtxIdx(y, x)];
+    return v.parent == FREE || v.t == 0;
+}
+
 #endif
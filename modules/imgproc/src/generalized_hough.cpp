@@ -99,6 +99,44 @@ namespace
         void convertTo(OutputArray positions, OutputArray votes);
     };
 
+    // runs a voting function of T over parts of a range; every part votes into a private
+    // histogram which is added to the shared one, so the result does not depend on the threads
+    template <class T>
+    class HoughVotingInvoker : public ParallelLoopBody
+    {
+    public:
+        typedef void (T::*VoteFunc)(const Range& range, double angle, double scale, Mat& hist) const;
+
+        HoughVotingInvoker(const T* _obj, VoteFunc _func, double _angle, double _scale, Mat& _hist) :
+            obj(_obj), func(_func), angle(_angle), scale(_scale), hist(_hist) {}
+
+        void operator()(const Range& range) const CV_OVERRIDE
+        {
+            Mat localHist(hist.size(), hist.type(), Scalar::all(0));
+            (obj->*func)(range, angle, scale, localHist);
+
+            AutoLock lock(mutex);
+            hist += localHist;
+        }
+
+    private:
+        const T* obj;
+        VoteFunc func;
+        double angle;
+        double scale;
+        Mat& hist;
+        mutable Mutex mutex;
+    };
+
+    // every part allocates a histogram, so there are not more parts than threads
+    template <class T>
+    void parallelVoting(const T* obj, typename HoughVotingInvoker<T>::VoteFunc func, int count,
+                        double angle, double scale, Mat& hist)
+    {
+        int nstripes = std::max(std::min(getNumThreads(), count), 1);
+        parallel_for_(Range(0, count), HoughVotingInvoker<T>(obj, func, angle, scale, hist), nstripes);
+    }
+
     GeneralizedHoughBase::GeneralizedHoughBase()
     {
         cannyLowThresh_ = 50;
@@ -363,6 +401,7 @@ namespace
         void processImage() CV_OVERRIDE;
 
         void calcHist();
+        void calcHistRows(const Range& rows, double, double, Mat& hist) const;
         void findPosInHist();
 
         int levels_;
@@ -427,16 +466,23 @@ namespace
         CV_Assert( levels_ > 0 && r_table_.size() == static_cast<size_t>(levels_ + 1) );
         CV_Assert( dp_ > 0.0 );
 
-        const double thetaScale = levels_ / 360.0;
         const double idp = 1.0 / dp_;
 
         hist_.create(cvCeil(imageSize_.height * idp) + 2, cvCeil(imageSize_.width * idp) + 2, CV_32SC1);
         hist_.setTo(0);
 
-        const int rows = hist_.rows - 2;
-        const int cols = hist_.cols - 2;
+        parallelVoting(this, &GeneralizedHoughBallardImpl::calcHistRows, imageSize_.height, 0., 0., hist_);
+    }
+
+    void GeneralizedHoughBallardImpl::calcHistRows(const Range& rowRange, double, double, Mat& hist) const
+    {
+        const double thetaScale = levels_ / 360.0;
+        const double idp = 1.0 / dp_;
+
+        const int rows = hist.rows - 2;
+        const int cols = hist.cols - 2;
 
-        for (int y = 0; y < imageSize_.height; ++y)
+        for (int y = rowRange.start; y < rowRange.end; ++y)
         {
             const uchar* edgesRow = imageEdges_.ptr(y);
             const float* dxRow = imageDx_.ptr<float>(y);
@@ -461,7 +507,7 @@ namespace
                         c.y = cvRound(c.y * idp);
 
                         if (c.x >= 0 && c.x < cols && c.y >= 0 && c.y < rows)
-                            ++hist_.at<int>(c.y + 1, c.x + 1);
+                            ++hist.at<int>(c.y + 1, c.x + 1);
                     }
                 }
             }
@@ -606,11 +652,17 @@ namespace
         };
 
         void buildFeatureList(const Mat& edges, const Mat& dx, const Mat& dy, std::vector< std::vector<Feature> >& features, Point2d center = Point2d());
+        void addFeatures(const std::vector<ContourPoint>& points, const Range& range, Point2d center, std::vector< std::vector<Feature> >& features) const;
         void getContourPoints(const Mat& edges, const Mat& dx, const Mat& dy, std::vector<ContourPoint>& points);
 
         void calcOrientation();
+        void voteOrientation(const Range& levels, double, double, Mat& hist) const;
         void calcScale(double angle);
+        void voteScale(const Range& levels, double angle, double, Mat& hist) const;
         void calcPosition(double angle, int angleVotes, double scale, int scaleVotes);
+        void votePosition(const Range& levels, double angle, double scale, Mat& hist) const;
+
+        class FeatureListInvoker;
 
         std::vector< std::vector<Feature> > templFeatures_;
         std::vector< std::vector<Feature> > imageFeatures_;
@@ -684,17 +736,44 @@ namespace
         }
     }
 
-    void GeneralizedHoughGuilImpl::buildFeatureList(const Mat& edges, const Mat& dx, const Mat& dy, std::vector< std::vector<Feature> >& features, Point2d center)
+    // builds the feature lists of parts of the contour points, the lists of the parts are concatenated
+    // in order, so the features kept within maxBufferSize are the same as in a serial scan
+    class GeneralizedHoughGuilImpl::FeatureListInvoker : public ParallelLoopBody
     {
-        CV_Assert( levels_ > 0 );
+    public:
+        FeatureListInvoker(const GeneralizedHoughGuilImpl* _obj, const std::vector<ContourPoint>& _points, Point2d _center,
+                           std::vector< std::vector< std::vector<Feature> > >& _parts) :
+            obj(_obj), points(_points), center(_center), parts(_parts) {}
 
-        const double maxDist = sqrt((double) templSize_.width * templSize_.width + templSize_.height * templSize_.height) * maxScale_;
+        void operator()(const Range& range) const CV_OVERRIDE
+        {
+            const int64 count = (int64)points.size(), nparts = (int64)parts.size();
 
-        const double alphaScale = levels_ / 360.0;
+            for (int i = range.start; i < range.end; ++i)
+            {
+                Range part((int)(count * i / nparts), (int)(count * (i + 1) / nparts));
+                obj->addFeatures(points, part, center, parts[i]);
+            }
+        }
+
+    private:
+        const GeneralizedHoughGuilImpl* obj;
+        const std::vector<ContourPoint>& points;
+        Point2d center;
+        std::vector< std::vector< std::vector<Feature> > >& parts;
+    };
+
+    void GeneralizedHoughGuilImpl::buildFeatureList(const Mat& edges, const Mat& dx, const Mat& dy, std::vector< std::vector<Feature> >& features, Point2d center)
+    {
+        CV_Assert( levels_ > 0 );
 
         std::vector<ContourPoint> points;
         getContourPoints(edges, dx, dy, points);
 
+        const int nparts = std::max(std::min(getNumThreads(), (int)points.size()), 1);
+        std::vector< std::vector< std::vector<Feature> > > parts(nparts);
+        parallel_for_(Range(0, nparts), FeatureListInvoker(this, points, center, parts), nparts);
+
         features.resize(levels_ + 1);
 #ifdef CV_CXX11
         std::for_each(features.begin(), features.end(), [=](std::vector<Feature>& e) { e.clear(); e.reserve(maxBufferSize_); });
@@ -703,7 +782,26 @@ namespace
         std::for_each(features.begin(), features.end(), std::bind2nd(std::mem_fun_ref(&std::vector<Feature>::reserve), maxBufferSize_));
 #endif
 
-        for (size_t i = 0; i < points.size(); ++i)
+        for (int i = 0; i < nparts; ++i)
+        {
+            for (int n = 0; n <= levels_; ++n)
+            {
+                const std::vector<Feature>& partRow = parts[i][n];
+                const size_t count = std::min(partRow.size(), static_cast<size_t>(maxBufferSize_) - features[n].size());
+                features[n].insert(features[n].end(), partRow.begin(), partRow.begin() + count);
+            }
+        }
+    }
+
+    void GeneralizedHoughGuilImpl::addFeatures(const std::vector<ContourPoint>& points, const Range& range, Point2d center, std::vector< std::vector<Feature> >& features) const
+    {
+        const double maxDist = sqrt((double) templSize_.width * templSize_.width + templSize_.height * templSize_.height) * maxScale_;
+
+        const double alphaScale = levels_ / 360.0;
+
+        features.resize(levels_ + 1);
+
+        for (int i = range.start; i < range.end; ++i)
         {
             ContourPoint p1 = points[i];
 
@@ -780,29 +878,9 @@ namespace
         const double iAngleStep = 1.0 / angleStep_;
         const int angleRange = cvCeil((maxAngle_ - minAngle_) * iAngleStep);
 
-        std::vector<int> OHist(angleRange + 1, 0);
-        for (int i = 0; i <= levels_; ++i)
-        {
-            const std::vector<Feature>& templRow = templFeatures_[i];
-            const std::vector<Feature>& imageRow = imageFeatures_[i];
-
-            for (size_t j = 0; j < templRow.size(); ++j)
-            {
-                Feature templF = templRow[j];
-
-                for (size_t k = 0; k < imageRow.size(); ++k)
-                {
-                    Feature imF = imageRow[k];
-
-                    const double angle = clampAngle(imF.p1.theta - templF.p1.theta);
-                    if (angle >= minAngle_ && angle <= maxAngle_)
-                    {
-                        const int n = cvRound((angle - minAngle_) * iAngleStep);
-                        ++OHist[n];
-                    }
-                }
-            }
-        }
+        Mat hist(1, angleRange + 1, CV_32SC1, Scalar::all(0));
+        parallelVoting(this, &GeneralizedHoughGuilImpl::voteOrientation, levels_ + 1, 0., 0., hist);
+        const int* OHist = hist.ptr<int>();
 
         angles_.clear();
 
@@ -828,9 +906,92 @@ namespace
         const double iScaleStep = 1.0 / scaleStep_;
         const int scaleRange = cvCeil((maxScale_ - minScale_) * iScaleStep);
 
-        std::vector<int> SHist(scaleRange + 1, 0);
+        Mat hist(1, scaleRange + 1, CV_32SC1, Scalar::all(0));
+        parallelVoting(this, &GeneralizedHoughGuilImpl::voteScale, levels_ + 1, angle, 0., hist);
+        const int* SHist = hist.ptr<int>();
+
+        scales_.clear();
+
+        for (int s = 0; s < scaleRange; ++s)
+        {
+            if (SHist[s] >= scaleThresh_)
+            {
+                const double scale = minScale_ + s * scaleStep_;
+                scales_.push_back(std::make_pair(scale, SHist[s]));
+            }
+        }
+    }
+
+    void GeneralizedHoughGuilImpl::calcPosition(double angle, int angleVotes, double scale, int scaleVotes)
+    {
+        CV_Assert( levels_ > 0 );
+        CV_Assert( templFeatures_.size() == static_cast<size_t>(levels_ + 1) );
+        CV_Assert( imageFeatures_.size() == templFeatures_.size() );
+        CV_Assert( dp_ > 0.0 );
+        CV_Assert( posThresh_ > 0 );
+
+        const double idp = 1.0 / dp_;
+
+        const int histRows = cvCeil(imageSize_.height * idp);
+        const int histCols = cvCeil(imageSize_.width * idp);
+
+        Mat DHist(histRows + 2, histCols + 2, CV_32SC1, Scalar::all(0));
+        parallelVoting(this, &GeneralizedHoughGuilImpl::votePosition, levels_ + 1, angle, scale, DHist);
+
+        for(int y = 0; y < histRows; ++y)
+        {
+            const int* prevRow = DHist.ptr<int>(y);
+            const int* curRow = DHist.ptr<int>(y + 1);
+            const int* nextRow = DHist.ptr<int>(y + 2);
+
+            for(int x = 0; x < histCols; ++x)
+            {
+                const int votes = curRow[x + 1];
+
+                if (votes > posThresh_ && votes > curRow[x] && votes >= curRow[x + 2] && votes > prevRow[x + 1] && votes >= nextRow[x + 1])
+                {
+                    posOutBuf_.push_back(Vec4f(static_cast<float>(x * dp_), static_cast<float>(y * dp_), static_cast<float>(scale), static_cast<float>(angle)));
+                    voteOutBuf_.push_back(Vec3i(votes, scaleVotes, angleVotes));
+                }
+            }
+        }
+    }
+
+    void GeneralizedHoughGuilImpl::voteOrientation(const Range& levels, double, double, Mat& hist) const
+    {
+        const double iAngleStep = 1.0 / angleStep_;
+        int* OHist = hist.ptr<int>();
+
+        for (int i = levels.start; i < levels.end; ++i)
+        {
+            const std::vector<Feature>& templRow = templFeatures_[i];
+            const std::vector<Feature>& imageRow = imageFeatures_[i];
+
+            for (size_t j = 0; j < templRow.size(); ++j)
+            {
+                Feature templF = templRow[j];
+
+                for (size_t k = 0; k < imageRow.size(); ++k)
+                {
+                    Feature imF = imageRow[k];
+
+                    const double angle = clampAngle(imF.p1.theta - templF.p1.theta);
+                    if (angle >= minAngle_ && angle <= maxAngle_)
+                    {
+                        const int n = cvRound((angle - minAngle_) * iAngleStep);
+                        ++OHist[n];
+                    }
+                }
+            }
+        }
+    }
+
+    void GeneralizedHoughGuilImpl::voteScale(const Range& levels, double angle, double, Mat& hist) const
+    {
+        const double iScaleStep = 1.0 / scaleStep_;
+        int* SHist = hist.ptr<int>();
 
-        for (int i = 0; i <= levels_; ++i)
+        for (int i = levels.start; i < levels.end; ++i)
         {
             const std::vector<Feature>& templRow = templFeatures_[i];
             const std::vector<Feature>& imageRow = imageFeatures_[i];
@@ -857,37 +1018,18 @@ namespace
                 }
             }
         }
-
-        scales_.clear();
-
-        for (int s = 0; s < scaleRange; ++s)
-        {
-            if (SHist[s] >= scaleThresh_)
-            {
-                const double scale = minScale_ + s * scaleStep_;
-                scales_.push_back(std::make_pair(scale, SHist[s]));
-            }
-        }
     }
 
-    void GeneralizedHoughGuilImpl::calcPosition(double angle, int angleVotes, double scale, int scaleVotes)
+    void GeneralizedHoughGuilImpl::votePosition(const Range& levels, double angle, double scale, Mat& DHist) const
     {
-        CV_Assert( levels_ > 0 );
-        CV_Assert( templFeatures_.size() == static_cast<size_t>(levels_ + 1) );
-        CV_Assert( imageFeatures_.size() == templFeatures_.size() );
-        CV_Assert( dp_ > 0.0 );
-        CV_Assert( posThresh_ > 0 );
-
         const double sinVal = sin(toRad(angle));
         const double cosVal = cos(toRad(angle));
         const double idp = 1.0 / dp_;
 
-        const int histRows = cvCeil(imageSize_.height * idp);
-        const int histCols = cvCeil(imageSize_.width * idp);
-
-        Mat DHist(histRows + 2, histCols + 2, CV_32SC1, Scalar::all(0));
+        const int histRows = DHist.rows - 2;
+        const int histCols = DHist.cols - 2;
 
-        for (int i = 0; i <= levels_; ++i)
+        for (int i = levels.start; i < levels.end; ++i)
         {
             const std::vector<Feature>& templRow = templFeatures_[i];
             const std::vector<Feature>& imageRow = imageFeatures_[i];
@@ -927,24 +1069,6 @@ namespace
                 }
             }
         }
-
-        for(int y = 0; y < histRows; ++y)
-        {
-            const int* prevRow = DHist.ptr<int>(y);
-            const int* curRow = DHist.ptr<int>(y + 1);
-            const int* nextRow = DHist.ptr<int>(y + 2);
-
-            for(int x = 0; x < histCols; ++x)
-            {
-                const int votes = curRow[x + 1];
-
-                if (votes > posThresh_ && votes > curRow[x] && votes >= curRow[x + 2] && votes > prevRow[x + 1] && votes >= nextRow[x + 1])
-                {
-                    posOutBuf_.push_back(Vec4f(static_cast<float>(x * dp_), static_cast<float>(y * dp_), static_cast<float>(scale), static_cast<float>(angle)));
-                    voteOutBuf_.push_back(Vec3i(votes, scaleVotes, angleVotes));
-                }
-            }
-        }
     }
 }
 
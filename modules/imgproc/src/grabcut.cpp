@@ -412,18 +412,38 @@ static void initGMMs( const Mat& img, const Mat& mask, GMM& bgdGMM, GMM& fgdGMM
 /*
   Assign GMMs components for each pixel.
 */
-static void assignGMMsComponents( const Mat& img, const Mat& mask, const GMM& bgdGMM, const GMM& fgdGMM, Mat& compIdxs )
+class AssignGMMsComponentsInvoker : public ParallelLoopBody
 {
-    Point p;
-    for( p.y = 0; p.y < img.rows; p.y++ )
+public:
+    AssignGMMsComponentsInvoker( const Mat& _img, const Mat& _mask, const GMM& _bgdGMM, const GMM& _fgdGMM, Mat& _compIdxs ) :
+        img(_img), mask(_mask), bgdGMM(_bgdGMM), fgdGMM(_fgdGMM), compIdxs(_compIdxs) {}
+
+    virtual void operator() (const Range& range) const CV_OVERRIDE
     {
-        for( p.x = 0; p.x < img.cols; p.x++ )
+        Point p;
+        for( p.y = range.start; p.y < range.end; p.y++ )
         {
-            Vec3d color = img.at<Vec3b>(p);
-            compIdxs.at<int>(p) = mask.at<uchar>(p) == GC_BGD || mask.at<uchar>(p) == GC_PR_BGD ?
-                bgdGMM.whichComponent(color) : fgdGMM.whichComponent(color);
+            for( p.x = 0; p.x < img.cols; p.x++ )
+            {
+                Vec3d color = img.at<Vec3b>(p);
+                compIdxs.at<int>(p) = mask.at<uchar>(p) == GC_BGD || mask.at<uchar>(p) == GC_PR_BGD ?
+                    bgdGMM.whichComponent(color) : fgdGMM.whichComponent(color);
+            }
         }
     }
+
+private:
+    const Mat& img;
+    const Mat& mask;
+    const GMM& bgdGMM;
+    const GMM& fgdGMM;
+    Mat& compIdxs;
+};
+
+static void assignGMMsComponents( const Mat& img, const Mat& mask, const GMM& bgdGMM, const GMM& fgdGMM, Mat& compIdxs )
+{
+    parallel_for_( Range(0, img.rows), AssignGMMsComponentsInvoker(img, mask, bgdGMM, fgdGMM, compIdxs),
+                   img.total()/(double)(1<<14) );
 }
 
 /*
@@ -433,21 +453,17 @@ static void learnGMMs( const Mat& img, const Mat& mask, const Mat& compIdxs, GMM
 {
     bgdGMM.initLearning();
     fgdGMM.initLearning();
+    // a single scan adds the samples of every component in the same order as a scan per component
     Point p;
-    for( int ci = 0; ci < GMM::componentsCount; ci++ )
+    for( p.y = 0; p.y < img.rows; p.y++ )
     {
-        for( p.y = 0; p.y < img.rows; p.y++ )
+        for( p.x = 0; p.x < img.cols; p.x++ )
         {
-            for( p.x = 0; p.x < img.cols; p.x++ )
-            {
-                if( compIdxs.at<int>(p) == ci )
-                {
-                    if( mask.at<uchar>(p) == GC_BGD || mask.at<uchar>(p) == GC_PR_BGD )
-                        bgdGMM.addSample( ci, img.at<Vec3b>(p) );
-                    else
-                        fgdGMM.addSample( ci, img.at<Vec3b>(p) );
-                }
-            }
+            int ci = compIdxs.at<int>(p);
+            if( mask.at<uchar>(p) == GC_BGD || mask.at<uchar>(p) == GC_PR_BGD )
+                bgdGMM.addSample( ci, img.at<Vec3b>(p) );
+            else
+                fgdGMM.addSample( ci, img.at<Vec3b>(p) );
         }
     }
     bgdGMM.endLearning();
@@ -455,72 +471,98 @@ static void learnGMMs( const Mat& img, const Mat& mask, const Mat& compIdxs, GMM
 }
 
 /*
-  Construct GCGraph
+  Set n-weights of the grid graph, they do not change between the iterations
 */
-static void constructGCGraph( const Mat& img, const Mat& mask, const GMM& bgdGMM, const GMM& fgdGMM, double lambda,
-                       const Mat& leftW, const Mat& upleftW, const Mat& upW, const Mat& uprightW,
-                       GCGraph<double>& graph )
+static void setGCGraphNWeights( const Mat& leftW, const Mat& upleftW, const Mat& upW, const Mat& uprightW,
+                                GCGridGraph<double>& graph )
 {
-    int vtxCount = img.cols*img.rows,
-        edgeCount = 2*(4*img.cols*img.rows - 3*(img.cols + img.rows) + 2);
-    graph.create(vtxCount, edgeCount);
+    typedef GCGridGraph<double> Graph;
     Point p;
-    for( p.y = 0; p.y < img.rows; p.y++ )
+    for( p.y = 0; p.y < leftW.rows; p.y++ )
     {
-        for( p.x = 0; p.x < img.cols; p.x++)
+        for( p.x = 0; p.x < leftW.cols; p.x++ )
         {
-            // add node
-            int vtxIdx = graph.addVtx();
-            Vec3b color = img.at<Vec3b>(p);
-
-            // set t-weights
-            double fromSource, toSink;
-            if( mask.at<uchar>(p) == GC_PR_BGD || mask.at<uchar>(p) == GC_PR_FGD )
-            {
-                fromSource = -log( bgdGMM(color) );
-                toSink = -log( fgdGMM(color) );
-            }
-            else if( mask.at<uchar>(p) == GC_BGD )
-            {
-                fromSource = 0;
-                toSink = lambda;
-            }
-            else // GC_FGD
-            {
-                fromSource = lambda;
-                toSink = 0;
-            }
-            graph.addTermWeights( vtxIdx, fromSource, toSink );
-
-            // set n-weights
             if( p.x>0 )
-            {
-                double w = leftW.at<double>(p);
-                graph.addEdges( vtxIdx, vtxIdx-1, w, w );
-            }
+                graph.setNWeight( p.y, p.x, Graph::LEFT, leftW.at<double>(p) );
             if( p.x>0 && p.y>0 )
-            {
-                double w = upleftW.at<double>(p);
-                graph.addEdges( vtxIdx, vtxIdx-img.cols-1, w, w );
-            }
+                graph.setNWeight( p.y, p.x, Graph::UP_LEFT, upleftW.at<double>(p) );
             if( p.y>0 )
+                graph.setNWeight( p.y, p.x, Graph::UP, upW.at<double>(p) );
+            if( p.x<leftW.cols-1 && p.y>0 )
+                graph.setNWeight( p.y, p.x, Graph::UP_RIGHT, uprightW.at<double>(p) );
+        }
+    }
+}
+
+/*
+  Calculate t-weights, the GMM likelihoods dominate the graph construction
+*/
+class CalcTWeightsInvoker : public ParallelLoopBody
+{
+public:
+    CalcTWeightsInvoker( const Mat& _img, const Mat& _mask, const GMM& _bgdGMM, const GMM& _fgdGMM, double _lambda,
+                         Mat& _fromSource, Mat& _toSink ) :
+        img(_img), mask(_mask), bgdGMM(_bgdGMM), fgdGMM(_fgdGMM), lambda(_lambda),
+        fromSource(_fromSource), toSink(_toSink) {}
+
+    virtual void operator() (const Range& range) const CV_OVERRIDE
+    {
+        Point p;
+        for( p.y = range.start; p.y < range.end; p.y++ )
+        {
+            for( p.x = 0; p.x < img.cols; p.x++ )
             {
-                double w = upW.at<double>(p);
-                graph.addEdges( vtxIdx, vtxIdx-img.cols, w, w );
-            }
-            if( p.x<img.cols-1 && p.y>0 )
-            {
-                double w = uprightW.at<double>(p);
-                graph.addEdges( vtxIdx, vtxIdx-img.cols+1, w, w );
+                Vec3b color = img.at<Vec3b>(p);
+                double& s = fromSource.at<double>(p);
+                double& t = toSink.at<double>(p);
+                if( mask.at<uchar>(p) == GC_PR_BGD || mask.at<uchar>(p) == GC_PR_FGD )
+                {
+                    s = -log( bgdGMM(color) );
+                    t = -log( fgdGMM(color) );
+                }
+                else if( mask.at<uchar>(p) == GC_BGD )
+                {
+                    s = 0;
+                    t = lambda;
+                }
+                else // GC_FGD
+                {
+                    s = lambda;
+                    t = 0;
+                }
             }
         }
     }
+
+private:
+    const Mat& img;
+    const Mat& mask;
+    const GMM& bgdGMM;
+    const GMM& fgdGMM;
+    double lambda;
+    Mat& fromSource;
+    Mat& toSink;
+};
+
+/*
+  Update t-weights of the grid graph. After the first iteration only the changes of the t-weights
+  are applied, so the max-flow continues from the previous flow.
+*/
+static void setGCGraphTWeights( const Mat& img, const Mat& mask, const GMM& bgdGMM, const GMM& fgdGMM, double lambda,
+                                Mat& fromSource, Mat& toSink, GCGridGraph<double>& graph )
+{
+    parallel_for_( Range(0, img.rows), CalcTWeightsInvoker(img, mask, bgdGMM, fgdGMM, lambda, fromSource, toSink),
+                   img.total()/(double)(1<<14) );
+    Point p;
+    for( p.y = 0; p.y < img.rows; p.y++ )
+        for( p.x = 0; p.x < img.cols; p.x++ )
+            graph.setTermWeights( p.y, p.x, fromSource.at<double>(p), toSink.at<double>(p) );
 }
 
 /*
   Estimate segmentation using MaxFlow algorithm
 */
-static void estimateSegmentation( GCGraph<double>& graph, Mat& mask )
+static void estimateSegmentation( GCGridGraph<double>& graph, Mat& mask )
 {
     graph.maxFlow();
     Point p;
@@ -530,7 +572,7 @@ static void estimateSegmentation( GCGraph<double>& graph, Mat& mask )
         {
             if( mask.at<uchar>(p) == GC_PR_BGD || mask.at<uchar>(p) == GC_PR_FGD )
             {
-                if( graph.inSourceSegment( p.y*mask.cols+p.x /*vertex index*/ ) )
+                if( graph.inSourceSegment( p.y, p.x ) )
                     mask.at<uchar>(p) = GC_PR_FGD;
                 else
                     mask.at<uchar>(p) = GC_PR_BGD;
@@ -583,13 +625,18 @@ void cv::grabCut( InputArray _img, InputOutputArray _mask, Rect rect,
     Mat leftW, upleftW, upW, uprightW;
     calcNWeights( img, leftW, upleftW, upW, uprightW, beta, gamma );
 
+    // the n-weights are fixed, so the graph and its flow are reused by all the iterations
+    GCGridGraph<double> graph;
+    graph.create( img.rows, img.cols );
+    setGCGraphNWeights( leftW, upleftW, upW, uprightW, graph );
+    Mat fromSource( img.size(), CV_64FC1 ), toSink( img.size(), CV_64FC1 );
+
     for( int i = 0; i < iterCount; i++ )
     {
-        GCGraph<double> graph;
         assignGMMsComponents( img, mask, bgdGMM, fgdGMM, compIdxs );
         if( mode != GC_EVAL_FREEZE_MODEL )
             learnGMMs( img, mask, compIdxs, bgdGMM, fgdGMM );
-        constructGCGraph(img, mask, bgdGMM, fgdGMM, lambda, leftW, upleftW, upW, uprightW, graph );
+        setGCGraphTWeights( img, mask, bgdGMM, fgdGMM, lambda, fromSource, toSink, graph );
         estimateSegmentation( graph, mask );
     }
 }
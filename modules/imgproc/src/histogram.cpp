@@ -222,6 +222,107 @@ static void histPrepareImages( const Mat* images, int nimages, const int* channe
 }
 
 
+// Adjusts the pointers prepared by histPrepareImages() to a part of the images: the rows
+// [range.start, range.end) or, if the continuous images are processed as a single row, the pixels
+// [range.start, range.end). The last pointer is the mask or the back projection with lastesz bytes per element.
+static void histSliceImages( const std::vector<uchar*>& ptrs, const std::vector<int>& deltas, int dims,
+                             Size imsize, int esz1, int lastesz, const Range& range,
+                             std::vector<uchar*>& sptrs, Size& ssize )
+{
+    sptrs = ptrs;
+    bool byRows = imsize.height > 1;
+    for( int i = 0; i < dims; i++ )
+    {
+        size_t rowElems = (size_t)imsize.width*deltas[i*2] + deltas[i*2 + 1];
+        sptrs[i] += (byRows ? rowElems : (size_t)deltas[i*2])*range.start*esz1;
+    }
+    if( sptrs[dims] )
+        sptrs[dims] += (byRows ? (size_t)deltas[dims*2 + 1] : (size_t)1)*range.start*lastesz;
+    ssize = byRows ? Size(imsize.width, range.size()) : Size(range.size(), 1);
+}
+
+// the number of parts to process in parallel; each part of calcHist has a private histogram
+// that is cleared and merged, so small images or huge histograms are not split
+static int histNumStripes( Size imsize, double histTotal )
+{
+    double npixels = (double)imsize.width*imsize.height;
+    int nthreads = getNumThreads();
+    if( nthreads <= 1 || npixels < (1 << 16) )
+        return 1;
+    return std::max(std::min(nthreads, cvFloor(npixels/(histTotal*4))), 1);
+}
+
+#if CV_SIMD_64F
+static inline void v_load_hist(const ushort* p, v_float64& v0, v_float64& v1)
+{
+    v_int32 v = v_reinterpret_as_s32(vx_load_expand(p));
+    v0 = v_cvt_f64(v);
+    v1 = v_cvt_f64_high(v);
+}
+
+static inline void v_load_hist(const float* p, v_float64& v0, v_float64& v1)
+{
+    v_float32 v = vx_load(p);
+    v0 = v_cvt_f64(v);
+    v1 = v_cvt_f64_high(v);
+}
+#endif
+
+// computes the bins of a uniform 1D histogram for a run of contiguous values, -1 for the values
+// out of range; the arithmetic is the same as in the scalar loop, so are the bins
+template<typename T> struct HistBins1D_SIMD
+{
+    HistBins1D_SIMD(double, double, double, double, int) {}
+    int operator()(const T*, int, int*) const { return 0; }
+};
+
+#if CV_SIMD_64F
+template<typename T> struct HistBins1D_SIMD_Impl
+{
+    HistBins1D_SIMD_Impl(double _a, double _b, double _lo, double _hi, int _sz) :
+        a(_a), b(_b), lo(_lo), hi(_hi), sz(_sz)
+    {
+    }
+
+    // returns the number of processed values
+    int operator()(const T* p, int n, int* idx) const
+    {
+        v_float64 va = vx_setall_f64(a), vb = vx_setall_f64(b);
+        v_float64 vlo = vx_setall_f64(lo), vhi = vx_setall_f64(hi);
+        v_float64 vzero = vx_setzero_f64(), vmax = vx_setall_f64(sz - 1), vout = vx_setall_f64(-1.);
+        int x = 0;
+        for( ; x <= n - v_int32::nlanes; x += v_int32::nlanes )
+        {
+            v_float64 v0, v1;
+            v_load_hist(p + x, v0, v1);
+            // NaNs pass the range check and fall into the bin 0, as cvFloor(NaN) does after clamping
+            v_float64 t0 = v_min(v_max(v0*va + vb, vzero), vmax);
+            v_float64 t1 = v_min(v_max(v1*va + vb, vzero), vmax);
+            t0 = v_select((v0 < vlo) | (v0 >= vhi), vout, t0);
+            t1 = v_select((v1 < vlo) | (v1 >= vhi), vout, t1);
+            v_store(idx + x, v_combine_low(v_floor(t0), v_floor(t1)));
+        }
+        vx_cleanup();
+        return x;
+    }
+
+    double a, b, lo, hi;
+    int sz;
+};
+
+template<> struct HistBins1D_SIMD<ushort> : HistBins1D_SIMD_Impl<ushort>
+{
+    HistBins1D_SIMD(double _a, double _b, double _lo, double _hi, int _sz) :
+        HistBins1D_SIMD_Impl<ushort>(_a, _b, _lo, _hi, _sz) {}
+};
+
+template<> struct HistBins1D_SIMD<float> : HistBins1D_SIMD_Impl<float>
+{
+    HistBins1D_SIMD(double _a, double _b, double _lo, double _hi, int _sz) :
+        HistBins1D_SIMD_Impl<float>(_a, _b, _lo, _hi, _sz) {}
+};
+#endif
+
 ////////////////////////////////// C A L C U L A T E    H I S T O G R A M ////////////////////////////////////
 
 template<typename T> static void
@@ -256,11 +357,30 @@ calcHist_( std::vector<uchar*>& _ptrs, const std::vector<int>& _deltas,
 
             double v0_lo = _ranges[0][0];
             double v0_hi = _ranges[0][1];
+            HistBins1D_SIMD<T> vop(a, b, v0_lo, v0_hi, sz);
+            const int BLOCK_SZ = 256;
+            int bins[BLOCK_SZ];
 
             for( ; imsize.height--; p0 += step0, mask += mstep )
             {
+                x = 0;
+                if( d0 == 1 )
+                {
+                    while( x < imsize.width )
+                    {
+                        int n = vop(p0, std::min(imsize.width - x, BLOCK_SZ), bins);
+                        if( n == 0 )
+                            break;
+                        for( int k = 0; k < n; k++ )
+                            if( bins[k] >= 0 && (!mask || mask[x + k]) )
+                                ((int*)H)[bins[k]]++;
+                        x += n;
+                        p0 += n;
+                    }
+                }
+
                 if( !mask )
-                    for( x = 0; x < imsize.width; x++, p0 += d0 )
+                    for( ; x < imsize.width; x++, p0 += d0 )
                     {
                         double v0 = (double)*p0;
                         int idx = cvFloor(v0*a + b);
@@ -271,7 +391,7 @@ calcHist_( std::vector<uchar*>& _ptrs, const std::vector<int>& _deltas,
                         ((int*)H)[idx]++;
                     }
                 else
-                    for( x = 0; x < imsize.width; x++, p0 += d0 )
+                    for( ; x < imsize.width; x++, p0 += d0 )
                         if( mask[x] )
                         {
                             double v0 = (double)*p0;
@@ -688,6 +808,51 @@ calcHist_8u( std::vector<uchar*>& _ptrs, const std::vector<int>& _deltas,
     }
 }
 
+typedef void (*CalcHistFunc)(std::vector<uchar*>& _ptrs, const std::vector<int>& _deltas,
+                             Size imsize, Mat& hist, int dims, const float** _ranges,
+                             const double* _uniranges, bool uniform);
+
+// every part of the image is counted into a private histogram that is then added to the result
+class CalcHistInvoker : public ParallelLoopBody
+{
+public:
+    CalcHistInvoker(CalcHistFunc _func, const std::vector<uchar*>& _ptrs, const std::vector<int>& _deltas,
+                    Size _imsize, int _esz1, Mat& _hist, int _dims, const float** _ranges,
+                    const double* _uniranges, bool _uniform) :
+        func(_func), ptrs(_ptrs), deltas(_deltas), imsize(_imsize), esz1(_esz1), hist(&_hist),
+        dims(_dims), ranges(_ranges), uniranges(_uniranges), uniform(_uniform)
+    {
+    }
+
+    virtual void operator() (const Range& range) const CV_OVERRIDE
+    {
+        std::vector<uchar*> sptrs;
+        Size ssize;
+        histSliceImages(ptrs, deltas, dims, imsize, esz1, 1, range, sptrs, ssize);
+
+        Mat lhist(hist->dims, hist->size, CV_32S, Scalar::all(0));
+        func(sptrs, deltas, ssize, lhist, dims, ranges, uniranges, uniform);
+
+        AutoLock lock(mutex);
+        add(*hist, lhist, *hist);
+    }
+
+private:
+    CalcHistFunc func;
+    const std::vector<uchar*>& ptrs;
+    const std::vector<int>& deltas;
+    Size imsize;
+    int esz1;
+    Mat* hist;
+    int dims;
+    const float** ranges;
+    const double* uniranges;
+    bool uniform;
+    mutable Mutex mutex;
+
+    CalcHistInvoker& operator=(const CalcHistInvoker&);
+};
+
 #ifdef HAVE_IPP
 
 typedef IppStatus(CV_STDCALL * IppiHistogram_C1)(const void* pSrc, int srcStep,
@@ -994,16 +1159,26 @@ void cv::calcHist( const Mat* images, int nimages, const int* channels,
     const double* _uniranges = uniform ? &uniranges[0] : 0;
 
     int depth = images[0].depth();
+    CalcHistFunc func = 0;
 
     if( depth == CV_8U )
-        calcHist_8u(ptrs, deltas, imsize, ihist, dims, ranges, _uniranges, uniform );
+        func = calcHist_8u;
     else if( depth == CV_16U )
-        calcHist_<ushort>(ptrs, deltas, imsize, ihist, dims, ranges, _uniranges, uniform );
+        func = calcHist_<ushort>;
     else if( depth == CV_32F )
-        calcHist_<float>(ptrs, deltas, imsize, ihist, dims, ranges, _uniranges, uniform );
+        func = calcHist_<float>;
     else
         CV_Error(CV_StsUnsupportedFormat, "");
 
+    int nstripes = histNumStripes(imsize, (double)ihist.total());
+    if( nstripes > 1 )
+        parallel_for_(Range(0, imsize.height > 1 ? imsize.height : imsize.width),
+                      CalcHistInvoker(func, ptrs, deltas, imsize, (int)images[0].elemSize1(), ihist,
+                                      dims, ranges, _uniranges, uniform),
+                      nstripes);
+    else
+        func(ptrs, deltas, imsize, ihist, dims, ranges, _uniranges, uniform );
+
     ihist.convertTo(hist, CV_32F);
 }
 
@@ -1142,6 +1317,53 @@ calcSparseHist_8u( std::vector<uchar*>& _ptrs, const std::vector<int>& _deltas,
 }
 
 
+typedef void (*CalcSparseHistFunc)(std::vector<uchar*>& _ptrs, const std::vector<int>& _deltas,
+                                   Size imsize, SparseMat& hist, int dims, const float** _ranges,
+                                   const double* _uniranges, bool uniform);
+
+class CalcSparseHistInvoker : public ParallelLoopBody
+{
+public:
+    CalcSparseHistInvoker(CalcSparseHistFunc _func, const std::vector<uchar*>& _ptrs, const std::vector<int>& _deltas,
+                          Size _imsize, int _esz1, SparseMat& _hist, int _dims, const float** _ranges,
+                          const double* _uniranges, bool _uniform) :
+        func(_func), ptrs(_ptrs), deltas(_deltas), imsize(_imsize), esz1(_esz1), hist(&_hist),
+        dims(_dims), ranges(_ranges), uniranges(_uniranges), uniform(_uniform)
+    {
+    }
+
+    virtual void operator() (const Range& range) const CV_OVERRIDE
+    {
+        std::vector<uchar*> sptrs;
+        Size ssize;
+        histSliceImages(ptrs, deltas, dims, imsize, esz1, 1, range, sptrs, ssize);
+
+        SparseMat lhist(dims, hist->hdr->size, CV_32F);
+        func(sptrs, deltas, ssize, lhist, dims, ranges, uniranges, uniform);
+
+        // the bins hold integer counters at this point
+        AutoLock lock(mutex);
+        SparseMatConstIterator it = lhist.begin();
+        for( size_t i = 0, N = lhist.nzcount(); i < N; i++, ++it )
+            *(int*)hist->ptr(it.node()->idx, true) += *(const int*)it.ptr;
+    }
+
+private:
+    CalcSparseHistFunc func;
+    const std::vector<uchar*>& ptrs;
+    const std::vector<int>& deltas;
+    Size imsize;
+    int esz1;
+    SparseMat* hist;
+    int dims;
+    const float** ranges;
+    const double* uniranges;
+    bool uniform;
+    mutable Mutex mutex;
+
+    CalcSparseHistInvoker& operator=(const CalcSparseHistInvoker&);
+};
+
 static void calcHist( const Mat* images, int nimages, const int* channels,
                       const Mat& mask, SparseMat& hist, int dims, const int* histSize,
                       const float** ranges, bool uniform, bool accumulate, bool keepInt )
@@ -1172,15 +1394,26 @@ static void calcHist( const Mat* images, int nimages, const int* channels,
     const double* _uniranges = uniform ? &uniranges[0] : 0;
 
     int depth = images[0].depth();
+    CalcSparseHistFunc func = 0;
     if( depth == CV_8U )
-        calcSparseHist_8u(ptrs, deltas, imsize, hist, dims, ranges, _uniranges, uniform );
+        func = calcSparseHist_8u;
     else if( depth == CV_16U )
-        calcSparseHist_<ushort>(ptrs, deltas, imsize, hist, dims, ranges, _uniranges, uniform );
+        func = calcSparseHist_<ushort>;
     else if( depth == CV_32F )
-        calcSparseHist_<float>(ptrs, deltas, imsize, hist, dims, ranges, _uniranges, uniform );
+        func = calcSparseHist_<float>;
     else
         CV_Error(CV_StsUnsupportedFormat, "");
 
+    // the size of a sparse histogram is unknown in advance, assume one bin per 16 pixels
+    int nstripes = histNumStripes(imsize, (double)imsize.width*imsize.height/16);
+    if( nstripes > 1 )
+        parallel_for_(Range(0, imsize.height > 1 ? imsize.height : imsize.width),
+                      CalcSparseHistInvoker(func, ptrs, deltas, imsize, (int)images[0].elemSize1(), hist,
+                                            dims, ranges, _uniranges, uniform),
+                      nstripes);
+    else
+        func(ptrs, deltas, imsize, hist, dims, ranges, _uniranges, uniform );
+
     if( !keepInt )
     {
         SparseMatIterator it = hist.begin();
@@ -1600,6 +1833,61 @@ calcBackProj_8u( std::vector<uchar*>& _ptrs, const std::vector<int>& _deltas,
     }
 }
 
+// the rows (or, for continuous images, the pixels) of the back projection are independent
+template<typename HistType> class CalcBackProjInvoker : public ParallelLoopBody
+{
+public:
+    typedef void (*Func)(std::vector<uchar*>& _ptrs, const std::vector<int>& _deltas,
+                         Size imsize, const HistType& hist, int dims, const float** _ranges,
+                         const double* _uniranges, float scale, bool uniform);
+
+    CalcBackProjInvoker(Func _func, const std::vector<uchar*>& _ptrs, const std::vector<int>& _deltas,
+                        Size _imsize, int _esz1, const HistType& _hist, int _dims, const float** _ranges,
+                        const double* _uniranges, float _scale, bool _uniform) :
+        func(_func), ptrs(_ptrs), deltas(_deltas), imsize(_imsize), esz1(_esz1), hist(_hist),
+        dims(_dims), ranges(_ranges), uniranges(_uniranges), scale(_scale), uniform(_uniform)
+    {
+    }
+
+    virtual void operator() (const Range& range) const CV_OVERRIDE
+    {
+        std::vector<uchar*> sptrs;
+        Size ssize;
+        // the back projection has the depth of the images
+        histSliceImages(ptrs, deltas, dims, imsize, esz1, esz1, range, sptrs, ssize);
+        func(sptrs, deltas, ssize, hist, dims, ranges, uniranges, scale, uniform);
+    }
+
+    // runs func over the whole image, in parallel for large images
+    static void run(Func func, std::vector<uchar*>& ptrs, const std::vector<int>& deltas,
+                    Size imsize, int esz1, const HistType& hist, int dims, const float** ranges,
+                    const double* uniranges, float scale, bool uniform)
+    {
+        if( histNumStripes(imsize, 1) > 1 )
+            parallel_for_(Range(0, imsize.height > 1 ? imsize.height : imsize.width),
+                          CalcBackProjInvoker(func, ptrs, deltas, imsize, esz1, hist, dims, ranges,
+                                              uniranges, scale, uniform),
+                          (double)getNumThreads()*4);
+        else
+            func(ptrs, deltas, imsize, hist, dims, ranges, uniranges, scale, uniform);
+    }
+
+private:
+    Func func;
+    const std::vector<uchar*>& ptrs;
+    const std::vector<int>& deltas;
+    Size imsize;
+    int esz1;
+    const HistType& hist;
+    int dims;
+    const float** ranges;
+    const double* uniranges;
+    float scale;
+    bool uniform;
+
+    CalcBackProjInvoker& operator=(const CalcBackProjInvoker&);
+};
+
 }
 
 void cv::calcBackProject( const Mat* images, int nimages, const int* channels,
@@ -1623,14 +1911,18 @@ void cv::calcBackProject( const Mat* images, int nimages, const int* channels,
     const double* _uniranges = uniform ? &uniranges[0] : 0;
 
     int depth = images[0].depth();
+    CalcBackProjInvoker<Mat>::Func func = 0;
     if( depth == CV_8U )
-        calcBackProj_8u(ptrs, deltas, imsize, hist, dims, ranges, _uniranges, (float)scale, uniform);
+        func = calcBackProj_8u;
     else if( depth == CV_16U )
-        calcBackProj_<ushort, ushort>(ptrs, deltas, imsize, hist, dims, ranges, _uniranges, (float)scale, uniform );
+        func = calcBackProj_<ushort, ushort>;
     else if( depth == CV_32F )
-        calcBackProj_<float, float>(ptrs, deltas, imsize, hist, dims, ranges, _uniranges, (float)scale, uniform );
+        func = calcBackProj_<float, float>;
     else
         CV_Error(CV_StsUnsupportedFormat, "");
+
+    CalcBackProjInvoker<Mat>::run(func, ptrs, deltas, imsize, (int)images[0].elemSize1(), hist, dims,
+                                  ranges, _uniranges, (float)scale, uniform);
 }
 
 
@@ -1791,17 +2083,18 @@ void cv::calcBackProject( const Mat* images, int nimages, const int* channels,
                        uniform, ptrs, deltas, imsize, uniranges );
     const double* _uniranges = uniform ? &uniranges[0] : 0;
     int depth = images[0].depth();
+    CalcBackProjInvoker<SparseMat>::Func func = 0;
     if( depth == CV_8U )
-        calcSparseBackProj_8u(ptrs, deltas, imsize, hist, dims, ranges,
-                              _uniranges, (float)scale, uniform);
+        func = calcSparseBackProj_8u;
     else if( depth == CV_16U )
-        calcSparseBackProj_<ushort, ushort>(ptrs, deltas, imsize, hist, dims, ranges,
-                                          _uniranges, (float)scale, uniform );
+        func = calcSparseBackProj_<ushort, ushort>;
     else if( depth == CV_32F )
-        calcSparseBackProj_<float, float>(ptrs, deltas, imsize, hist, dims, ranges,
-                                          _uniranges, (float)scale, uniform );
+        func = calcSparseBackProj_<float, float>;
     else
         CV_Error(CV_StsUnsupportedFormat, "");
+
+    CalcBackProjInvoker<SparseMat>::run(func, ptrs, deltas, imsize, (int)images[0].elemSize1(), hist, dims,
+                                        ranges, _uniranges, (float)scale, uniform);
 }
 
 #ifdef HAVE_OPENCL
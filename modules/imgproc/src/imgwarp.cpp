@@ -2152,6 +2152,125 @@ void cv::convertMaps( InputArray _map1, InputArray _map2,
 namespace cv
 {
 
+static const int WARP_AFFINE_AB_BITS = MAX(10, (int)INTER_BITS);
+
+// computes the integer source coordinates of bw consecutive pixels for INTER_NEAREST
+static void warpAffineBlocklineNN(const int *adelta, const int *bdelta, short* xy, int X0, int Y0, int bw)
+{
+    const int AB_BITS = WARP_AFFINE_AB_BITS;
+    int x1 = 0;
+    #if CV_TRY_SSE4_1
+    if( CV_CPU_HAS_SUPPORT_SSE4_1 )
+    {
+        opt_SSE4_1::WarpAffineInvoker_Blockline_SSE41((int*)adelta, (int*)bdelta, xy, X0, Y0, bw);
+        return;
+    }
+    #endif
+    #if CV_SIMD128
+    {
+        v_int32x4 v_X0 = v_setall_s32(X0), v_Y0 = v_setall_s32(Y0);
+        int span = v_uint16x8::nlanes;
+        for( ; x1 <= bw - span; x1 += span )
+        {
+            v_int16x8 v_dst[2];
+            #define CV_CONVERT_MAP(ptr,offset,shift) v_pack(v_shr<AB_BITS>(shift+v_load(ptr + offset)),\
+                                                            v_shr<AB_BITS>(shift+v_load(ptr + offset + 4)))
+            v_dst[0] = CV_CONVERT_MAP(adelta, x1, v_X0);
+            v_dst[1] = CV_CONVERT_MAP(bdelta, x1, v_Y0);
+            #undef CV_CONVERT_MAP
+            v_store_interleave(xy + (x1 << 1), v_dst[0], v_dst[1]);
+        }
+    }
+    #endif
+    for( ; x1 < bw; x1++ )
+    {
+        int X = (X0 + adelta[x1]) >> AB_BITS;
+        int Y = (Y0 + bdelta[x1]) >> AB_BITS;
+        xy[x1*2] = saturate_cast<short>(X);
+        xy[x1*2+1] = saturate_cast<short>(Y);
+    }
+}
+
+// computes the fixed-point source coordinates of bw consecutive pixels for the interpolating modes
+static void warpAffineBlocklineInter(const int *adelta, const int *bdelta, short* xy, short* alpha, int X0, int Y0, int bw)
+{
+    const int AB_BITS = WARP_AFFINE_AB_BITS;
+    int x1 = 0;
+    #if CV_TRY_AVX2
+    if ( CV_CPU_HAS_SUPPORT_AVX2 )
+        x1 = opt_AVX2::warpAffineBlockline((int*)adelta, (int*)bdelta, xy, alpha, X0, Y0, bw);
+    #endif
+    #if CV_SIMD128
+    {
+        v_int32x4 v__X0 = v_setall_s32(X0), v__Y0 = v_setall_s32(Y0);
+        v_int32x4 v_mask = v_setall_s32(INTER_TAB_SIZE - 1);
+        int span = v_float32x4::nlanes;
+        for( ; x1 <= bw - span * 2; x1 += span * 2 )
+        {
+            v_int32x4 v_X0 = v_shr<AB_BITS - INTER_BITS>(v__X0 + v_load(adelta + x1));
+            v_int32x4 v_Y0 = v_shr<AB_BITS - INTER_BITS>(v__Y0 + v_load(bdelta + x1));
+            v_int32x4 v_X1 = v_shr<AB_BITS - INTER_BITS>(v__X0 + v_load(adelta + x1 + span));
+            v_int32x4 v_Y1 = v_shr<AB_BITS - INTER_BITS>(v__Y0 + v_load(bdelta + x1 + span));
+
+            v_int16x8 v_xy[2];
+            v_xy[0] = v_pack(v_shr<INTER_BITS>(v_X0), v_shr<INTER_BITS>(v_X1));
+            v_xy[1] = v_pack(v_shr<INTER_BITS>(v_Y0), v_shr<INTER_BITS>(v_Y1));
+            v_store_interleave(xy + (x1 << 1), v_xy[0], v_xy[1]);
+
+            v_int32x4 v_alpha0 = v_shl<INTER_BITS>(v_Y0 & v_mask) | (v_X0 & v_mask);
+            v_int32x4 v_alpha1 = v_shl<INTER_BITS>(v_Y1 & v_mask) | (v_X1 & v_mask);
+            v_store(alpha + x1, v_pack(v_alpha0, v_alpha1));
+        }
+    }
+    #endif
+    for( ; x1 < bw; x1++ )
+    {
+        int X = (X0 + adelta[x1]) >> (AB_BITS - INTER_BITS);
+        int Y = (Y0 + bdelta[x1]) >> (AB_BITS - INTER_BITS);
+        xy[x1*2] = saturate_cast<short>(X >> INTER_BITS);
+        xy[x1*2+1] = saturate_cast<short>(Y >> INTER_BITS);
+        alpha[x1] = (short)((Y & (INTER_TAB_SIZE-1))*INTER_TAB_SIZE +
+                (X & (INTER_TAB_SIZE-1)));
+    }
+}
+
+// computes the coordinates of bw pixels of the dst row y in the format expected by remap()
+static inline void warpAffineBlockline(const int *adelta, const int *bdelta, short* xy, short* alpha,
+                                       const double* M, int interpolation, int y, int bw)
+{
+    const int AB_SCALE = 1 << WARP_AFFINE_AB_BITS;
+    int round_delta = interpolation == INTER_NEAREST ? AB_SCALE/2 : AB_SCALE/INTER_TAB_SIZE/2;
+    int X0 = saturate_cast<int>((M[1]*y + M[2])*AB_SCALE) + round_delta;
+    int Y0 = saturate_cast<int>((M[4]*y + M[5])*AB_SCALE) + round_delta;
+
+    if( interpolation == INTER_NEAREST )
+        warpAffineBlocklineNN(adelta, bdelta, xy, X0, Y0, bw);
+    else
+        warpAffineBlocklineInter(adelta, bdelta, xy, alpha, X0, Y0, bw);
+}
+
+static void invertAffine(double* M)
+{
+    double D = M[0]*M[4] - M[1]*M[3];
+    D = D != 0 ? 1./D : 0;
+    double A11 = M[4]*D, A22=M[0]*D;
+    M[0] = A11; M[1] *= -D;
+    M[3] *= -D; M[4] = A22;
+    double b1 = -M[0]*M[2] - M[1]*M[5];
+    double b2 = -M[3]*M[2] - M[4]*M[5];
+    M[2] = b1; M[5] = b2;
+}
+
+static void initWarpAffineDeltas(const double* M, int width, int* adelta, int* bdelta)
+{
+    const int AB_SCALE = 1 << WARP_AFFINE_AB_BITS;
+    for( int x = 0; x < width; x++ )
+    {
+        adelta[x] = saturate_cast<int>(M[0]*x*AB_SCALE);
+        bdelta[x] = saturate_cast<int>(M[3]*x*AB_SCALE);
+    }
+}
+
 class WarpAffineInvoker :
     public ParallelLoopBody
 {
@@ -2168,15 +2287,7 @@ public:
     {
         const int BLOCK_SZ = 64;
         short XY[BLOCK_SZ*BLOCK_SZ*2], A[BLOCK_SZ*BLOCK_SZ];
-        const int AB_BITS = MAX(10, (int)INTER_BITS);
-        const int AB_SCALE = 1 << AB_BITS;
-        int round_delta = interpolation == INTER_NEAREST ? AB_SCALE/2 : AB_SCALE/INTER_TAB_SIZE/2, x, y, x1, y1;
-    #if CV_TRY_AVX2
-        bool useAVX2 = CV_CPU_HAS_SUPPORT_AVX2;
-    #endif
-    #if CV_TRY_SSE4_1
-        bool useSSE4_1 = CV_CPU_HAS_SUPPORT_SSE4_1;
-    #endif
+        int x, y, y1;
 
         int bh0 = std::min(BLOCK_SZ/2, dst.rows);
         int bw0 = std::min(BLOCK_SZ*BLOCK_SZ/bh0, dst.cols);
@@ -2193,87 +2304,8 @@ public:
                 Mat dpart(dst, Rect(x, y, bw, bh));
 
                 for( y1 = 0; y1 < bh; y1++ )
-                {
-                    short* xy = XY + y1*bw*2;
-                    int X0 = saturate_cast<int>((M[1]*(y + y1) + M[2])*AB_SCALE) + round_delta;
-                    int Y0 = saturate_cast<int>((M[4]*(y + y1) + M[5])*AB_SCALE) + round_delta;
-
-                    if( interpolation == INTER_NEAREST )
-                    {
-                        x1 = 0;
-                        #if CV_TRY_SSE4_1
-                        if( useSSE4_1 )
-                            opt_SSE4_1::WarpAffineInvoker_Blockline_SSE41(adelta + x, bdelta + x, xy, X0, Y0, bw);
-                        else
-                        #endif
-                        {
-                            #if CV_SIMD128
-                            {
-                                v_int32x4 v_X0 = v_setall_s32(X0), v_Y0 = v_setall_s32(Y0);
-                                int span = v_uint16x8::nlanes;
-                                for( ; x1 <= bw - span; x1 += span )
-                                {
-                                    v_int16x8 v_dst[2];
-                                    #define CV_CONVERT_MAP(ptr,offset,shift) v_pack(v_shr<AB_BITS>(shift+v_load(ptr + offset)),\
-                                                                                    v_shr<AB_BITS>(shift+v_load(ptr + offset + 4)))
-                                    v_dst[0] = CV_CONVERT_MAP(adelta, x+x1, v_X0);
-                                    v_dst[1] = CV_CONVERT_MAP(bdelta, x+x1, v_Y0);
-                                    #undef CV_CONVERT_MAP
-                                    v_store_interleave(xy + (x1 << 1), v_dst[0], v_dst[1]);
-                                }
-                            }
-                            #endif
-                            for( ; x1 < bw; x1++ )
-                            {
-                                int X = (X0 + adelta[x+x1]) >> AB_BITS;
-                                int Y = (Y0 + bdelta[x+x1]) >> AB_BITS;
-                                xy[x1*2] = saturate_cast<short>(X);
-                                xy[x1*2+1] = saturate_cast<short>(Y);
-                            }
-                        }
-                    }
-                    else
-                    {
-                        short* alpha = A + y1*bw;
-                        x1 = 0;
-                        #if CV_TRY_AVX2
-                        if ( useAVX2 )
-                            x1 = opt_AVX2::warpAffineBlockline(adelta + x, bdelta + x, xy, alpha, X0, Y0, bw);
-                        #endif
-                        #if CV_SIMD128
-                        {
-                            v_int32x4 v__X0 = v_setall_s32(X0), v__Y0 = v_setall_s32(Y0);
-                            v_int32x4 v_mask = v_setall_s32(INTER_TAB_SIZE - 1);
-                            int span = v_float32x4::nlanes;
-                            for( ; x1 <= bw - span * 2; x1 += span * 2 )
-                            {
-                                v_int32x4 v_X0 = v_shr<AB_BITS - INTER_BITS>(v__X0 + v_load(adelta + x + x1));
-                                v_int32x4 v_Y0 = v_shr<AB_BITS - INTER_BITS>(v__Y0 + v_load(bdelta + x + x1));
-                                v_int32x4 v_X1 = v_shr<AB_BITS - INTER_BITS>(v__X0 + v_load(adelta + x + x1 + span));
-                                v_int32x4 v_Y1 = v_shr<AB_BITS - INTER_BITS>(v__Y0 + v_load(bdelta + x + x1 + span));
-
-                                v_int16x8 v_xy[2];
-                                v_xy[0] = v_pack(v_shr<INTER_BITS>(v_X0), v_shr<INTER_BITS>(v_X1));
-                                v_xy[1] = v_pack(v_shr<INTER_BITS>(v_Y0), v_shr<INTER_BITS>(v_Y1));
-                                v_store_interleave(xy + (x1 << 1), v_xy[0], v_xy[1]);
-
-                                v_int32x4 v_alpha0 = v_shl<INTER_BITS>(v_Y0 & v_mask) | (v_X0 & v_mask);
-                                v_int32x4 v_alpha1 = v_shl<INTER_BITS>(v_Y1 & v_mask) | (v_X1 & v_mask);
-                                v_store(alpha + x1, v_pack(v_alpha0, v_alpha1));
-                            }
-                        }
-                        #endif
-                        for( ; x1 < bw; x1++ )
-                        {
-                            int X = (X0 + adelta[x+x1]) >> (AB_BITS - INTER_BITS);
-                            int Y = (Y0 + bdelta[x+x1]) >> (AB_BITS - INTER_BITS);
-                            xy[x1*2] = saturate_cast<short>(X >> INTER_BITS);
-                            xy[x1*2+1] = saturate_cast<short>(Y >> INTER_BITS);
-                            alpha[x1] = (short)((Y & (INTER_TAB_SIZE-1))*INTER_TAB_SIZE +
-                                    (X & (INTER_TAB_SIZE-1)));
-                        }
-                    }
-                }
+                    warpAffineBlockline(adelta + x, bdelta + x, XY + y1*bw*2, A + y1*bw,
+                                        M, interpolation, y + y1, bw);
 
                 if( interpolation == INTER_NEAREST )
                     remap( src, dpart, _XY, Mat(), interpolation, borderType, borderValue );
@@ -2546,17 +2578,9 @@ void warpAffine(int src_type,
     Mat src(Size(src_width, src_height), src_type, const_cast<uchar*>(src_data), src_step);
     Mat dst(Size(dst_width, dst_height), src_type, dst_data, dst_step);
 
-    int x;
     AutoBuffer<int> _abdelta(dst.cols*2);
     int* adelta = &_abdelta[0], *bdelta = adelta + dst.cols;
-    const int AB_BITS = MAX(10, (int)INTER_BITS);
-    const int AB_SCALE = 1 << AB_BITS;
-
-    for( x = 0; x < dst.cols; x++ )
-    {
-        adelta[x] = saturate_cast<int>(M[0]*x*AB_SCALE);
-        bdelta[x] = saturate_cast<int>(M[3]*x*AB_SCALE);
-    }
+    initWarpAffineDeltas(M, dst.cols, adelta, bdelta);
 
     Range range(0, dst.rows);
     WarpAffineInvoker invoker(src, dst, interpolation, borderType,
@@ -2604,16 +2628,7 @@ void cv::warpAffine( InputArray _src, OutputArray _dst,
     M0.convertTo(matM, matM.type());
 
     if( !(flags & WARP_INVERSE_MAP) )
-    {
-        double D = M[0]*M[4] - M[1]*M[3];
-        D = D != 0 ? 1./D : 0;
-        double A11 = M[4]*D, A22=M[0]*D;
-        M[0] = A11; M[1] *= -D;
-        M[3] *= -D; M[4] = A22;
-        double b1 = -M[0]*M[2] - M[1]*M[5];
-        double b2 = -M[3]*M[2] - M[4]*M[5];
-        M[2] = b1; M[5] = b2;
-    }
+        invertAffine(M);
 
 #if defined (HAVE_IPP) && IPP_VERSION_X100 >= 810 && !IPP_DISABLE_WARPAFFINE
     CV_IPP_CHECK()
@@ -2939,6 +2954,97 @@ void WarpPerspectiveLine_Process_CV_SIMD(const double *M, short* xy, short* alph
 }
 #endif
 
+// computes the source coordinates of a line of the destination image in the format expected by remap()
+class WarpPerspectiveLine
+{
+public:
+    WarpPerspectiveLine(const double *_M, int _interpolation) : M(_M), interpolation(_interpolation)
+    {
+        #if CV_TRY_SSE4_1
+        if(CV_CPU_HAS_SUPPORT_SSE4_1)
+            pwarp_impl_sse4 = opt_SSE4_1::WarpPerspectiveLine_SSE4::getImpl(M);
+        #endif
+    }
+
+    // processes the pixels [x, x + bw) of the dst row y
+    void operator() (short* xy, short* alpha, int x, int y, int bw) const
+    {
+        double X0 = M[0]*x + M[1]*y + M[2];
+        double Y0 = M[3]*x + M[4]*y + M[5];
+        double W0 = M[6]*x + M[7]*y + M[8];
+
+        if( interpolation == INTER_NEAREST )
+        {
+            #if CV_TRY_SSE4_1
+            if (pwarp_impl_sse4)
+                pwarp_impl_sse4->processNN(M, xy, X0, Y0, W0, bw);
+            else
+            #endif
+            #if CV_SIMD128_64F
+            WarpPerspectiveLine_ProcessNN_CV_SIMD(M, xy, X0, Y0, W0, bw);
+            #else
+            for( int x1 = 0; x1 < bw; x1++ )
+            {
+                double W = W0 + M[6]*x1;
+                W = W ? 1./W : 0;
+                double fX = std::max((double)INT_MIN, std::min((double)INT_MAX, (X0 + M[0]*x1)*W));
+                double fY = std::max((double)INT_MIN, std::min((double)INT_MAX, (Y0 + M[3]*x1)*W));
+                int X = saturate_cast<int>(fX);
+                int Y = saturate_cast<int>(fY);
+
+                xy[x1*2] = saturate_cast<short>(X);
+                xy[x1*2+1] = saturate_cast<short>(Y);
+            }
+            #endif
+        }
+        else
+        {
+            #if CV_TRY_SSE4_1
+            if (pwarp_impl_sse4)
+                pwarp_impl_sse4->process(M, xy, alpha, X0, Y0, W0, bw);
+            else
+            #endif
+            #if CV_SIMD128_64F
+            WarpPerspectiveLine_Process_CV_SIMD(M, xy, alpha, X0, Y0, W0, bw);
+            #else
+            for( int x1 = 0; x1 < bw; x1++ )
+            {
+                double W = W0 + M[6]*x1;
+                W = W ? INTER_TAB_SIZE/W : 0;
+                double fX = std::max((double)INT_MIN, std::min((double)INT_MAX, (X0 + M[0]*x1)*W));
+                double fY = std::max((double)INT_MIN, std::min((double)INT_MAX, (Y0 + M[3]*x1)*W));
+                int X = saturate_cast<int>(fX);
+                int Y = saturate_cast<int>(fY);
+
+                xy[x1*2] = saturate_cast<short>(X >> INTER_BITS);
+                xy[x1*2+1] = saturate_cast<short>(Y >> INTER_BITS);
+                alpha[x1] = (short)((Y & (INTER_TAB_SIZE-1))*INTER_TAB_SIZE +
+                                    (X & (INTER_TAB_SIZE-1)));
+            }
+            #endif
+        }
+    }
+
+private:
+    const double* M;
+    int interpolation;
+    #if CV_TRY_SSE4_1
+    Ptr<opt_SSE4_1::WarpPerspectiveLine_SSE4> pwarp_impl_sse4;
+    #endif
+};
+
+static const int WARP_PERSPECTIVE_BLOCK_SZ = 32;
+
+// the block decomposition affects the rounding of the coordinates, so it is shared with WarpPlan
+static Size getWarpPerspectiveBlockSize(Size dsize)
+{
+    const int BLOCK_SZ = WARP_PERSPECTIVE_BLOCK_SZ;
+    int bh0 = std::min(BLOCK_SZ/2, dsize.height);
+    int bw0 = std::min(BLOCK_SZ*BLOCK_SZ/bh0, dsize.width);
+    bh0 = std::min(BLOCK_SZ*BLOCK_SZ/bw0, dsize.height);
+    return Size(bw0, bh0);
+}
+
 class WarpPerspectiveInvoker :
     public ParallelLoopBody
 {
@@ -2957,19 +3063,14 @@ public:
 
     virtual void operator() (const Range& range) const CV_OVERRIDE
     {
-        const int BLOCK_SZ = 32;
+        const int BLOCK_SZ = WARP_PERSPECTIVE_BLOCK_SZ;
         short XY[BLOCK_SZ*BLOCK_SZ*2], A[BLOCK_SZ*BLOCK_SZ];
-        int x, y, y1, width = dst.cols, height = dst.rows;
+        int x, y, y1, width = dst.cols;
 
-        int bh0 = std::min(BLOCK_SZ/2, height);
-        int bw0 = std::min(BLOCK_SZ*BLOCK_SZ/bh0, width);
-        bh0 = std::min(BLOCK_SZ*BLOCK_SZ/bw0, height);
+        Size bsize = getWarpPerspectiveBlockSize(dst.size());
+        int bw0 = bsize.width, bh0 = bsize.height;
 
-        #if CV_TRY_SSE4_1
-        Ptr<opt_SSE4_1::WarpPerspectiveLine_SSE4> pwarp_impl_sse4;
-        if(CV_CPU_HAS_SUPPORT_SSE4_1)
-            pwarp_impl_sse4 = opt_SSE4_1::WarpPerspectiveLine_SSE4::getImpl(M);
-        #endif
+        WarpPerspectiveLine warpLine(M, interpolation);
 
         for( y = range.start; y < range.end; y += bh0 )
         {
@@ -2982,65 +3083,7 @@ public:
                 Mat dpart(dst, Rect(x, y, bw, bh));
 
                 for( y1 = 0; y1 < bh; y1++ )
-                {
-                    short* xy = XY + y1*bw*2;
-                    double X0 = M[0]*x + M[1]*(y + y1) + M[2];
-                    double Y0 = M[3]*x + M[4]*(y + y1) + M[5];
-                    double W0 = M[6]*x + M[7]*(y + y1) + M[8];
-
-                    if( interpolation == INTER_NEAREST )
-                    {
-                        #if CV_TRY_SSE4_1
-                        if (pwarp_impl_sse4)
-                            pwarp_impl_sse4->processNN(M, xy, X0, Y0, W0, bw);
-                        else
-                        #endif
-                        #if CV_SIMD128_64F
-                        WarpPerspectiveLine_ProcessNN_CV_SIMD(M, xy, X0, Y0, W0, bw);
-                        #else
-                        for( int x1 = 0; x1 < bw; x1++ )
-                        {
-                            double W = W0 + M[6]*x1;
-                            W = W ? 1./W : 0;
-                            double fX = std::max((double)INT_MIN, std::min((double)INT_MAX, (X0 + M[0]*x1)*W));
-                            double fY = std::max((double)INT_MIN, std::min((double)INT_MAX, (Y0 + M[3]*x1)*W));
-                            int X = saturate_cast<int>(fX);
-                            int Y = saturate_cast<int>(fY);
-
-                            xy[x1*2] = saturate_cast<short>(X);
-                            xy[x1*2+1] = saturate_cast<short>(Y);
-                        }
-                        #endif
-                    }
-                    else
-                    {
-                        short* alpha = A + y1*bw;
-
-                        #if CV_TRY_SSE4_1
-                        if (pwarp_impl_sse4)
-                            pwarp_impl_sse4->process(M, xy, alpha, X0, Y0, W0, bw);
-                        else
-                        #endif
-                        #if CV_SIMD128_64F
-                        WarpPerspectiveLine_Process_CV_SIMD(M, xy, alpha, X0, Y0, W0, bw);
-                        #else
-                        for( int x1 = 0; x1 < bw; x1++ )
-                        {
-                            double W = W0 + M[6]*x1;
-                            W = W ? INTER_TAB_SIZE/W : 0;
-                            double fX = std::max((double)INT_MIN, std::min((double)INT_MAX, (X0 + M[0]*x1)*W));
-                            double fY = std::max((double)INT_MIN, std::min((double)INT_MAX, (Y0 + M[3]*x1)*W));
-                            int X = saturate_cast<int>(fX);
-                            int Y = saturate_cast<int>(fY);
-
-                            xy[x1*2] = saturate_cast<short>(X >> INTER_BITS);
-                            xy[x1*2+1] = saturate_cast<short>(Y >> INTER_BITS);
-                            alpha[x1] = (short)((Y & (INTER_TAB_SIZE-1))*INTER_TAB_SIZE +
-                                                (X & (INTER_TAB_SIZE-1)));
-                        }
-                        #endif
-                    }
-                }
+                    warpLine(XY + y1*bw*2, A + y1*bw, x, y + y1, bw);
 
                 if( interpolation == INTER_NEAREST )
                     remap( src, dpart, _XY, Mat(), interpolation, borderType, borderValue );
@@ -3234,6 +3277,182 @@ void cv::warpPerspective( InputArray _src, OutputArray _dst, InputArray _M0,
 }
 
 
+namespace cv
+{
+
+struct WarpPlan::Impl
+{
+    Impl() : perspective(false), interpolation(INTER_LINEAR)
+    {
+        memset(M, 0, sizeof(M));
+    }
+
+    void buildMaps(size_t maxMapBytes);
+
+    bool perspective;
+    // the inverse transformation, i.e. dst -> src
+    double M[9];
+    int interpolation;
+    Size dsize;
+    // integer coordinates (CV_16SC2) and interpolation table indices (CV_16UC1), see convertMaps()
+    Mat map1, map2;
+};
+
+class WarpPlanMapsInvoker :
+    public ParallelLoopBody
+{
+public:
+    WarpPlanMapsInvoker(WarpPlan::Impl& _plan, const int* _adelta, const int* _bdelta) :
+        ParallelLoopBody(), plan(_plan), adelta(_adelta), bdelta(_bdelta)
+    {
+    }
+
+    virtual void operator() (const Range& range) const CV_OVERRIDE
+    {
+        int width = plan.dsize.width;
+        Size bsize = getWarpPerspectiveBlockSize(plan.dsize);
+        WarpPerspectiveLine warpLine(plan.M, plan.interpolation);
+
+        for( int y = range.start; y < range.end; y++ )
+        {
+            short* xy = plan.map1.ptr<short>(y);
+            short* alpha = plan.map2.empty() ? 0 : plan.map2.ptr<short>(y);
+
+            if( !plan.perspective )
+            {
+                warpAffineBlockline(adelta, bdelta, xy, alpha, plan.M, plan.interpolation, y, width);
+                continue;
+            }
+
+            // reproduce the block decomposition of WarpPerspectiveInvoker to get the same rounding
+            for( int x = 0; x < width; x += bsize.width )
+            {
+                int bw = std::min(bsize.width, width - x);
+                warpLine(xy + x*2, alpha ? alpha + x : 0, x, y, bw);
+            }
+        }
+    }
+
+private:
+    WarpPlan::Impl& plan;
+    const int *adelta, *bdelta;
+};
+
+void WarpPlan::Impl::buildMaps(size_t maxMapBytes)
+{
+    bool nearest = interpolation == INTER_NEAREST;
+    size_t bytes = (size_t)dsize.width*dsize.height*(nearest ? 4 : 6);
+    map1.release();
+    map2.release();
+    if( bytes > maxMapBytes || dsize.width > SHRT_MAX || dsize.height > SHRT_MAX )
+        return;
+
+    map1.create(dsize, CV_16SC2);
+    if( !nearest )
+        map2.create(dsize, CV_16UC1);
+
+    AutoBuffer<int> _abdelta(perspective ? 1 : dsize.width*2);
+    int* adelta = _abdelta.data(), *bdelta = adelta + dsize.width;
+    if( !perspective )
+        initWarpAffineDeltas(M, dsize.width, adelta, bdelta);
+
+    parallel_for_(Range(0, dsize.height), WarpPlanMapsInvoker(*this, adelta, bdelta),
+                  dsize.area()/(double)(1<<16));
+}
+
+WarpPlan::WarpPlan()
+{
+}
+
+void WarpPlan::initAffine(InputArray _M0, Size dsize, int flags, size_t maxMapBytes)
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat M0 = _M0.getMat();
+    CV_Assert( (M0.type() == CV_32F || M0.type() == CV_64F) && M0.rows == 2 && M0.cols == 3 );
+    CV_Assert( dsize.width > 0 && dsize.height > 0 );
+
+    Ptr<Impl> plan = makePtr<Impl>();
+    Mat matM(2, 3, CV_64F, plan->M);
+    M0.convertTo(matM, matM.type());
+    if( !(flags & WARP_INVERSE_MAP) )
+        invertAffine(plan->M);
+
+    plan->interpolation = flags & INTER_MAX;
+    if( plan->interpolation == INTER_AREA )
+        plan->interpolation = INTER_LINEAR;
+    plan->dsize = dsize;
+    plan->buildMaps(maxMapBytes);
+    p = plan;
+}
+
+void WarpPlan::initPerspective(InputArray _M0, Size dsize, int flags, size_t maxMapBytes)
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat M0 = _M0.getMat();
+    CV_Assert( (M0.type() == CV_32F || M0.type() == CV_64F) && M0.rows == 3 && M0.cols == 3 );
+    CV_Assert( dsize.width > 0 && dsize.height > 0 );
+
+    Ptr<Impl> plan = makePtr<Impl>();
+    Mat matM(3, 3, CV_64F, plan->M);
+    M0.convertTo(matM, matM.type());
+    if( !(flags & WARP_INVERSE_MAP) )
+        invert(matM, matM);
+
+    plan->perspective = true;
+    plan->interpolation = flags & INTER_MAX;
+    if( plan->interpolation == INTER_AREA )
+        plan->interpolation = INTER_LINEAR;
+    plan->dsize = dsize;
+    plan->buildMaps(maxMapBytes);
+    p = plan;
+}
+
+void WarpPlan::apply(InputArray _src, OutputArray _dst, int borderType, const Scalar& borderValue) const
+{
+    CV_INSTRUMENT_REGION();
+
+    CV_Assert( !empty() );
+    const Impl& plan = *p;
+    CV_Assert( _src.channels() <= 4 || (plan.interpolation != INTER_LANCZOS4 &&
+                                        plan.interpolation != INTER_CUBIC) );
+
+    Mat src = _src.getMat();
+    CV_Assert( src.cols > 0 && src.rows > 0 );
+    _dst.create( plan.dsize, src.type() );
+    Mat dst = _dst.getMat();
+    if( dst.data == src.data )
+        src = src.clone();
+
+    if( !plan.map1.empty() )
+        remap( src, dst, plan.map1, plan.map2, plan.interpolation, borderType, borderValue );
+    else if( plan.perspective )
+        hal::warpPerspectve(src.type(), src.data, src.step, src.cols, src.rows, dst.data, dst.step, dst.cols, dst.rows,
+                            plan.M, plan.interpolation, borderType, borderValue.val);
+    else
+        hal::warpAffine(src.type(), src.data, src.step, src.cols, src.rows, dst.data, dst.step, dst.cols, dst.rows,
+                        plan.M, plan.interpolation, borderType, borderValue.val);
+}
+
+bool WarpPlan::hasMaps() const
+{
+    return p && !p->map1.empty();
+}
+
+size_t WarpPlan::mapBytes() const
+{
+    return p ? p->map1.total()*p->map1.elemSize() + p->map2.total()*p->map2.elemSize() : 0;
+}
+
+bool WarpPlan::empty() const
+{
+    return !p;
+}
+
+} // cv::
+
+
 cv::Mat cv::getRotationMatrix2D( Point2f center, double angle, double scale )
 {
     CV_INSTRUMENT_REGION();
@@ -742,18 +742,13 @@ struct PyrDownInvoker : ParallelLoopBody
     int _borderType;
 };
 
-template<class CastOp> void
-pyrDown_( const Mat& _src, Mat& _dst, int borderType )
+static const int PYR_DOWN_TAB_SZ = CV_CN_MAX*7;
+
+// fills the column tables used by PyrDownInvoker; tabL and tabR have PYR_DOWN_TAB_SZ elements,
+// tabM has dsize.width*cn elements
+static void initPyrDownTabs( Size ssize, Size dsize, int cn, int borderType, int* tabL, int* tabR, int* tabM )
 {
     const int PD_SZ = 5;
-    CV_Assert( !_src.empty() );
-    Size ssize = _src.size(), dsize = _dst.size();
-    int cn = _src.channels();
-
-    int tabL[CV_CN_MAX*(PD_SZ+2)], tabR[CV_CN_MAX*(PD_SZ+2)];
-    AutoBuffer<int> _tabM(dsize.width*cn);
-    int* tabM = _tabM.data();
-
     CV_Assert( ssize.width > 0 && ssize.height > 0 &&
                std::abs(dsize.width*2 - ssize.width) <= 2 &&
                std::abs(dsize.height*2 - ssize.height) <= 2 );
@@ -772,6 +767,19 @@ pyrDown_( const Mat& _src, Mat& _dst, int borderType )
 
     for (int x = 0; x < dsize.width*cn; x++)
         tabM[x] = (x/cn)*2*cn + x % cn;
+}
+
+template<class CastOp> void
+pyrDown_( const Mat& _src, Mat& _dst, int borderType )
+{
+    CV_Assert( !_src.empty() );
+    Size ssize = _src.size(), dsize = _dst.size();
+    int cn = _src.channels();
+
+    int tabL[PYR_DOWN_TAB_SZ], tabR[PYR_DOWN_TAB_SZ];
+    AutoBuffer<int> _tabM(dsize.width*cn);
+    int* tabM = _tabM.data();
+    initPyrDownTabs(ssize, dsize, cn, borderType, tabL, tabR, tabM);
 
     int *tabLPtr = tabL;
     int *tabRPtr = tabR;
@@ -900,85 +908,84 @@ void PyrDownInvoker<CastOp>::operator()(const Range& range) const
 }
 
 
-template<class CastOp> void
-pyrUp_( const Mat& _src, Mat& _dst, int)
+// computes pairs of rows of the 2x upsampled image, one source row at a time;
+// the source rows must be processed in increasing order, starting from any row
+template<class CastOp> class PyrUpRows
 {
-    const int PU_SZ = 3;
+public:
     typedef typename CastOp::type1 WT;
     typedef typename CastOp::rtype T;
 
-    Size ssize = _src.size(), dsize = _dst.size();
-    int cn = _src.channels();
-    int bufstep = (int)alignSize((dsize.width+1)*cn, 16);
-    AutoBuffer<WT> _buf(bufstep*PU_SZ + 16);
-    WT* buf = alignPtr((WT*)_buf.data(), 16);
-    AutoBuffer<int> _dtab(ssize.width*cn);
-    int* dtab = _dtab.data();
-    WT* rows[PU_SZ];
-    T* dsts[2];
-    CastOp castOp;
-    //PyrUpVecH<T, WT> vecOpH;
-
-    CV_Assert( std::abs(dsize.width - ssize.width*2) == dsize.width % 2 &&
-               std::abs(dsize.height - ssize.height*2) == dsize.height % 2);
-    int k, x, sy0 = -PU_SZ/2, sy = sy0;
-
-    ssize.width *= cn;
-    dsize.width *= cn;
-
-    for( x = 0; x < ssize.width; x++ )
-        dtab[x] = (x/cn)*2*cn + x % cn;
+    PyrUpRows( const Mat& _src, Size _dsize, int y0 ) : src(_src)
+    {
+        ssize = src.size(); dsize = _dsize;
+        dcols = dsize.width;
+        cn = src.channels();
+        bufstep = (int)alignSize((dsize.width+1)*cn, 16);
+        _buf.allocate(bufstep*PU_SZ + 16);
+        buf = alignPtr((WT*)_buf.data(), 16);
+        _dtab.allocate(ssize.width*cn);
+        ssize.width *= cn;
+        dsize.width *= cn;
+        for( int x = 0; x < ssize.width; x++ )
+            _dtab[x] = (x/cn)*2*cn + x % cn;
+        sy = y0 + sy0;
+    }
 
-    for( int y = 0; y < ssize.height; y++ )
+    // writes the dst rows y*2 and y*2+1; dst1 may be the same as dst0 for the last row of an odd-height image
+    void operator()( int y, T* dst0, T* dst1 )
     {
-        T* dst0 = _dst.ptr<T>(y*2);
-        T* dst1 = _dst.ptr<T>(std::min(y*2+1, dsize.height-1));
+        const int* dtab = _dtab.data();
+        WT* rows[PU_SZ];
+        T* dsts[2];
+        CastOp castOp;
         WT *row0, *row1, *row2;
+        int x;
 
         // fill the ring buffer (horizontal convolution and decimation)
         for( ; sy <= y + 1; sy++ )
         {
             WT* row = buf + ((sy - sy0) % PU_SZ)*bufstep;
             int _sy = borderInterpolate(sy*2, ssize.height*2, BORDER_REFLECT_101)/2;
-            const T* src = _src.ptr<T>(_sy);
+            const T* src_ = src.ptr<T>(_sy);
 
             if( ssize.width == cn )
             {
                 for( x = 0; x < cn; x++ )
-                    row[x] = row[x + cn] = src[x]*8;
+                    row[x] = row[x + cn] = src_[x]*8;
                 continue;
             }
 
             for( x = 0; x < cn; x++ )
             {
                 int dx = dtab[x];
-                WT t0 = src[x]*6 + src[x + cn]*2;
-                WT t1 = (src[x] + src[x + cn])*4;
+                WT t0 = src_[x]*6 + src_[x + cn]*2;
+                WT t1 = (src_[x] + src_[x + cn])*4;
                 row[dx] = t0; row[dx + cn] = t1;
                 dx = dtab[ssize.width - cn + x];
                 int sx = ssize.width - cn + x;
-                t0 = src[sx - cn] + src[sx]*7;
-                t1 = src[sx]*8;
+                t0 = src_[sx - cn] + src_[sx]*7;
+                t1 = src_[sx]*8;
                 row[dx] = t0; row[dx + cn] = t1;
 
                 if (dsize.width > ssize.width*2)
                 {
-                    row[(_dst.cols-1) + x] = row[dx + cn];
+                    row[(dcols-1) + x] = row[dx + cn];
                 }
             }
 
             for( x = cn; x < ssize.width - cn; x++ )
             {
                 int dx = dtab[x];
-                WT t0 = src[x-cn] + src[x]*6 + src[x+cn];
-                WT t1 = (src[x] + src[x+cn])*4;
+                WT t0 = src_[x-cn] + src_[x]*6 + src_[x+cn];
+                WT t1 = (src_[x] + src_[x+cn])*4;
                 row[dx] = t0;
                 row[dx+cn] = t1;
             }
         }
 
         // do vertical convolution and decimation and write the result to the destination image
-        for( k = 0; k < PU_SZ; k++ )
+        for( int k = 0; k < PU_SZ; k++ )
             rows[k] = buf + ((y - PU_SZ/2 + k - sy0) % PU_SZ)*bufstep;
         row0 = rows[0]; row1 = rows[1]; row2 = rows[2];
         dsts[0] = dst0; dsts[1] = dst1;
@@ -992,12 +999,38 @@ pyrUp_( const Mat& _src, Mat& _dst, int)
         }
     }
 
+private:
+    enum { PU_SZ = 3, sy0 = -PU_SZ/2 };
+
+    const Mat& src;
+    Size ssize, dsize;
+    int dcols, cn, bufstep, sy;
+    AutoBuffer<WT> _buf;
+    WT* buf;
+    AutoBuffer<int> _dtab;
+};
+
+template<class CastOp> void
+pyrUp_( const Mat& _src, Mat& _dst, int)
+{
+    typedef typename CastOp::rtype T;
+
+    Size ssize = _src.size(), dsize = _dst.size();
+    int cn = _src.channels();
+
+    CV_Assert( std::abs(dsize.width - ssize.width*2) == dsize.width % 2 &&
+               std::abs(dsize.height - ssize.height*2) == dsize.height % 2);
+
+    PyrUpRows<CastOp> upRows(_src, dsize, 0);
+    for( int y = 0; y < ssize.height; y++ )
+        upRows(y, _dst.ptr<T>(y*2), _dst.ptr<T>(std::min(y*2+1, dsize.height-1)));
+
     if (dsize.height > ssize.height*2)
     {
         T* dst0 = _dst.ptr<T>(ssize.height*2-2);
         T* dst2 = _dst.ptr<T>(ssize.height*2);
 
-        for(x = 0; x < dsize.width ; x++ )
+        for(int x = 0; x < dsize.width*cn ; x++ )
         {
             dst2[x] = dst0[x];
         }
@@ -1565,6 +1598,225 @@ void cv::buildPyramid( InputArray _src, OutputArrayOfArrays _dst, int maxlevel,
         pyrDown( _dst.getMatRef(i-1), _dst.getMatRef(i), Size(), borderType );
 }
 
+namespace cv
+{
+
+template<typename T, typename LT> static void
+pyrLaplacianRow( const T* g, const T* u, LT* l, int width )
+{
+    for( int x = 0; x < width; x++ )
+        l[x] = (LT)((LT)g[x] - (LT)u[x]);
+}
+
+static void pyrLaplacianRow( const uchar* g, const uchar* u, short* l, int width )
+{
+    int x = 0;
+#if CV_SIMD
+    for( ; x <= width - v_uint8::nlanes; x += v_uint8::nlanes )
+    {
+        v_uint16 g0, g1, u0, u1;
+        v_expand(vx_load(g + x), g0, g1);
+        v_expand(vx_load(u + x), u0, u1);
+        v_store(l + x, v_reinterpret_as_s16(g0) - v_reinterpret_as_s16(u0));
+        v_store(l + x + v_int16::nlanes, v_reinterpret_as_s16(g1) - v_reinterpret_as_s16(u1));
+    }
+    vx_cleanup();
+#endif
+    for( ; x < width; x++ )
+        l[x] = (short)(g[x] - u[x]);
+}
+
+// One step of the fused pyramid construction: src -> dst is a pyrDown step and
+// lapSrc - pyrUp(src) -> lapDst is the Laplacian level below src. Both steps read the same rows
+// of src, so they are done by the same stripe while the rows are still in cache.
+// The range is measured in pairs of src rows (i.e. in dst rows).
+template<class DownCast, class UpCast, typename LT>
+class BuildPyramidInvoker : public ParallelLoopBody
+{
+public:
+    typedef typename DownCast::rtype T;
+
+    BuildPyramidInvoker( const PyrDownInvoker<DownCast>* _down, const Mat& _src, const Mat& _lapSrc, const Mat& _lapDst )
+        : down(_down), src(_src), lapSrc(_lapSrc), lapDst(_lapDst)
+    {
+    }
+
+    void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        if( down )
+            (*down)(range);
+
+        if( lapDst.empty() )
+            return;
+
+        Size lsize = lapSrc.size();
+        int width = lsize.width*lapSrc.channels();
+        int y0 = range.start*2, y1 = std::min(range.end*2, src.rows);
+        AutoBuffer<T> _urows(width*2);
+        T* urows[] = { _urows.data(), _urows.data() + width };
+        PyrUpRows<UpCast> upRows(src, lsize, y0);
+
+        for( int y = y0; y < y1; y++ )
+        {
+            // the same aliasing of the last row as in pyrUp_
+            bool last = y*2 + 1 >= lsize.height;
+            upRows(y, urows[0], last ? urows[0] : urows[1]);
+            pyrLaplacianRow(lapSrc.ptr<T>(y*2), urows[0], (LT*)lapDst.ptr<LT>(y*2), width);
+            if( !last )
+                pyrLaplacianRow(lapSrc.ptr<T>(y*2 + 1), urows[1], (LT*)lapDst.ptr<LT>(y*2 + 1), width);
+        }
+    }
+
+private:
+    const PyrDownInvoker<DownCast>* down;
+    Mat src, lapSrc, lapDst;
+};
+
+template<class DownCast, class UpCast, typename LT> static void
+buildPyramid_( std::vector<Mat>& gauss, std::vector<Mat>* lap, int borderType )
+{
+    int maxlevel = (int)gauss.size() - 1;
+
+    // the pass i computes the Gaussian level i and the Laplacian level i-2
+    for( int i = 1; i <= maxlevel + (lap ? 1 : 0); i++ )
+    {
+        const Mat& src = gauss[i-1];
+        Mat dst, lapSrc, lapDst;
+        if( i <= maxlevel )
+            dst = gauss[i];
+        if( lap && i >= 2 )
+        {
+            lapSrc = gauss[i-2];
+            lapDst = (*lap)[i-2];
+        }
+        if( dst.empty() && lapDst.empty() )
+            continue;
+
+        int cn = src.channels();
+        int tabL[PYR_DOWN_TAB_SZ], tabR[PYR_DOWN_TAB_SZ];
+        AutoBuffer<int> _tabM(std::max(dst.cols*cn, 1));
+        int *tabLPtr = tabL, *tabRPtr = tabR, *tabM = _tabM.data();
+        if( !dst.empty() )
+            initPyrDownTabs(src.size(), dst.size(), cn, borderType, tabL, tabR, tabM);
+        PyrDownInvoker<DownCast> down(src, dst, borderType, &tabRPtr, &tabM, &tabLPtr);
+
+        // stripes of ~64K of src, so that both steps of a stripe work in L2 cache
+        double nstripes = std::max((double)getNumThreads(), (double)(src.total()*src.elemSize() >> 16));
+        parallel_for_(Range(0, (src.rows + 1)/2),
+                      BuildPyramidInvoker<DownCast, UpCast, LT>(dst.empty() ? 0 : &down, src, lapSrc, lapDst),
+                      nstripes);
+    }
+}
+
+typedef void (*BuildPyramidFunc)(std::vector<Mat>&, std::vector<Mat>*, int);
+
+static int laplacianPyramidDepth( int depth )
+{
+    return depth == CV_8U ? CV_16S : depth == CV_16U || depth == CV_16S ? CV_32F : depth;
+}
+
+// allocates the levels [first, last] of a pyramid as parts of a single buffer
+static void allocatePyramid( Size size, int type, int first, int last, std::vector<Mat>& levels )
+{
+    const size_t align = 64; // in pixels, keeps every level cache line aligned
+    std::vector<size_t> ofs(last + 1, 0);
+    size_t total = 0;
+    Size sz = size;
+    for( int i = 0; i <= last; i++ )
+    {
+        if( i >= first )
+        {
+            ofs[i] = total;
+            total += alignSize((size_t)sz.area(), align);
+        }
+        sz = Size((sz.width + 1)/2, (sz.height + 1)/2);
+    }
+    if( total == 0 )
+        return;
+    CV_Assert( total <= (size_t)INT_MAX );
+
+    Mat buf(1, (int)total, type);
+    sz = size;
+    for( int i = 0; i <= last; i++ )
+    {
+        if( i >= first )
+            levels[i] = buf.colRange((int)ofs[i], (int)ofs[i] + sz.area()).reshape(0, sz.height);
+        sz = Size((sz.width + 1)/2, (sz.height + 1)/2);
+    }
+}
+
+}
+
+void cv::buildPyramid( InputArray _src, OutputArrayOfArrays _gaussian, OutputArrayOfArrays _laplacian,
+                       int maxlevel, int borderType )
+{
+    CV_INSTRUMENT_REGION();
+
+    CV_Assert(borderType != BORDER_CONSTANT && maxlevel >= 0);
+
+    int type = _src.type(), depth = CV_MAT_DEPTH(type), cn = CV_MAT_CN(type);
+    int ldepth = laplacianPyramidDepth(depth);
+    bool needLaplacian = _laplacian.needed();
+
+    if (_src.dims() <= 2 && _gaussian.isUMatVector())
+    {
+        buildPyramid( _src, _gaussian, maxlevel, borderType );
+        if( needLaplacian )
+        {
+            _laplacian.create( maxlevel + 1, 1, 0 );
+            for( int i = 0; i < maxlevel; i++ )
+            {
+                UMat up;
+                pyrUp( _gaussian.getUMatRef(i+1), up, _gaussian.getUMatRef(i).size() );
+                subtract( _gaussian.getUMatRef(i), up, _laplacian.getUMatRef(i), noArray(), ldepth );
+            }
+            _gaussian.getUMatRef(maxlevel).convertTo( _laplacian.getUMatRef(maxlevel), ldepth );
+        }
+        return;
+    }
+
+    Mat src = _src.getMat();
+    CV_Assert( !src.empty() );
+
+    BuildPyramidFunc func = 0;
+    if( depth == CV_8U )
+        func = buildPyramid_< FixPtCast<uchar, 8>, FixPtCast<uchar, 6>, short >;
+    else if( depth == CV_16S )
+        func = buildPyramid_< FixPtCast<short, 8>, FixPtCast<short, 6>, float >;
+    else if( depth == CV_16U )
+        func = buildPyramid_< FixPtCast<ushort, 8>, FixPtCast<ushort, 6>, float >;
+    else if( depth == CV_32F )
+        func = buildPyramid_< FltCast<float, 8>, FltCast<float, 6>, float >;
+    else if( depth == CV_64F )
+        func = buildPyramid_< FltCast<double, 8>, FltCast<double, 6>, double >;
+    else
+        CV_Error( CV_StsUnsupportedFormat, "" );
+
+    std::vector<Mat> gauss(maxlevel + 1), lap;
+    gauss[0] = src;
+    allocatePyramid( src.size(), type, 1, maxlevel, gauss );
+    if( needLaplacian )
+    {
+        lap.resize(maxlevel + 1);
+        allocatePyramid( src.size(), CV_MAKETYPE(ldepth, cn), 0, maxlevel, lap );
+    }
+
+    func( gauss, needLaplacian ? &lap : 0, borderType & ~BORDER_ISOLATED );
+
+    _gaussian.create( maxlevel + 1, 1, 0 );
+    for( int i = 0; i <= maxlevel; i++ )
+        _gaussian.getMatRef(i) = gauss[i];
+
+    if( needLaplacian )
+    {
+        // the top of the Laplacian pyramid is the smallest Gaussian level
+        gauss[maxlevel].convertTo( lap[maxlevel], ldepth );
+        _laplacian.create( maxlevel + 1, 1, 0 );
+        for( int i = 0; i <= maxlevel; i++ )
+            _laplacian.getMatRef(i) = lap[i];
+    }
+}
+
 CV_IMPL void cvPyrDown( const void* srcarr, void* dstarr, int _filter )
 {
     cv::Mat src = cv::cvarrToMat(srcarr), dst = cv::cvarrToMat(dstarr);
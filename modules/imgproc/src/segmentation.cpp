@@ -41,6 +41,7 @@
 //M*/
 
 #include "precomp.hpp"
+#include "opencv2/core/hal/intrin.hpp"
 
 /****************************************************************************************\
 *                                       Watershed                                        *
@@ -330,6 +331,203 @@ void cv::watershed( InputArray _src, InputOutputArray _markers )
 \****************************************************************************************/
 
 
+namespace cv
+{
+
+#if CV_SIMD128
+// accumulates the pixels of a window row whose color distance to c is within isr2
+static inline int meanShiftRowSIMD( const uchar* ptr, int x, int maxx, int y, const v_uint8x16& c0,
+                                    const v_uint8x16& c1, const v_uint8x16& c2, const v_uint32x4& visr2,
+                                    v_uint32x4* vsum )
+{
+    const v_uint32x4 vstep = v_setall_u32(4);
+    v_uint32x4 vx = v_uint32x4((unsigned)x, (unsigned)x + 1, (unsigned)x + 2, (unsigned)x + 3);
+    v_uint32x4 vy = v_setall_u32((unsigned)y);
+
+    for( ; x + 15 <= maxx; x += 16, ptr += 48 )
+    {
+        v_uint8x16 t[3];
+        v_load_deinterleave(ptr, t[0], t[1], t[2]);
+        v_uint16x8 d[2], t16[3][2];
+        v_uint32x4 dist[4], t32[3][4];
+
+        v_mul_expand(v_absdiff(t[0], c0), v_absdiff(t[0], c0), d[0], d[1]);
+        v_expand(d[0], dist[0], dist[1]); v_expand(d[1], dist[2], dist[3]);
+        v_mul_expand(v_absdiff(t[1], c1), v_absdiff(t[1], c1), d[0], d[1]);
+        for( int k = 0; k < 2; k++ )
+        {
+            v_uint32x4 a, b;
+            v_expand(d[k], a, b);
+            dist[k*2] += a; dist[k*2+1] += b;
+        }
+        v_mul_expand(v_absdiff(t[2], c2), v_absdiff(t[2], c2), d[0], d[1]);
+        for( int k = 0; k < 2; k++ )
+        {
+            v_uint32x4 a, b;
+            v_expand(d[k], a, b);
+            dist[k*2] += a; dist[k*2+1] += b;
+        }
+
+        for( int c = 0; c < 3; c++ )
+        {
+            v_expand(t[c], t16[c][0], t16[c][1]);
+            v_expand(t16[c][0], t32[c][0], t32[c][1]);
+            v_expand(t16[c][1], t32[c][2], t32[c][3]);
+        }
+
+        for( int k = 0; k < 4; k++, vx += vstep )
+        {
+            v_uint32x4 m = dist[k] <= visr2;
+            vsum[0] += t32[0][k] & m;
+            vsum[1] += t32[1][k] & m;
+            vsum[2] += t32[2][k] & m;
+            vsum[3] += vx & m;
+            vsum[4] += vy & m;
+            vsum[5] -= m;
+        }
+    }
+    return x;
+}
+#endif
+
+// runs the mean shift procedure for the pixels of a pyramid level; the pixels are independent of
+// each other, so the rows are processed in parallel
+class MeanShiftFilterInvoker : public ParallelLoopBody
+{
+public:
+    MeanShiftFilterInvoker(const Mat& _src, Mat& _dst, const Mat& _mask, float _sp, int _isr2,
+                           const int* _tab, const TermCriteria& _termcrit) :
+        src(_src), dst(_dst), mask(_mask), sp(_sp), isr2(_isr2), tab(_tab), termcrit(_termcrit) {}
+
+    virtual void operator() (const Range& range) const CV_OVERRIDE
+    {
+        Size size = src.size();
+        int sstep = (int)src.step;
+#if CV_SIMD128
+        v_uint32x4 visr2 = v_setall_u32((unsigned)isr2);
+#endif
+
+        for( int i = range.start; i < range.end; i++ )
+        {
+            const uchar* sptr = src.ptr(i);
+            uchar* dptr = dst.ptr(i);
+            const uchar* mrow = mask.empty() ? NULL : mask.ptr(i);
+            for( int j = 0; j < size.width; j++, sptr += 3, dptr += 3 )
+            {
+                int x0 = j, y0 = i, x1, y1, iter;
+                int c0, c1, c2;
+
+                if( mrow && !mrow[j] )
+                    continue;
+
+                c0 = sptr[0], c1 = sptr[1], c2 = sptr[2];
+
+                // iterate meanshift procedure
+                for( iter = 0; iter < termcrit.maxCount; iter++ )
+                {
+                    const uchar* ptr;
+                    int x, y, count = 0;
+                    int minx, miny, maxx, maxy;
+                    int s0 = 0, s1 = 0, s2 = 0, sx = 0, sy = 0;
+                    double icount;
+                    int stop_flag;
+
+                    //mean shift: process pixels in window (p-sigmaSp)x(p+sigmaSp)
+                    minx = cvRound(x0 - sp); minx = MAX(minx, 0);
+                    miny = cvRound(y0 - sp); miny = MAX(miny, 0);
+                    maxx = cvRound(x0 + sp); maxx = MIN(maxx, size.width-1);
+                    maxy = cvRound(y0 + sp); maxy = MIN(maxy, size.height-1);
+                    ptr = sptr + (miny - i)*sstep + (minx - j)*3;
+
+#if CV_SIMD128
+                    v_uint32x4 vsum[6];
+                    bool simdRows = maxx - minx + 1 >= 16;
+                    if( simdRows )
+                    {
+                        for( int k = 0; k < 6; k++ )
+                            vsum[k] = v_setzero_u32();
+                    }
+                    v_uint8x16 vc0 = v_setall_u8((uchar)c0), vc1 = v_setall_u8((uchar)c1), vc2 = v_setall_u8((uchar)c2);
+#endif
+
+                    for( y = miny; y <= maxy; y++, ptr += sstep )
+                    {
+                        const uchar* rptr = ptr;
+                        int row_count = 0;
+                        x = minx;
+#if CV_SIMD128
+                        if( simdRows )
+                        {
+                            int x2 = meanShiftRowSIMD(rptr, x, maxx, y, vc0, vc1, vc2, visr2, vsum);
+                            rptr += (x2 - x)*3;
+                            x = x2;
+                        }
+#endif
+                        for( ; x <= maxx; x++, rptr += 3 )
+                        {
+                            int t0 = rptr[0], t1 = rptr[1], t2 = rptr[2];
+                            if( tab[t0-c0+255] + tab[t1-c1+255] + tab[t2-c2+255] <= isr2 )
+                            {
+                                s0 += t0; s1 += t1; s2 += t2;
+                                sx += x; row_count++;
+                            }
+                        }
+                        count += row_count;
+                        sy += y*row_count;
+                    }
+
+#if CV_SIMD128
+                    if( simdRows )
+                    {
+                        s0 += (int)v_reduce_sum(vsum[0]);
+                        s1 += (int)v_reduce_sum(vsum[1]);
+                        s2 += (int)v_reduce_sum(vsum[2]);
+                        sx += (int)v_reduce_sum(vsum[3]);
+                        sy += (int)v_reduce_sum(vsum[4]);
+                        count += (int)v_reduce_sum(vsum[5]);
+                    }
+#endif
+
+                    if( count == 0 )
+                        break;
+
+                    icount = 1./count;
+                    x1 = cvRound(sx*icount);
+                    y1 = cvRound(sy*icount);
+                    s0 = cvRound(s0*icount);
+                    s1 = cvRound(s1*icount);
+                    s2 = cvRound(s2*icount);
+
+                    stop_flag = (x0 == x1 && y0 == y1) || std::abs(x1-x0) + std::abs(y1-y0) +
+                        tab[s0 - c0 + 255] + tab[s1 - c1 + 255] +
+                        tab[s2 - c2 + 255] <= termcrit.epsilon;
+
+                    x0 = x1; y0 = y1;
+                    c0 = s0; c1 = s1; c2 = s2;
+
+                    if( stop_flag )
+                        break;
+                }
+
+                dptr[0] = (uchar)c0;
+                dptr[1] = (uchar)c1;
+                dptr[2] = (uchar)c2;
+            }
+        }
+    }
+
+private:
+    const Mat& src;
+    Mat& dst;
+    const Mat& mask;
+    float sp;
+    int isr2;
+    const int* tab;
+    TermCriteria termcrit;
+};
+
+}
+
 void cv::pyrMeanShiftFiltering( InputArray _src, OutputArray _dst,
                                 double sp0, double sr, int max_level,
                                 TermCriteria termcrit )
@@ -405,8 +603,6 @@ void cv::pyrMeanShiftFiltering( InputArray _src, OutputArray _dst,
     {
         cv::Mat src = src_pyramid[level];
         cv::Size size = src.size();
-        const uchar* sptr = src.ptr();
-        int sstep = (int)src.step;
         uchar* dptr;
         int dstep;
         float sp = (float)(sp0 / (1 << level));
@@ -437,117 +633,12 @@ void cv::pyrMeanShiftFiltering( InputArray _src, OutputArray _dst,
             cv::dilate( m, m, cv::Mat() );
         }
 
-        dptr = dst_pyramid[level].ptr();
-        dstep = (int)dst_pyramid[level].step;
-
-        for( i = 0; i < size.height; i++, sptr += sstep - size.width*3,
-                                          dptr += dstep - size.width*3
-        )
-        {
-            uchar* mask = m.empty() ? NULL : m.ptr(i);
-            for( j = 0; j < size.width; j++, sptr += 3, dptr += 3 )
-            {
-                int x0 = j, y0 = i, x1, y1, iter;
-                int c0, c1, c2;
-
-                if( mask && !mask[j] )
-                    continue;
-
-                c0 = sptr[0], c1 = sptr[1], c2 = sptr[2];
-
-                // iterate meanshift procedure
-                for( iter = 0; iter < termcrit.maxCount; iter++ )
-                {
-                    const uchar* ptr;
-                    int x, y, count = 0;
-                    int minx, miny, maxx, maxy;
-                    int s0 = 0, s1 = 0, s2 = 0, sx = 0, sy = 0;
-                    double icount;
-                    int stop_flag;
-
-                    //mean shift: process pixels in window (p-sigmaSp)x(p+sigmaSp)
-                    minx = cvRound(x0 - sp); minx = MAX(minx, 0);
-                    miny = cvRound(y0 - sp); miny = MAX(miny, 0);
-                    maxx = cvRound(x0 + sp); maxx = MIN(maxx, size.width-1);
-                    maxy = cvRound(y0 + sp); maxy = MIN(maxy, size.height-1);
-                    ptr = sptr + (miny - i)*sstep + (minx - j)*3;
-
-                    for( y = miny; y <= maxy; y++, ptr += sstep - (maxx-minx+1)*3 )
-                    {
-                        int row_count = 0;
-                        x = minx;
-                        #if CV_ENABLE_UNROLLED
-                        for( ; x + 3 <= maxx; x += 4, ptr += 12 )
-                        {
-                            int t0 = ptr[0], t1 = ptr[1], t2 = ptr[2];
-                            if( tab[t0-c0+255] + tab[t1-c1+255] + tab[t2-c2+255] <= isr2 )
-                            {
-                                s0 += t0; s1 += t1; s2 += t2;
-                                sx += x; row_count++;
-                            }
-                            t0 = ptr[3], t1 = ptr[4], t2 = ptr[5];
-                            if( tab[t0-c0+255] + tab[t1-c1+255] + tab[t2-c2+255] <= isr2 )
-                            {
-                                s0 += t0; s1 += t1; s2 += t2;
-                                sx += x+1; row_count++;
-                            }
-                            t0 = ptr[6], t1 = ptr[7], t2 = ptr[8];
-                            if( tab[t0-c0+255] + tab[t1-c1+255] + tab[t2-c2+255] <= isr2 )
-                            {
-                                s0 += t0; s1 += t1; s2 += t2;
-                                sx += x+2; row_count++;
-                            }
-                            t0 = ptr[9], t1 = ptr[10], t2 = ptr[11];
-                            if( tab[t0-c0+255] + tab[t1-c1+255] + tab[t2-c2+255] <= isr2 )
-                            {
-                                s0 += t0; s1 += t1; s2 += t2;
-                                sx += x+3; row_count++;
-                            }
-                        }
-                        #endif
-                        for( ; x <= maxx; x++, ptr += 3 )
-                        {
-                            int t0 = ptr[0], t1 = ptr[1], t2 = ptr[2];
-                            if( tab[t0-c0+255] + tab[t1-c1+255] + tab[t2-c2+255] <= isr2 )
-                            {
-                                s0 += t0; s1 += t1; s2 += t2;
-                                sx += x; row_count++;
-                            }
-                        }
-                        count += row_count;
-                        sy += y*row_count;
-                    }
-
-                    if( count == 0 )
-                        break;
-
-                    icount = 1./count;
-                    x1 = cvRound(sx*icount);
-                    y1 = cvRound(sy*icount);
-                    s0 = cvRound(s0*icount);
-                    s1 = cvRound(s1*icount);
-                    s2 = cvRound(s2*icount);
-
-                    stop_flag = (x0 == x1 && y0 == y1) || std::abs(x1-x0) + std::abs(y1-y0) +
-                        tab[s0 - c0 + 255] + tab[s1 - c1 + 255] +
-                        tab[s2 - c2 + 255] <= termcrit.epsilon;
-
-                    x0 = x1; y0 = y1;
-                    c0 = s0; c1 = s1; c2 = s2;
-
-                    if( stop_flag )
-                        break;
-                }
-
-                dptr[0] = (uchar)c0;
-                dptr[1] = (uchar)c1;
-                dptr[2] = (uchar)c2;
-            }
-        }
+        Mat dst = dst_pyramid[level];
+        parallel_for_(Range(0, size.height), MeanShiftFilterInvoker(src, dst, m, sp, isr2, tab, termcrit),
+                      size.area()/(double)(1<<14));
     }
 }
 
-
 ///////////////////////////////////////////////////////////////////////////////////////////////
 
 CV_IMPL void cvWatershed( const CvArr* _src, CvArr* _markers )
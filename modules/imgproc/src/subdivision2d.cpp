@@ -481,12 +481,150 @@ int Subdiv2D::insert(Point2f pt)
     return curr_point;
 }
 
+// position of a point along the Hilbert curve filling a 2^16 x 2^16 grid
+static uint64 hilbertIndex( unsigned x, unsigned y )
+{
+    const unsigned n = 1u << 16;
+    uint64 d = 0;
+
+    for( unsigned s = n/2; s > 0; s /= 2 )
+    {
+        unsigned rx = (x & s) != 0, ry = (y & s) != 0;
+        d += (uint64)s * s * ((3 * rx) ^ ry);
+
+        // rotate the quadrant so that the curve is continuous
+        if( ry == 0 )
+        {
+            if( rx == 1 )
+            {
+                x = n - 1 - x;
+                y = n - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return d;
+}
+
+struct HilbertIndexLess
+{
+    HilbertIndexLess(const std::vector<uint64>& _keys) : keys(&_keys) {}
+    bool operator()(int a, int b) const { return (*keys)[a] < (*keys)[b]; }
+    const std::vector<uint64>* keys;
+};
+
+// the smallest round of the randomized insertion order
+static const int BRIO_MIN_ROUND = 64;
+
+// Biased randomized insertion order: the points are shuffled and split into rounds of doubling size,
+// the points of every round are sorted along the Hilbert curve. Consecutive points are close to each
+// other, so the point location started from the recently inserted edge takes few steps, while the
+// random rounds keep the expected number of edge flips linear.
+static void brioOrder( const std::vector<Point2f>& ptvec, Point2f topLeft, Point2f bottomRight,
+                       std::vector<int>& order )
+{
+    int i, n = (int)ptvec.size();
+    order.resize(n);
+    for( i = 0; i < n; i++ )
+        order[i] = i;
+
+    RNG rng((uint64)-1);
+    for( i = n - 1; i > 0; i-- )
+        std::swap(order[i], order[rng.uniform(0, i + 1)]);
+
+    double sx = 65535. / std::max(bottomRight.x - topLeft.x, FLT_EPSILON);
+    double sy = 65535. / std::max(bottomRight.y - topLeft.y, FLT_EPSILON);
+    std::vector<uint64> keys(n);
+    for( i = 0; i < n; i++ )
+    {
+        int x = cvRound((ptvec[i].x - topLeft.x) * sx), y = cvRound((ptvec[i].y - topLeft.y) * sy);
+        keys[i] = hilbertIndex((unsigned)std::min(std::max(x, 0), 65535), (unsigned)std::min(std::max(y, 0), 65535));
+    }
+
+    for( int end = n; end > 0; )
+    {
+        int start = end / 2 < BRIO_MIN_ROUND ? 0 : end / 2;
+        std::sort(order.begin() + start, order.begin() + end, HilbertIndexLess(keys));
+        end = start;
+    }
+}
+
 void Subdiv2D::insert(const std::vector<Point2f>& ptvec)
 {
     CV_INSTRUMENT_REGION();
 
-    for( size_t i = 0; i < ptvec.size(); i++ )
-        insert(ptvec[i]);
+    int i, n = (int)ptvec.size();
+    if( n < BRIO_MIN_ROUND*2 )
+    {
+        for( i = 0; i < n; i++ )
+            insert(ptvec[i]);
+        return;
+    }
+
+    for( i = 0; i < n; i++ )
+    {
+        Point2f pt = ptvec[i];
+        if( pt.x < topLeft.x || pt.y < topLeft.y || pt.x >= bottomRight.x || pt.y >= bottomRight.y )
+            CV_Error( CV_StsOutOfRange, "" );
+    }
+
+    std::vector<int> order;
+    brioOrder(ptvec, topLeft, bottomRight, order);
+
+    size_t nvtx0 = vtx.size();
+    std::vector<uchar> existed(nvtx0);
+    for( size_t j = 0; j < nvtx0; j++ )
+        existed[j] = !vtx[j].isfree();
+
+    // the vertices created here, in the order of creation, and the smallest index
+    // of the input points coinciding with each of them
+    std::vector<int> created, firstIndex;
+    created.reserve(n);
+
+    for( i = 0; i < n; i++ )
+    {
+        int k = order[i];
+        int v = insert(ptvec[k]);
+        if( (size_t)v < nvtx0 && existed[v] )
+            continue;
+        if( (size_t)v >= firstIndex.size() )
+            firstIndex.resize(std::max((size_t)v + 1, vtx.size()), -1);
+        if( firstIndex[v] < 0 )
+        {
+            created.push_back(v);
+            firstIndex[v] = k;
+        }
+        else
+            firstIndex[v] = std::min(firstIndex[v], k);
+    }
+
+    // Renumber the created vertices as if the points were inserted one by one in the input order:
+    // the same IDs are taken from the free list, so only their assignment to the points differs.
+    std::vector<std::pair<int, int> > byInput(created.size());
+    for( size_t j = 0; j < created.size(); j++ )
+        byInput[j] = std::make_pair(firstIndex[created[j]], created[j]);
+    std::sort(byInput.begin(), byInput.end());
+
+    std::vector<int> remap(vtx.size());
+    for( size_t j = 0; j < remap.size(); j++ )
+        remap[j] = (int)j;
+    std::vector<Vertex> newVtx(created.size());
+    for( size_t j = 0; j < created.size(); j++ )
+    {
+        remap[byInput[j].second] = created[j];
+        newVtx[j] = vtx[byInput[j].second];
+    }
+    for( size_t j = 0; j < created.size(); j++ )
+        vtx[created[j]] = newVtx[j];
+
+    for( size_t j = 0; j < qedges.size(); j++ )
+    {
+        QuadEdge& qe = qedges[j];
+        if( qe.isfree() )
+            continue;
+        qe.pt[0] = remap[qe.pt[0]];
+        qe.pt[2] = remap[qe.pt[2]];
+    }
 }
 
 void Subdiv2D::initDelaunay( Rect rect )
@@ -737,18 +875,19 @@ void Subdiv2D::getLeadingEdgeList(std::vector<int>& leadingEdgeList) const
 {
     leadingEdgeList.clear();
     int i, total = (int)(qedges.size()*4);
-    std::vector<bool> edgemask(total, false);
+    std::vector<uchar> edgemask(total, (uchar)0);
+    leadingEdgeList.reserve(qedges.size()*2/3 + 1);
 
     for( i = 4; i < total; i += 2 )
     {
         if( edgemask[i] )
             continue;
         int edge = i;
-        edgemask[edge] = true;
+        edgemask[edge] = 1;
         edge = getEdge(edge, NEXT_AROUND_LEFT);
-        edgemask[edge] = true;
+        edgemask[edge] = 1;
         edge = getEdge(edge, NEXT_AROUND_LEFT);
-        edgemask[edge] = true;
+        edgemask[edge] = 1;
         leadingEdgeList.push_back(i);
     }
 }
@@ -757,7 +896,10 @@ void Subdiv2D::getTriangleList(std::vector<Vec6f>& triangleList) const
 {
     triangleList.clear();
     int i, total = (int)(qedges.size()*4);
-    std::vector<bool> edgemask(total, false);
+    // every edge is visited once, a byte mask is faster to update than the packed bits
+    std::vector<uchar> edgemask(total, (uchar)0);
+    // a triangulation with E edges has about 2E/3 triangles
+    triangleList.reserve(qedges.size()*2/3 + 1);
     const bool filterPoints = true;
     Rect2f rect(topLeft.x, topLeft.y, bottomRight.x - topLeft.x, bottomRight.y - topLeft.y);
 
@@ -778,9 +920,9 @@ void Subdiv2D::getTriangleList(std::vector<Vec6f>& triangleList) const
         edgeOrg(edge_c, &c);
         if (filterPoints && !rect.contains(c))
             continue;
-        edgemask[edge_a] = true;
-        edgemask[edge_b] = true;
-        edgemask[edge_c] = true;
+        edgemask[edge_a] = 1;
+        edgemask[edge_b] = 1;
+        edgemask[edge_c] = 1;
         triangleList.push_back(Vec6f(a.x, a.y, b.x, b.y, c.x, c.y));
     }
 }
@@ -790,17 +932,18 @@ void Subdiv2D::getVoronoiFacetList(const std::vector<int>& idx,
                                    CV_OUT std::vector<Point2f>& facetCenters)
 {
     calcVoronoi();
-    facetList.clear();
     facetCenters.clear();
 
-    std::vector<Point2f> buf;
-
-    size_t i, total;
+    size_t i, total, nfacets = 0;
     if( idx.empty() )
         i = 4, total = vtx.size();
     else
         i = 0, total = idx.size();
 
+    // the facets are filled in place, so the storage of the previous calls is reused
+    facetList.resize(std::max(facetList.size(), total - i));
+    facetCenters.reserve(total - i);
+
     for( ; i < total; i++ )
     {
         int k = idx.empty() ? (int)i : idx[i];
@@ -810,17 +953,19 @@ void Subdiv2D::getVoronoiFacetList(const std::vector<int>& idx,
         int edge = rotateEdge(vtx[k].firstEdge, 1), t = edge;
 
         // gather points
-        buf.clear();
+        std::vector<Point2f>& facet = facetList[nfacets++];
+        facet.clear();
         do
         {
-            buf.push_back(vtx[edgeOrg(t)].pt);
+            facet.push_back(vtx[edgeOrg(t)].pt);
             t = getEdge( t, NEXT_AROUND_LEFT );
         }
         while( t != edge );
 
-        facetList.push_back(buf);
         facetCenters.push_back(vtx[k].pt);
     }
+
+    facetList.resize(nfacets);
 }
 
 
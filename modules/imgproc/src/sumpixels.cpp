@@ -46,6 +46,9 @@
 #include "opencv2/core/hal/intrin.hpp"
 #include "sumpixels.hpp"
 
+#include "sumpixels.simd.hpp"
+#include "sumpixels.simd_declarations.hpp" // defines CV_CPU_DISPATCH_MODES_ALL=AVX2,...,BASELINE based on CMakeLists.txt content
+
 namespace cv
 {
 
@@ -402,6 +405,210 @@ void integral_( const T* src, size_t _srcstep, ST* sum, size_t _sumstep,
 }
 
 
+static void integralRowPrefix(int depth, int sdepth, int sqdepth,
+                              const uchar* src, size_t srcstep,
+                              uchar* sum, size_t sumstep,
+                              uchar* sqsum, size_t sqsumstep,
+                              int width, int cn, const Range& rows)
+{
+    CV_CPU_DISPATCH(integralRowPrefix, (depth, sdepth, sqdepth, src, srcstep, sum, sumstep, sqsum, sqsumstep, width, cn, rows),
+        CV_CPU_DISPATCH_MODES_ALL);
+}
+
+static void integralColumnSum(int sdepth, int sqdepth,
+                              uchar* sum, size_t sumstep,
+                              uchar* sqsum, size_t sqsumstep,
+                              int height, const Range& cols)
+{
+    CV_CPU_DISPATCH(integralColumnSum, (sdepth, sqdepth, sum, sumstep, sqsum, sqsumstep, height, cols),
+        CV_CPU_DISPATCH_MODES_ALL);
+}
+
+static void integralTiltedDiagonals(int depth, int sdepth,
+                                    const uchar* src, size_t srcstep,
+                                    uchar* diag, size_t diagstep,
+                                    int width, int height, int cn, int band, const Range& bands)
+{
+    CV_CPU_DISPATCH(integralTiltedDiagonals, (depth, sdepth, src, srcstep, diag, diagstep, width, height, cn, band, bands),
+        CV_CPU_DISPATCH_MODES_ALL);
+}
+
+static void integralTiltedBorders(int depth, int sdepth,
+                                  const uchar* src, size_t srcstep,
+                                  const uchar* diag, size_t diagstep,
+                                  uchar* tilted, size_t tiltedstep,
+                                  int width, int height, int cn)
+{
+    CV_CPU_DISPATCH(integralTiltedBorders, (depth, sdepth, src, srcstep, diag, diagstep, tilted, tiltedstep, width, height, cn),
+        CV_CPU_DISPATCH_MODES_ALL);
+}
+
+static void integralTiltedSums(int depth, int sdepth,
+                               const uchar* src, size_t srcstep,
+                               const uchar* diag, size_t diagstep,
+                               uchar* tilted, size_t tiltedstep,
+                               int width, int height, int cn, int band, const Range& bands)
+{
+    CV_CPU_DISPATCH(integralTiltedSums, (depth, sdepth, src, srcstep, diag, diagstep, tilted, tiltedstep, width, height, cn, band, bands),
+        CV_CPU_DISPATCH_MODES_ALL);
+}
+
+class IntegralRowPrefixInvoker : public ParallelLoopBody
+{
+public:
+    IntegralRowPrefixInvoker(int _depth, int _sdepth, int _sqdepth,
+                             const uchar* _src, size_t _srcstep,
+                             uchar* _sum, size_t _sumstep,
+                             uchar* _sqsum, size_t _sqsumstep,
+                             int _width, int _cn) :
+        depth(_depth), sdepth(_sdepth), sqdepth(_sqdepth), src(_src), srcstep(_srcstep),
+        sum(_sum), sumstep(_sumstep), sqsum(_sqsum), sqsumstep(_sqsumstep), width(_width), cn(_cn)
+    {
+    }
+
+    virtual void operator() (const Range& range) const CV_OVERRIDE
+    {
+        integralRowPrefix(depth, sdepth, sqdepth, src, srcstep, sum, sumstep, sqsum, sqsumstep, width, cn, range);
+    }
+
+private:
+    int depth, sdepth, sqdepth;
+    const uchar* src;
+    size_t srcstep;
+    uchar* sum;
+    size_t sumstep;
+    uchar* sqsum;
+    size_t sqsumstep;
+    int width, cn;
+};
+
+// the range is measured in blocks of `block` columns
+class IntegralColumnSumInvoker : public ParallelLoopBody
+{
+public:
+    IntegralColumnSumInvoker(int _sdepth, int _sqdepth,
+                             uchar* _sum, size_t _sumstep,
+                             uchar* _sqsum, size_t _sqsumstep,
+                             int _width, int _height, int _block) :
+        sdepth(_sdepth), sqdepth(_sqdepth), sum(_sum), sumstep(_sumstep),
+        sqsum(_sqsum), sqsumstep(_sqsumstep), width(_width), height(_height), block(_block)
+    {
+    }
+
+    virtual void operator() (const Range& range) const CV_OVERRIDE
+    {
+        Range cols(range.start*block, std::min(range.end*block, width));
+        integralColumnSum(sdepth, sqdepth, sum, sumstep, sqsum, sqsumstep, height, cols);
+    }
+
+private:
+    int sdepth, sqdepth;
+    uchar* sum;
+    size_t sumstep;
+    uchar* sqsum;
+    size_t sqsumstep;
+    int width, height, block;
+};
+
+// the range is measured in bands of `band` diagonals
+class IntegralTiltedInvoker : public ParallelLoopBody
+{
+public:
+    IntegralTiltedInvoker(bool _diagonals, int _depth, int _sdepth,
+                          const uchar* _src, size_t _srcstep,
+                          uchar* _diag, size_t _diagstep,
+                          uchar* _tilted, size_t _tiltedstep,
+                          int _width, int _height, int _cn, int _band) :
+        diagonals(_diagonals), depth(_depth), sdepth(_sdepth), src(_src), srcstep(_srcstep),
+        diag(_diag), diagstep(_diagstep), tilted(_tilted), tiltedstep(_tiltedstep),
+        width(_width), height(_height), cn(_cn), band(_band)
+    {
+    }
+
+    virtual void operator() (const Range& range) const CV_OVERRIDE
+    {
+        if( diagonals )
+            integralTiltedDiagonals(depth, sdepth, src, srcstep, diag, diagstep, width, height, cn, band, range);
+        else
+            integralTiltedSums(depth, sdepth, src, srcstep, diag, diagstep, tilted, tiltedstep, width, height, cn, band, range);
+    }
+
+private:
+    bool diagonals;
+    int depth, sdepth;
+    const uchar* src;
+    size_t srcstep;
+    uchar* diag;
+    size_t diagstep;
+    uchar* tilted;
+    size_t tiltedstep;
+    int width, height, cn, band;
+};
+
+static bool integral_parallel(int depth, int sdepth, int sqdepth,
+                              const uchar* src, size_t srcstep,
+                              uchar* sum, size_t sumstep,
+                              uchar* sqsum, size_t sqsumstep,
+                              uchar* tilted, size_t tiltedstep, int width, int height, int cn)
+{
+    // for small images the second pass over the sums costs more than the threads save
+    if( (double)width*height*cn < (double)(1 << 18) || getNumThreads() <= 1 ||
+        (tilted && (width < 2 || height < 2)) )
+        return false;
+
+    static const int supported[][3] =
+    {
+        { CV_8U, CV_32S, CV_64F }, { CV_8U, CV_32S, CV_32F }, { CV_8U, CV_32S, CV_32S },
+        { CV_8U, CV_32F, CV_64F }, { CV_8U, CV_32F, CV_32F }, { CV_8U, CV_64F, CV_64F },
+        { CV_16U, CV_64F, CV_64F }, { CV_16S, CV_64F, CV_64F }, { CV_32F, CV_32F, CV_64F },
+        { CV_32F, CV_32F, CV_32F }, { CV_32F, CV_64F, CV_64F }, { CV_64F, CV_64F, CV_64F }
+    };
+    bool found = false;
+    for( size_t i = 0; i < sizeof(supported)/sizeof(supported[0]) && !found; i++ )
+        found = supported[i][0] == depth && supported[i][1] == sdepth && supported[i][2] == sqdepth;
+    if( !found )
+        return false;
+
+    CV_INSTRUMENT_REGION();
+
+    size_t selem = CV_ELEM_SIZE1(sdepth), sqelem = CV_ELEM_SIZE1(sqdepth);
+    memset(sum, 0, (width + 1)*cn*selem);
+    if( sqsum )
+        memset(sqsum, 0, (width + 1)*cn*sqelem);
+
+    // 1. horizontal prefix sums, the rows are independent
+    parallel_for_(Range(0, height),
+                  IntegralRowPrefixInvoker(depth, sdepth, sqdepth, src, srcstep, sum, sumstep, sqsum, sqsumstep, width, cn));
+
+    // 2. vertical accumulation in blocks of columns; the first column is zero
+    const int block = 256;
+    int ncols = (width + 1)*cn;
+    parallel_for_(Range(0, (ncols + block - 1)/block),
+                  IntegralColumnSumInvoker(sdepth, sqdepth, sum, sumstep, sqsum, sqsumstep, ncols, height + 1, block));
+
+    if( tilted )
+    {
+        // every tilted sum depends on the previous row through its neighbours, but only along
+        // the diagonals, so both passes go as wavefronts over bands of diagonals
+        const int band = 128;
+        Mat diag(height - 1, width*cn, CV_MAKETYPE(sdepth, 1));
+
+        // 3. sums along the up-right diagonals of the source
+        int ndiags = width + height - 2;
+        parallel_for_(Range(0, (ndiags + band - 1)/band),
+                      IntegralTiltedInvoker(true, depth, sdepth, src, srcstep, diag.data, diag.step,
+                                            tilted, tiltedstep, width, height, cn, band));
+
+        // 4. the first two rows and columns, then the rest along the up-left diagonals
+        integralTiltedBorders(depth, sdepth, src, srcstep, diag.data, diag.step, tilted, tiltedstep, width, height, cn);
+        ndiags = width + height - 3;
+        parallel_for_(Range(0, (ndiags + band - 1)/band),
+                      IntegralTiltedInvoker(false, depth, sdepth, src, srcstep, diag.data, diag.step,
+                                            tilted, tiltedstep, width, height, cn, band));
+    }
+    return true;
+}
+
 #ifdef HAVE_OPENCL
 
 static bool ocl_integral( InputArray _src, OutputArray _sum, int sdepth )
@@ -552,6 +759,9 @@ void integral(int depth, int sdepth, int sqdepth,
     CALL_HAL(integral, cv_hal_integral, depth, sdepth, sqdepth, src, srcstep, sum, sumstep, sqsum, sqsumstep, tilted, tstep, width, height, cn);
     CV_IPP_RUN_FAST(ipp_integral(depth, sdepth, sqdepth, src, srcstep, sum, sumstep, sqsum, sqsumstep, tilted, tstep, width, height, cn));
 
+    if( integral_parallel(depth, sdepth, sqdepth, src, srcstep, sum, sumstep, sqsum, sqsumstep, tilted, tstep, width, height, cn) )
+        return;
+
 #define ONE_CALL(A, B, C) integral_<A, B, C>((const A*)src, srcstep, (B*)sum, sumstep, (C*)sqsum, sqsumstep, (B*)tilted, tstep, width, height, cn)
 
     if( depth == CV_8U && sdepth == CV_32S && sqdepth == CV_64F )
@@ -0,0 +1,542 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "opencv2/core/hal/intrin.hpp"
+
+namespace cv {
+CV_CPU_OPTIMIZATION_NAMESPACE_BEGIN
+// forward declarations
+
+// Computes the horizontal prefix sums of the source rows [rows.start, rows.end) and stores them
+// into the rows [rows.start + 1, rows.end + 1) of sum and sqsum (sqsum may be NULL),
+// including the leading zero column.
+void integralRowPrefix(int depth, int sdepth, int sqdepth,
+                       const uchar* src, size_t srcstep,
+                       uchar* sum, size_t sumstep,
+                       uchar* sqsum, size_t sqsumstep,
+                       int width, int cn, const Range& rows);
+
+// Accumulates the row prefix sums vertically in the columns [cols.start, cols.end) (in elements)
+// of the first height rows of sum and sqsum, turning them into the integral images.
+void integralColumnSum(int sdepth, int sqdepth,
+                       uchar* sum, size_t sumstep,
+                       uchar* sqsum, size_t sqsumstep,
+                       int height, const Range& cols);
+
+// The tilted sums of integral_() are computed in three steps which do the same additions:
+// the sums along the up-right diagonals of the source (the row buffer of integral_()),
+// the first two columns and the first two rows of tilted, and the rest of tilted,
+// which is accumulated along the up-left diagonals.
+
+// Computes the rows [0, height - 1) of diag on the bands of `band` up-right diagonals
+// (x + y = const) given by the range.
+void integralTiltedDiagonals(int depth, int sdepth,
+                             const uchar* src, size_t srcstep,
+                             uchar* diag, size_t diagstep,
+                             int width, int height, int cn, int band, const Range& bands);
+
+void integralTiltedBorders(int depth, int sdepth,
+                           const uchar* src, size_t srcstep,
+                           const uchar* diag, size_t diagstep,
+                           uchar* tilted, size_t tiltedstep,
+                           int width, int height, int cn);
+
+// Computes the sums of the source pixels (y, x), y >= 1, x >= 1, on the bands of `band` up-left
+// diagonals (x - y = const, starting from 2 - height) given by the range.
+void integralTiltedSums(int depth, int sdepth,
+                        const uchar* src, size_t srcstep,
+                        const uchar* diag, size_t diagstep,
+                        uchar* tilted, size_t tiltedstep,
+                        int width, int height, int cn, int band, const Range& bands);
+
+#ifndef CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
+
+namespace {
+
+template <typename T, typename ST, typename QT>
+struct IntegralRow_SIMD
+{
+    // returns the number of processed pixels of a single channel row
+    int operator()(const T*, ST*, QT*, int) const
+    {
+        return 0;
+    }
+};
+
+#if CV_SIMD
+
+// prefix sums of v_uint16::nlanes consecutive pixels, the same scheme as in Integral_SIMD<uchar, int, double>
+static inline void v_prefix_sum(const uchar* src, v_int32& lo, v_int32& hi)
+{
+    v_int16 el8 = v_reinterpret_as_s16(vx_load_expand(src));
+    el8 += v_rotate_left<1>(el8);
+    el8 += v_rotate_left<2>(el8);
+#if CV_SIMD_WIDTH >= 32
+    el8 += v_rotate_left<4>(el8);
+#if CV_SIMD_WIDTH == 64
+    el8 += v_rotate_left<8>(el8);
+#endif
+#endif
+    v_expand(el8, lo, hi);
+    hi += lo;
+}
+
+static inline v_int32 v_prefix_sum(const v_int32& a)
+{
+    v_int32 s = a + v_rotate_left<1>(a);
+    s += v_rotate_left<2>(s);
+#if CV_SIMD_WIDTH >= 32
+    s += v_rotate_left<4>(s);
+#if CV_SIMD_WIDTH == 64
+    s += v_rotate_left<8>(s);
+#endif
+#endif
+    return s;
+}
+
+template <typename QT>
+struct IntegralRow_SIMD<uchar, int, QT>
+{
+    int operator()(const uchar* src, int* sum, QT* sqsum, int width) const
+    {
+        if (sqsum)
+            return 0;
+
+        v_int32 prev = vx_setzero_s32();
+        int x = 0;
+        for (; x <= width - v_uint16::nlanes; x += v_uint16::nlanes)
+        {
+            v_int32 lo, hi;
+            v_prefix_sum(src + x, lo, hi);
+            lo += prev;
+            hi += prev;
+            prev = v_broadcast_element<v_int32::nlanes - 1>(hi);
+            v_store(sum + x, lo);
+            v_store(sum + x + v_int32::nlanes, hi);
+        }
+        vx_cleanup();
+        return x;
+    }
+};
+
+template <typename QT>
+struct IntegralRow_SIMD<uchar, float, QT>
+{
+    int operator()(const uchar* src, float* sum, QT* sqsum, int width) const
+    {
+        // the row sums are exact in int32 and converted to float as the scalar code would round them
+        if (sqsum || width >= (1 << 16))
+            return 0;
+
+        v_int32 prev = vx_setzero_s32();
+        int x = 0;
+        for (; x <= width - v_uint16::nlanes; x += v_uint16::nlanes)
+        {
+            v_int32 lo, hi;
+            v_prefix_sum(src + x, lo, hi);
+            lo += prev;
+            hi += prev;
+            prev = v_broadcast_element<v_int32::nlanes - 1>(hi);
+            v_store(sum + x, v_cvt_f32(lo));
+            v_store(sum + x + v_float32::nlanes, v_cvt_f32(hi));
+        }
+        vx_cleanup();
+        return x;
+    }
+};
+
+#if CV_SIMD_64F
+template <>
+struct IntegralRow_SIMD<uchar, double, double>
+{
+    int operator()(const uchar* src, double* sum, double* sqsum, int width) const
+    {
+        v_float64 prev = vx_setzero_f64(), prevsq = vx_setzero_f64();
+        int x = 0;
+        for (; x <= width - v_uint16::nlanes; x += v_uint16::nlanes)
+        {
+            v_int32 lo, hi;
+            v_prefix_sum(src + x, lo, hi);
+            v_store(sum + x, v_cvt_f64(lo) + prev);
+            v_store(sum + x + v_float64::nlanes, v_cvt_f64_high(lo) + prev);
+            v_store(sum + x + v_float64::nlanes*2, v_cvt_f64(hi) + prev);
+            v_store(sum + x + v_float64::nlanes*3, v_cvt_f64_high(hi) + prev);
+            prev = vx_setall_f64(sum[x + v_uint16::nlanes - 1]);
+
+            if (sqsum)
+            {
+                // a square fits into 17 bits, so a vector of prefix sums of squares fits into int32
+                v_uint16 el = vx_load_expand(src + x);
+                v_uint32 sq0, sq1;
+                v_mul_expand(el, el, sq0, sq1);
+                v_int32 s0 = v_prefix_sum(v_reinterpret_as_s32(sq0));
+                v_int32 s1 = v_prefix_sum(v_reinterpret_as_s32(sq1));
+                v_float64 t = prevsq + vx_setall_f64((double)v_extract_n<v_int32::nlanes - 1>(s0));
+                v_store(sqsum + x, v_cvt_f64(s0) + prevsq);
+                v_store(sqsum + x + v_float64::nlanes, v_cvt_f64_high(s0) + prevsq);
+                v_store(sqsum + x + v_float64::nlanes*2, v_cvt_f64(s1) + t);
+                v_store(sqsum + x + v_float64::nlanes*3, v_cvt_f64_high(s1) + t);
+                prevsq = vx_setall_f64(sqsum[x + v_uint16::nlanes - 1]);
+            }
+        }
+        vx_cleanup();
+        return x;
+    }
+};
+#endif
+
+#endif
+
+template <typename T, typename ST, typename QT>
+void integralRowPrefix_(const T* src, size_t _srcstep,
+                        ST* sum, size_t _sumstep,
+                        QT* sqsum, size_t _sqsumstep,
+                        int width, int cn, const Range& rows)
+{
+    IntegralRow_SIMD<T, ST, QT> vop;
+
+    for (int y = rows.start; y < rows.end; y++)
+    {
+        const T* srow = (const T*)((const uchar*)src + _srcstep*y);
+        ST* srow_sum = (ST*)((uchar*)sum + _sumstep*(y + 1));
+        QT* srow_sqsum = sqsum ? (QT*)((uchar*)sqsum + _sqsumstep*(y + 1)) : 0;
+
+        for (int k = 0; k < cn; k++)
+        {
+            srow_sum[k] = 0;
+            if (srow_sqsum)
+                srow_sqsum[k] = 0;
+        }
+        srow_sum += cn;
+        if (srow_sqsum)
+            srow_sqsum += cn;
+
+        // the same order of accumulation as in integral_(), so that the results are identical
+        for (int k = 0; k < cn; k++)
+        {
+            int x = cn == 1 ? vop(srow, srow_sum, srow_sqsum, width) : 0;
+            ST s = x > 0 ? srow_sum[x - 1] : 0;
+            if (srow_sqsum)
+            {
+                QT sq = x > 0 ? srow_sqsum[x - 1] : 0;
+                for (x = x*cn + k; x < width*cn; x += cn)
+                {
+                    T it = srow[x];
+                    s += it;
+                    sq += (QT)it*it;
+                    srow_sum[x] = s;
+                    srow_sqsum[x] = sq;
+                }
+            }
+            else
+            {
+                for (x = x*cn + k; x < width*cn; x += cn)
+                {
+                    s += srow[x];
+                    srow_sum[x] = s;
+                }
+            }
+        }
+    }
+}
+
+#if CV_SIMD
+static inline int integralColumn_SIMD(const int* prev, int* cur, int x, int x1)
+{
+    for (; x <= x1 - v_int32::nlanes; x += v_int32::nlanes)
+        v_store(cur + x, vx_load(cur + x) + vx_load(prev + x));
+    return x;
+}
+
+static inline int integralColumn_SIMD(const float* prev, float* cur, int x, int x1)
+{
+    for (; x <= x1 - v_float32::nlanes; x += v_float32::nlanes)
+        v_store(cur + x, vx_load(cur + x) + vx_load(prev + x));
+    return x;
+}
+
+#if CV_SIMD_64F
+static inline int integralColumn_SIMD(const double* prev, double* cur, int x, int x1)
+{
+    for (; x <= x1 - v_float64::nlanes; x += v_float64::nlanes)
+        v_store(cur + x, vx_load(cur + x) + vx_load(prev + x));
+    return x;
+}
+#endif
+#endif
+
+template <typename ST> static inline int integralColumn_SIMD(const ST*, ST*, int x, int)
+{
+    return x;
+}
+
+template <typename ST>
+void integralColumnSum_(uchar* sum, size_t sumstep, int height, const Range& cols)
+{
+    // the row 0 is zero and the row 1 contains the sums of the first source row already
+    for (int y = 2; y < height; y++)
+    {
+        const ST* prev = (const ST*)(sum + sumstep*(y - 1));
+        ST* cur = (ST*)(sum + sumstep*y);
+        int x = integralColumn_SIMD(prev, cur, cols.start, cols.end);
+        for (; x < cols.end; x++)
+            cur[x] += prev[x];
+    }
+    vx_cleanup();
+}
+
+typedef void (*IntegralColumnFunc)(uchar*, size_t, int, const Range&);
+
+static IntegralColumnFunc getIntegralColumnFunc(int depth)
+{
+    return depth == CV_32S ? integralColumnSum_<int> :
+           depth == CV_32F ? integralColumnSum_<float> :
+           depth == CV_64F ? integralColumnSum_<double> : 0;
+}
+
+#if CV_SIMD
+static inline int integralTiltedDiagonals_SIMD(const uchar* src, const int* prev, int* cur, int x, int x1)
+{
+    for (; x <= x1 - v_uint16::nlanes; x += v_uint16::nlanes)
+    {
+        v_int32 lo, hi;
+        v_expand(v_reinterpret_as_s16(vx_load_expand(src + x)), lo, hi);
+        v_store(cur + x, vx_load(prev + x) + lo);
+        v_store(cur + x + v_int32::nlanes, vx_load(prev + x + v_int32::nlanes) + hi);
+    }
+    return x;
+}
+
+static inline int integralTiltedSums_SIMD(const uchar* src, const int* diag, const int* prev, int* cur, int cn, int x, int x1)
+{
+    for (; x <= x1 - v_uint16::nlanes; x += v_uint16::nlanes)
+    {
+        v_int32 lo, hi;
+        v_expand(v_reinterpret_as_s16(vx_load_expand(src + x)), lo, hi);
+        v_store(cur + x, vx_load(diag + x) + ((vx_load(diag + x + cn) + lo) + vx_load(prev + x)));
+        v_store(cur + x + v_int32::nlanes, vx_load(diag + x + v_int32::nlanes) +
+                ((vx_load(diag + x + cn + v_int32::nlanes) + hi) + vx_load(prev + x + v_int32::nlanes)));
+    }
+    return x;
+}
+#endif
+
+template <typename T, typename ST> static inline int integralTiltedDiagonals_SIMD(const T*, const ST*, ST*, int x, int)
+{
+    return x;
+}
+
+template <typename T, typename ST> static inline int integralTiltedSums_SIMD(const T*, const ST*, const ST*, ST*, int, int x, int)
+{
+    return x;
+}
+
+// diag(y, x) = diag(y - 1, x + 1) + src(y, x), the last column is the source one
+template <typename T, typename ST>
+void integralTiltedDiagonals_(const uchar* _src, size_t srcstep, uchar* _diag, size_t diagstep,
+                              int width, int height, int cn, int band, const Range& bands)
+{
+    for (int y = 0; y < height - 1; y++)
+    {
+        const T* src = (const T*)(_src + srcstep*y);
+        ST* cur = (ST*)(_diag + diagstep*y);
+        int x0 = std::max(bands.start*band - y, 0), x1 = std::min(bands.end*band - y, width);
+        if (x0 >= x1)
+            continue;
+
+        int last = y == 0 ? x0 : x1 == width ? width - 1 : x1;
+        int x = x0*cn;
+        if (last > x0)
+        {
+            const ST* prev = (const ST*)(_diag + diagstep*(y - 1)) + cn;
+            x = integralTiltedDiagonals_SIMD(src, prev, cur, x, last*cn);
+            for (; x < last*cn; x++)
+                cur[x] = prev[x] + src[x];
+        }
+        for (; x < x1*cn; x++)
+            cur[x] = src[x];
+    }
+    vx_cleanup();
+}
+
+template <typename T, typename ST>
+void integralTiltedBorders_(const uchar* _src, size_t srcstep, const uchar* _diag, size_t diagstep,
+                            uchar* _tilted, size_t tiltedstep, int width, int height, int cn)
+{
+    ST* tilted0 = (ST*)_tilted;
+    ST* tilted1 = (ST*)(_tilted + tiltedstep);
+    const T* src = (const T*)_src;
+    for (int x = 0; x < (width + 1)*cn; x++)
+        tilted0[x] = 0;
+    for (int k = 0; k < cn; k++)
+        tilted1[k] = 0;
+    for (int x = 0; x < width*cn; x++)
+        tilted1[x + cn] = src[x];
+
+    for (int y = 1; y < height; y++)
+    {
+        src = (const T*)(_src + srcstep*y);
+        const ST* prev = (const ST*)(_tilted + tiltedstep*y);
+        ST* cur = (ST*)(_tilted + tiltedstep*(y + 1));
+        const ST* diag = (const ST*)(_diag + diagstep*(y - 1));
+        for (int k = 0; k < cn; k++)
+        {
+            ST t = src[k];
+            cur[k] = prev[cn + k];
+            cur[cn + k] = prev[cn + k] + t + (width > 1 ? diag[cn + k] : (ST)0);
+        }
+    }
+}
+
+// tilted(y + 1, x + 1) = diag(y - 1, x) + diag(y - 1, x + 1) + src(y, x) + tilted(y, x),
+// the last column doesn't have the second term
+template <typename T, typename ST>
+void integralTiltedSums_(const uchar* _src, size_t srcstep, const uchar* _diag, size_t diagstep,
+                         uchar* _tilted, size_t tiltedstep, int width, int height, int cn, int band, const Range& bands)
+{
+    for (int y = 1; y < height; y++)
+    {
+        const T* src = (const T*)(_src + srcstep*y);
+        const ST* diag = (const ST*)(_diag + diagstep*(y - 1));
+        const ST* prev = (const ST*)(_tilted + tiltedstep*y);
+        ST* cur = (ST*)(_tilted + tiltedstep*(y + 1)) + cn;
+        int d0 = 2 - height + bands.start*band, d1 = 2 - height + bands.end*band;
+        int x0 = std::max(d0 + y, 1), x1 = std::min(d1 + y, width);
+        if (x0 >= x1)
+            continue;
+
+        int last = x1 == width ? width - 1 : x1;
+        int x = integralTiltedSums_SIMD(src, diag, prev, cur, cn, x0*cn, last*cn);
+        for (; x < last*cn; x++)
+        {
+            ST t = src[x];
+            cur[x] = diag[x] + ((diag[x + cn] + t) + prev[x]);
+        }
+        for (; x < x1*cn; x++)
+        {
+            ST t = src[x];
+            cur[x] = (t + diag[x]) + prev[x];
+        }
+    }
+    vx_cleanup();
+}
+
+#define CV_INTEGRAL_TILTED_CALL(func, args) \
+    if( depth == CV_8U && sdepth == CV_32S ) \
+        func<uchar, int> args; \
+    else if( depth == CV_8U && sdepth == CV_32F ) \
+        func<uchar, float> args; \
+    else if( depth == CV_8U && sdepth == CV_64F ) \
+        func<uchar, double> args; \
+    else if( depth == CV_16U && sdepth == CV_64F ) \
+        func<ushort, double> args; \
+    else if( depth == CV_16S && sdepth == CV_64F ) \
+        func<short, double> args; \
+    else if( depth == CV_32F && sdepth == CV_32F ) \
+        func<float, float> args; \
+    else if( depth == CV_32F && sdepth == CV_64F ) \
+        func<float, double> args; \
+    else if( depth == CV_64F && sdepth == CV_64F ) \
+        func<double, double> args; \
+    else \
+        CV_Error( CV_StsUnsupportedFormat, "" )
+
+} // namespace
+
+void integralRowPrefix(int depth, int sdepth, int sqdepth,
+                       const uchar* src, size_t srcstep,
+                       uchar* sum, size_t sumstep,
+                       uchar* sqsum, size_t sqsumstep,
+                       int width, int cn, const Range& rows)
+{
+    CV_INSTRUMENT_REGION();
+
+#define ONE_CALL(A, B, C) integralRowPrefix_<A, B, C>((const A*)src, srcstep, (B*)sum, sumstep, (C*)sqsum, sqsumstep, width, cn, rows)
+
+    if( depth == CV_8U && sdepth == CV_32S && sqdepth == CV_64F )
+        ONE_CALL(uchar, int, double);
+    else if( depth == CV_8U && sdepth == CV_32S && sqdepth == CV_32F )
+        ONE_CALL(uchar, int, float);
+    else if( depth == CV_8U && sdepth == CV_32S && sqdepth == CV_32S )
+        ONE_CALL(uchar, int, int);
+    else if( depth == CV_8U && sdepth == CV_32F && sqdepth == CV_64F )
+        ONE_CALL(uchar, float, double);
+    else if( depth == CV_8U && sdepth == CV_32F && sqdepth == CV_32F )
+        ONE_CALL(uchar, float, float);
+    else if( depth == CV_8U && sdepth == CV_64F && sqdepth == CV_64F )
+        ONE_CALL(uchar, double, double);
+    else if( depth == CV_16U && sdepth == CV_64F && sqdepth == CV_64F )
+        ONE_CALL(ushort, double, double);
+    else if( depth == CV_16S && sdepth == CV_64F && sqdepth == CV_64F )
+        ONE_CALL(short, double, double);
+    else if( depth == CV_32F && sdepth == CV_32F && sqdepth == CV_64F )
+        ONE_CALL(float, float, double);
+    else if( depth == CV_32F && sdepth == CV_32F && sqdepth == CV_32F )
+        ONE_CALL(float, float, float);
+    else if( depth == CV_32F && sdepth == CV_64F && sqdepth == CV_64F )
+        ONE_CALL(float, double, double);
+    else if( depth == CV_64F && sdepth == CV_64F && sqdepth == CV_64F )
+        ONE_CALL(double, double, double);
+    else
+        CV_Error( CV_StsUnsupportedFormat, "" );
+
+#undef ONE_CALL
+}
+
+void integralColumnSum(int sdepth, int sqdepth,
+                       uchar* sum, size_t sumstep,
+                       uchar* sqsum, size_t sqsumstep,
+                       int height, const Range& cols)
+{
+    CV_INSTRUMENT_REGION();
+
+    IntegralColumnFunc sumFunc = getIntegralColumnFunc(sdepth);
+    CV_Assert( sumFunc );
+    sumFunc(sum, sumstep, height, cols);
+
+    if( sqsum )
+    {
+        IntegralColumnFunc sqsumFunc = getIntegralColumnFunc(sqdepth);
+        CV_Assert( sqsumFunc );
+        sqsumFunc(sqsum, sqsumstep, height, cols);
+    }
+}
+
+void integralTiltedDiagonals(int depth, int sdepth,
+                             const uchar* src, size_t srcstep,
+                             uchar* diag, size_t diagstep,
+                             int width, int height, int cn, int band, const Range& bands)
+{
+    CV_INSTRUMENT_REGION();
+
+    CV_INTEGRAL_TILTED_CALL(integralTiltedDiagonals_, (src, srcstep, diag, diagstep, width, height, cn, band, bands));
+}
+
+void integralTiltedBorders(int depth, int sdepth,
+                           const uchar* src, size_t srcstep,
+                           const uchar* diag, size_t diagstep,
+                           uchar* tilted, size_t tiltedstep,
+                           int width, int height, int cn)
+{
+    CV_INSTRUMENT_REGION();
+
+    CV_INTEGRAL_TILTED_CALL(integralTiltedBorders_, (src, srcstep, diag, diagstep, tilted, tiltedstep, width, height, cn));
+}
+
+void integralTiltedSums(int depth, int sdepth,
+                        const uchar* src, size_t srcstep,
+                        const uchar* diag, size_t diagstep,
+                        uchar* tilted, size_t tiltedstep,
+                        int width, int height, int cn, int band, const Range& bands)
+{
+    CV_INSTRUMENT_REGION();
+
+    CV_INTEGRAL_TILTED_CALL(integralTiltedSums_, (src, srcstep, diag, diagstep, tilted, tiltedstep, width, height, cn, band, bands));
+}
+
+#undef CV_INTEGRAL_TILTED_CALL
+
+#endif
+CV_CPU_OPTIMIZATION_NAMESPACE_END
+} // namespace
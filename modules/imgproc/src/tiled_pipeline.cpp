@@ -0,0 +1,549 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+
+namespace cv
+{
+
+TileSource::~TileSource() {}
+TileSink::~TileSink() {}
+
+// One operation of the pipeline. Rectangles are given in the coordinates of the whole image
+// at the corresponding stage of the pipeline.
+class TiledOp
+{
+public:
+    virtual ~TiledOp() {}
+    virtual Size outputSize(Size inSize) const { return inSize; }
+    virtual int outputType(int inType) const { return inType; }
+    // the region of the input image needed to compute the region dstRect of the output image
+    virtual Rect inputRect(const Rect& dstRect, Size inSize) const = 0;
+    // src holds the region srcRect = inputRect(dstRect) of the input image of size inSize
+    virtual void apply(const Mat& src, const Rect& srcRect, Size inSize, Mat& dst, const Rect& dstRect) const = 0;
+};
+
+// extracts the roi as a standalone matrix, so the border extrapolation of the next
+// operation does not see the pixels outside of it
+static Mat cropTile(const Mat& m, const Rect& roi)
+{
+    if( roi.x == 0 && roi.y == 0 && roi.width == m.cols && roi.height == m.rows )
+        return m;
+    return m(roi).clone();
+}
+
+class TiledNeighborhoodOp : public TiledOp
+{
+public:
+    explicit TiledNeighborhoodOp(Size _halo) : halo(_halo) {}
+
+    virtual Rect inputRect(const Rect& dstRect, Size inSize) const CV_OVERRIDE
+    {
+        Rect r(dstRect.x - halo.width, dstRect.y - halo.height,
+               dstRect.width + halo.width*2, dstRect.height + halo.height*2);
+        return r & Rect(Point(), inSize);
+    }
+
+    virtual void apply(const Mat& src, const Rect& srcRect, Size, Mat& dst, const Rect& dstRect) const CV_OVERRIDE
+    {
+        Mat buf;
+        process(src, buf);
+        dst = cropTile(buf, dstRect - srcRect.tl());
+    }
+
+protected:
+    virtual void process(const Mat& src, Mat& dst) const = 0;
+    Size halo;
+};
+
+class TiledPointOp : public TiledOp
+{
+public:
+    virtual Rect inputRect(const Rect& dstRect, Size) const CV_OVERRIDE
+    {
+        return dstRect;
+    }
+
+    virtual void apply(const Mat& src, const Rect& srcRect, Size, Mat& dst, const Rect& dstRect) const CV_OVERRIDE
+    {
+        process(src(dstRect - srcRect.tl()), dst);
+    }
+
+protected:
+    virtual void process(const Mat& src, Mat& dst) const = 0;
+};
+
+class TiledFilter2DOp : public TiledNeighborhoodOp
+{
+public:
+    TiledFilter2DOp(int _ddepth, const Mat& _kernel, double _delta, int _borderType)
+        : TiledNeighborhoodOp(Size(_kernel.cols/2, _kernel.rows/2)), ddepth(_ddepth),
+          kernel(_kernel), delta(_delta), borderType(_borderType)
+    {
+    }
+
+    virtual int outputType(int inType) const CV_OVERRIDE
+    {
+        return CV_MAKETYPE(ddepth < 0 ? CV_MAT_DEPTH(inType) : ddepth, CV_MAT_CN(inType));
+    }
+
+protected:
+    virtual void process(const Mat& src, Mat& dst) const CV_OVERRIDE
+    {
+        cv::filter2D(src, dst, ddepth, kernel, Point(-1, -1), delta, borderType);
+    }
+
+    int ddepth;
+    Mat kernel;
+    double delta;
+    int borderType;
+};
+
+static Size gaussianHalo(Size ksize, double sigmaX, double sigmaY)
+{
+    // the kernel size selected from sigma is at most 8*sigma + 1 (see createGaussianKernels)
+    if( sigmaY <= 0 )
+        sigmaY = sigmaX;
+    if( ksize.width <= 0 )
+        ksize.width = cvRound(sigmaX*4*2 + 1)|1;
+    if( ksize.height <= 0 )
+        ksize.height = cvRound(sigmaY*4*2 + 1)|1;
+    return Size(ksize.width/2, ksize.height/2);
+}
+
+class TiledGaussianBlurOp : public TiledNeighborhoodOp
+{
+public:
+    TiledGaussianBlurOp(Size _ksize, double _sigmaX, double _sigmaY, int _borderType)
+        : TiledNeighborhoodOp(gaussianHalo(_ksize, _sigmaX, _sigmaY)), ksize(_ksize),
+          sigmaX(_sigmaX), sigmaY(_sigmaY), borderType(_borderType)
+    {
+    }
+
+protected:
+    virtual void process(const Mat& src, Mat& dst) const CV_OVERRIDE
+    {
+        cv::GaussianBlur(src, dst, ksize, sigmaX, sigmaY, borderType);
+    }
+
+    Size ksize;
+    double sigmaX, sigmaY;
+    int borderType;
+};
+
+class TiledBoxFilterOp : public TiledNeighborhoodOp
+{
+public:
+    TiledBoxFilterOp(int _ddepth, Size _ksize, bool _normalize, int _borderType)
+        : TiledNeighborhoodOp(Size(_ksize.width/2, _ksize.height/2)), ddepth(_ddepth),
+          ksize(_ksize), normalize(_normalize), borderType(_borderType)
+    {
+    }
+
+    virtual int outputType(int inType) const CV_OVERRIDE
+    {
+        return CV_MAKETYPE(ddepth < 0 ? CV_MAT_DEPTH(inType) : ddepth, CV_MAT_CN(inType));
+    }
+
+protected:
+    virtual void process(const Mat& src, Mat& dst) const CV_OVERRIDE
+    {
+        cv::boxFilter(src, dst, ddepth, ksize, Point(-1, -1), normalize, borderType);
+    }
+
+    int ddepth;
+    Size ksize;
+    bool normalize;
+    int borderType;
+};
+
+static Size morphologyHalo(int op, Size ksize, int iterations)
+{
+    // opening, closing and the hats apply the kernel twice
+    int passes = op == MORPH_OPEN || op == MORPH_CLOSE ||
+                 op == MORPH_TOPHAT || op == MORPH_BLACKHAT ? 2 : 1;
+    int n = passes*std::max(iterations, 1);
+    return Size(ksize.width/2*n, ksize.height/2*n);
+}
+
+class TiledMorphologyOp : public TiledNeighborhoodOp
+{
+public:
+    TiledMorphologyOp(int _op, const Mat& _kernel, int _iterations, int _borderType, const Scalar& _borderValue)
+        : TiledNeighborhoodOp(morphologyHalo(_op, _kernel.empty() ? Size(3, 3) : _kernel.size(), _iterations)),
+          op(_op), kernel(_kernel), iterations(_iterations), borderType(_borderType), borderValue(_borderValue)
+    {
+    }
+
+protected:
+    virtual void process(const Mat& src, Mat& dst) const CV_OVERRIDE
+    {
+        cv::morphologyEx(src, dst, op, kernel, Point(-1, -1), iterations, borderType, borderValue);
+    }
+
+    int op;
+    Mat kernel;
+    int iterations, borderType;
+    Scalar borderValue;
+};
+
+class TiledThresholdOp : public TiledPointOp
+{
+public:
+    TiledThresholdOp(double _thresh, double _maxval, int _type)
+        : thresh(_thresh), maxval(_maxval), type(_type)
+    {
+    }
+
+protected:
+    virtual void process(const Mat& src, Mat& dst) const CV_OVERRIDE
+    {
+        cv::threshold(src, dst, thresh, maxval, type);
+    }
+
+    double thresh, maxval;
+    int type;
+};
+
+class TiledCvtColorOp : public TiledPointOp
+{
+public:
+    TiledCvtColorOp(int _code, int _dstCn) : code(_code), dstCn(_dstCn) {}
+
+    virtual int outputType(int inType) const CV_OVERRIDE
+    {
+        // run the conversion on a tiny image to learn the output type
+        Mat probe(2, 2, inType, Scalar::all(0)), out;
+        cv::cvtColor(probe, out, code, dstCn);
+        CV_Assert( out.size() == probe.size() && "Only the conversions keeping the image size are supported" );
+        return out.type();
+    }
+
+protected:
+    virtual void process(const Mat& src, Mat& dst) const CV_OVERRIDE
+    {
+        cv::cvtColor(src, dst, code, dstCn);
+    }
+
+    int code, dstCn;
+};
+
+class TiledResizeOp : public TiledOp
+{
+public:
+    TiledResizeOp(double _fx, double _fy, int _interpolation)
+        : fx(_fx), fy(_fy), interpolation(_interpolation), kx(0), ky(0)
+    {
+        CV_Assert( fx > 0 && fy > 0 );
+        double sx = 1./fx, sy = 1./fy;
+        int isx = saturate_cast<int>(sx), isy = saturate_cast<int>(sy);
+        bool integerScale = std::abs(sx - isx) < DBL_EPSILON && std::abs(sy - isy) < DBL_EPSILON &&
+                            isx >= 1 && isy >= 1;
+        // cv::resize implements the integer downscaling with INTER_AREA, and the bilinear
+        // 2x downscaling is equivalent to it
+        if( integerScale && (interpolation == INTER_AREA ||
+                             (interpolation == INTER_LINEAR && isx == 2 && isy == 2)) )
+        {
+            kx = isx;
+            ky = isy;
+        }
+        else
+            CV_Assert( interpolation == INTER_NEAREST || interpolation == INTER_LINEAR ||
+                       interpolation == INTER_CUBIC || interpolation == INTER_LANCZOS4 ||
+                       !"INTER_AREA is supported for the integer downscaling factors only" );
+    }
+
+    virtual Size outputSize(Size inSize) const CV_OVERRIDE
+    {
+        Size dsize(saturate_cast<int>(inSize.width*fx), saturate_cast<int>(inSize.height*fy));
+        CV_Assert( !dsize.empty() );
+        return dsize;
+    }
+
+    virtual Rect inputRect(const Rect& dstRect, Size inSize) const CV_OVERRIDE
+    {
+        Rect r;
+        if( kx > 0 )
+            r = Rect(dstRect.x*kx, dstRect.y*ky, dstRect.width*kx, dstRect.height*ky);
+        else
+        {
+            std::vector<int> xofs, yofs;
+            Range xr = coords(dstRect.x, dstRect.width, fx, inSize.width, xofs);
+            Range yr = coords(dstRect.y, dstRect.height, fy, inSize.height, yofs);
+            r = Rect(xr.start, yr.start, xr.size(), yr.size());
+        }
+        return r & Rect(Point(), inSize);
+    }
+
+    virtual void apply(const Mat& src, const Rect& srcRect, Size inSize, Mat& dst, const Rect& dstRect) const CV_OVERRIDE
+    {
+        dst.create(dstRect.size(), src.type());
+        if( kx > 0 )
+        {
+            // the tiles are aligned to the decimation blocks, so the result is the same
+            // as for the whole image
+            hal::resize(src.type(), src.data, src.step, src.cols, src.rows,
+                        dst.data, dst.step, dst.cols, dst.rows, fx, fy, INTER_AREA);
+            return;
+        }
+
+        // the maps are computed for the whole image and shifted to the tile,
+        // which keeps the neighbor tiles consistent
+        std::vector<int> xofs, yofs;
+        coords(dstRect.x, dstRect.width, fx, inSize.width, xofs);
+        coords(dstRect.y, dstRect.height, fy, inSize.height, yofs);
+
+        Mat map1(dstRect.size(), CV_16SC2), map2;
+        if( interpolation != INTER_NEAREST )
+            map2.create(dstRect.size(), CV_16UC1);
+        int shift = interpolation == INTER_NEAREST ? 0 : INTER_BITS;
+        for( int y = 0; y < dstRect.height; y++ )
+        {
+            short* xy = map1.ptr<short>(y);
+            ushort* alpha = map2.empty() ? 0 : map2.ptr<ushort>(y);
+            int Y = yofs[y];
+            for( int x = 0; x < dstRect.width; x++ )
+            {
+                int X = xofs[x];
+                xy[x*2] = saturate_cast<short>((X >> shift) - srcRect.x);
+                xy[x*2+1] = saturate_cast<short>((Y >> shift) - srcRect.y);
+                if( alpha )
+                    alpha[x] = (ushort)((Y & (INTER_TAB_SIZE-1))*INTER_TAB_SIZE + (X & (INTER_TAB_SIZE-1)));
+            }
+        }
+        remap(src, dst, map1, map2, interpolation, BORDER_REPLICATE);
+    }
+
+protected:
+    // computes the source coordinates of the dst pixels [d0, d0 + n) and returns the source range they use;
+    // the coordinates are integer for INTER_NEAREST and fixed-point with INTER_BITS fractional bits otherwise
+    Range coords(int d0, int n, double scale, int inSize, std::vector<int>& ofs) const
+    {
+        double iscale = 1./scale;
+        ofs.resize(n);
+        if( interpolation == INTER_NEAREST )
+        {
+            // the same mapping as in resizeNN
+            for( int i = 0; i < n; i++ )
+                ofs[i] = std::min(cvFloor((d0 + i)*iscale), inSize - 1);
+            return Range(ofs[0], ofs[n-1] + 1);
+        }
+
+        // pixel centers are aligned, as in cv::resize. Like there, the bilinear coordinates are clamped
+        // to the image, while the wider kernels keep their weights and replicate the border pixels.
+        int maxofs = (inSize - 1)*INTER_TAB_SIZE;
+        for( int i = 0; i < n; i++ )
+        {
+            int X = cvRound(((d0 + i + 0.5)*iscale - 0.5)*INTER_TAB_SIZE);
+            ofs[i] = interpolation == INTER_LINEAR ? std::min(std::max(X, 0), maxofs) : X;
+        }
+        // the widest supported kernel (Lanczos4) reads from x - 3 to x + 4
+        return Range((ofs[0] >> INTER_BITS) - 3, (ofs[n-1] >> INTER_BITS) + 5);
+    }
+
+    double fx, fy;
+    int interpolation;
+    int kx, ky;
+};
+
+struct TiledPipeline::Impl
+{
+    Impl() : tileSize(512, 512) {}
+
+    std::vector<Ptr<TiledOp> > ops;
+    Size tileSize;
+};
+
+class TiledPipelineInvoker : public ParallelLoopBody
+{
+public:
+    TiledPipelineInvoker(const TiledPipeline::Impl& _impl, TileSource& _src, TileSink& _dst,
+                         const std::vector<Size>& _sizes, Mutex& _readMutex, Mutex& _writeMutex)
+        : impl(_impl), src(_src), dst(_dst), sizes(_sizes),
+          readMutex(_readMutex), writeMutex(_writeMutex)
+    {
+    }
+
+    virtual void operator() (const Range& range) const CV_OVERRIDE
+    {
+        size_t i, nops = impl.ops.size();
+        Size outSize = sizes[nops], tileSize = impl.tileSize;
+        int tilesPerRow = (outSize.width + tileSize.width - 1)/tileSize.width;
+        std::vector<Rect> rects(nops + 1);
+
+        for( int t = range.start; t < range.end; t++ )
+        {
+            int tx = (t % tilesPerRow)*tileSize.width, ty = (t / tilesPerRow)*tileSize.height;
+            rects[nops] = Rect(tx, ty, tileSize.width, tileSize.height) & Rect(Point(), outSize);
+
+            // propagate the halos back to the source image
+            for( i = nops; i > 0; i-- )
+                rects[i-1] = impl.ops[i-1]->inputRect(rects[i], sizes[i-1]);
+
+            Mat tile;
+            {
+                AutoLock lock(readMutex);
+                src.read(rects[0], tile);
+            }
+            CV_Assert( tile.size() == rects[0].size() && tile.type() == src.type() );
+
+            for( i = 0; i < nops; i++ )
+            {
+                Mat out;
+                impl.ops[i]->apply(tile, rects[i], sizes[i], out, rects[i+1]);
+                tile = out;
+            }
+
+            {
+                AutoLock lock(writeMutex);
+                dst.write(rects[nops], tile);
+            }
+        }
+    }
+
+private:
+    const TiledPipeline::Impl& impl;
+    TileSource& src;
+    TileSink& dst;
+    const std::vector<Size>& sizes;
+    Mutex& readMutex;
+    Mutex& writeMutex;
+};
+
+class MatTileSource : public TileSource
+{
+public:
+    explicit MatTileSource(const Mat& _m) : m(_m) {}
+    virtual Size size() const CV_OVERRIDE { return m.size(); }
+    virtual int type() const CV_OVERRIDE { return m.type(); }
+    virtual void read(const Rect& roi, OutputArray dst) CV_OVERRIDE { m(roi).copyTo(dst); }
+
+private:
+    Mat m;
+};
+
+class MatTileSink : public TileSink
+{
+public:
+    explicit MatTileSink(const Mat& _m) : m(_m) {}
+    virtual void write(const Rect& roi, InputArray tile) CV_OVERRIDE
+    {
+        Mat dst = m(roi);
+        tile.copyTo(dst);
+    }
+
+private:
+    Mat m;
+};
+
+TiledPipeline::TiledPipeline() : p(makePtr<Impl>())
+{
+}
+
+TiledPipeline& TiledPipeline::filter2D(int ddepth, InputArray kernel, double delta, int borderType)
+{
+    p->ops.push_back(makePtr<TiledFilter2DOp>(ddepth, kernel.getMat().clone(), delta, borderType));
+    return *this;
+}
+
+TiledPipeline& TiledPipeline::GaussianBlur(Size ksize, double sigmaX, double sigmaY, int borderType)
+{
+    CV_Assert( ksize.width > 0 || sigmaX > 0 );
+    p->ops.push_back(makePtr<TiledGaussianBlurOp>(ksize, sigmaX, sigmaY, borderType));
+    return *this;
+}
+
+TiledPipeline& TiledPipeline::boxFilter(int ddepth, Size ksize, bool normalize, int borderType)
+{
+    p->ops.push_back(makePtr<TiledBoxFilterOp>(ddepth, ksize, normalize, borderType));
+    return *this;
+}
+
+TiledPipeline& TiledPipeline::morphologyEx(int op, InputArray kernel, int iterations,
+                                           int borderType, const Scalar& borderValue)
+{
+    p->ops.push_back(makePtr<TiledMorphologyOp>(op, kernel.getMat().clone(), iterations,
+                                                borderType, borderValue));
+    return *this;
+}
+
+TiledPipeline& TiledPipeline::threshold(double thresh, double maxval, int type)
+{
+    CV_Assert( (type & (THRESH_OTSU | THRESH_TRIANGLE)) == 0 );
+    p->ops.push_back(makePtr<TiledThresholdOp>(thresh, maxval, type));
+    return *this;
+}
+
+TiledPipeline& TiledPipeline::resize(double fx, double fy, int interpolation)
+{
+    p->ops.push_back(makePtr<TiledResizeOp>(fx, fy, interpolation));
+    return *this;
+}
+
+TiledPipeline& TiledPipeline::cvtColor(int code, int dstCn)
+{
+    p->ops.push_back(makePtr<TiledCvtColorOp>(code, dstCn));
+    return *this;
+}
+
+void TiledPipeline::setTileSize(Size tileSize)
+{
+    CV_Assert( tileSize.width > 0 && tileSize.height > 0 );
+    p->tileSize = tileSize;
+}
+
+Size TiledPipeline::getTileSize() const
+{
+    return p->tileSize;
+}
+
+Size TiledPipeline::outputSize(Size inputSize) const
+{
+    for( size_t i = 0; i < p->ops.size(); i++ )
+        inputSize = p->ops[i]->outputSize(inputSize);
+    return inputSize;
+}
+
+int TiledPipeline::outputType(int inputType) const
+{
+    for( size_t i = 0; i < p->ops.size(); i++ )
+        inputType = p->ops[i]->outputType(inputType);
+    return inputType;
+}
+
+void TiledPipeline::run(TileSource& src, TileSink& dst) const
+{
+    CV_INSTRUMENT_REGION();
+
+    size_t i, nops = p->ops.size();
+    std::vector<Size> sizes(nops + 1);
+    sizes[0] = src.size();
+    CV_Assert( sizes[0].width > 0 && sizes[0].height > 0 );
+    for( i = 0; i < nops; i++ )
+        sizes[i+1] = p->ops[i]->outputSize(sizes[i]);
+
+    Size outSize = sizes[nops], tileSize = p->tileSize;
+    int ntiles = ((outSize.width + tileSize.width - 1)/tileSize.width)*
+                 ((outSize.height + tileSize.height - 1)/tileSize.height);
+    Mutex readMutex, writeMutex;
+    parallel_for_(Range(0, ntiles), TiledPipelineInvoker(*p, src, dst, sizes, readMutex, writeMutex), ntiles);
+}
+
+void TiledPipeline::run(InputArray _src, OutputArray _dst) const
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat src = _src.getMat();
+    CV_Assert( !src.empty() && src.dims <= 2 );
+    _dst.create(outputSize(src.size()), outputType(src.type()));
+    Mat dst = _dst.getMat();
+    if( dst.data == src.data )
+        src = src.clone();
+
+    MatTileSource source(src);
+    MatTileSink sink(dst);
+    run(source, sink);
+}
+
+}
@@ -289,4 +289,60 @@ namespace opencv_test { namespace {
         test.safe_run();
     }
 
+    typedef testing::TestWithParam<int> Imgproc_ApproxBilateralFilter;
+
+    TEST_P(Imgproc_ApproxBilateralFilter, accuracy)
+    {
+        const int type = GetParam(), cn = CV_MAT_CN(type);
+        const double sigmaColor = 30, sigmaSpace = 6;
+
+        // piecewise constant image with noise
+        Mat clean(240, 320, CV_8UC(cn), Scalar(40, 90, 140));
+        rectangle(clean, Rect(60, 40, 150, 110), Scalar(200, 160, 60), FILLED);
+        circle(clean, Point(230, 160), 55, Scalar(120, 230, 20), FILLED);
+        Mat noise(clean.size(), CV_MAKETYPE(CV_16S, cn));
+        randn(noise, 0, 8);
+        Mat src;
+        cv::add(clean, noise, src, noArray(), CV_8U);
+
+        double scale = CV_MAT_DEPTH(type) == CV_32F ? 1./255 : 1.;
+        src.convertTo(src, type, scale);
+
+        Mat ref, dst;
+        bilateralFilter(src, ref, cvRound(sigmaSpace*3)*2 + 1, sigmaColor*scale, sigmaSpace);
+        approxBilateralFilter(src, dst, sigmaColor*scale, sigmaSpace);
+        ASSERT_EQ(src.type(), dst.type());
+
+        ref.convertTo(ref, CV_8U, 1/scale);
+        dst.convertTo(dst, CV_8U, 1/scale);
+        EXPECT_GE(cvtest::PSNR(ref, dst), 30.);
+
+        // the result does not depend on the number of threads
+        int threads = getNumThreads();
+        Mat dst1;
+        setNumThreads(1);
+        approxBilateralFilter(src, dst1, sigmaColor*scale, sigmaSpace);
+        setNumThreads(threads);
+        dst1.convertTo(dst1, CV_8U, 1/scale);
+        EXPECT_EQ(0, cvtest::norm(dst, dst1, NORM_INF));
+    }
+
+    INSTANTIATE_TEST_CASE_P(/**/, Imgproc_ApproxBilateralFilter, testing::Values(CV_8UC1, CV_8UC3, CV_32FC1, CV_32FC3));
+
+    // the grid for small sigmas would be too large, bilateralFilter is used
+    TEST(Imgproc_ApproxBilateralFilterFallback, large_grid)
+    {
+        Mat src(300, 400, CV_8UC3), ref, dst;
+        randu(src, 0, 256);
+        bilateralFilter(src, ref, -1, 0.01, 1);
+        approxBilateralFilter(src, dst, 0.01, 1);
+        EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+
+        Mat fsrc(30, 40, CV_32FC1);
+        randu(fsrc, -1e30f, 1e30f);
+        bilateralFilter(fsrc, ref, -1, 1e-3, 10);
+        approxBilateralFilter(fsrc, dst, 1e-3, 10);
+        EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+    }
+
 }} // namespace
@@ -499,5 +499,74 @@ TEST(Imgproc_PointPolygonTest, regression_10222)
     EXPECT_GT(result, 0) << "Desired result: point is inside polygon - actual result: point is not inside polygon";
 }
 
+TEST(Imgproc_ContourDescriptors, batch)
+{
+    Mat img(600, 800, CV_8UC1);
+    randu(img, 0, 256);
+    GaussianBlur(img, img, Size(0, 0), 4);
+    cv::threshold(img, img, 128, 255, THRESH_BINARY);
+
+    std::vector<std::vector<Point> > contours;
+    findContours(img, contours, RETR_LIST, CHAIN_APPROX_SIMPLE);
+    ASSERT_GT(contours.size(), 100u);
+    contours.push_back(std::vector<Point>());
+    const int n = (int)contours.size();
+
+    Mat areas, rects, boxes, mom;
+    contourDescriptors(contours, areas, rects, boxes, mom, true);
+    ASSERT_EQ(n, areas.rows);
+    ASSERT_EQ(CV_32SC4, rects.type());
+    ASSERT_EQ(CV_32FC(5), boxes.type());
+    ASSERT_EQ(Size(10, n), mom.size());
+
+    std::vector<std::vector<Point> > approx, hulls;
+    approxPolyDPBatch(contours, approx, 2, true);
+    convexHullBatch(contours, hulls, true);
+    ASSERT_EQ((size_t)n, approx.size());
+    ASSERT_EQ((size_t)n, hulls.size());
+
+    for (int i = 0; i < n; i++)
+    {
+        SCOPED_TRACE(cv::format("contour %d", i));
+        const std::vector<Point>& c = contours[i];
+        if (c.empty())
+        {
+            EXPECT_EQ(0, areas.at<double>(i));
+            EXPECT_EQ(Vec4i(), rects.at<Vec4i>(i));
+            EXPECT_EQ(0, cvtest::norm(mom.row(i), NORM_INF));
+            EXPECT_TRUE(approx[i].empty());
+            EXPECT_TRUE(hulls[i].empty());
+            continue;
+        }
+
+        EXPECT_EQ(contourArea(c, true), areas.at<double>(i));
+
+        Rect r = boundingRect(c);
+        EXPECT_EQ(Vec4i(r.x, r.y, r.width, r.height), rects.at<Vec4i>(i));
+
+        RotatedRect box = minAreaRect(c);
+        Vec<float, 5> b = boxes.at<Vec<float, 5> >(i);
+        EXPECT_EQ(box.center, Point2f(b[0], b[1]));
+        EXPECT_EQ(box.size, Size2f(b[2], b[3]));
+        EXPECT_EQ(box.angle, b[4]);
+
+        Moments m = moments(c);
+        EXPECT_EQ(m.m00, mom.at<double>(i, 0));
+        EXPECT_EQ(m.m11, mom.at<double>(i, 4));
+        EXPECT_EQ(m.m03, mom.at<double>(i, 9));
+
+        std::vector<Point> a, h;
+        approxPolyDP(c, a, 2, true);
+        convexHull(c, h, true);
+        EXPECT_EQ(a, approx[i]);
+        EXPECT_EQ(h, hulls[i]);
+    }
+
+    std::vector<Mat> hullMats;
+    convexHullBatch(contours, hullMats);
+    ASSERT_EQ((size_t)n, hullMats.size());
+    EXPECT_EQ(CV_32SC2, hullMats[0].type());
+}
+
 }} // namespace
 /* End of file. */
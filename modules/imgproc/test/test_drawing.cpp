@@ -583,4 +583,154 @@ TEST(Drawing, line)
     ASSERT_THROW(line(mat, Point(1,1),Point(99,99),Scalar(255),0), cv::Exception);
 }
 
+typedef testing::TestWithParam<int> Drawing_DrawList;
+
+TEST_P(Drawing_DrawList, regression)
+{
+    const int type = GetParam();
+    const Size sz(640, 480);
+    RNG& rng = theRNG();
+    const int lineTypes[] = { LINE_4, LINE_8, LINE_AA };
+
+    Mat ref(sz, type, Scalar::all(0)), dst(sz, type, Scalar::all(0));
+    DrawList list;
+
+    for (int i = 0; i < 500; i++)
+    {
+        // mostly small primitives, with an occasional big one crossing many bands
+        int r = rng.uniform(0, 10) == 0 ? 300 : 20;
+        Point pt1(rng.uniform(-50, sz.width + 50), rng.uniform(-50, sz.height + 50));
+        Point pt2 = pt1 + Point(rng.uniform(-r, r), rng.uniform(-r, r));
+        Scalar color(rng.uniform(0, 256), rng.uniform(0, 256), rng.uniform(0, 256));
+        int thickness = rng.uniform(1, 5);
+        int lineType = lineTypes[rng.uniform(0, 3)];
+        int shift = rng.uniform(0, 3);
+        std::vector<Point> poly;
+        poly.push_back(pt1);
+        poly.push_back(pt2);
+        poly.push_back(Point(pt1.x, pt2.y));
+
+        switch (rng.uniform(0, 8))
+        {
+        case 0:
+            line(ref, pt1, pt2, color, thickness, lineType);
+            list.line(pt1, pt2, color, thickness, lineType);
+            break;
+        case 1:
+            thickness = rng.uniform(-1, 4);
+            rectangle(ref, pt1, pt2, color, thickness, lineType);
+            list.rectangle(pt1, pt2, color, thickness, lineType);
+            break;
+        case 2:
+            circle(ref, pt1 * (1 << shift), r << shift, color, thickness, lineType, shift);
+            list.circle(pt1 * (1 << shift), r << shift, color, thickness, lineType, shift);
+            break;
+        case 3:
+            ellipse(ref, pt1, Size(r, r / 2), 30, 0, 270, color, -1, lineType);
+            list.ellipse(pt1, Size(r, r / 2), 30, 0, 270, color, -1, lineType);
+            break;
+        case 4:
+            polylines(ref, poly, true, color, thickness, lineType);
+            list.polylines(poly, true, color, thickness, lineType);
+            break;
+        case 5:
+            {
+            std::vector<std::vector<Point> > polys(1, poly);
+            fillPoly(ref, polys, color, lineType, 0, Point(3, -3));
+            list.fillPoly(polys, color, lineType, 0, Point(3, -3));
+            }
+            break;
+        case 6:
+            fillConvexPoly(ref, poly, color, lineType);
+            list.fillConvexPoly(poly, color, lineType);
+            break;
+        default:
+            putText(ref, "label 42", pt1, FONT_HERSHEY_SIMPLEX, r / 20., color, thickness, lineType);
+            list.putText("label 42", pt1, FONT_HERSHEY_SIMPLEX, r / 20., color, thickness, lineType);
+            break;
+        }
+    }
+
+    EXPECT_EQ(500u, list.size());
+    list.draw(dst);
+    EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+
+    list.clear();
+    EXPECT_TRUE(list.empty());
+}
+
+TEST_P(Drawing_DrawList, opacity)
+{
+    const int type = GetParam();
+    const Size sz(640, 480);
+    const double alpha = 0.3;
+    RNG& rng = theRNG();
+
+    Mat img(sz, type), overlay, ref, dst;
+    randu(img, 0, 256);
+    overlay = img.clone();
+    DrawList list;
+    list.setOpacity(alpha);
+    EXPECT_EQ(alpha, list.getOpacity());
+
+    // non-overlapping primitives in a grid of cells, so the blended overlay is the reference
+    for (int y = 0; y < sz.height; y += 80)
+    {
+        for (int x = 0; x < sz.width; x += 80)
+        {
+            Point c(x + 40, y + 40);
+            Scalar color(rng.uniform(0, 256), rng.uniform(0, 256), rng.uniform(0, 256));
+            std::vector<Point> poly;
+            poly.push_back(c + Point(-30, -30));
+            poly.push_back(c + Point(30, -10));
+            poly.push_back(c + Point(-10, 30));
+
+            switch ((x + y) / 80 % 4)
+            {
+            case 0:
+                rectangle(overlay, c - Point(30, 20), c + Point(30, 20), color, FILLED);
+                list.rectangle(c - Point(30, 20), c + Point(30, 20), color, FILLED);
+                break;
+            case 1:
+                circle(overlay, c * 4, 30 * 4, color, FILLED, LINE_8, 2);
+                list.circle(c * 4, 30 * 4, color, FILLED, LINE_8, 2);
+                break;
+            case 2:
+                fillConvexPoly(overlay, poly, color);
+                list.fillConvexPoly(poly, color);
+                break;
+            default:
+                line(overlay, poly[0], poly[1], color, 5);
+                list.line(poly[0], poly[1], color, 5);
+                break;
+            }
+        }
+    }
+
+    addWeighted(img, 1 - alpha, overlay, alpha, 0, ref);
+    dst = img.clone();
+    list.draw(dst);
+    EXPECT_LE(cvtest::norm(ref, dst, NORM_INF), CV_MAT_DEPTH(type) == CV_32F ? 1e-3 : 1);
+
+    // antialiased edges are blended partially, the opaque primitives are not affected
+    list.clear();
+    list.circle(Point(320, 240), 100, Scalar::all(255), FILLED, LINE_AA);
+    list.setOpacity(1);
+    list.rectangle(Point(10, 10), Point(50, 50), Scalar::all(0), FILLED);
+    dst = img.clone();
+    list.draw(dst);
+    ref = img.clone();
+    rectangle(ref, Point(10, 10), Point(50, 50), Scalar::all(0), FILLED);
+    EXPECT_EQ(0, cvtest::norm(ref.rowRange(0, 130), dst.rowRange(0, 130), NORM_INF));
+
+    Mat full = img.clone(), mask(sz, CV_8U, Scalar::all(0));
+    circle(full, Point(320, 240), 100, Scalar::all(255), FILLED, LINE_AA);
+    circle(mask, Point(320, 240), 100, Scalar::all(255), FILLED, LINE_AA);
+    addWeighted(img, 1 - alpha, full, alpha, 0, ref);
+    EXPECT_LE(cvtest::norm(ref, dst, NORM_INF, Mat(mask == 255)), CV_MAT_DEPTH(type) == CV_32F ? 1e-3 : 1);
+    EXPECT_GT(countNonZero((mask > 0) & (mask < 255)), 0);
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Drawing_DrawList, testing::Values(CV_8UC1, CV_8UC3, CV_8UC4, CV_16UC3, CV_32FC1));
+
 }} // namespace
@@ -2323,4 +2323,120 @@ TEST(Imgproc_Pyrdown, issue_12961)
     ASSERT_EQ(0.0, cv::norm(dst));
 }
 
+typedef testing::TestWithParam<tuple<perf::MatType, Size> > Imgproc_BuildPyramid;
+
+TEST_P(Imgproc_BuildPyramid, laplacian_bitexact)
+{
+    int type = get<0>(GetParam());
+    Size sz = get<1>(GetParam());
+    const int maxlevel = 4;
+    int depth = CV_MAT_DEPTH(type);
+    int ldepth = depth == CV_8U ? CV_16S : depth == CV_16U || depth == CV_16S ? CV_32F : depth;
+
+    Mat src(sz, type);
+    randu(src, 0, 256);
+
+    std::vector<Mat> refG, refL(maxlevel + 1);
+    buildPyramid(src, refG, maxlevel, BORDER_REFLECT);
+    for( int i = 0; i < maxlevel; i++ )
+    {
+        Mat up;
+        pyrUp(refG[i+1], up, refG[i].size());
+        subtract(refG[i], up, refL[i], noArray(), ldepth);
+    }
+    refG[maxlevel].convertTo(refL[maxlevel], ldepth);
+
+    std::vector<Mat> g, l;
+    buildPyramid(src, g, l, maxlevel, BORDER_REFLECT);
+    ASSERT_EQ((size_t)maxlevel + 1, g.size());
+    ASSERT_EQ((size_t)maxlevel + 1, l.size());
+    for( int i = 0; i <= maxlevel; i++ )
+    {
+        SCOPED_TRACE(cv::format("level=%d", i));
+        ASSERT_EQ(refG[i].size(), g[i].size());
+        ASSERT_EQ(CV_MAKETYPE(ldepth, src.channels()), l[i].type());
+        EXPECT_EQ(0, cvtest::norm(refG[i], g[i], NORM_INF));
+        EXPECT_EQ(0, cvtest::norm(refL[i], l[i], NORM_INF));
+    }
+
+    std::vector<Mat> g2;
+    buildPyramid(src, g2, noArray(), maxlevel, BORDER_REFLECT);
+    for( int i = 0; i <= maxlevel; i++ )
+        EXPECT_EQ(0, cvtest::norm(refG[i], g2[i], NORM_INF));
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Imgproc_BuildPyramid, testing::Combine(
+    testing::Values(CV_8UC1, CV_8UC3, CV_16SC1, CV_16UC4, CV_32FC1, CV_32FC3, CV_64FC1),
+    testing::Values(Size(320, 240), Size(127, 61), Size(35, 2))));
+
+TEST(Imgproc_Integral, parallel_bitexact)
+{
+    static const int depths[][3] =
+    {
+        { CV_8U, CV_32S, CV_64F }, { CV_8U, CV_32S, CV_32S }, { CV_8U, CV_32F, CV_64F },
+        { CV_8U, CV_64F, CV_64F }, { CV_16U, CV_64F, CV_64F }, { CV_16S, CV_64F, CV_64F },
+        { CV_32F, CV_32F, CV_32F }, { CV_32F, CV_64F, CV_64F }, { CV_64F, CV_64F, CV_64F }
+    };
+    int nthreads = getNumThreads();
+
+    for( size_t i = 0; i < sizeof(depths)/sizeof(depths[0]); i++ )
+    {
+        for( int cn = 1; cn <= 4; cn += 2 )
+        {
+            SCOPED_TRACE(cv::format("depth=%d sdepth=%d sqdepth=%d cn=%d", depths[i][0], depths[i][1], depths[i][2], cn));
+            Mat src(613, 1031, CV_MAKETYPE(depths[i][0], cn));
+            randu(src, 0, 256);
+
+            Mat sum0, sqsum0, sum1, sqsum1, sum2, tsum0, tsqsum0, tilted0, tsum1, tsqsum1, tilted1;
+            setNumThreads(1);
+            integral(src, sum0, sqsum0, depths[i][1], depths[i][2]);
+            integral(src, tsum0, tsqsum0, tilted0, depths[i][1], depths[i][2]);
+            setNumThreads(4);
+            integral(src, sum1, sqsum1, depths[i][1], depths[i][2]);
+            integral(src, sum2, depths[i][1]);
+            integral(src, tsum1, tsqsum1, tilted1, depths[i][1], depths[i][2]);
+            setNumThreads(nthreads);
+
+            EXPECT_EQ(0, cvtest::norm(sum0, sum1, NORM_INF));
+            EXPECT_EQ(0, cvtest::norm(sqsum0, sqsum1, NORM_INF));
+            EXPECT_EQ(0, cvtest::norm(sum0, sum2, NORM_INF));
+            EXPECT_EQ(0, cvtest::norm(sum0, tsum1, NORM_INF));
+            EXPECT_EQ(0, cvtest::norm(sqsum0, tsqsum1, NORM_INF));
+            EXPECT_EQ(0, cvtest::norm(tilted0, tilted1, NORM_INF));
+        }
+    }
+}
+
+TEST(Imgproc_FilterBank, accuracy)
+{
+    Mat whole(500, 640, CV_8UC1);
+    randu(whole, 0, 256);
+    Mat src = whole(Rect(13, 7, 601, 480));
+
+    std::vector<Mat> kernels;
+    for (int i = 0; i < 4; i++)
+        kernels.push_back(getGaborKernel(Size(31, 25), 4.0, CV_PI*i/4, 10, 0.5, 0, CV_32F));
+    kernels.push_back(getGaborKernel(Size(5, 5), 1.5, 0.3, 4, 0.5, 0, CV_64F));
+    Mat k(12, 16, CV_32F);
+    randu(k, -1, 1);
+    kernels.push_back(k);
+
+    const int borders[] = { BORDER_REFLECT_101, BORDER_CONSTANT, BORDER_REPLICATE, BORDER_REFLECT_101 | BORDER_ISOLATED };
+    for (int b = 0; b < 4; b++)
+    {
+        std::vector<Mat> dst;
+        filterBank(src, kernels, dst, CV_64F, borders[b]);
+        ASSERT_EQ(kernels.size(), dst.size());
+
+        for (size_t i = 0; i < kernels.size(); i++)
+        {
+            SCOPED_TRACE(cv::format("border=%d kernel=%d", borders[b], (int)i));
+            Mat ref;
+            cv::filter2D(src, ref, CV_64F, kernels[i], Point(-1, -1), 0, borders[b]);
+            ASSERT_EQ(CV_64FC1, dst[i].type());
+            EXPECT_LE(cvtest::norm(ref, dst[i], NORM_INF), 1e-4 * cvtest::norm(ref, NORM_INF));
+        }
+    }
+}
+
 }} // namespace
@@ -0,0 +1,85 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "test_precomp.hpp"
+
+namespace opencv_test { namespace {
+
+static Mat makeGeneralizedHoughTemplate()
+{
+    Mat templ(64, 64, CV_8UC1, Scalar::all(0));
+    std::vector<Point> poly;
+    poly.push_back(Point(8, 10));
+    poly.push_back(Point(50, 6));
+    poly.push_back(Point(56, 40));
+    poly.push_back(Point(30, 56));
+    poly.push_back(Point(12, 44));
+    fillConvexPoly(templ, poly, Scalar::all(255));
+    rectangle(templ, Rect(22, 20, 14, 12), Scalar::all(0), -1);
+    return templ;
+}
+
+static void detectWithThreads(const Ptr<GeneralizedHough>& alg, const Mat& image, int nthreads, Mat& positions, Mat& votes)
+{
+    int prevThreads = getNumThreads();
+    setNumThreads(nthreads);
+    alg->detect(image, positions, votes);
+    setNumThreads(prevThreads);
+}
+
+static void checkGeneralizedHough(const Ptr<GeneralizedHough>& alg, const Mat& image, Point2f center)
+{
+    Mat positions1, votes1, positions, votes;
+    detectWithThreads(alg, image, 1, positions1, votes1);
+    detectWithThreads(alg, image, getNumThreads(), positions, votes);
+
+    ASSERT_FALSE(positions.empty());
+    EXPECT_EQ(0, cvtest::norm(positions1, positions, NORM_INF));
+    EXPECT_EQ(0, cvtest::norm(votes1, votes, NORM_INF));
+
+    bool found = false;
+    for (int i = 0; i < positions.cols; i++)
+    {
+        Vec4f p = positions.at<Vec4f>(i);
+        if (cv::norm(Point2f(p[0], p[1]) - center) <= 2)
+            found = true;
+    }
+    EXPECT_TRUE(found);
+}
+
+TEST(Imgproc_GeneralizedHough, Ballard_parallel)
+{
+    Mat templ = makeGeneralizedHoughTemplate();
+    Mat image(240, 320, CV_8UC1, Scalar::all(0));
+    templ.copyTo(image(Rect(Point(150, 90), templ.size())));
+
+    Ptr<GeneralizedHoughBallard> alg = createGeneralizedHoughBallard();
+    alg->setVotesThreshold(20);
+    alg->setTemplate(templ);
+
+    checkGeneralizedHough(alg, image, Point2f(150 + 32, 90 + 32));
+}
+
+TEST(Imgproc_GeneralizedHough, Guil_parallel)
+{
+    Mat templ = makeGeneralizedHoughTemplate();
+    Mat image(240, 320, CV_8UC1, Scalar::all(0));
+    templ.copyTo(image(Rect(Point(150, 90), templ.size())));
+
+    Ptr<GeneralizedHoughGuil> alg = createGeneralizedHoughGuil();
+    alg->setMinAngle(0);
+    alg->setMaxAngle(10);
+    alg->setAngleStep(1);
+    alg->setMinScale(0.9);
+    alg->setMaxScale(1.1);
+    alg->setScaleStep(0.05);
+    alg->setAngleThresh(100);
+    alg->setScaleThresh(100);
+    alg->setPosThresh(20);
+    alg->setTemplate(templ);
+
+    checkGeneralizedHough(alg, image, Point2f(150 + 32, 90 + 32));
+}
+
+}} // namespace
@@ -498,6 +498,69 @@ int CV_GoodFeatureToTTest::validate_test_results( int test_case_idx )
 
 TEST(Imgproc_GoodFeatureToT, accuracy) { CV_GoodFeatureToTTest test; test.safe_run(); }
 
+TEST(Imgproc_GoodFeatureToT, grid)
+{
+    Mat src(480, 640, CV_8UC1);
+    randu(src, 0, 256);
+    GaussianBlur(src, src, Size(0, 0), 2);
+
+    const Size gridSize(4, 3);
+    const int maxPerCell = 7;
+    const double minDistance = 10;
+
+    std::vector<Point2f> corners;
+    goodFeaturesToTrackGrid(src, corners, gridSize, maxPerCell, 0.01, minDistance);
+    ASSERT_FALSE(corners.empty());
+    EXPECT_EQ((size_t)gridSize.area()*maxPerCell, corners.size());
+
+    Mat eig;
+    cornerMinEigenVal(src, eig, 3, 3);
+
+    std::vector<int> cellCount(gridSize.area(), 0);
+    for (size_t i = 0; i < corners.size(); i++)
+    {
+        Point p(cvRound(corners[i].x), cvRound(corners[i].y));
+        cellCount[(p.y*gridSize.height/src.rows)*gridSize.width + p.x*gridSize.width/src.cols]++;
+        if (i > 0)
+        {
+            EXPECT_LE(eig.at<float>(p), eig.at<float>(cvRound(corners[i - 1].y), cvRound(corners[i - 1].x)));
+        }
+        for (size_t j = 0; j < i; j++)
+            EXPECT_GE(cv::norm(corners[i] - corners[j]), minDistance);
+    }
+    for (size_t i = 0; i < cellCount.size(); i++)
+        EXPECT_EQ(maxPerCell, cellCount[i]) << "cell " << i;
+
+    // the strongest corners are the same as without the quota
+    std::vector<Point2f> ref;
+    goodFeaturesToTrack(src, ref, 1, 0.01, minDistance);
+    ASSERT_EQ(1u, ref.size());
+    EXPECT_EQ(ref[0], corners[0]);
+}
+
+TEST(Imgproc_CornerSubPix, parallel)
+{
+    Mat src(480, 640, CV_8UC1);
+    randu(src, 0, 256);
+    GaussianBlur(src, src, Size(0, 0), 2);
+
+    std::vector<Point2f> corners;
+    goodFeaturesToTrack(src, corners, 1000, 0.01, 5);
+    ASSERT_GT(corners.size(), 100u);
+
+    std::vector<Point2f> refined1 = corners, refined = corners;
+    TermCriteria criteria(TermCriteria::COUNT + TermCriteria::EPS, 40, 0.001);
+
+    int nthreads = getNumThreads();
+    setNumThreads(1);
+    cornerSubPix(src, refined1, Size(5, 5), Size(-1, -1), criteria);
+    setNumThreads(nthreads);
+    cornerSubPix(src, refined, Size(5, 5), Size(-1, -1), criteria);
+
+    EXPECT_EQ(0, cvtest::norm(refined1, refined, NORM_INF));
+    EXPECT_GT(cvtest::norm(corners, refined, NORM_INF), 0);
+}
+
 
 }} // namespace
 /* End of file. */
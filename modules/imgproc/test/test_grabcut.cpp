@@ -175,4 +175,31 @@ TEST(Imgproc_GrabCut, repeatability)
     EXPECT_EQ(0, countNonZero(mask_2 != mask_3));
 }
 
+// the graph of the later iterations continues from the flow of the previous ones,
+// it must find the same segmentation as a graph built from scratch
+TEST(Imgproc_GrabCut, warm_start)
+{
+    Mat img(180, 240, CV_8UC3, Scalar(60, 120, 40));
+    ellipse(img, Point(110, 95), Size(60, 40), 20, 0, 360, Scalar(40, 70, 210), FILLED);
+    rectangle(img, Rect(140, 60, 50, 70), Scalar(200, 190, 60), FILLED);
+    Mat noise(img.size(), CV_16SC3);
+    theRNG().state = 0x12345;
+    randn(noise, 0, 25);
+    cv::add(img, noise, img, noArray(), CV_8U);
+    Rect rect(30, 30, 190, 130);
+
+    Mat mask1, bgdModel1, fgdModel1;
+    theRNG().state = 0x12345;
+    grabCut(img, mask1, rect, bgdModel1, fgdModel1, 0, GC_INIT_WITH_RECT);
+    Mat mask2 = mask1.clone(), bgdModel2 = bgdModel1.clone(), fgdModel2 = fgdModel1.clone();
+
+    grabCut(img, mask1, rect, bgdModel1, fgdModel1, 4, GC_EVAL);
+    for( int i = 0; i < 4; i++ )
+        grabCut(img, mask2, rect, bgdModel2, fgdModel2, 1, GC_EVAL);
+
+    Mat fgd1 = (mask1 & 1), fgd2 = (mask2 & 1);
+    EXPECT_GT(countNonZero(fgd1), 1000);
+    EXPECT_LE(countNonZero(fgd1 != fgd2), (int)(img.total()/1000));
+}
+
 }} // namespace
@@ -1957,5 +1957,61 @@ TEST(Imgproc_Hist_Calc, calcHist_regression_11544)
     }
 }
 
+TEST(Imgproc_Hist_Calc, parallel_bitexact)
+{
+    const int depths[] = { CV_8U, CV_16U, CV_32F };
+    int nthreads = getNumThreads();
+
+    for( int d = 0; d < 3; d++ )
+    {
+        Mat big(517, 733, CV_MAKETYPE(depths[d], 3));
+        randu(big, 0, 256);
+        Mat mask(big.size(), CV_8U);
+        randu(mask, 0, 2);
+
+        // a continuous image, a submatrix and a masked submatrix
+        Mat images[] = { big, big(Rect(3, 5, 700, 500)), big(Rect(3, 5, 700, 500)) };
+        Mat masks[] = { Mat(), Mat(), mask(Rect(3, 5, 700, 500)) };
+
+        for( int k = 0; k < 3; k++ )
+        {
+            for( int dims = 1; dims <= 3; dims += 2 )
+            {
+                SCOPED_TRACE(cv::format("depth=%d case=%d dims=%d", depths[d], k, dims));
+                int channels[] = { 0, 1, 2 };
+                int histSize[] = { 37, 16, 20 };
+                float range[] = { 0, 256 };
+                float nonuniform[] = { 0, 10, 50, 51, 100, 200, 255 };
+                const float* ranges[] = { range, range, range };
+                const float* nuranges[] = { nonuniform, nonuniform, nonuniform };
+                int nuSize[] = { 6, 6, 6 };
+
+                Mat hist0, hist1, nhist0, nhist1, bp0, bp1;
+                SparseMat shist0, shist1;
+                setNumThreads(1);
+                calcHist(&images[k], 1, channels, masks[k], hist0, dims, histSize, ranges);
+                calcHist(&images[k], 1, channels, masks[k], nhist0, dims, nuSize, nuranges, false);
+                calcHist(&images[k], 1, channels, masks[k], shist0, dims, histSize, ranges);
+                calcBackProject(&images[k], 1, channels, hist0, bp0, ranges, 0.5);
+                setNumThreads(4);
+                calcHist(&images[k], 1, channels, masks[k], hist1, dims, histSize, ranges);
+                calcHist(&images[k], 1, channels, masks[k], nhist1, dims, nuSize, nuranges, false);
+                calcHist(&images[k], 1, channels, masks[k], shist1, dims, histSize, ranges);
+                calcBackProject(&images[k], 1, channels, hist1, bp1, ranges, 0.5);
+                setNumThreads(nthreads);
+
+                EXPECT_EQ(0, cvtest::norm(hist0, hist1, NORM_INF));
+                EXPECT_EQ(0, cvtest::norm(nhist0, nhist1, NORM_INF));
+                EXPECT_EQ(0, cvtest::norm(bp0, bp1, NORM_INF));
+                Mat dshist0, dshist1;
+                shist0.copyTo(dshist0);
+                shist1.copyTo(dshist1);
+                EXPECT_EQ(0, cvtest::norm(dshist0, dshist1, NORM_INF));
+                EXPECT_EQ(0, cvtest::norm(hist0, dshist0, NORM_INF));
+            }
+        }
+    }
+}
+
 }} // namespace
 /* End Of File */
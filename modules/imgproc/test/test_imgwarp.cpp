@@ -1743,6 +1743,62 @@ TEST(Imgproc_Warp, multichannel)
     }
 }
 
+TEST(Imgproc_WarpPlan, bitexact)
+{
+    static const int inter_types[] = {INTER_NEAREST, INTER_LINEAR, INTER_CUBIC, INTER_LANCZOS4};
+    static const int border_types[] = {BORDER_CONSTANT, BORDER_REPLICATE, BORDER_REFLECT, BORDER_TRANSPARENT};
+    static const int types[] = {CV_8UC1, CV_8UC3, CV_16UC4, CV_32FC1};
+
+    RNG& rng = theRNG();
+    for( int iter = 0; iter < 40; iter++ )
+    {
+        int inter = inter_types[rng.uniform(0, 4)];
+        int border = border_types[rng.uniform(0, 4)];
+        int type = types[rng.uniform(0, 4)];
+        bool perspective = rng.uniform(0, 2) != 0;
+        int flags = inter | (rng.uniform(0, 2) ? WARP_INVERSE_MAP : 0);
+        Size ssize(rng.uniform(10, 300), rng.uniform(10, 300));
+        Size dsize(rng.uniform(10, 300), rng.uniform(10, 300));
+        Scalar borderValue = Scalar::all(rng.uniform(0, 256));
+
+        Mat src(ssize, type);
+        randu(src, 0, 256);
+        Mat M = getRotationMatrix2D(Point2f(ssize.width*0.5f, ssize.height*0.5f),
+                                    rng.uniform(-180., 180.), rng.uniform(0.5, 2.));
+        if( perspective )
+        {
+            Mat M3 = Mat::eye(3, 3, CV_64F);
+            M.copyTo(M3.rowRange(0, 2));
+            M3.at<double>(2, 0) = rng.uniform(-1e-3, 1e-3);
+            M3.at<double>(2, 1) = rng.uniform(-1e-3, 1e-3);
+            M = M3;
+        }
+
+        Mat ref(dsize, type, Scalar::all(7)), dst(dsize, type, Scalar::all(7)), dst2 = dst.clone();
+        WarpPlan plan, lowmem;
+        if( perspective )
+        {
+            warpPerspective(src, ref, M, dsize, flags, border, borderValue);
+            plan.initPerspective(M, dsize, flags);
+            lowmem.initPerspective(M, dsize, flags, 0);
+        }
+        else
+        {
+            warpAffine(src, ref, M, dsize, flags, border, borderValue);
+            plan.initAffine(M, dsize, flags);
+            lowmem.initAffine(M, dsize, flags, 0);
+        }
+        ASSERT_TRUE(plan.hasMaps());
+        ASSERT_FALSE(lowmem.hasMaps());
+        EXPECT_EQ(0u, lowmem.mapBytes());
+
+        plan.apply(src, dst, border, borderValue);
+        lowmem.apply(src, dst2, border, borderValue);
+        ASSERT_EQ(0.0, cvtest::norm(ref, dst, NORM_INF)) << "iter=" << iter;
+        ASSERT_EQ(0.0, cvtest::norm(ref, dst2, NORM_INF)) << "iter=" << iter;
+    }
+}
+
 TEST(Imgproc_GetAffineTransform, singularity)
 {
     Point2f A_sample[3];
@@ -50,4 +50,69 @@ TEST(Imgproc_Subdiv2D_getTriangleList, regression_5788)
     EXPECT_EQ(trig_cnt, 105);
 }
 
+static bool triangleLess(const Vec6f& a, const Vec6f& b)
+{
+    return std::lexicographical_compare(a.val, a.val + 6, b.val, b.val + 6);
+}
+
+static void getSortedTriangles(const Subdiv2D& subdiv, std::vector<Vec6f>& triangles)
+{
+    subdiv.getTriangleList(triangles);
+    for (size_t i = 0; i < triangles.size(); i++)
+    {
+        // start each triangle from its lexicographically smallest vertex
+        Vec6f& t = triangles[i];
+        Point2f p[] = { Point2f(t[0], t[1]), Point2f(t[2], t[3]), Point2f(t[4], t[5]) };
+        int k = 0;
+        for (int j = 1; j < 3; j++)
+            if (p[j].x < p[k].x || (p[j].x == p[k].x && p[j].y < p[k].y))
+                k = j;
+        for (int j = 0; j < 3; j++)
+        {
+            t[j*2] = p[(k + j) % 3].x;
+            t[j*2 + 1] = p[(k + j) % 3].y;
+        }
+    }
+    std::sort(triangles.begin(), triangles.end(), triangleLess);
+}
+
+TEST(Imgproc_Subdiv2D, bulk_insert)
+{
+    const Rect rect(0, 0, 2000, 1500);
+    RNG& rng = theRNG();
+    std::vector<Point2f> pts(20000);
+    for (size_t i = 0; i < pts.size(); i++)
+        pts[i] = Point2f(rng.uniform(0.f, 2000.f), rng.uniform(0.f, 1500.f));
+    // duplicates must keep the ID of their first occurrence
+    for (size_t i = 0; i < 100; i++)
+        pts[pts.size() - 1 - i] = pts[i*7];
+
+    Subdiv2D ref(rect), subdiv(rect);
+    for (size_t i = 0; i < pts.size(); i++)
+        ref.insert(pts[i]);
+    subdiv.insert(pts);
+
+    std::vector<Vec6f> refTriangles, triangles;
+    getSortedTriangles(ref, refTriangles);
+    getSortedTriangles(subdiv, triangles);
+    ASSERT_EQ(refTriangles.size(), triangles.size());
+    for (size_t i = 0; i < triangles.size(); i++)
+        ASSERT_EQ(refTriangles[i], triangles[i]) << "triangle " << i;
+
+    for (size_t i = 0; i < pts.size(); i++)
+    {
+        int refEdge = 0, refVertex = 0, edge = 0, vertex = 0;
+        ASSERT_EQ(Subdiv2D::PTLOC_VERTEX, ref.locate(pts[i], refEdge, refVertex));
+        ASSERT_EQ(Subdiv2D::PTLOC_VERTEX, subdiv.locate(pts[i], edge, vertex));
+        ASSERT_EQ(refVertex, vertex) << "point " << i;
+    }
+
+    std::vector<std::vector<Point2f> > refFacets, facets;
+    std::vector<Point2f> refCenters, centers;
+    ref.getVoronoiFacetList(std::vector<int>(), refFacets, refCenters);
+    subdiv.getVoronoiFacetList(std::vector<int>(), facets, centers);
+    EXPECT_EQ(refCenters, centers);
+    ASSERT_EQ(refFacets.size(), facets.size());
+}
+
 }};
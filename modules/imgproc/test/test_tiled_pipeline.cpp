@@ -0,0 +1,141 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "test_precomp.hpp"
+
+namespace opencv_test { namespace {
+
+// serves the tiles of an in-memory image and counts the pixels read
+class CountingTileSource : public TileSource
+{
+public:
+    explicit CountingTileSource(const Mat& _m) : m(_m), pixelsRead(0) {}
+    Size size() const CV_OVERRIDE { return m.size(); }
+    int type() const CV_OVERRIDE { return m.type(); }
+    void read(const Rect& roi, OutputArray dst) CV_OVERRIDE
+    {
+        ASSERT_EQ(roi, roi & Rect(Point(), m.size()));
+        pixelsRead += roi.area();
+        m(roi).copyTo(dst);
+    }
+
+    Mat m;
+    size_t pixelsRead;
+};
+
+class CollectingTileSink : public TileSink
+{
+public:
+    explicit CollectingTileSink(Size size, int type) : m(size, type, Scalar::all(0)), mask(size, CV_8U, Scalar(0)) {}
+    void write(const Rect& roi, InputArray tile) CV_OVERRIDE
+    {
+        ASSERT_EQ(roi.size(), tile.size());
+        ASSERT_EQ(0, countNonZero(mask(roi)));
+        tile.copyTo(m(roi));
+        mask(roi).setTo(Scalar(255));
+    }
+
+    Mat m, mask;
+};
+
+TEST(Imgproc_TiledPipeline, filters_bitexact)
+{
+    Mat src(437, 619, CV_8UC3);
+    randu(src, 0, 256);
+
+    Mat kernel = (Mat_<float>(3, 5) << 1, 2, 0, -2, -1, 2, 4, 1, -4, -2, 1, 2, 0, -2, -1);
+    Mat se = getStructuringElement(MORPH_ELLIPSE, Size(7, 5));
+
+    Mat ref;
+    GaussianBlur(src, ref, Size(0, 0), 2.0);
+    morphologyEx(ref, ref, MORPH_OPEN, se, Point(-1, -1), 2);
+    cv::filter2D(ref, ref, CV_16S, kernel, Point(-1, -1), 3, BORDER_REFLECT);
+    boxFilter(ref, ref, CV_32F, Size(4, 3));
+    cv::threshold(ref, ref, 20, 255, THRESH_TRUNC);
+    cvtColor(ref, ref, COLOR_BGR2GRAY);
+
+    TiledPipeline pipeline;
+    pipeline.GaussianBlur(Size(0, 0), 2.0)
+            .morphologyEx(MORPH_OPEN, se, 2)
+            .filter2D(CV_16S, kernel, 3, BORDER_REFLECT)
+            .boxFilter(CV_32F, Size(4, 3))
+            .threshold(20, 255, THRESH_TRUNC)
+            .cvtColor(COLOR_BGR2GRAY);
+    pipeline.setTileSize(Size(100, 77));
+    EXPECT_EQ(src.size(), pipeline.outputSize(src.size()));
+    EXPECT_EQ(CV_32FC1, pipeline.outputType(src.type()));
+
+    CountingTileSource source(src);
+    CollectingTileSink sink(pipeline.outputSize(src.size()), pipeline.outputType(src.type()));
+    pipeline.run(source, sink);
+
+    EXPECT_EQ(src.total(), (size_t)countNonZero(sink.mask));
+    EXPECT_LE(cvtest::norm(ref, sink.m, NORM_INF), 1e-4);
+
+    Mat dst;
+    pipeline.run(src, dst);
+    EXPECT_LE(cvtest::norm(ref, dst, NORM_INF), 1e-4);
+}
+
+TEST(Imgproc_TiledPipeline, resize)
+{
+    // remap quantizes the coordinates to 1/32 pixel, so the image is smoothed
+    // to make the difference from cv::resize small
+    Mat src(403, 517, CV_8UC1);
+    randu(src, 0, 256);
+    GaussianBlur(src, src, Size(0, 0), 3);
+    normalize(src, src, 0, 255, NORM_MINMAX);
+
+    static const int inter[] = { INTER_NEAREST, INTER_AREA, INTER_LINEAR, INTER_LINEAR, INTER_CUBIC };
+    static const double scale[] = { 0.37, 0.25, 0.5, 1.7, 0.6 };
+    // 0: bit-exact with cv::resize, otherwise remap precision
+    static const double eps[] = { 0, 0, 0, 1, 1 };
+
+    for( int i = 0; i < 5; i++ )
+    {
+        SCOPED_TRACE(cv::format("interpolation=%d scale=%g", inter[i], scale[i]));
+        Mat ref, dst;
+        cv::resize(src, ref, Size(), scale[i], scale[i], inter[i]);
+
+        TiledPipeline pipeline;
+        pipeline.resize(scale[i], scale[i], inter[i]);
+        pipeline.setTileSize(Size(64, 48));
+        ASSERT_EQ(ref.size(), pipeline.outputSize(src.size()));
+        pipeline.run(src, dst);
+        EXPECT_LE(cvtest::norm(ref, dst, NORM_INF), eps[i]);
+
+        // the tiles must not depend on their neighbors
+        Mat whole;
+        pipeline.setTileSize(src.size());
+        pipeline.run(src, whole);
+        EXPECT_EQ(0, cvtest::norm(whole, dst, NORM_INF));
+    }
+
+    TiledPipeline pipeline;
+    EXPECT_THROW(pipeline.resize(0.3, 0.3, INTER_AREA), cv::Exception);
+}
+
+TEST(Imgproc_TiledPipeline, bounded_reads)
+{
+    Mat src(1000, 1000, CV_8UC1);
+    randu(src, 0, 256);
+
+    TiledPipeline pipeline;
+    pipeline.boxFilter(-1, Size(9, 9)).resize(0.5, 0.5, INTER_AREA);
+    pipeline.setTileSize(Size(100, 100));
+
+    CountingTileSource source(src);
+    CollectingTileSink sink(pipeline.outputSize(src.size()), src.type());
+    pipeline.run(source, sink);
+
+    // every output tile needs a 200x200 source region plus the filter halo
+    EXPECT_LE(source.pixelsRead, (size_t)25*208*208);
+
+    Mat ref;
+    boxFilter(src, ref, -1, Size(9, 9));
+    cv::resize(ref, ref, Size(), 0.5, 0.5, INTER_AREA);
+    EXPECT_EQ(0, cvtest::norm(ref, sink.m, NORM_INF));
+}
+
+}} // namespace
@@ -124,4 +124,78 @@ void CV_WatershedTest::run( int /* start_from */)
 
 TEST(Imgproc_Watershed, regression) { CV_WatershedTest test; test.safe_run(); }
 
+// straightforward mean shift filtering of a single level
+static void meanShiftFilterReference(const Mat& src, Mat& dst, double sp, double sr, int maxCount, double eps)
+{
+    int isr2 = cvRound(sr*sr);
+    dst.create(src.size(), src.type());
+    for( int i = 0; i < src.rows; i++ )
+    {
+        for( int j = 0; j < src.cols; j++ )
+        {
+            Vec3b c = src.at<Vec3b>(i, j);
+            int x0 = j, y0 = i;
+            for( int iter = 0; iter < maxCount; iter++ )
+            {
+                int minx = std::max(cvRound(x0 - sp), 0), maxx = std::min(cvRound(x0 + sp), src.cols - 1);
+                int miny = std::max(cvRound(y0 - sp), 0), maxy = std::min(cvRound(y0 + sp), src.rows - 1);
+                int s[3] = { 0, 0, 0 }, sx = 0, sy = 0, count = 0;
+                for( int y = miny; y <= maxy; y++ )
+                    for( int x = minx; x <= maxx; x++ )
+                    {
+                        Vec3b t = src.at<Vec3b>(y, x);
+                        int d = 0;
+                        for( int k = 0; k < 3; k++ )
+                            d += (t[k] - c[k])*(t[k] - c[k]);
+                        if( d <= isr2 )
+                        {
+                            for( int k = 0; k < 3; k++ )
+                                s[k] += t[k];
+                            sx += x; sy += y; count++;
+                        }
+                    }
+                if( count == 0 )
+                    break;
+                int x1 = cvRound(sx*(1./count)), y1 = cvRound(sy*(1./count));
+                Vec3b c1;
+                int d = std::abs(x1 - x0) + std::abs(y1 - y0);
+                for( int k = 0; k < 3; k++ )
+                {
+                    c1[k] = (uchar)cvRound(s[k]*(1./count));
+                    d += (c1[k] - c[k])*(c1[k] - c[k]);
+                }
+                bool stop = (x0 == x1 && y0 == y1) || d <= eps;
+                x0 = x1; y0 = y1; c = c1;
+                if( stop )
+                    break;
+            }
+            dst.at<Vec3b>(i, j) = c;
+        }
+    }
+}
+
+TEST(Imgproc_PyrMeanShiftFiltering, accuracy)
+{
+    Mat src(97, 131, CV_8UC3);
+    randu(src, 0, 256);
+    GaussianBlur(src, src, Size(0, 0), 3);
+    // keep the window wide enough for the vectorized path
+    const double sp = 12, sr = 20;
+    TermCriteria termcrit(TermCriteria::MAX_ITER + TermCriteria::EPS, 5, 1);
+
+    Mat ref, dst;
+    meanShiftFilterReference(src, ref, sp, sr, termcrit.maxCount, termcrit.epsilon);
+    pyrMeanShiftFiltering(src, dst, sp, sr, 0, termcrit);
+    EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+
+    // the pyramid levels do not depend on the number of threads either
+    int threads = getNumThreads();
+    Mat dst1;
+    setNumThreads(1);
+    pyrMeanShiftFiltering(src, dst1, sp, sr, 2, termcrit);
+    setNumThreads(threads);
+    pyrMeanShiftFiltering(src, dst, sp, sr, 2, termcrit);
+    EXPECT_EQ(0, cvtest::norm(dst1, dst, NORM_INF));
+}
+
 }} // namespace